@@ -0,0 +1,138 @@
+/*
+ * alloc.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "moonlight/alloc.h"
+#include "moonlight/alloc_hooks.h"
+#include "moonlight/json.h"
+#include "moonlight/lex.h"
+#include "moonlight/sql/sqlite3.h"
+#include "moonlight/bench.h"
+
+using namespace moonlight;
+using namespace moonlight::test;
+
+const size_t OBJECTS = 10000;
+
+struct Node {
+    uint64_t key;
+    uint64_t value;
+    Node* next;
+};
+
+std::string make_document(int records) {
+    json::Array array;
+    for (int x = 0; x < records; x++) {
+        array.append(json::Object()
+                     .set("id", x)
+                     .set("name", "record-" + std::to_string(x))
+                     .set("score", x * 1.25)
+                     .set("tags", std::vector<std::string>{"alpha", "beta", "gamma"}));
+    }
+    return json::to_string(json::Object().set("records", array));
+}
+
+int main() {
+    BenchmarkSuite suite("moonlight alloc benchmarks");
+    std::vector<Node*> nodes(OBJECTS);
+    alloc::Arena arena;
+
+    suite.bench(Benchmark("new/delete 24 byte objects (baseline)", [&]() {
+        for (auto& node : nodes) {
+            node = new Node{1, 2, nullptr};
+        }
+        for (auto node : nodes) {
+            delete node;
+        }
+    }).items(OBJECTS));
+    suite.bench(Benchmark("ObjectPool 24 byte objects", [&]() {
+        for (auto& node : nodes) {
+            node = alloc::ObjectPool<Node>::create(Node{1, 2, nullptr});
+        }
+        for (auto node : nodes) {
+            alloc::ObjectPool<Node>::destroy(node);
+        }
+    }).items(OBJECTS));
+    suite.bench(Benchmark("Arena 24 byte objects", [&]() {
+        for (auto& node : nodes) {
+            node = arena.make<Node>(Node{1, 2, nullptr});
+        }
+        arena.reset();
+    }).items(OBJECTS));
+    suite.bench(Benchmark("std::pmr::monotonic_buffer_resource 24 byte objects", [&]() {
+        std::pmr::monotonic_buffer_resource resource;
+        std::pmr::polymorphic_allocator<Node> allocator(&resource);
+        for (auto& node : nodes) {
+            node = allocator.allocate(1);
+        }
+    }).items(OBJECTS));
+
+    const std::string document = make_document(1000);
+    suite.bench(Benchmark("parse 1000 records (baseline)", [&]() {
+        do_not_optimize(json::read<json::Value::Pointer>(document));
+    }).bytes(document.size()).items(1000));
+    suite.bench(Benchmark("parse 1000 records, Arena", [&]() {
+        {
+            alloc::Scope scope(arena);
+            do_not_optimize(json::read<json::Value::Pointer>(document));
+        }
+        arena.reset();
+    }).bytes(document.size()).items(1000));
+    suite.bench(Benchmark("parse 1000 records, PoolResource", [&]() {
+        alloc::Scope scope(alloc::pool_resource());
+        do_not_optimize(json::read<json::Value::Pointer>(document));
+    }).bytes(document.size()).items(1000));
+
+    auto lexer = lex::Grammar<std::string>()
+    .def(lex::ignore("\\s+"))
+    .def(lex::match("[a-z]+"), "word")
+    .def(lex::match("[0-9]+"), "number")
+    .lexer();
+    std::string text;
+    for (int x = 0; x < 1000; x++) {
+        text += "moon " + std::to_string(x) + " ";
+    }
+    suite.bench(Benchmark("lex 2000 tokens (baseline)", [&]() {
+        do_not_optimize(lexer.lex(text));
+    }).items(2000));
+    suite.bench(Benchmark("lex 2000 tokens, Arena", [&]() {
+        {
+            std::pmr::vector<lex::Token<std::string>> tokens(&arena);
+            do_not_optimize(lexer.try_lex(text, tokens));
+        }
+        arena.reset();
+    }).items(2000));
+
+    auto sql = sqlite::Client::open("");
+    sql->exec("create table t (x integer, y text)");
+    for (int x = 0; x < 1000; x++) {
+        sql->exec("insert into t values (?, ?)", x, "row");
+    }
+    auto sum_rows = [&]() {
+        int total = 0;
+        sql->query("select x, y from t").for_each([&](auto row) {
+            total += row->at(0).as_int();
+        });
+        do_not_optimize(total);
+    };
+    suite.bench(Benchmark("query 1000 rows (baseline)", sum_rows).items(1000));
+    suite.bench(Benchmark("query 1000 rows, Arena", [&]() {
+        {
+            alloc::Scope scope(arena);
+            sum_rows();
+        }
+        arena.reset();
+    }).items(1000));
+
+    return suite.run();
+}
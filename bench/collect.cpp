@@ -0,0 +1,74 @@
+/*
+ * collect.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "moonlight/collect.h"
+#include "moonlight/alloc_hooks.h"
+#include "moonlight/hash.h"
+#include "moonlight/bench.h"
+
+using namespace moonlight;
+using namespace moonlight::test;
+
+const size_t SIZE = 4000000;
+
+int main() {
+    BenchmarkSuite suite("moonlight collect benchmarks");
+
+    std::vector<uint64_t> src(SIZE);
+    for (size_t x = 0; x < SIZE; x++) {
+        src[x] = hash::mix(x);
+    }
+
+    suite.bench(Benchmark("map", [&]() {
+        do_not_optimize(collect::map<uint64_t>(src, [](const uint64_t& x) {
+            return hash::mix(x);
+        }));
+    }).items(SIZE));
+    suite.bench(Benchmark("filter", [&]() {
+        do_not_optimize(collect::filter(src, [](uint64_t x) {
+            return x % 3 == 0;
+        }));
+    }).items(SIZE));
+    suite.bench(Benchmark("sorted", [&]() {
+        do_not_optimize(collect::sorted(src));
+    }).items(SIZE));
+    suite.bench(Benchmark("std::accumulate", [&]() {
+        do_not_optimize(std::accumulate(src.begin(), src.end(), (uint64_t)0));
+    }).items(SIZE));
+
+    for (size_t threads : {1, 2, 4, 8, 16}) {
+        auto pool = std::make_shared<collect::par::Pool>(threads);
+        std::string suffix = ", " + std::to_string(threads) + " threads";
+
+        suite.bench(Benchmark("par::map" + suffix, [=, &src]() {
+            do_not_optimize(collect::par::map(src, [](uint64_t x) {
+                return hash::mix(x);
+            }, *pool));
+        }).items(SIZE));
+        suite.bench(Benchmark("par::filter" + suffix, [=, &src]() {
+            do_not_optimize(collect::par::filter(src, [](uint64_t x) {
+                return x % 3 == 0;
+            }, *pool));
+        }).items(SIZE));
+        suite.bench(Benchmark("par::sorted" + suffix, [=, &src]() {
+            do_not_optimize(collect::par::sorted(src, std::less<>(), *pool));
+        }).items(SIZE));
+        suite.bench(Benchmark("par::reduce" + suffix, [=, &src]() {
+            do_not_optimize(collect::par::reduce(src, (uint64_t)0, std::plus<>(), *pool));
+        }).items(SIZE));
+    }
+
+    return suite.run();
+}
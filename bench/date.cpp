@@ -0,0 +1,44 @@
+/*
+ * date.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include "moonlight/date.h"
+#include "moonlight/alloc_hooks.h"
+#include "moonlight/bench.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+int main() {
+    const auto date = moonlight::date::Date(2021, moonlight::date::Month::February, 28);
+    const std::string iso_date = date.isoformat();
+    const std::string iso_datetime = "2021-02-28T13:45:00Z";
+
+    return BenchmarkSuite("moonlight date benchmarks")
+    .bench("Date::from_isoformat", [&]() {
+        do_not_optimize(moonlight::date::Date::from_isoformat(iso_date));
+    })
+    .bench("Date::isoformat", [&]() {
+        do_not_optimize(date.isoformat());
+    })
+    .bench(Benchmark("Date::operator++", [&]() {
+        auto d = date;
+        for (int x = 0; x < 365; x++) {
+            ++d;
+        }
+        do_not_optimize(d);
+    }).items(365))
+    .bench("Date::weekday", [&]() {
+        do_not_optimize(date.weekday());
+    })
+    .bench("Datetime::from_isoformat", [&]() {
+        do_not_optimize(moonlight::date::Datetime::from_isoformat(iso_datetime));
+    })
+    .run();
+}
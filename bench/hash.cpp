@@ -0,0 +1,100 @@
+/*
+ * hash.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "moonlight/hash.h"
+#include "moonlight/alloc_hooks.h"
+#include "moonlight/bench.h"
+
+using namespace moonlight;
+using namespace moonlight::test;
+
+const size_t KEYS = 8192;
+
+/**
+ * Insert strided integer keys into a power-of-two linear probing table,
+ * returning the number of probes.
+ */
+template<class H>
+size_t probe_table(H hash_function) {
+    std::vector<uint64_t> slots(KEYS * 2, 0);
+    size_t mask = slots.size() - 1;
+    size_t probes = 0;
+
+    for (uint64_t x = 1; x <= KEYS; x++) {
+        uint64_t key = x << 12;
+        for (size_t n = hash_function(key) & mask; ; n = (n + 1) & mask, probes++) {
+            if (slots[n] == 0) {
+                slots[n] = key;
+                break;
+            }
+        }
+    }
+    return probes;
+}
+
+int main() {
+    BenchmarkSuite suite("moonlight hash benchmarks");
+
+    for (size_t len : {8, 64, 1024, 65536}) {
+        std::string data(len, 'x');
+        for (size_t x = 0; x < len; x++) {
+            data[x] = 'a' + (x * 7) % 26;
+        }
+
+        suite.bench(Benchmark("std::hash " + std::to_string(len) + "B", [=]() {
+            do_not_optimize(std::hash<std::string_view>()(data));
+        }).bytes(len));
+        suite.bench(Benchmark("hash::bytes " + std::to_string(len) + "B", [=]() {
+            do_not_optimize(hash::bytes(data));
+        }).bytes(len));
+    }
+
+    std::vector<std::string> keys;
+    for (size_t x = 0; x < KEYS; x++) {
+        keys.push_back("/api/v1/resources/" + std::to_string(x * 7919));
+    }
+
+    suite.bench(Benchmark("unordered_map<string> std::hash", [&]() {
+        std::unordered_map<std::string, size_t> map;
+        for (size_t x = 0; x < keys.size(); x++) {
+            map.emplace(keys[x], x);
+        }
+        size_t sum = 0;
+        for (const auto& key : keys) {
+            sum += map.find(key)->second;
+        }
+        do_not_optimize(sum);
+    }).items(KEYS));
+    suite.bench(Benchmark("unordered_map<string> hash::Hash", [&]() {
+        std::unordered_map<std::string, size_t, hash::Hash> map;
+        for (size_t x = 0; x < keys.size(); x++) {
+            map.emplace(keys[x], x);
+        }
+        size_t sum = 0;
+        for (const auto& key : keys) {
+            sum += map.find(key)->second;
+        }
+        do_not_optimize(sum);
+    }).items(KEYS));
+
+    suite.bench(Benchmark("linear probing std::hash", []() {
+        do_not_optimize(probe_table(std::hash<uint64_t>()));
+    }).items(KEYS));
+    suite.bench(Benchmark("linear probing hash::mix", []() {
+        do_not_optimize(probe_table(hash::mix));
+    }).items(KEYS));
+
+    return suite.run();
+}
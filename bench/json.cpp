@@ -0,0 +1,67 @@
+/*
+ * json.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include "moonlight/json.h"
+#include "moonlight/alloc_hooks.h"
+#include "moonlight/bench.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+std::string make_document(int records) {
+    json::Array array;
+    for (int x = 0; x < records; x++) {
+        array.append(json::Object()
+                     .set("id", x)
+                     .set("name", "record-" + std::to_string(x))
+                     .set("score", x * 1.25)
+                     .set("active", x % 2 == 0)
+                     .set("tags", std::vector<std::string>{"alpha", "beta", "gamma"}));
+    }
+    return json::to_string(json::Object().set("records", array));
+}
+
+int main() {
+    const std::string small = make_document(1);
+    const std::string large = make_document(1000);
+    const auto large_obj = json::read<json::Object>(large);
+    const std::string long_string = json::to_string(std::string(1 << 20, 'x'));
+
+    return BenchmarkSuite("moonlight json benchmarks")
+    .bench(Benchmark("parse small document", [&]() {
+        do_not_optimize(json::read<json::Object>(small));
+    }).bytes(small.size()))
+    .bench(Benchmark("parse 1000 records", [&]() {
+        do_not_optimize(json::read<json::Object>(large));
+    }).bytes(large.size()).items(1000))
+    .bench(Benchmark("push parse 1000 records, 4KB chunks", [&]() {
+        json::parser::PushParser parser;
+        for (size_t x = 0; x < large.size(); x += 4096) {
+            parser.feed(std::span<const char>(large.data() + x, std::min(size_t(4096), large.size() - x)));
+        }
+        parser.finish();
+        do_not_optimize(parser.next());
+    }).bytes(large.size()).items(1000))
+    .bench(Benchmark("push parse a 1MB string, 4KB chunks", [&]() {
+        json::parser::PushParser parser;
+        for (size_t x = 0; x < long_string.size(); x += 4096) {
+            parser.feed(std::span<const char>(long_string.data() + x, std::min(size_t(4096), long_string.size() - x)));
+        }
+        parser.finish();
+        do_not_optimize(parser.next());
+    }).bytes(long_string.size()))
+    .bench(Benchmark("serialize 1000 records", [&]() {
+        do_not_optimize(json::to_string(large_obj));
+    }).bytes(large.size()).items(1000))
+    .bench(Benchmark("serialize 1000 records, pretty", [&]() {
+        do_not_optimize(json::to_string(large_obj, json::FormatOptions{.pretty = true}));
+    }).items(1000))
+    .run();
+}
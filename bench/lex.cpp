@@ -0,0 +1,40 @@
+/*
+ * lex.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include "moonlight/lex.h"
+#include "moonlight/alloc_hooks.h"
+#include "moonlight/bench.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+int main() {
+    auto grammar = lex::Grammar<std::string>()
+    .def(lex::ignore("\\s+"))
+    .def(lex::match("[0-9]+"), "number")
+    .def(lex::match("[a-zA-Z_][a-zA-Z0-9_]*"), "word")
+    .def(lex::match("[-+*/=()]"), "op");
+    auto lexer = grammar.lexer();
+
+    std::string line = "let total = (count + 42) * scale_factor - offset / 7\n";
+    std::string program;
+    for (int x = 0; x < 100; x++) {
+        program += line;
+    }
+
+    return BenchmarkSuite("moonlight lex benchmarks")
+    .bench(Benchmark("lex one line", [&]() {
+        do_not_optimize(lexer.lex(line));
+    }).bytes(line.size()))
+    .bench(Benchmark("lex 100 lines", [&]() {
+        do_not_optimize(lexer.lex(program));
+    }).bytes(program.size()))
+    .run();
+}
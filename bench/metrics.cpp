@@ -0,0 +1,77 @@
+/*
+ * metrics.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "moonlight/metrics.h"
+#include "moonlight/alloc_hooks.h"
+#include "moonlight/bench.h"
+
+using namespace moonlight;
+using namespace moonlight::test;
+
+const size_t UPDATES = 1000000;
+
+template<class F>
+void on_threads(size_t threads, F f) {
+    std::vector<std::thread> workers;
+    for (size_t x = 0; x < threads; x++) {
+        workers.emplace_back([&]() {
+            for (size_t y = 0; y < UPDATES / threads; y++) {
+                f(y);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+int main() {
+    BenchmarkSuite suite("moonlight metrics benchmarks");
+    metrics::Registry registry;
+    auto& counter = registry.counter("counter_total");
+    auto& histogram = registry.histogram("histogram_ns");
+    std::atomic<uint64_t> shared_counter = 0;
+
+    for (size_t threads : {1, 2, 4, 8}) {
+        std::string suffix = ", " + std::to_string(threads) + " threads";
+
+        suite.bench(Benchmark("std::atomic fetch_add (baseline)" + suffix, [&]() {
+            on_threads(threads, [&](size_t) {
+                shared_counter.fetch_add(1, std::memory_order_relaxed);
+            });
+        }).items(UPDATES));
+        suite.bench(Benchmark("Counter::inc" + suffix, [&]() {
+            on_threads(threads, [&](size_t) {
+                counter.inc();
+            });
+        }).items(UPDATES));
+        suite.bench(Benchmark("Histogram::record" + suffix, [&]() {
+            on_threads(threads, [&](size_t y) {
+                histogram.record(y * 37);
+            });
+        }).items(UPDATES));
+    }
+
+    for (int x = 0; x < 64; x++) {
+        registry.histogram("histogram_" + std::to_string(x) + "_ns").record(x);
+    }
+    suite.bench(Benchmark("Registry::snapshot, 66 metrics", [&]() {
+        do_not_optimize(registry.snapshot());
+    }));
+    suite.bench(Benchmark("Registry::to_text, 66 metrics", [&]() {
+        do_not_optimize(registry.to_text());
+    }));
+
+    return suite.run();
+}
@@ -0,0 +1,90 @@
+/*
+ * mmap.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "moonlight/mmap.h"
+#include "moonlight/alloc_hooks.h"
+#include "moonlight/hash.h"
+#include "moonlight/bench.h"
+
+using namespace moonlight;
+using namespace moonlight::test;
+
+const size_t QUERIES = 1024;
+
+/**
+ * Benchmark lookups in tables of `keys` keys with 4 values each.
+ */
+template<class K>
+void bench_table(BenchmarkSuite& suite, const std::string& name,
+                 size_t keys, K (*make_key)(size_t)) {
+    std::vector<std::pair<K, int>> pairs;
+    for (size_t x = 0; x < keys * 4; x++) {
+        pairs.emplace_back(make_key(hash::mix(x % keys) % keys), x);
+    }
+    std::vector<K> queries;
+    for (size_t x = 0; x < QUERIES; x++) {
+        queries.push_back(make_key(hash::mix(x + keys) % keys));
+    }
+
+    std::multimap<K, int> tree(pairs.begin(), pairs.end());
+    mmap::FlatMultimap<K, int> flat(pairs);
+    std::string suffix = ", " + name + " x " + std::to_string(keys);
+
+    suite.bench(Benchmark("std::multimap build" + suffix, [=]() {
+        do_not_optimize(std::multimap<K, int>(pairs.begin(), pairs.end()));
+    }).items(pairs.size()));
+    suite.bench(Benchmark("FlatMultimap build" + suffix, [=]() {
+        do_not_optimize(mmap::FlatMultimap<K, int>(pairs));
+    }).items(pairs.size()));
+    suite.bench(Benchmark("std::multimap equal_range" + suffix, [=]() {
+        int sum = 0;
+        for (const auto& key : queries) {
+            auto range = tree.equal_range(key);
+            for (auto iter = range.first; iter != range.second; iter++) {
+                sum += iter->second;
+            }
+        }
+        do_not_optimize(sum);
+    }).items(QUERIES));
+    suite.bench(Benchmark("FlatMultimap equal_range" + suffix, [=]() {
+        int sum = 0;
+        for (const auto& key : queries) {
+            for (int value : flat.equal_range(key)) {
+                sum += value;
+            }
+        }
+        do_not_optimize(sum);
+    }).items(QUERIES));
+    suite.bench(Benchmark("mmap::collect std::multimap" + suffix, [=]() {
+        for (const auto& key : queries) {
+            do_not_optimize(mmap::collect(tree, key));
+        }
+    }).items(QUERIES));
+}
+
+int main() {
+    BenchmarkSuite suite("moonlight mmap benchmarks");
+
+    auto int_key = +[](size_t x) { return (int)x; };
+    auto string_key = +[](size_t x) { return "command-" + std::to_string(x); };
+
+    for (size_t keys : {64, 4096, 262144}) {
+        bench_table<int>(suite, "int", keys, int_key);
+    }
+    for (size_t keys : {64, 4096}) {
+        bench_table<std::string>(suite, "string", keys, string_key);
+    }
+
+    return suite.run();
+}
@@ -0,0 +1,76 @@
+/*
+ * nanoid.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "moonlight/nanoid.h"
+#include "moonlight/alloc_hooks.h"
+#include "moonlight/bench.h"
+
+using namespace moonlight;
+using namespace moonlight::test;
+
+const size_t BATCH = 1000;
+const size_t THREADS = 4;
+
+// The alphabet and size used by `utils/nanoid.cpp`.
+const std::string UTILS_ALPHABET = nanoid::NUMBERS + nanoid::LOWERCASE;
+
+int main() {
+    nanoid::Generator ids;
+    nanoid::Generator utils_ids(8, UTILS_ALPHABET);
+    std::vector<char> buffer(BATCH * ids.size());
+
+    return BenchmarkSuite("moonlight nanoid benchmarks")
+    .bench(Benchmark("generate()", []() {
+        do_not_optimize(nanoid::generate());
+    }).items(1))
+    .bench(Benchmark("Generator::generate()", [&]() {
+        do_not_optimize(ids.generate());
+    }).items(1))
+    .bench(Benchmark("Generator::generate_n()", [&]() {
+        ids.generate_n(buffer.data(), BATCH);
+        do_not_optimize(buffer);
+    }).items(BATCH))
+    .bench(Benchmark("generate(), utils/nanoid", []() {
+        do_not_optimize(nanoid::generate(8, UTILS_ALPHABET));
+    }).items(1))
+    .bench(Benchmark("Generator, utils/nanoid", [&]() {
+        do_not_optimize(utils_ids.generate());
+    }).items(1))
+    .bench(Benchmark("generate(), 4 threads", []() {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREADS; t++) {
+            threads.emplace_back([]() {
+                for (size_t x = 0; x < BATCH; x++) {
+                    do_not_optimize(nanoid::generate());
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }).items(THREADS * BATCH))
+    .bench(Benchmark("Generator::generate_n(), 4 threads", [&]() {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREADS; t++) {
+            threads.emplace_back([&]() {
+                std::vector<char> out(BATCH * ids.size());
+                ids.generate_n(out.data(), BATCH);
+                do_not_optimize(out);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }).items(THREADS * BATCH))
+    .run();
+}
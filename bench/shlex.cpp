@@ -0,0 +1,108 @@
+/*
+ * shlex.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "moonlight/shlex.h"
+#include "moonlight/alloc_hooks.h"
+#include "moonlight/collect.h"
+#include "moonlight/rx.h"
+#include "moonlight/bench.h"
+
+using namespace moonlight;
+using namespace moonlight::test;
+
+const size_t LINES = 1000;
+
+/**
+ * `shlex::split()` as it was, reading through `ShellStringLexer`.
+ */
+std::vector<std::string> legacy_split(const std::string& str) {
+    auto lex = shlex::ShellStringLexer(str);
+    std::vector<std::string> argv;
+    for (auto iter = lex.begin(); iter != lex.end(); iter++) {
+        argv.push_back(*iter);
+    }
+    return argv;
+}
+
+/**
+ * `shlex::quote()` and `shlex::join()` as they were, using regexes.
+ */
+std::string legacy_quote(const std::string& str) {
+    static const auto rx_unsafe = rx::def("[^\\w@%\\-+=:,./]");
+    static const auto rx_quotes = rx::def("(\'+)");
+
+    if (str.size() == 0) {
+        return "''";
+    }
+    if (rx::match(rx_unsafe, str)) {
+        std::ostringstream sb;
+        sb << '\'' << rx::replace(rx_quotes, str, "\'\"$1\"\'") << '\'';
+        return sb.str();
+    }
+    return str;
+}
+
+std::string legacy_join(const std::vector<std::string>& cmd) {
+    return str::join(collect::map<std::string>(cmd, legacy_quote), " ");
+}
+
+int main() {
+    std::vector<std::string> lines;
+    for (size_t x = 0; x < LINES; x++) {
+        lines.push_back(
+            "/usr/bin/worker --job " + std::to_string(x) +
+            " --input '/data/in/batch " + std::to_string(x % 17) + ".csv'" +
+            " --label \"run\\t" + std::to_string(x) + "\" --verbose");
+    }
+    auto argvs = collect::map<std::vector<std::string>>(lines, legacy_split);
+
+    size_t bytes = 0;
+    for (const auto& line : lines) {
+        bytes += line.size();
+    }
+
+    return BenchmarkSuite("moonlight shlex benchmarks")
+    .bench(Benchmark("split, ShellStringLexer", [&]() {
+        for (const auto& line : lines) {
+            do_not_optimize(legacy_split(line));
+        }
+    }).items(LINES).bytes(bytes))
+    .bench(Benchmark("split", [&]() {
+        for (const auto& line : lines) {
+            do_not_optimize(shlex::split(line));
+        }
+    }).items(LINES).bytes(bytes))
+    .bench(Benchmark("Tokenizer", [&]() {
+        shlex::Tokenizer tokens;
+        for (const auto& line : lines) {
+            tokens.reset(line);
+            while (auto token = tokens.next()) {
+                do_not_optimize(token->value);
+            }
+        }
+    }).items(LINES).bytes(bytes))
+    .bench(Benchmark("split_all", [&]() {
+        do_not_optimize(shlex::split_all(lines));
+    }).items(LINES).bytes(bytes))
+    .bench(Benchmark("join, regex quote", [&]() {
+        for (const auto& argv : argvs) {
+            do_not_optimize(legacy_join(argv));
+        }
+    }).items(LINES))
+    .bench(Benchmark("join", [&]() {
+        for (const auto& argv : argvs) {
+            do_not_optimize(shlex::join(argv));
+        }
+    }).items(LINES))
+    .run();
+}
@@ -0,0 +1,79 @@
+/*
+ * slice.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "moonlight/slice.h"
+#include "moonlight/alloc_hooks.h"
+#include "moonlight/bench.h"
+
+using namespace moonlight;
+using namespace moonlight::test;
+
+const size_t SIZE = 1000000;
+const int WINDOWS = 1000;
+const int WINDOW = 1000;
+
+template<class V>
+int64_t sum(const V& view) {
+    int64_t total = 0;
+    for (auto x : view) {
+        total += x;
+    }
+    return total;
+}
+
+int main() {
+    BenchmarkSuite suite("moonlight slice benchmarks");
+
+    std::vector<int> numbers(SIZE);
+    std::iota(numbers.begin(), numbers.end(), 0);
+    std::string text(SIZE, 'x');
+
+    suite.bench(Benchmark("sum 1000 windows, slice (copying)", [&]() {
+        int64_t total = 0;
+        for (int x = 0; x < WINDOWS; x++) {
+            total += sum(slice(numbers, x * WINDOW, x * WINDOW + WINDOW));
+        }
+        do_not_optimize(total);
+    }).items(SIZE));
+    suite.bench(Benchmark("sum 1000 windows, slice_view", [&]() {
+        int64_t total = 0;
+        for (int x = 0; x < WINDOWS; x++) {
+            total += sum(slice_view(numbers, x * WINDOW, x * WINDOW + WINDOW));
+        }
+        do_not_optimize(total);
+    }).items(SIZE));
+
+    suite.bench(Benchmark("every 8th element, slice (copying)", [&]() {
+        do_not_optimize(sum(slice(numbers, {}, {}, 8)));
+    }).items(SIZE / 8));
+    suite.bench(Benchmark("every 8th element, slice_view", [&]() {
+        do_not_optimize(sum(slice_view(numbers, {}, {}, 8)));
+    }).items(SIZE / 8));
+
+    suite.bench(Benchmark("1000 substrings, slice (copying)", [&]() {
+        size_t total = 0;
+        for (int x = 0; x < WINDOWS; x++) {
+            total += slice(text, x * WINDOW, x * WINDOW + WINDOW).size();
+        }
+        do_not_optimize(total);
+    }).bytes(SIZE));
+    suite.bench(Benchmark("1000 substrings, slice_view", [&]() {
+        size_t total = 0;
+        for (int x = 0; x < WINDOWS; x++) {
+            total += slice_view(text, x * WINDOW, x * WINDOW + WINDOW).size();
+        }
+        do_not_optimize(total);
+    }).bytes(SIZE));
+
+    return suite.run();
+}
@@ -0,0 +1,50 @@
+/*
+ * stream.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <numeric>
+
+#include "moonlight/generator.h"
+#include "moonlight/alloc_hooks.h"
+#include "moonlight/bench.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+const int N = 10000;
+
+int main() {
+    std::vector<int> values(N);
+    std::iota(values.begin(), values.end(), 0);
+
+    return BenchmarkSuite("moonlight stream benchmarks")
+    .bench(Benchmark("iterate", [&]() {
+        int sum = 0;
+        for (int x : gen::stream(values)) {
+            sum += x;
+        }
+        do_not_optimize(sum);
+    }).items(N))
+    .bench(Benchmark("filter + transform + collect", [&]() {
+        auto result = gen::stream(values)
+        .filter([](const int& x) { return x % 3 == 0; })
+        .transform<long>([](const int& x) { return (long)x * x; })
+        .collect();
+        do_not_optimize(result);
+    }).items(N))
+    .bench(Benchmark("reduce", [&]() {
+        do_not_optimize(gen::stream(values).reduce<long>([](const long& acc, const int& x) {
+            return acc + x;
+        }));
+    }).items(N))
+    .bench(Benchmark("sorted", [&]() {
+        do_not_optimize(gen::stream(values).sorted().collect());
+    }).items(N))
+    .run();
+}
@@ -0,0 +1,47 @@
+/*
+ * uuid.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <string>
+
+#include "moonlight/uuid.h"
+#include "moonlight/alloc_hooks.h"
+#include "moonlight/bench.h"
+
+using namespace moonlight;
+using namespace moonlight::test;
+
+int main() {
+    uuid::Generator v4;
+    uuid::V7Generator v7;
+    auto id = v7();
+    std::string text = uuids::to_string(id);
+    char buffer[36];
+
+    return BenchmarkSuite("moonlight uuid benchmarks")
+    .bench(Benchmark("Generator (v4)", [&]() {
+        do_not_optimize(v4());
+    }).items(1))
+    .bench(Benchmark("V7Generator", [&]() {
+        do_not_optimize(v7());
+    }).items(1))
+    .bench(Benchmark("uuids::to_string", [&]() {
+        do_not_optimize(uuids::to_string(id));
+    }).items(1))
+    .bench(Benchmark("uuid::format", [&]() {
+        uuid::format(id, buffer);
+        do_not_optimize(buffer);
+    }).items(1))
+    .bench(Benchmark("uuids::uuid::from_string", [&]() {
+        do_not_optimize(uuids::uuid::from_string(text));
+    }).items(1))
+    .bench(Benchmark("uuid::try_parse", [&]() {
+        do_not_optimize(uuid::try_parse(text));
+    }).items(1))
+    .run();
+}
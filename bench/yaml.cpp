@@ -0,0 +1,81 @@
+/*
+ * yaml.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#define RYML_SINGLE_HDR_DEFINE_NOW
+
+#include <sstream>
+#include <string>
+
+#include "moonlight/yaml.h"
+#include "moonlight/alloc_hooks.h"
+#include "moonlight/bench.h"
+
+using namespace moonlight;
+using namespace moonlight::test;
+
+const size_t JOBS = 1000;
+
+/**
+ * The same job list as a YAML stream of one document per job, and as the
+ * JSON array an external converter would produce from it.
+ */
+std::string job_yaml(size_t x) {
+    return "name: job-" + std::to_string(x) + "\n"
+        "command: /usr/bin/worker --shard " + std::to_string(x) + "\n"
+        "retries: " + std::to_string(x % 5) + "\n"
+        "enabled: true\n"
+        "tags: [nightly, shard-" + std::to_string(x % 16) + "]\n"
+        "env:\n"
+        "  QUEUE: batch\n"
+        "  TIMEOUT: 3600\n";
+}
+
+std::string job_json(size_t x) {
+    return "{\"name\": \"job-" + std::to_string(x) + "\", "
+        "\"command\": \"/usr/bin/worker --shard " + std::to_string(x) + "\", "
+        "\"retries\": " + std::to_string(x % 5) + ", "
+        "\"enabled\": true, "
+        "\"tags\": [\"nightly\", \"shard-" + std::to_string(x % 16) + "\"], "
+        "\"env\": {\"QUEUE\": \"batch\", \"TIMEOUT\": 3600}}";
+}
+
+int main() {
+    std::string yaml_list, yaml_stream, json_list = "[";
+    for (size_t x = 0; x < JOBS; x++) {
+        std::string doc = job_yaml(x);
+        yaml_stream += "---\n" + doc;
+
+        std::string item;
+        for (char c : doc) {
+            item.push_back(c);
+            if (c == '\n') {
+                item += "  ";
+            }
+        }
+        yaml_list += "- " + item.substr(0, item.size() - 2);
+
+        json_list += (x > 0 ? ", " : "") + job_json(x);
+    }
+    json_list += "]";
+
+    return BenchmarkSuite("moonlight yaml benchmarks")
+    .bench(Benchmark("json::read", [&]() {
+        do_not_optimize(json::read<json::Value::Pointer>(json_list));
+    }).items(JOBS).bytes(json_list.size()))
+    .bench(Benchmark("yaml::read", [&]() {
+        do_not_optimize(yaml::read<json::Value::Pointer>(yaml_list));
+    }).items(JOBS).bytes(yaml_list.size()))
+    .bench(Benchmark("yaml::documents", [&]() {
+        std::istringstream infile(yaml_stream);
+        for (auto doc : yaml::documents(infile)) {
+            do_not_optimize(doc);
+        }
+    }).items(JOBS).bytes(yaml_stream.size()))
+    .run();
+}
@@ -48,7 +48,7 @@ ENV.update(
         "-DMOONLIGHT_STACKTRACE_IN_DESCRIPTION",
         "--std=c++2a",
     ],
-    LDFLAGS=[PERFORMANCE, "-lpthread", "-lutil", "-lsqlite3"],
+    LDFLAGS=[PERFORMANCE, "-lpthread", "-lutil", "-lsqlite3", "-lpanelw", "-lncursesw"],
     PREFIX=os.environ.get("PREFIX", "/usr/local"),
     DESTDIR=os.environ.get("DESTDIR", ""),
 )
@@ -63,6 +63,39 @@ def fetch_rapidyaml():
     )
 
 
+# --------------------------------------------------------------------
+UCD_URL = "https://www.unicode.org/Public/15.0.0/ucd"
+UCD_FILES = [
+    "EastAsianWidth.txt",
+    "extracted/DerivedGeneralCategory.txt",
+    "auxiliary/GraphemeBreakProperty.txt",
+    "emoji/emoji-data.txt",
+]
+
+
+# --------------------------------------------------------------------
+@task(keep=True)
+def ucd():
+    """Fetch the Unicode Character Database files used by `unicode_data`."""
+    return [
+        sh(
+            "mkdir -p $(dirname {target}) && curl -o {target} %s/%s" % (UCD_URL, name),
+            target="deps/ucd/%s" % name.replace("extracted/", ""),
+        )
+        for name in UCD_FILES
+    ]
+
+
+# --------------------------------------------------------------------
+@task(dep="ucd")
+def unicode_data(ucd):
+    """Regenerate the display width and grapheme tables in `unicode_data.h`."""
+    return sh(
+        "python3 utils/gen_unicode_data.py deps/ucd > {target}",
+        target="include/moonlight/unicode_data.h",
+    )
+
+
 # --------------------------------------------------------------------
 @task(keep=True)
 def deps():
@@ -82,6 +115,12 @@ def lab_sources():
     return Path.cwd().glob("lab/*.cpp")
 
 
+# -------------------------------------------------------------------
+@provide
+def bench_sources():
+    return Path.cwd().glob("bench/*.cpp")
+
+
 # -------------------------------------------------------------------
 @provide
 def util_sources():
@@ -118,6 +157,28 @@ def tests(test_sources, headers, deps, large_json_file):
     return [*random.sample(tests, len(tests))]
 
 
+# -------------------------------------------------------------------
+@task(dep="deps")
+def bench(bench_sources, headers, deps):
+    """Compile and run the benchmarks, comparing against `bench/baseline`."""
+    return [
+        sh(
+            "mkdir -p bench/results && MOONLIGHT_BENCH_OUTPUT={target} "
+            "MOONLIGHT_BENCH_BASELINE=bench/baseline/%s.json {input}" % src.stem,
+            input=compile(src, headers=headers),
+            target="bench/results/%s.json" % src.stem,
+        )
+        for src in bench_sources
+    ]
+
+
+# -------------------------------------------------------------------
+@task
+def bench_baseline(bench):
+    """Save the latest benchmark results as the baseline."""
+    return sh("mkdir -p bench/baseline && cp bench/results/*.json bench/baseline/")
+
+
 # -------------------------------------------------------------------
 @task
 def utils(util_sources, headers):
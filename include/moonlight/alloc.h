@@ -0,0 +1,550 @@
+/*
+ * ## alloc.h: Arenas, object pools and memory resources. -----------
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * ## Usage ---------------------------------------------------------
+ * This header offers allocators for code which allocates many small objects
+ * and frees them all at once, or frees and reallocates objects of the same
+ * size over and over.  Each is a `std::pmr::memory_resource`, so it can back
+ * any `std::pmr` container.
+ *
+ * - `alloc::Arena`: A monotonic arena.  Allocation bumps a pointer through
+ *   chunks of memory taken from an upstream resource, and freeing is a no-op.
+ *   Memory is reclaimed all at once by `reset()`, which keeps one chunk as
+ *   large as all of those used for reuse, or when the arena is destroyed.  `make<T>(...)`
+ *   constructs an object in the arena, and runs its destructor when the
+ *   arena is reset or destroyed.  An arena may start with a caller's buffer,
+ *   e.g. one on the stack.  Arenas are not thread safe.
+ *
+ * ```
+ * alloc::Arena arena;
+ * std::pmr::vector<int> numbers(&arena);
+ * ```
+ *
+ * - `alloc::FixedPool<Size, Align>`: A process-wide pool of fixed size
+ *   blocks.  Each thread keeps its own free list, refilled from and spilled
+ *   to a shared free list in batches of `MOONLIGHT_ALLOC_POOL_BATCH`, so most
+ *   allocations and frees take no lock.  Blocks may be freed on any thread.
+ *   Pool memory is never returned to the system.
+ * - `alloc::ObjectPool<T>`: Creates and destroys `T` objects in the
+ *   `FixedPool` for their size.
+ * - `alloc::PoolResource`, `alloc::pool_resource()`: A memory resource which
+ *   serves allocations of up to `MOONLIGHT_ALLOC_POOL_MAX_SIZE` bytes from
+ *   `FixedPool`s in 16 byte size classes, and larger ones from its upstream
+ *   resource.
+ * - `alloc::PoolAllocator<T>`: A standard allocator over the pools, e.g. for
+ *   `std::allocate_shared()`.
+ *
+ * ## Scoped allocation ---------------------------------------------
+ * `alloc::Scope` sets the memory resource used by `alloc::make_shared()` on
+ * the calling thread until it is destroyed.  Outside of any scope,
+ * `alloc::make_shared()` is `std::make_shared()`.  The JSON value types,
+ * `automata` states and the SQLite client's rows and columns are created
+ * with `alloc::make_shared()`, so a whole parse or query can be scoped to
+ * an arena:
+ *
+ * ```
+ * alloc::Arena arena;
+ * {
+ *     alloc::Scope scope(arena);
+ *     auto value = json::read<json::Value::Pointer>(input);
+ *     ...
+ * }
+ * ```
+ *
+ * `json::parser::Parser` and `lex::Lexer::try_lex()` also accept a memory
+ * resource directly.  Objects created in an arena must be released before the
+ * arena is reset or destroyed.  `clone()` a JSON value outside of the scope to
+ * copy it out of the arena.
+ */
+
+#ifndef __MOONLIGHT_ALLOC_H
+#define __MOONLIGHT_ALLOC_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "moonlight/constants.h"
+
+namespace moonlight {
+namespace alloc {
+
+namespace _alloc {
+
+inline thread_local std::pmr::memory_resource* current = nullptr;
+
+const size_t MAX_ALIGN = alignof(std::max_align_t);
+const size_t POOL_GRAIN = 16;
+const size_t POOL_CLASSES = MOONLIGHT_ALLOC_POOL_MAX_SIZE / POOL_GRAIN;
+
+static_assert(MOONLIGHT_ALLOC_POOL_MAX_SIZE % POOL_GRAIN == 0,
+              "MOONLIGHT_ALLOC_POOL_MAX_SIZE must be a multiple of 16.");
+
+constexpr size_t align_up(size_t n, size_t align) {
+    return (n + align - 1) & ~(align - 1);
+}
+
+}  // namespace _alloc
+
+/**------------------------------------------------------------------
+ * A monotonic arena.
+ */
+class Arena : public std::pmr::memory_resource {
+ public:
+     explicit Arena(size_t chunk_size = MOONLIGHT_ALLOC_ARENA_CHUNK,
+                    std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+     : _upstream(upstream), _chunk_size(std::max(chunk_size, sizeof(Chunk) * 2)) { }
+
+     /**
+      * Start with a caller's buffer, which must outlive the arena.
+      */
+     Arena(void* buffer, size_t size,
+           std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+     : Arena(MOONLIGHT_ALLOC_ARENA_CHUNK, upstream) {
+         _buffer = static_cast<char*>(buffer);
+         _buffer_size = size;
+         _ptr = _buffer;
+         _end = _buffer + size;
+     }
+
+     Arena(const Arena&) = delete;
+     Arena& operator=(const Arena&) = delete;
+
+     ~Arena() {
+         _finalize();
+         _free_chunks();
+     }
+
+     void* allocate(size_t bytes, size_t align = _alloc::MAX_ALIGN) {
+         uintptr_t p = (reinterpret_cast<uintptr_t>(_ptr) + align - 1) & ~(uintptr_t)(align - 1);
+         // `>=` rather than `>` so that a zero byte allocation never
+         // returns the null pointer of an empty arena.
+         if (p + bytes >= reinterpret_cast<uintptr_t>(_end)) {
+             return _allocate_slow(bytes, align);
+         }
+         _ptr = reinterpret_cast<char*>(p + bytes);
+         _allocated += bytes;
+         return reinterpret_cast<void*>(p);
+     }
+
+     /**
+      * Construct a `T` in the arena.  Its destructor is run when the arena
+      * is reset or destroyed.
+      */
+     template<class T, class... TD>
+     T* make(TD&&... params) {
+         if constexpr (std::is_trivially_destructible_v<T>) {
+             return new (allocate(sizeof(T), alignof(T))) T(std::forward<TD>(params)...);
+
+         } else {
+             Finalizer* finalizer = static_cast<Finalizer*>(
+                 allocate(sizeof(Finalizer), alignof(Finalizer)));
+             T* obj = new (allocate(sizeof(T), alignof(T))) T(std::forward<TD>(params)...);
+             finalizer->object = obj;
+             finalizer->destroy = [](void* p) {
+                 static_cast<T*>(p)->~T();
+             };
+             finalizer->next = _finalizers;
+             _finalizers = finalizer;
+             return obj;
+         }
+     }
+
+     /**
+      * Destroy objects created with `make()` and reclaim all memory.  If
+      * more than one chunk was used, they are replaced with one chunk
+      * large enough for all of them, so that a workload repeated after each
+      * reset settles into a single chunk.
+      */
+     void reset() {
+         _finalize();
+         if (_chunks != nullptr && _chunks->prev != nullptr) {
+             size_t size = capacity();
+             _free_chunks();
+             _add_chunk(size);
+         }
+         if (_chunks != nullptr) {
+             _ptr = reinterpret_cast<char*>(_chunks + 1);
+             _end = reinterpret_cast<char*>(_chunks) + _chunks->size;
+         } else {
+             _ptr = _buffer;
+             _end = _buffer + _buffer_size;
+         }
+         _allocated = 0;
+     }
+
+     /**
+      * Bytes handed out since construction or the last `reset()`.
+      */
+     size_t allocated() const {
+         return _allocated;
+     }
+
+     /**
+      * Bytes of memory held by the arena, not counting the caller's buffer.
+      */
+     size_t capacity() const {
+         size_t total = 0;
+         for (Chunk* chunk = _chunks; chunk != nullptr; chunk = chunk->prev) {
+             total += chunk->size;
+         }
+         return total;
+     }
+
+ protected:
+     void* do_allocate(size_t bytes, size_t align) override {
+         return allocate(bytes, align);
+     }
+
+     void do_deallocate(void*, size_t, size_t) override { }
+
+     bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+         return this == &other;
+     }
+
+ private:
+     struct alignas(_alloc::MAX_ALIGN) Chunk {
+         Chunk* prev;
+         size_t size;
+     };
+
+     struct Finalizer {
+         void* object;
+         void (*destroy)(void*);
+         Finalizer* next;
+     };
+
+     void* _allocate_slow(size_t bytes, size_t align) {
+         _add_chunk(std::max(_chunk_size, _alloc::align_up(sizeof(Chunk) + bytes + align, _alloc::MAX_ALIGN)));
+         _chunk_size = std::min(_chunk_size * 2, std::max<size_t>(_chunk_size, MOONLIGHT_ALLOC_ARENA_MAX_CHUNK));
+         return allocate(bytes, align);
+     }
+
+     void _add_chunk(size_t size) {
+         Chunk* chunk = static_cast<Chunk*>(_upstream->allocate(size, alignof(Chunk)));
+         chunk->prev = _chunks;
+         chunk->size = size;
+         _chunks = chunk;
+         _ptr = reinterpret_cast<char*>(chunk + 1);
+         _end = reinterpret_cast<char*>(chunk) + size;
+     }
+
+     void _finalize() {
+         while (_finalizers != nullptr) {
+             Finalizer* finalizer = _finalizers;
+             _finalizers = finalizer->next;
+             finalizer->destroy(finalizer->object);
+         }
+     }
+
+     void _free_chunks() {
+         while (_chunks != nullptr) {
+             Chunk* prev = _chunks->prev;
+             _upstream->deallocate(_chunks, _chunks->size, alignof(Chunk));
+             _chunks = prev;
+         }
+     }
+
+     std::pmr::memory_resource* _upstream;
+     size_t _chunk_size;
+     Chunk* _chunks = nullptr;
+     Finalizer* _finalizers = nullptr;
+     char* _buffer = nullptr;
+     size_t _buffer_size = 0;
+     char* _ptr = nullptr;
+     char* _end = nullptr;
+     size_t _allocated = 0;
+};
+
+/**------------------------------------------------------------------
+ * A process-wide pool of fixed size blocks with per-thread free lists.
+ */
+template<size_t Size, size_t Align = _alloc::MAX_ALIGN>
+class FixedPool {
+ public:
+     static constexpr size_t BLOCK_SIZE = _alloc::align_up(std::max(Size, sizeof(void*)), Align);
+     static constexpr size_t BATCH = MOONLIGHT_ALLOC_POOL_BATCH;
+
+     static void* allocate() {
+         Cache& cache = _cache();
+         if (cache.head == nullptr) {
+             _shared().take(cache);
+         }
+         Node* node = cache.head;
+         cache.head = node->next;
+         cache.count--;
+         return node;
+     }
+
+     static void deallocate(void* ptr) {
+         Cache& cache = _cache();
+         Node* node = static_cast<Node*>(ptr);
+         node->next = cache.head;
+         cache.head = node;
+         if (++cache.count >= BATCH * 2) {
+             _shared().give(cache, BATCH);
+         }
+     }
+
+ private:
+     struct Node {
+         Node* next;
+     };
+
+     struct Cache;
+
+     struct Shared {
+         std::mutex mutex;
+         Node* head = nullptr;
+         size_t count = 0;
+
+         void take(Cache& cache) {
+             std::lock_guard lock(mutex);
+             if (head == nullptr) {
+                 _carve();
+             }
+             for (size_t x = 0; x < BATCH && head != nullptr; x++) {
+                 Node* node = head;
+                 head = node->next;
+                 count--;
+                 node->next = cache.head;
+                 cache.head = node;
+                 cache.count++;
+             }
+         }
+
+         void give(Cache& cache, size_t n) {
+             std::lock_guard lock(mutex);
+             for (size_t x = 0; x < n && cache.head != nullptr; x++) {
+                 Node* node = cache.head;
+                 cache.head = node->next;
+                 cache.count--;
+                 node->next = head;
+                 head = node;
+                 count++;
+             }
+         }
+
+         void _carve() {
+             size_t size = std::max<size_t>(MOONLIGHT_ALLOC_POOL_CHUNK, BLOCK_SIZE * BATCH);
+             char* chunk = static_cast<char*>(::operator new(size, std::align_val_t(Align)));
+             for (size_t offset = 0; offset + BLOCK_SIZE <= size; offset += BLOCK_SIZE) {
+                 Node* node = reinterpret_cast<Node*>(chunk + offset);
+                 node->next = head;
+                 head = node;
+                 count++;
+             }
+         }
+     };
+
+     struct Cache {
+         Node* head = nullptr;
+         size_t count = 0;
+
+         ~Cache() {
+             _shared().give(*this, count);
+         }
+     };
+
+     static Cache& _cache() {
+         thread_local Cache cache;
+         return cache;
+     }
+
+     // Never destroyed, so blocks may be freed by static and thread-local
+     // destructors.
+     static Shared& _shared() {
+         static Shared* shared = new Shared();
+         return *shared;
+     }
+};
+
+/**------------------------------------------------------------------
+ * Creates and destroys `T` objects in the pool for their size.
+ */
+template<class T>
+class ObjectPool {
+ public:
+     typedef FixedPool<sizeof(T), std::max(alignof(T), alignof(void*))> Pool;
+
+     template<class... TD>
+     static T* create(TD&&... params) {
+         void* ptr = Pool::allocate();
+         try {
+             return new (ptr) T(std::forward<TD>(params)...);
+         } catch (...) {
+             Pool::deallocate(ptr);
+             throw;
+         }
+     }
+
+     static void destroy(T* obj) {
+         if (obj != nullptr) {
+             obj->~T();
+             Pool::deallocate(obj);
+         }
+     }
+};
+
+namespace _alloc {
+
+typedef void* (*PoolAllocate)();
+typedef void (*PoolDeallocate)(void*);
+
+template<size_t... I>
+constexpr std::array<PoolAllocate, sizeof...(I)> pool_allocators(std::index_sequence<I...>) {
+    return {&FixedPool<(I + 1) * POOL_GRAIN, POOL_GRAIN>::allocate...};
+}
+
+template<size_t... I>
+constexpr std::array<PoolDeallocate, sizeof...(I)> pool_deallocators(std::index_sequence<I...>) {
+    return {&FixedPool<(I + 1) * POOL_GRAIN, POOL_GRAIN>::deallocate...};
+}
+
+inline constexpr auto POOL_ALLOCATE = pool_allocators(std::make_index_sequence<POOL_CLASSES>());
+inline constexpr auto POOL_DEALLOCATE = pool_deallocators(std::make_index_sequence<POOL_CLASSES>());
+
+inline bool is_pooled(size_t bytes, size_t align) {
+    return bytes <= MOONLIGHT_ALLOC_POOL_MAX_SIZE && align <= POOL_GRAIN;
+}
+
+inline size_t pool_class(size_t bytes) {
+    return bytes == 0 ? 0 : (bytes - 1) / POOL_GRAIN;
+}
+
+}  // namespace _alloc
+
+/**------------------------------------------------------------------
+ * A memory resource serving small allocations from `FixedPool`s.
+ */
+class PoolResource : public std::pmr::memory_resource {
+ public:
+     explicit PoolResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+     : _upstream(upstream) { }
+
+ protected:
+     void* do_allocate(size_t bytes, size_t align) override {
+         if (_alloc::is_pooled(bytes, align)) {
+             return _alloc::POOL_ALLOCATE[_alloc::pool_class(bytes)]();
+         }
+         return _upstream->allocate(bytes, align);
+     }
+
+     void do_deallocate(void* ptr, size_t bytes, size_t align) override {
+         if (_alloc::is_pooled(bytes, align)) {
+             _alloc::POOL_DEALLOCATE[_alloc::pool_class(bytes)](ptr);
+         } else {
+             _upstream->deallocate(ptr, bytes, align);
+         }
+     }
+
+     bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+         auto pool = dynamic_cast<const PoolResource*>(&other);
+         return pool != nullptr && pool->_upstream->is_equal(*_upstream);
+     }
+
+ private:
+     std::pmr::memory_resource* _upstream;
+};
+
+inline PoolResource* pool_resource() {
+    static PoolResource* resource = new PoolResource();
+    return resource;
+}
+
+/**------------------------------------------------------------------
+ * A standard allocator over the pools.
+ */
+template<class T>
+class PoolAllocator {
+ public:
+     typedef T value_type;
+
+     PoolAllocator() noexcept { }
+
+     template<class U>
+     PoolAllocator(const PoolAllocator<U>&) noexcept { }
+
+     T* allocate(size_t n) {
+         if (n == 1 && _alloc::is_pooled(sizeof(T), alignof(T))) {
+             return static_cast<T*>(_alloc::POOL_ALLOCATE[_alloc::pool_class(sizeof(T))]());
+         }
+         return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+     }
+
+     void deallocate(T* ptr, size_t n) noexcept {
+         if (n == 1 && _alloc::is_pooled(sizeof(T), alignof(T))) {
+             _alloc::POOL_DEALLOCATE[_alloc::pool_class(sizeof(T))](ptr);
+         } else {
+             ::operator delete(ptr, std::align_val_t(alignof(T)));
+         }
+     }
+
+     template<class U>
+     bool operator==(const PoolAllocator<U>&) const noexcept {
+         return true;
+     }
+};
+
+/**------------------------------------------------------------------
+ * Sets the calling thread's memory resource for `make_shared()`.
+ */
+class Scope {
+ public:
+     explicit Scope(std::pmr::memory_resource& resource)
+     : Scope(&resource) { }
+
+     /**
+      * A null resource restores the default, `std::make_shared()`.
+      */
+     explicit Scope(std::pmr::memory_resource* resource)
+     : _prev(_alloc::current) {
+         _alloc::current = resource;
+     }
+
+     Scope(const Scope&) = delete;
+     Scope& operator=(const Scope&) = delete;
+
+     ~Scope() {
+         _alloc::current = _prev;
+     }
+
+ private:
+     std::pmr::memory_resource* _prev;
+};
+
+/**
+ * The calling thread's memory resource, or `nullptr` outside of any scope.
+ */
+inline std::pmr::memory_resource* current_resource() {
+    return _alloc::current;
+}
+
+template<class T, class... TD>
+std::shared_ptr<T> make_shared(TD&&... params) {
+    std::pmr::memory_resource* resource = _alloc::current;
+    if (resource == nullptr) {
+        return std::make_shared<T>(std::forward<TD>(params)...);
+    }
+    return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource),
+                                   std::forward<TD>(params)...);
+}
+
+}  // namespace alloc
+}  // namespace moonlight
+
+
+#endif /* !__MOONLIGHT_ALLOC_H */
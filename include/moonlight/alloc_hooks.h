@@ -0,0 +1,136 @@
+/*
+ * ## alloc_hooks.h: Allocation counting for tests and benchmarks. --
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * ## Usage ---------------------------------------------------------
+ * Including this header replaces the global `operator new` and `operator
+ * delete` with versions which count allocations, frees and bytes allocated
+ * per thread, for use with `test::AllocationSnapshot`,
+ * `ASSERT_MAX_ALLOCATIONS()` and the allocation columns of
+ * `test::BenchmarkSuite` reports.  See `test.h`.
+ *
+ * ```
+ * #include "moonlight/alloc_hooks.h"
+ * #include "moonlight/test.h"
+ *
+ * .test("lookups don't allocate", [&]() {
+ *     ASSERT_MAX_ALLOCATIONS(0, map.find(key));
+ * })
+ * ```
+ *
+ * This header is meant for test and benchmark programs only.  It defines
+ * the replacement operators, which may only be defined once per program, so
+ * it must be included in exactly one translation unit.  Allocations made
+ * directly with `malloc()` are not counted.
+ */
+
+#ifndef __MOONLIGHT_ALLOC_HOOKS_H
+#define __MOONLIGHT_ALLOC_HOOKS_H
+
+#include <cstdlib>
+#include <new>
+
+#include "moonlight/test.h"
+
+namespace moonlight {
+namespace test {
+namespace _alloc {
+
+inline void* allocate(std::size_t size, std::size_t align = 0) noexcept {
+    thread_counters.allocs++;
+    thread_counters.bytes += size;
+    size = size ? size : 1;
+    if (align > alignof(std::max_align_t)) {
+        return std::aligned_alloc(align, (size + align - 1) / align * align);
+    }
+    return std::malloc(size);
+}
+
+inline void deallocate(void* ptr) noexcept {
+    if (ptr != nullptr) {
+        thread_counters.frees++;
+        std::free(ptr);
+    }
+}
+
+inline void* allocate_or_throw(std::size_t size, std::size_t align = 0) {
+    for (;;) {
+        void* ptr = allocate(size, align);
+        if (ptr != nullptr) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+static const bool _installed = (installed = true);
+
+}  // namespace _alloc
+}  // namespace test
+}  // namespace moonlight
+
+void* operator new(std::size_t size) {
+    return moonlight::test::_alloc::allocate_or_throw(size);
+}
+
+void* operator new[](std::size_t size) {
+    return moonlight::test::_alloc::allocate_or_throw(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return moonlight::test::_alloc::allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return moonlight::test::_alloc::allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    return moonlight::test::_alloc::allocate_or_throw(size, (std::size_t)align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return moonlight::test::_alloc::allocate_or_throw(size, (std::size_t)align);
+}
+
+void operator delete(void* ptr) noexcept {
+    moonlight::test::_alloc::deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    moonlight::test::_alloc::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    moonlight::test::_alloc::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    moonlight::test::_alloc::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    moonlight::test::_alloc::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    moonlight::test::_alloc::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    moonlight::test::_alloc::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    moonlight::test::_alloc::deallocate(ptr);
+}
+
+#endif /* !__MOONLIGHT_ALLOC_HOOKS_H */
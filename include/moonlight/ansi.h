@@ -54,6 +54,12 @@
  *  std::cout << bright_red("Hello, I'm Red!") << std::endl;
  *  ```
  *
+ *  `ansi::WrappedText::wrap(cols)` breaks the text into lines of at most
+ *  `cols` terminal columns, each wrapped in the same escape sequences.  It is
+ *  only available when `layout.h` is also included, so that `ansi.h` itself
+ *  doesn't depend on utfcpp.  Use `unicode::display_width(wt.text())` from
+ *  `unicode.h` to measure the text.
+ *
  *  You can also use `fg::rgb` and `bg::rgb` to emit 24bit color on terminals
  *  which support this feature.  This function template can be called with three
  *  integers, one for R, G, and B bytes respectively, or with a
@@ -92,6 +98,9 @@
  * std::cout << seq::clear << seq::move_cursor(0, 0);
  * ```
  *
+ * For full-screen interfaces redrawn many times a second, see `ansi::Screen`
+ * in `screen.h`, which only emits the changes between frames.
+ *
  * ## Options -------------------------------------------------------
  * By default, `ansi.h` respects the following environment variables and
  * conditions for determining when to emit color or control (i.e. text effects,
@@ -126,6 +135,11 @@
 #include "moonlight/color.h"
 
 namespace moonlight {
+
+namespace layout {
+class TextLayout;
+}
+
 namespace ansi {
 
 // ------------------------------------------------------------------
@@ -296,6 +310,21 @@ class WrappedText {
          return _end;
      }
 
+     /**
+      * Wrap the text to the given number of columns, with each line wrapped
+      * in the same escape sequences.  Requires `layout.h`.
+      */
+     template<class Layout = layout::TextLayout>
+     std::vector<WrappedText> wrap(int cols) const {
+         Layout text(cols);
+         text.append(_text);
+         std::vector<WrappedText> lines;
+         for (auto line : text.lines(0, text.line_count())) {
+             lines.emplace_back(_start, std::string(line), _end);
+         }
+         return lines;
+     }
+
  private:
      const Sequence _start;
      const std::string _text;
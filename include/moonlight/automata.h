@@ -129,6 +129,7 @@
 #include <memory>
 #include <vector>
 
+#include "moonlight/alloc.h"
 #include "moonlight/exceptions.h"
 
 namespace moonlight {
@@ -163,7 +164,7 @@ class StateMachine {
      template<class T, class... TD>
      static StateMachine<S> init(typename S::Context& context, TD... params) {
          StateMachine<S> machine(context);
-         auto state = std::make_shared<T>(std::forward<TD>(params)...);
+         auto state = alloc::make_shared<T>(std::forward<TD>(params)...);
          machine.push(state);
          return machine;
      }
@@ -424,19 +425,19 @@ class State : public std::enable_shared_from_this<State<C>> {
 
      template<class T, class... TD>
      void push(TD... params) {
-         auto state = std::make_shared<T>(std::forward<TD>(params)...);
+         auto state = alloc::make_shared<T>(std::forward<TD>(params)...);
          machine().push(state);
      }
 
      template<class T, class... TD>
      void transition(TD... params) {
-         auto state = std::make_shared<T>(std::forward<TD>(params)...);
+         auto state = alloc::make_shared<T>(std::forward<TD>(params)...);
          machine().transition(state);
      }
 
      template<class T, class... TD>
      void reset(TD... params) {
-         auto state = std::make_shared<T>(std::forward<TD>(params)...);
+         auto state = alloc::make_shared<T>(std::forward<TD>(params)...);
          machine().reset(state);
      }
 
@@ -485,19 +486,19 @@ class Lambda : public State<C> {
 
           template<class T, class... TD>
           void push_state(TD... params) {
-              auto state = std::make_shared<T>(std::forward<TD>(params)...);
+              auto state = alloc::make_shared<T>(std::forward<TD>(params)...);
               push(state);
           }
 
           template<class T, class... TD>
           void transition_state(TD... params) {
-              auto state = std::make_shared<T>(std::forward<TD>(params)...);
+              auto state = alloc::make_shared<T>(std::forward<TD>(params)...);
               transition(state);
           }
 
           template<class T, class... TD>
           void reset_state(TD... params) {
-              auto state = std::make_shared<T>(std::forward<TD>(params)...);
+              auto state = alloc::make_shared<T>(std::forward<TD>(params)...);
               reset(state);
           }
 
@@ -0,0 +1,405 @@
+/*
+ * ## bench.h: A microbenchmark harness built around closures. ------
+ *
+ * Author: Lain Supe (lainproliant)
+ * Date: Sun October 18, 2026
+ *
+ * ## Usage ---------------------------------------------------------
+ * `test::BenchmarkSuite` is built the same way as `test::TestSuite` in
+ * `test.h`, where each benchmark is a closure which is called repeatedly and
+ * timed.  Use `do_not_optimize(v)` to keep the compiler from optimizing away a
+ * result which is otherwise unused.
+ *
+ * ```
+ * int main() {
+ *      std::string doc = file::slurp("data.json");
+ *      return BenchmarkSuite("My Benchmarks")
+ *      .bench(Benchmark("parse", [&]() {
+ *          do_not_optimize(json::read<json::Object>(doc));
+ *      }).bytes(doc.size()))
+ *      .run();
+ * }
+ * ```
+ *
+ * Each benchmark is first run for a warmup period, during which the number of
+ * calls per sample is calibrated so that each sample takes at least
+ * `MOONLIGHT_BENCH_SAMPLE_MS`.  The mean, median, standard deviation and
+ * percentiles of the time per call are then reported over
+ * `MOONLIGHT_BENCH_SAMPLES` samples, along with items or bytes per second if
+ * `items(n)` or `bytes(n)` were given for the benchmark.  If the program
+ * includes `moonlight/alloc_hooks.h`, the number of allocations and bytes
+ * allocated per call are also reported.
+ *
+ * The following environment variables are read by `BenchmarkSuite::run()`:
+ *
+ * - `MOONLIGHT_BENCH_FILTER`: Only run benchmarks whose names contain this.
+ * - `MOONLIGHT_BENCH_OUTPUT`: Write the results as JSON to this file.
+ * - `MOONLIGHT_BENCH_BASELINE`: Compare the median times against the results
+ *   previously written to this file.  Benchmarks which are slower than the
+ *   baseline by more than `MOONLIGHT_BENCH_THRESHOLD` percent, 10 by
+ *   default, are reported as regressions.
+ *
+ * `run()` returns the number of benchmarks which threw an exception or
+ * regressed.
+ */
+#ifndef __MOONLIGHT_BENCH_H
+#define __MOONLIGHT_BENCH_H
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <optional>
+
+#include "moonlight/constants.h"
+#include "moonlight/format.h"
+#include "moonlight/json.h"
+#include "moonlight/test.h"
+
+namespace moonlight {
+namespace test {
+
+//-------------------------------------------------------------------
+// Prevent the compiler from optimizing away the computation of `value`.
+template<class T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "m"(value) : "memory");
+}
+
+template<class T>
+inline void do_not_optimize(T& value) {
+    asm volatile("" : "+m"(value) : : "memory");
+}
+
+// Prevent the compiler from reordering memory accesses across this point.
+inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+}
+
+//-------------------------------------------------------------------
+class Benchmark {
+ public:
+     Benchmark(const std::string& name, std::function<void()> bench_fn) :
+     bench_fn(bench_fn), name(name) {}
+     virtual ~Benchmark() {}
+
+     // The number of items processed by each call to the benchmark.
+     Benchmark& items(size_t n) {
+         items_per_call = n;
+         return *this;
+     }
+
+     // The number of bytes processed by each call to the benchmark.
+     Benchmark& bytes(size_t n) {
+         bytes_per_call = n;
+         return *this;
+     }
+
+     const std::string& get_name() const {
+         return name;
+     }
+
+     size_t get_items() const {
+         return items_per_call;
+     }
+
+     size_t get_bytes() const {
+         return bytes_per_call;
+     }
+
+     /**
+      * Time `calls` consecutive calls to the benchmark, in nanoseconds.
+      */
+     double time(size_t calls) const {
+         auto start = std::chrono::steady_clock::now();
+         for (size_t x = 0; x < calls; x++) {
+             bench_fn();
+         }
+         auto end = std::chrono::steady_clock::now();
+         return std::chrono::duration<double, std::nano>(end - start).count();
+     }
+
+ private:
+     std::function<void()> bench_fn;
+     std::string name;
+     size_t items_per_call = 0;
+     size_t bytes_per_call = 0;
+};
+
+//-------------------------------------------------------------------
+struct BenchmarkResult {
+    std::string name;
+    size_t batch = 0;
+    size_t samples = 0;
+    double mean_ns = 0;
+    double median_ns = 0;
+    double stddev_ns = 0;
+    double min_ns = 0;
+    double max_ns = 0;
+    double p90_ns = 0;
+    double p99_ns = 0;
+    double items_per_second = 0;
+    double bytes_per_second = 0;
+    std::optional<double> allocs_per_call;
+    std::optional<double> alloc_bytes_per_call;
+
+    /**
+     * Summarize per-call times measured over each sample.
+     */
+    static BenchmarkResult summarize(const Benchmark& bench, size_t batch, std::vector<double> times) {
+        BenchmarkResult result;
+        result.name = bench.get_name();
+        result.batch = batch;
+        result.samples = times.size();
+
+        std::sort(times.begin(), times.end());
+        double sum = 0;
+        for (double t : times) {
+            sum += t;
+        }
+        result.mean_ns = sum / times.size();
+
+        double variance = 0;
+        for (double t : times) {
+            variance += (t - result.mean_ns) * (t - result.mean_ns);
+        }
+        result.stddev_ns = times.size() > 1 ? std::sqrt(variance / (times.size() - 1)) : 0;
+
+        result.min_ns = times.front();
+        result.max_ns = times.back();
+        result.median_ns = percentile(times, 50);
+        result.p90_ns = percentile(times, 90);
+        result.p99_ns = percentile(times, 99);
+        result.items_per_second = bench.get_items() * 1e9 / result.mean_ns;
+        result.bytes_per_second = bench.get_bytes() * 1e9 / result.mean_ns;
+        return result;
+    }
+
+    // Nearest-rank percentile of a sorted, non-empty vector.
+    static double percentile(const std::vector<double>& sorted, double p) {
+        size_t rank = std::ceil(p / 100.0 * sorted.size());
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    json::Object to_json() const {
+        json::Object obj;
+        obj.set("name", name)
+        .set("batch", (double)batch)
+        .set("samples", (double)samples)
+        .set("mean_ns", mean_ns)
+        .set("median_ns", median_ns)
+        .set("stddev_ns", stddev_ns)
+        .set("min_ns", min_ns)
+        .set("max_ns", max_ns)
+        .set("p90_ns", p90_ns)
+        .set("p99_ns", p99_ns);
+        if (items_per_second > 0) {
+            obj.set("items_per_second", items_per_second);
+        }
+        if (bytes_per_second > 0) {
+            obj.set("bytes_per_second", bytes_per_second);
+        }
+        if (allocs_per_call.has_value()) {
+            obj.set("allocs_per_call", *allocs_per_call);
+            obj.set("alloc_bytes_per_call", *alloc_bytes_per_call);
+        }
+        return obj;
+    }
+};
+
+//-------------------------------------------------------------------
+class BenchmarkSuite {
+ public:
+     explicit BenchmarkSuite(const std::string& name) : name(name) {}
+     virtual ~BenchmarkSuite() {}
+
+     BenchmarkSuite& bench(const std::string& name, std::function<void()> bench_fn) {
+         return bench(Benchmark(name, bench_fn));
+     }
+
+     BenchmarkSuite& bench(const Benchmark& bench) {
+         benchmarks.push_back(bench);
+         return *this;
+     }
+
+     BenchmarkSuite& samples(size_t n) {
+         sample_count = std::max<size_t>(n, 1);
+         return *this;
+     }
+
+     BenchmarkSuite& warmup(std::chrono::milliseconds ms) {
+         warmup_time = ms;
+         return *this;
+     }
+
+     BenchmarkSuite& sample_time(std::chrono::milliseconds ms) {
+         sample_time_target = ms;
+         return *this;
+     }
+
+     /**
+      * Run the benchmarks in the order they were defined, returning the
+      * number of benchmarks which failed or regressed against the baseline.
+      */
+     int run(std::ostream& out = std::cout) {
+         auto filter = sys::getenv("MOONLIGHT_BENCH_FILTER");
+         auto output_file = sys::getenv("MOONLIGHT_BENCH_OUTPUT");
+         auto baseline_file = sys::getenv("MOONLIGHT_BENCH_BASELINE");
+         double threshold = std::stod(sys::getenv("MOONLIGHT_BENCH_THRESHOLD").value_or("10"));
+
+         std::map<std::string, double> baseline;
+         if (baseline_file.has_value()) {
+             baseline = load_baseline(*baseline_file);
+         }
+
+         out << "===== " << name << " =====" << std::endl;
+
+         int regressions = 0;
+         int failures = 0;
+         json::Array results;
+         for (const Benchmark& bench : benchmarks) {
+             if (filter.has_value() && bench.get_name().find(*filter) == std::string::npos) {
+                 continue;
+             }
+
+             BenchmarkResult result;
+             try {
+                 result = measure(bench);
+             } catch (const std::exception& e) {
+                 out << fmt::format("{:<40} FAILED {}", bench.get_name(), e.what()) << std::endl;
+                 failures++;
+                 continue;
+             }
+             results.append(result.to_json());
+             out << fmt::format("{:<40} {:>10} ±{:>10}  median {:>10}  p99 {:>10}",
+                                bench.get_name(),
+                                format_ns(result.mean_ns),
+                                format_ns(result.stddev_ns),
+                                format_ns(result.median_ns),
+                                format_ns(result.p99_ns));
+             if (result.items_per_second > 0) {
+                 out << fmt::format("  {:>10} items/s", format_rate(result.items_per_second));
+             }
+             if (result.bytes_per_second > 0) {
+                 out << fmt::format("  {:>10}B/s", format_rate(result.bytes_per_second));
+             }
+             if (result.allocs_per_call.has_value()) {
+                 out << fmt::format("  {:.1f} allocs ({}B)/call", *result.allocs_per_call,
+                                    format_rate(*result.alloc_bytes_per_call));
+             }
+
+             auto iter = baseline.find(bench.get_name());
+             if (iter != baseline.end() && iter->second > 0) {
+                 double change = (result.median_ns / iter->second - 1.0) * 100.0;
+                 out << fmt::format("  {}{:.1f}%", change >= 0 ? "+" : "", change);
+                 if (change > threshold) {
+                     out << " REGRESSED";
+                     regressions++;
+                 }
+             }
+             out << std::endl;
+         }
+         out << std::endl;
+
+         if (output_file.has_value()) {
+             json::Object report;
+             report.set("suite", name);
+             report.set("benchmarks", results);
+             json::write_file(*output_file, report, json::FormatOptions{.pretty = true, .indent = 2});
+         }
+
+         return failures + regressions;
+     }
+
+     int size() const {
+         return benchmarks.size();
+     }
+
+ private:
+     /**
+      * Warm up, then choose the number of calls per sample so that each
+      * sample takes at least `sample_time_target`, keeping timer overhead
+      * and resolution small relative to the time measured.
+      */
+     BenchmarkResult measure(const Benchmark& bench) const {
+         const double target_ns = std::chrono::duration<double, std::nano>(sample_time_target).count();
+         const auto warmup_until = std::chrono::steady_clock::now() + warmup_time;
+
+         size_t batch = 1;
+         for (;;) {
+             double elapsed = bench.time(batch);
+             if (elapsed >= target_ns && std::chrono::steady_clock::now() >= warmup_until) {
+                 break;
+             }
+             if (elapsed < target_ns) {
+                 double scale = target_ns / std::max(elapsed, 1.0);
+                 batch = std::max<size_t>(batch + 1, batch * std::min(scale * 1.2, 10.0));
+             }
+         }
+
+         std::vector<double> times;
+         times.reserve(sample_count);
+         auto allocs_before = AllocationStats::current();
+         for (size_t x = 0; x < sample_count; x++) {
+             times.push_back(bench.time(batch) / batch);
+         }
+         auto allocs = AllocationStats::current() - allocs_before;
+
+         auto result = BenchmarkResult::summarize(bench, batch, times);
+         if (AllocationStats::tracked()) {
+             double calls = batch * sample_count;
+             result.allocs_per_call = allocs.allocs / calls;
+             result.alloc_bytes_per_call = allocs.bytes / calls;
+         }
+         return result;
+     }
+
+     /**
+      * Load the median time of each benchmark from a file written by a
+      * previous run with `MOONLIGHT_BENCH_OUTPUT`.
+      */
+     static std::map<std::string, double> load_baseline(const std::string& filename) {
+         std::map<std::string, double> baseline;
+         std::ifstream infile(filename);
+         if (! infile) {
+             return baseline;
+         }
+         auto report = json::read<json::Object>(infile, filename);
+         for (auto& result : report.get<json::Array>("benchmarks").extract<json::Object>()) {
+             baseline[result.get<std::string>("name")] = result.get<double>("median_ns");
+         }
+         return baseline;
+     }
+
+     static std::string format_ns(double ns) {
+         if (ns < 1e3) {
+             return fmt::format("{:.1f} ns", ns);
+         } else if (ns < 1e6) {
+             return fmt::format("{:.2f} us", ns / 1e3);
+         } else if (ns < 1e9) {
+             return fmt::format("{:.2f} ms", ns / 1e6);
+         }
+         return fmt::format("{:.2f} s", ns / 1e9);
+     }
+
+     static std::string format_rate(double rate) {
+         if (rate < 1e3) {
+             return fmt::format("{:.1f} ", rate);
+         } else if (rate < 1e6) {
+             return fmt::format("{:.2f} K", rate / 1e3);
+         } else if (rate < 1e9) {
+             return fmt::format("{:.2f} M", rate / 1e6);
+         }
+         return fmt::format("{:.2f} G", rate / 1e9);
+     }
+
+     std::vector<Benchmark> benchmarks;
+     std::string name;
+     size_t sample_count = MOONLIGHT_BENCH_SAMPLES;
+     std::chrono::milliseconds warmup_time{MOONLIGHT_BENCH_WARMUP_MS};
+     std::chrono::milliseconds sample_time_target{MOONLIGHT_BENCH_SAMPLE_MS};
+};
+
+}  // namespace test
+}  // namespace moonlight
+
+#endif /* __MOONLIGHT_BENCH_H */
@@ -31,6 +31,10 @@
  * The first parameter in the argument list is assumed to be the program name,
  * and is available via `get_program_name()` on the `cli` object.
  *
+ * `cli::parse` throws `core::UsageError` if an unknown flag or option is given
+ * or an option is missing its value.  `cli::try_parse` accepts the same
+ * parameters and instead returns a `core::Result` holding the error.
+ *
  * ## Other Functions -----------------------------------------------
  * `cli.h` also provides two other useful utility functions:
  *
@@ -49,6 +53,7 @@
 
 #include "moonlight/exceptions.h"
 #include "moonlight/collect.h"
+#include "moonlight/result.h"
 #include "moonlight/variadic.h"
 #include "moonlight/slice.h"
 
@@ -152,13 +157,23 @@ class CommandLine {
          return args_;
      }
 
-     static CommandLine parse(const std::vector<std::string>& argv,
-                              const std::set<std::string>& flag_names = {},
-                              const std::set<std::string>& opt_names = {}) {
+     /**
+      * Parse the given arguments, returning a `core::Error` rather than
+      * throwing if an unknown flag or option is given or an option is missing
+      * its value.  The error location's `offset` is the index of the argument
+      * in `argv`.
+      */
+     static core::Result<CommandLine> try_parse(const std::vector<std::string>& argv,
+                                                const std::set<std::string>& flag_names = {},
+                                                const std::set<std::string>& opt_names = {}) {
          CommandLine results;
          results.program_name = argv[0];
 
          for (unsigned int x = 1; x < argv.size(); x++) {
+             auto error = [&](core::ErrorCode code, const std::string& message) {
+                 return core::Error{code, message, file::Location{1, x, x, "argv"}};
+             };
+
              auto& arg = argv[x];
              if (arg == "--") {
                  // All following args are true args.
@@ -181,7 +196,7 @@ class CommandLine {
                          results.multi_opts.insert(std::pair<std::string, std::string>(opt, value));
 
                      } else {
-                         THROW(core::UsageError, str::cat(
+                         return error(core::ErrorCode::UNKNOWN_NAME, str::cat(
                                  "Unknown option '", opt, "'."));
                      }
 
@@ -196,12 +211,12 @@ class CommandLine {
                          results.multi_opts.insert(std::pair<std::string, std::string>(longopt, value));
 
                      } else {
-                         THROW(core::UsageError, str::cat(
+                         return error(core::ErrorCode::MISSING_VALUE, str::cat(
                                  "Missing required value for option '--", longopt, "'."));
                      }
 
                  } else {
-                     THROW(core::UsageError, str::cat(
+                     return error(core::ErrorCode::UNKNOWN_NAME, str::cat(
                              "Unknown flag or option '--", longopt, "'."));
                  }
 
@@ -225,11 +240,11 @@ class CommandLine {
                              results.opts.insert(std::pair<std::string, std::string>{shortopt, argv[++x]});
 
                          } else {
-                             THROW(core::UsageError, str::cat(
+                             return error(core::ErrorCode::MISSING_VALUE, str::cat(
                                      "Missing required parameter for '-", shortopt, "'."));
                          }
                      } else {
-                         THROW(core::UsageError, str::cat(
+                         return error(core::ErrorCode::UNKNOWN_NAME, str::cat(
                                  "Unknown flag or option '-", shortopt, "'."));
                      }
                  }
@@ -243,6 +258,17 @@ class CommandLine {
          return results;
      }
 
+     static CommandLine parse(const std::vector<std::string>& argv,
+                              const std::set<std::string>& flag_names = {},
+                              const std::set<std::string>& opt_names = {}) {
+         auto result = try_parse(argv, flag_names, opt_names);
+         if (! result) {
+             THROW(core::UsageError, result.error().message);
+         }
+         return std::move(result).value();
+     }
+
+
  private:
      std::string program_name;
      std::set<std::string> flags;
@@ -268,6 +294,22 @@ inline CommandLine parse(int argc_in, char** argv_in,
     return parse(argv_to_vector(argc_in, argv_in), flag_names, opt_names);
 }
 
+/**
+*/
+inline core::Result<CommandLine> try_parse(const std::vector<std::string>& argv,
+                                           const std::set<std::string>& flag_names = {},
+                                           const std::set<std::string>& opt_names = {}) {
+    return CommandLine::try_parse(argv, flag_names, opt_names);
+}
+
+/**
+*/
+inline core::Result<CommandLine> try_parse(int argc_in, char** argv_in,
+                                           const std::set<std::string>& flag_names = {},
+                                           const std::set<std::string>& opt_names = {}) {
+    return try_parse(argv_to_vector(argc_in, argv_in), flag_names, opt_names);
+}
+
 }  // namespace cli
 }  // namespace moonlight
 
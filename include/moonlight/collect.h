@@ -27,21 +27,110 @@
  * - `zip<R>(A, B)`: Combine the contents of `A` and `B` into a single new
  *   `std::vector<R>` by constructing new `R` objects using elements `A[x]` and
  *   `B[x]`, i.e. `R(A[x], B[x])`.
+ *
+ * `filter()` and `sorted()` also accept a collection by rvalue, in which case
+ * they work on it in place and return it rather than copying it.  Views, e.g.
+ * `std::span` or those returned by `slice_view()`, don't own their elements,
+ * so they are never modified or moved from: `filter()` and `sorted()` copy
+ * their elements into a new `std::vector` instead.
+ *
+ * ## Parallel algorithms -------------------------------------------
+ * The `moonlight::collect::par` namespace offers parallel versions of these
+ * algorithms for large random access collections, e.g. `std::vector`.  The
+ * collection is split into chunks of at least `MOONLIGHT_PAR_MIN_CHUNK`
+ * elements, which are processed by the threads of a `par::Pool`, including
+ * the calling thread.  Each algorithm takes the pool as an optional final
+ * argument, defaulting to `par::Pool::shared()`, which has one thread per
+ * hardware thread.  Functions are taken as template parameters rather than
+ * `std::function`, so they can be inlined.
+ *
+ * - `par::map(C, f(x))`: Return a `std::vector` of `f(x)` for each element,
+ *   in order.  The result type must be default constructible.  If `C` is an
+ *   rvalue which owns its elements, they are moved into `f(x)`.
+ * - `par::filter(C, f(x))`: Return a `std::vector` of the elements for which
+ *   `f(x)` is true, in order.  If `C` is an rvalue which owns its elements,
+ *   they are moved.
+ * - `par::for_each(C, f(x))`: Call `f(x)` with a reference to each element,
+ *   which may modify it in place.
+ * - `par::sort(C, comp)`: Sort the collection in place.  The sort isn't stable.
+ * - `par::sorted(C, comp)`: Return a sorted copy of `C`, or sort `C` in place
+ *   and return it if it is an rvalue which owns its elements.  The copy of a
+ *   view is a `std::vector`.
+ * - `par::reduce(C, init, f(a, b))`: Combine the elements of `C` and `init`
+ *   with `f`, which must be associative.  Elements are combined in order, but
+ *   grouped arbitrarily.
+ *
+ * ```
+ * auto lengths = collect::par::map(lines, [](const std::string& line) {
+ *     return line.size();
+ * });
+ * size_t total = collect::par::reduce(lengths, size_t(0), std::plus<>());
+ * ```
+ *
+ * Exceptions thrown by `f` are rethrown in the calling thread once all of
+ * the chunks which were started have finished.  A parallel algorithm called
+ * from within another runs sequentially on the calling thread.
  */
 
 #ifndef __MOONLIGHT_COLLECT_H
 #define __MOONLIGHT_COLLECT_H
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <vector>
 #include <set>
 #include <map>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "moonlight/constants.h"
 
 namespace moonlight {
 namespace collect {
 
+namespace _collect {
+
+template<class C>
+concept View = std::ranges::view<std::remove_cvref_t<C>>;
+
+/**
+ * A collection passed by rvalue which owns its elements, so it can be
+ * modified in place or have its elements moved from.  Views such as
+ * `std::span` refer to elements owned elsewhere, so they don't qualify.
+ */
+template<class C>
+concept owning_rvalue = (! std::is_lvalue_reference_v<C>
+                         && ! std::ranges::borrowed_range<C>
+                         && ! View<C>);
+
+/**
+ * The type of a new collection holding the elements of `C`: `C` itself, or
+ * a `std::vector` if `C` is a view.
+ */
+template<class C, bool = View<C>>
+struct owned {
+    typedef std::remove_cvref_t<C> type;
+};
+
+template<class C>
+struct owned<C, true> {
+    typedef std::vector<std::ranges::range_value_t<C>> type;
+};
+
+template<class C>
+using owned_t = typename owned<C>::type;
+
+}  // namespace _collect
+
 template<typename T>
 inline bool contains(const T& coll, const typename T::value_type& v) {
     return std::find(coll.begin(), coll.end(), v) != coll.end();
@@ -76,8 +165,8 @@ template<typename T>
 inline void flatten(std::vector<T>& flattened) { (void) flattened; }
 
 template<typename T>
-inline T filter(const T& coll, const std::function<bool(typename T::value_type)>& f) {
-    T result;
+inline _collect::owned_t<T> filter(const T& coll, const std::function<bool(typename T::value_type)>& f) {
+    _collect::owned_t<T> result;
     for (auto v : coll) {
         if (f(v)) {
             result.push_back(v);
@@ -86,6 +175,15 @@ inline T filter(const T& coll, const std::function<bool(typename T::value_type)>
     return result;
 }
 
+template<typename T>
+requires _collect::owning_rvalue<T>
+inline T filter(T&& coll, const std::function<bool(typename T::value_type)>& f) {
+    coll.erase(std::remove_if(coll.begin(), coll.end(), [&](const auto& v) {
+        return ! f(v);
+    }), coll.end());
+    return std::move(coll);
+}
+
 template<typename T>
 inline std::shared_ptr<T> filter(const std::shared_ptr<T>& coll,
                                  const std::function<bool(typename T::value_type)>& f) {
@@ -93,26 +191,42 @@ inline std::shared_ptr<T> filter(const std::shared_ptr<T>& coll,
 }
 
 template<typename C1>
-inline C1 sorted(const C1& src) {
-    C1 result;
+inline _collect::owned_t<C1> sorted(const C1& src) {
+    _collect::owned_t<C1> result;
     std::copy(src.begin(), src.end(), std::back_inserter(result));
     std::sort(result.begin(), result.end());
     return result;
 }
 
 template<typename C1>
-inline C1 sorted(const C1& src, std::function<bool(const typename C1::value_type& a,
-                                                   const typename C1::value_type& b)> comp) {
-    C1 result;
+inline _collect::owned_t<C1> sorted(const C1& src, std::function<bool(const typename C1::value_type& a,
+                                                                      const typename C1::value_type& b)> comp) {
+    _collect::owned_t<C1> result;
     std::copy(src.begin(), src.end(), std::back_inserter(result));
     std::sort(result.begin(), result.end(), comp);
     return result;
 }
 
+template<typename C1>
+requires _collect::owning_rvalue<C1>
+inline C1 sorted(C1&& src) {
+    std::sort(src.begin(), src.end());
+    return std::move(src);
+}
+
+template<typename C1>
+requires _collect::owning_rvalue<C1>
+inline C1 sorted(C1&& src, std::function<bool(const typename C1::value_type& a,
+                                              const typename C1::value_type& b)> comp) {
+    std::sort(src.begin(), src.end(), comp);
+    return std::move(src);
+}
+
 template<typename T, typename C1>
 inline std::vector<T> map(const C1& src, std::function<T(const typename C1::value_type&)> f) {
     std::vector<T> result;
-    for (auto v : src) {
+    result.reserve(src.size());
+    for (const auto& v : src) {
         result.push_back(f(v));
     }
     return result;
@@ -143,6 +257,330 @@ inline std::vector<R> zip(const C1& srcA, const C2& srcB) {
     return result;
 }
 
+namespace par {
+
+namespace _par {
+
+// Set while a thread is running chunks, so that nested parallel algorithms
+// run sequentially instead of waiting on the pool they are running in.
+inline thread_local bool in_pool = false;
+
+template<class C>
+using element_t = std::remove_reference_t<decltype(*std::begin(std::declval<C&>()))>;
+
+/**
+ * The element of `src` at `x`, moved if `C` is an rvalue which owns its
+ * elements.
+ */
+template<class C, class S>
+decltype(auto) forward_at(S& src, size_t x) {
+    if constexpr (_collect::owning_rvalue<C>) {
+        return std::move(src[x]);
+    } else {
+        return std::as_const(src[x]);
+    }
+}
+
+}  // namespace _par
+
+/**------------------------------------------------------------------
+ * A pool of threads for running chunked work.  The calling thread runs
+ * chunks alongside the pool's threads, so a pool of `threads` threads
+ * starts `threads - 1` of its own.  Batches from different callers are run
+ * one at a time.
+ */
+class Pool {
+ public:
+     explicit Pool(size_t threads = std::thread::hardware_concurrency()) {
+         threads = std::max<size_t>(threads, 1);
+         for (size_t x = 1; x < threads; x++) {
+             _workers.emplace_back([this]() { _run(); });
+         }
+     }
+
+     Pool(const Pool&) = delete;
+     Pool& operator=(const Pool&) = delete;
+
+     ~Pool() {
+         std::unique_lock<std::mutex> lock(_mutex);
+         _stopping = true;
+         lock.unlock();
+         _cv.notify_all();
+         for (auto& worker : _workers) {
+             worker.join();
+         }
+     }
+
+     static Pool& shared() {
+         static Pool pool;
+         return pool;
+     }
+
+     size_t threads() const {
+         return _workers.size() + 1;
+     }
+
+     /**
+      * The number of chunks to split `size` elements into.
+      */
+     size_t chunks(size_t size) const {
+         size_t by_size = (size + MOONLIGHT_PAR_MIN_CHUNK - 1) / MOONLIGHT_PAR_MIN_CHUNK;
+         return std::max<size_t>(std::min(by_size, threads() * MOONLIGHT_PAR_CHUNKS_PER_THREAD), 1);
+     }
+
+     /**
+      * Call `f(chunk, begin, end)` for each of `chunks` contiguous ranges
+      * covering `[0, size)`, and wait for them all to finish.
+      */
+     template<class F>
+     void run(size_t size, size_t chunks, F&& f) {
+         auto task = [&](size_t chunk) {
+             f(chunk, size * chunk / chunks, size * (chunk + 1) / chunks);
+         };
+
+         if (chunks <= 1 || _workers.empty() || _par::in_pool) {
+             for (size_t chunk = 0; chunk < chunks; chunk++) {
+                 task(chunk);
+             }
+             return;
+         }
+
+         std::unique_lock<std::mutex> batch_lock(_batch_mutex);
+         std::function<void(size_t)> batch_task = task;
+
+         std::unique_lock<std::mutex> lock(_mutex);
+         _task = &batch_task;
+         _chunks = chunks;
+         _next = 0;
+         _pending = chunks;
+         _failed = false;
+         _error = nullptr;
+         _generation++;
+         lock.unlock();
+         _cv.notify_all();
+
+         _work();
+
+         lock.lock();
+         _done_cv.wait(lock, [this]() { return _pending == 0 && _busy == 0; });
+         _task = nullptr;
+         if (_error) {
+             std::rethrow_exception(_error);
+         }
+     }
+
+ private:
+     void _run() {
+         uint64_t generation = 0;
+         for (;;) {
+             std::unique_lock<std::mutex> lock(_mutex);
+             _cv.wait(lock, [&]() {
+                 return _stopping || (_task != nullptr && _generation != generation);
+             });
+             if (_stopping) {
+                 return;
+             }
+             generation = _generation;
+             _busy++;
+             lock.unlock();
+
+             _work();
+
+             lock.lock();
+             if (--_busy == 0) {
+                 _done_cv.notify_all();
+             }
+         }
+     }
+
+     void _work() {
+         _par::in_pool = true;
+         for (;;) {
+             size_t chunk = _next.fetch_add(1);
+             if (chunk >= _chunks) {
+                 break;
+             }
+
+             if (! _failed) {
+                 try {
+                     (*_task)(chunk);
+
+                 } catch (...) {
+                     std::lock_guard<std::mutex> lock(_mutex);
+                     if (! _error) {
+                         _error = std::current_exception();
+                     }
+                     _failed = true;
+                 }
+             }
+
+             if (_pending.fetch_sub(1) == 1) {
+                 std::lock_guard<std::mutex> lock(_mutex);
+                 _done_cv.notify_all();
+             }
+         }
+         _par::in_pool = false;
+     }
+
+     std::vector<std::thread> _workers;
+     std::mutex _batch_mutex;
+     std::mutex _mutex;
+     std::condition_variable _cv;
+     std::condition_variable _done_cv;
+     const std::function<void(size_t)>* _task = nullptr;
+     size_t _chunks = 0;
+     std::atomic<size_t> _next = 0;
+     std::atomic<size_t> _pending = 0;
+     std::atomic<bool> _failed = false;
+     std::exception_ptr _error;
+     size_t _busy = 0;
+     uint64_t _generation = 0;
+     bool _stopping = false;
+};
+
+/**------------------------------------------------------------------
+ * Return a `std::vector` of `f(x)` for each element of `src`.
+ */
+template<class C, class F>
+auto map(C&& src, F f, Pool& pool = Pool::shared()) {
+    using T = std::decay_t<decltype(f(_par::forward_at<C>(src, 0)))>;
+
+    if constexpr (std::is_same_v<T, bool>) {
+        // Neighbouring elements of `std::vector<bool>` share words, so they
+        // can't be written from different threads.
+        auto bytes = par::map(std::forward<C>(src), [&](auto&& x) -> uint8_t {
+            return f(std::forward<decltype(x)>(x));
+        }, pool);
+        return std::vector<bool>(bytes.begin(), bytes.end());
+
+    } else {
+        std::vector<T> result(src.size());
+        pool.run(src.size(), pool.chunks(src.size()), [&](size_t, size_t begin, size_t end) {
+            for (size_t x = begin; x < end; x++) {
+                result[x] = f(_par::forward_at<C>(src, x));
+            }
+        });
+        return result;
+    }
+}
+
+/**------------------------------------------------------------------
+ * Return a `std::vector` of the elements of `src` for which `f(x)` is true.
+ */
+template<class C, class F>
+auto filter(C&& src, F f, Pool& pool = Pool::shared()) {
+    using T = std::decay_t<_par::element_t<C>>;
+    size_t chunks = pool.chunks(src.size());
+    std::vector<std::vector<T>> kept(chunks);
+
+    pool.run(src.size(), chunks, [&](size_t chunk, size_t begin, size_t end) {
+        for (size_t x = begin; x < end; x++) {
+            if (f(std::as_const(src[x]))) {
+                kept[chunk].push_back(_par::forward_at<C>(src, x));
+            }
+        }
+    });
+
+    size_t size = 0;
+    for (const auto& part : kept) {
+        size += part.size();
+    }
+    std::vector<T> result;
+    result.reserve(size);
+    for (auto& part : kept) {
+        std::move(part.begin(), part.end(), std::back_inserter(result));
+    }
+    return result;
+}
+
+/**------------------------------------------------------------------
+ * Call `f(x)` with a reference to each element of `coll`.
+ */
+template<class C, class F>
+void for_each(C& coll, F f, Pool& pool = Pool::shared()) {
+    pool.run(coll.size(), pool.chunks(coll.size()), [&](size_t, size_t begin, size_t end) {
+        for (size_t x = begin; x < end; x++) {
+            f(coll[x]);
+        }
+    });
+}
+
+/**------------------------------------------------------------------
+ * Sort `coll` in place.  Chunks are sorted in parallel, then merged
+ * pairwise in parallel rounds.
+ */
+template<class C, class Compare = std::less<>>
+void sort(C& coll, Compare comp = Compare(), Pool& pool = Pool::shared()) {
+    size_t size = coll.size();
+    size_t chunks = pool.chunks(size);
+    auto begin = coll.begin();
+
+    pool.run(size, chunks, [&](size_t, size_t first, size_t last) {
+        std::sort(begin + first, begin + last, comp);
+    });
+
+    for (size_t width = 1; width < chunks; width *= 2) {
+        size_t merges = (chunks + 2 * width - 1) / (2 * width);
+        pool.run(merges, merges, [&](size_t merge, size_t, size_t) {
+            size_t lo = merge * 2 * width;
+            size_t mid = std::min(lo + width, chunks);
+            size_t hi = std::min(lo + 2 * width, chunks);
+            if (mid < hi) {
+                std::inplace_merge(begin + size * lo / chunks,
+                                   begin + size * mid / chunks,
+                                   begin + size * hi / chunks, comp);
+            }
+        });
+    }
+}
+
+/**------------------------------------------------------------------
+ * Return a sorted copy of `src`, or sort `src` in place and return it if it
+ * is an rvalue which owns its elements.  Views are copied into a
+ * `std::vector`, so the elements they refer to are left alone.
+ */
+template<class C, class Compare = std::less<>>
+_collect::owned_t<C> sorted(C&& src, Compare comp = Compare(), Pool& pool = Pool::shared()) {
+    _collect::owned_t<C> result = [&]() {
+        if constexpr (_collect::View<C>) {
+            return _collect::owned_t<C>(src.begin(), src.end());
+        } else {
+            return _collect::owned_t<C>(std::forward<C>(src));
+        }
+    }();
+    par::sort(result, comp, pool);
+    return result;
+}
+
+/**------------------------------------------------------------------
+ * Combine the elements of `src` and `init` with the associative function
+ * `f(a, b)`.
+ */
+template<class C, class T, class F>
+T reduce(const C& src, T init, F f, Pool& pool = Pool::shared()) {
+    size_t chunks = pool.chunks(src.size());
+    std::vector<std::optional<T>> partials(chunks);
+
+    pool.run(src.size(), chunks, [&](size_t chunk, size_t begin, size_t end) {
+        if (begin == end) {
+            return;
+        }
+        T acc = src[begin];
+        for (size_t x = begin + 1; x < end; x++) {
+            acc = f(std::move(acc), src[x]);
+        }
+        partials[chunk] = std::move(acc);
+    });
+
+    for (auto& partial : partials) {
+        if (partial) {
+            init = f(std::move(init), std::move(*partial));
+        }
+    }
+    return init;
+}
+
+}  // namespace par
 
 }  // namespace collect
 }  // namespace moonlight
@@ -17,10 +17,13 @@
  *   - `uRGB::of(v)` parses a color, either from the first 24bits of an integer,
  *     or a hexidecimal string optionally starting with an octothorpe ('#').
  *   - `uRGB::is_valid(s)` determines if the given string is a valid hex color
- *     string, which in this case must have a leading octothorpe ('#').
+ *     string, which is six hexidecimal digits optionally starting with an
+ *     octothorpe ('#').
  *   - `uRGB::validate(s)` parses a hex color from the string `s`, validating
  *     first that it is a valid color hex string via `uRGB::is_valid(s)`.  If it
  *     is not valid, a `core::ValueError` is thrown.
+ *   - `uRGB::try_validate(s)` is like `uRGB::validate(s)`, but returns a
+ *     `core::Result` holding the error rather than throwing it.
  *   - `uRGB::str()` emits a uRGB value as a hex color string with a leading
  *     octothorpe ('#').
  *   - `uRGB` can be explicitly converted to `int`, `fRGB`, and `fHSV` via
@@ -50,11 +53,14 @@
 #define __MOONLIGHT_COLOR_H
 
 #include <inttypes.h>
+#include <charconv>
 #include <string>
+#include <string_view>
 #include <cmath>
+#include <iomanip>
 #include <ostream>
-#include "moonlight/rx.h"
 #include "moonlight/exceptions.h"
+#include "moonlight/result.h"
 
 namespace moonlight {
 namespace color {
@@ -125,16 +131,29 @@ struct uRGB {
         return of(std::stoul(sx, nullptr, 16));
     }
 
+    static core::Result<uRGB> try_validate(std::string_view s) {
+        std::string_view hex = s.starts_with("#") ? s.substr(1) : s;
+        unsigned int c = 0;
+        auto [ptr, ec] = std::from_chars(hex.data(), hex.data() + hex.size(), c, 16);
+
+        if (hex.size() != 6 || ec != std::errc() || ptr != hex.data() + hex.size()) {
+            return core::Error{
+                core::ErrorCode::SYNTAX_ERROR,
+                "RGB color string is not valid: " + std::string(s)};
+        }
+        return of(c);
+    }
+
     static bool is_valid(const std::string& s) {
-        static const auto rx = rx::def("#?[0-9a-fA-F]{6}");
-        return rx::match(rx, s);
+        return try_validate(s).ok();
     }
 
     static uRGB validate(const std::string& s) {
-        if (! is_valid(s)) {
-            THROW(core::ValueError, "RGB color string is not valid: " + s);
+        auto result = try_validate(s);
+        if (! result) {
+            THROW(core::ValueError, result.error().message);
         }
-        return of(s);
+        return *result;
     }
 
     operator fRGB() const;
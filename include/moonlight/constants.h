@@ -22,4 +22,96 @@
 #define MOONLIGHT_STACKTRACE_LINE_BUFSIZE 1024
 #endif
 
+#ifndef MOONLIGHT_STACKTRACE_MAX_FRAMES
+#define MOONLIGHT_STACKTRACE_MAX_FRAMES 64
+#endif
+
+#ifndef MOONLIGHT_FMT_INLINE_BUFSIZE
+#define MOONLIGHT_FMT_INLINE_BUFSIZE 256
+#endif
+
+#ifndef MOONLIGHT_FMT_FLOAT_BUFSIZE
+#define MOONLIGHT_FMT_FLOAT_BUFSIZE 64
+#endif
+
+#ifndef MOONLIGHT_STRING_IHASH_CHUNK
+#define MOONLIGHT_STRING_IHASH_CHUNK 256
+#endif
+
+#ifndef MOONLIGHT_SYMBOL_SHARDS
+#define MOONLIGHT_SYMBOL_SHARDS 64
+#endif
+
+#ifndef MOONLIGHT_SYMBOL_CHUNK_SIZE
+#define MOONLIGHT_SYMBOL_CHUNK_SIZE 16384
+#endif
+
+#ifndef MOONLIGHT_UNICODE_CHUNK_SIZE
+#define MOONLIGHT_UNICODE_CHUNK_SIZE 4096
+#endif
+
+#ifndef MOONLIGHT_SUBPROCESS_READ_BUFSIZE
+#define MOONLIGHT_SUBPROCESS_READ_BUFSIZE 65536
+#endif
+
+#ifndef MOONLIGHT_SUBPROCESS_MAX_EVENTS
+#define MOONLIGHT_SUBPROCESS_MAX_EVENTS 64
+#endif
+
+#ifndef MOONLIGHT_BENCH_WARMUP_MS
+#define MOONLIGHT_BENCH_WARMUP_MS 100
+#endif
+
+#ifndef MOONLIGHT_BENCH_SAMPLE_MS
+#define MOONLIGHT_BENCH_SAMPLE_MS 10
+#endif
+
+#ifndef MOONLIGHT_BENCH_SAMPLES
+#define MOONLIGHT_BENCH_SAMPLES 30
+#endif
+
+#ifndef MOONLIGHT_CURSES_FRAME_MS
+#define MOONLIGHT_CURSES_FRAME_MS 33
+#endif
+
+#ifndef MOONLIGHT_RNG_BUFSIZE
+#define MOONLIGHT_RNG_BUFSIZE 1024
+#endif
+
+#ifndef MOONLIGHT_PAR_MIN_CHUNK
+#define MOONLIGHT_PAR_MIN_CHUNK 2048
+#endif
+
+#ifndef MOONLIGHT_PAR_CHUNKS_PER_THREAD
+#define MOONLIGHT_PAR_CHUNKS_PER_THREAD 4
+#endif
+
+#ifndef MOONLIGHT_METRICS_SHARDS
+#define MOONLIGHT_METRICS_SHARDS 16
+#endif
+
+#ifndef MOONLIGHT_METRICS_HISTOGRAM_SUB_BITS
+#define MOONLIGHT_METRICS_HISTOGRAM_SUB_BITS 2
+#endif
+
+#ifndef MOONLIGHT_ALLOC_ARENA_CHUNK
+#define MOONLIGHT_ALLOC_ARENA_CHUNK 4096
+#endif
+
+#ifndef MOONLIGHT_ALLOC_ARENA_MAX_CHUNK
+#define MOONLIGHT_ALLOC_ARENA_MAX_CHUNK 1048576
+#endif
+
+#ifndef MOONLIGHT_ALLOC_POOL_CHUNK
+#define MOONLIGHT_ALLOC_POOL_CHUNK 65536
+#endif
+
+#ifndef MOONLIGHT_ALLOC_POOL_BATCH
+#define MOONLIGHT_ALLOC_POOL_BATCH 64
+#endif
+
+#ifndef MOONLIGHT_ALLOC_POOL_MAX_SIZE
+#define MOONLIGHT_ALLOC_POOL_MAX_SIZE 256
+#endif
+
 #endif /* !__MOONLIGHT_CONSTANTS_H */
@@ -14,7 +14,10 @@
  * First, initialize `ncurses` by calling the `curses::init()` method.  This
  * method makes some assumptions, namely that you intend to use `ncurses` in an
  * "immediate" mode style, i.e. with unbuffered keyboard input and no terminal
- * echo.  This is useful for building TUIs and CLI based games.
+ * echo.  This is useful for building TUIs and CLI based games.  It also sets
+ * the locale from the environment, so that UTF-8 text drawn into windows is
+ * shown correctly.  Link with the wide-character `ncursesw` and `panelw`
+ * libraries.
  *
  * You probably also want to call `curses::init_color()`, as this will
  * initialize color rendering in `ncurses` and define a useful preset of
@@ -26,6 +29,38 @@
  * than `y` and then `x`.  This is mainly communicated via an `XY` struct with
  * `x` and `y` integer components.
  *
+ * ## Rendering -----------------------------------------------------
+ * Draw into a `Panel` only when what it shows has changed, and let a
+ * `curses::Renderer` bring the terminal up to date.  Each frame it copies
+ * every panel into the virtual screen with `wnoutrefresh()` and sends the
+ * result to the terminal with a single `doupdate()`.  When no panel has been
+ * drawn into, damaged, moved, or restacked since the last frame, it skips
+ * the frame entirely, so an idle interface costs almost nothing.
+ *
+ * `Panel::damage(rect)` marks an area of a panel, in its own coordinates, as
+ * needing to be redrawn on the terminal even though its contents were not
+ * changed through `curses`, e.g. after another program wrote to the terminal.
+ *
+ * `Renderer::run(update)` is a frame-paced main loop built on a
+ * `time::posix::Timer`.  It calls `update()` once per frame, which should
+ * handle input and draw whatever changed, and then sleeps until the next
+ * frame.  The loop ends when `update()` returns `false`.
+ *
+ * ```
+ * curses::Renderer renderer;
+ * renderer.run([&]() {
+ *     int key = getch();
+ *     if (key == 'q') {
+ *         return false;
+ *     }
+ *     if (stats.changed()) {
+ *         panel->win().go(1, 1);
+ *         panel->win().draw(stats.summary());
+ *     }
+ *     return true;
+ * });
+ * ```
+ *
  * TODO: Add more documentation around `Window`, `Panel` and how input is
  * received from the mouse and keyboard.
  */
@@ -36,16 +71,27 @@
 #include <curses.h>
 #include <panel.h>
 
+#include <algorithm>
 #include <climits>
+#include <clocale>
 #include <functional>
 #include <optional>
 #include <string>
 #include <memory>
+#include <thread>
+#include <type_traits>
 
+#include "moonlight/constants.h"
 #include "moonlight/exceptions.h"
+#include "moonlight/geometry.h"
 #include "moonlight/posix.h"
 
 namespace moonlight {
+
+namespace layout {
+class TextLayout;
+}
+
 namespace curses {
 
 using moonlight::time::posix::get_ticks;
@@ -53,6 +99,15 @@ using moonlight::time::posix::get_ticks;
 // ------------------------------------------------------------------
 const int MAX_KEYCODE = 410;
 
+namespace _panel {
+
+// Counts the times a panel was created, moved, restacked, or deleted, which
+// changes what is visible beneath it even if nothing was drawn.  Each
+// `Renderer` compares this against the count it last rendered.
+inline uint64_t restack_count = 0;
+
+}  // namespace _panel
+
 // ------------------------------------------------------------------
 struct XY {
     int x;
@@ -90,6 +145,7 @@ inline void cleanup() {
 
 // ------------------------------------------------------------------
 inline void init() {
+    setlocale(LC_ALL, "");
     initscr();
     atexit(cleanup);
     cbreak();
@@ -268,6 +324,29 @@ class Window {
          wclear(raw_ptr());
      }
 
+     /**
+      * Whether anything was drawn into the window since it was last copied
+      * to the virtual screen.
+      */
+     bool touched() const {
+         return is_wintouched(_window);
+     }
+
+     void touch() {
+         touchwin(_window);
+     }
+
+     /**
+      * Mark the lines covered by `rect`, in window coordinates, as changed.
+      */
+     void touch(const geo::Rect<int>& rect) {
+         int y0 = std::max(rect.pos.y, 0);
+         int y1 = std::min(rect.pos.y + rect.sz.h, sz().y);
+         if (y1 > y0) {
+             wtouchln(_window, y0, y1 - y0, 1);
+         }
+     }
+
      void draw(const std::string& chars, int attr = A_NORMAL) {
          wattrset(raw_ptr(), attr);
          for (char c : chars) {
@@ -276,6 +355,26 @@ class Window {
          wattrset(raw_ptr(), A_NORMAL);
      }
 
+     /**
+      * Draw the wrapped lines of `text` starting at `first_line` from the
+      * cursor position down to the bottom of the window.  Only the visible
+      * lines are visited.  This is only available when `layout.h` is also
+      * included, so that `curses.h` itself doesn't depend on utfcpp.
+      */
+     template<class Layout>
+     requires std::is_same_v<Layout, layout::TextLayout>
+     void draw(Layout& text, size_t first_line = 0, int attr = A_NORMAL) {
+         XY origin = where();
+         size_t rows = std::max(sz().y - origin.y, 0);
+         wattrset(raw_ptr(), attr);
+         int y = origin.y;
+         for (auto line : text.lines(first_line, rows)) {
+             wmove(raw_ptr(), y++, origin.x);
+             waddnstr(raw_ptr(), line.data(), line.size());
+         }
+         wattrset(raw_ptr(), A_NORMAL);
+     }
+
      void carousel(const std::string& chars, bool forward = true, int interval = 250) {
          for (size_t x = 0; x < chars.length(); x++) {
              if (forward) {
@@ -317,6 +416,15 @@ class Panel : public std::enable_shared_from_this<Panel> {
 
      ~Panel() {
          del_panel(raw_ptr());
+         _panel::restack_count++;
+     }
+
+     /**
+      * Get the `Panel` that owns a raw `PANEL` pointer, or `nullptr` if it
+      * isn't owned by a `Panel`.
+      */
+     static Panel* from_raw_ptr(PANEL* panel) {
+         return static_cast<Panel*>(const_cast<void*>(panel_userptr(panel)));
      }
 
      const Window& cwin() const {
@@ -333,6 +441,7 @@ class Panel : public std::enable_shared_from_this<Panel> {
 
      std::shared_ptr<Panel> pos(const XY& pos_) {
          move_panel(raw_ptr(), pos_.y, pos_.x);
+         _panel::restack_count++;
          return shared_from_this();
      }
 
@@ -342,6 +451,7 @@ class Panel : public std::enable_shared_from_this<Panel> {
 
      std::shared_ptr<Panel> center(const Window& window) {
          win().center(window);
+         _panel::restack_count++;
          return shared_from_this();
      }
 
@@ -351,10 +461,60 @@ class Panel : public std::enable_shared_from_this<Panel> {
 
      void to_top() {
          top_panel(raw_ptr());
+         _panel::restack_count++;
      }
 
      void to_bottom() {
          bottom_panel(raw_ptr());
+         _panel::restack_count++;
+     }
+
+     /**
+      * Mark the whole panel as needing to be redrawn on the terminal.
+      */
+     void damage() {
+         damage(geo::Rect<int>(sz().x, sz().y));
+     }
+
+     /**
+      * Mark an area of the panel, in panel coordinates, as needing to be
+      * redrawn on the terminal.  Damaged areas accumulate into their
+      * bounding rectangle until the next frame is rendered.
+      */
+     void damage(const geo::Rect<int>& rect) {
+         if (! _damage.has_value()) {
+             _damage = rect;
+             return;
+         }
+
+         int x0 = std::min(_damage->pos.x, rect.pos.x);
+         int y0 = std::min(_damage->pos.y, rect.pos.y);
+         int x1 = std::max(_damage->pos.x + _damage->sz.w, rect.pos.x + rect.sz.w);
+         int y1 = std::max(_damage->pos.y + _damage->sz.h, rect.pos.y + rect.sz.h);
+         _damage = geo::Rect<int>(x0, y0, x1 - x0, y1 - y0);
+     }
+
+     const std::optional<geo::Rect<int>>& damaged() const {
+         return _damage;
+     }
+
+     /**
+      * Whether the panel needs to be copied to the terminal, either because
+      * it was drawn into or because an area of it was damaged.
+      */
+     bool dirty() const {
+         return _damage.has_value() || cwin().touched();
+     }
+
+     /**
+      * Touch the damaged area of the window so that `curses` will copy it to
+      * the screen, and forget it.
+      */
+     void apply_damage() {
+         if (_damage.has_value()) {
+             win().touch(*_damage);
+             _damage.reset();
+         }
      }
 
      PANEL* raw_ptr() {
@@ -364,10 +524,108 @@ class Panel : public std::enable_shared_from_this<Panel> {
  private:
      void init_own_panel() {
          _panel = new_panel(win().raw_ptr());
+         set_panel_userptr(_panel, this);
+         _panel::restack_count++;
      }
 
      Window _win;
      PANEL* _panel;
+     std::optional<geo::Rect<int>> _damage;
+};
+
+// ------------------------------------------------------------------
+class Renderer {
+ public:
+     explicit Renderer(uint64_t frame_ms = MOONLIGHT_CURSES_FRAME_MS)
+     : _timer(time::posix::create_timer(frame_ms)) { }
+
+     /**
+      * Whether anything visible changed since the last frame.
+      */
+     bool dirty() const {
+         if (_restack_count != _panel::restack_count || is_wintouched(stdscr)) {
+             return true;
+         }
+
+         for (PANEL* panel = panel_above(nullptr); panel != nullptr; panel = panel_above(panel)) {
+             Panel* owner = Panel::from_raw_ptr(panel);
+             if (owner == nullptr ? is_wintouched(panel_window(panel)) : owner->dirty()) {
+                 return true;
+             }
+         }
+
+         return false;
+     }
+
+     /**
+      * Force the next frame to redraw the whole terminal, e.g. after it was
+      * resized or another program wrote to it.
+      */
+     void invalidate() {
+         clearok(curscr, TRUE);
+         _restack_count.reset();
+     }
+
+     /**
+      * Render a frame if anything changed, or if `force` is true.  Returns
+      * whether a frame was rendered.
+      */
+     bool refresh(bool force = false) {
+         if (! force && ! dirty()) {
+             _skipped++;
+             return false;
+         }
+
+         for (PANEL* panel = panel_above(nullptr); panel != nullptr; panel = panel_above(panel)) {
+             Panel* owner = Panel::from_raw_ptr(panel);
+             if (owner != nullptr) {
+                 owner->apply_damage();
+             }
+         }
+
+         update_panels();
+         doupdate();
+         _restack_count = _panel::restack_count;
+         _frames++;
+         return true;
+     }
+
+     /**
+      * Call `update()` once per frame and render the frame if anything
+      * changed, sleeping between frames, until `update()` returns false.
+      */
+     void run(std::function<bool()> update) {
+         _timer->start();
+         for (;;) {
+             if (! update()) {
+                 break;
+             }
+             refresh();
+             std::this_thread::sleep_for(std::chrono::milliseconds(_timer->wait_time()));
+             _timer->update();
+         }
+         _timer->pause();
+     }
+
+     /**
+      * The number of frames rendered.
+      */
+     uint64_t frames() const {
+         return _frames;
+     }
+
+     /**
+      * The number of frames skipped because nothing changed.
+      */
+     uint64_t skipped() const {
+         return _skipped;
+     }
+
+ private:
+     std::shared_ptr<time::posix::Timer> _timer;
+     std::optional<uint64_t> _restack_count;
+     uint64_t _frames = 0;
+     uint64_t _skipped = 0;
 };
 
 }  // namespace curses
@@ -20,7 +20,9 @@
  * by Python's `datetime` and Java 8's `java.time`.
  *
  * Any operations that would result in the creation of an invalid date or time
- * object will result in `core::ValueError` being thrown.
+ * object will result in `core::ValueError` being thrown.  The parsing functions
+ * `strptime()` and `from_isoformat()` of `Date` and `Datetime` have `try_`
+ * variants which instead return a `core::Result` holding the parse error.
  *
  * The main classes of this library are the following:
  *
@@ -48,6 +50,7 @@
 #include <string>
 
 #include "moonlight/exceptions.h"
+#include "moonlight/result.h"
 #include "date/date.h"
 
 #ifndef MOONLIGHT_TZ_UNSAFE
@@ -222,7 +225,7 @@ class Zone {
          return result;
      }
 
-     struct tm strptime(const std::string& format, const std::string& dt_str) const {
+     core::Result<struct tm> try_strptime(const std::string& format, const std::string& dt_str) const {
 #ifndef MOONLIGHT_TZ_UNSAFE
          std::lock_guard<std::mutex> lock(mutex());
 #endif
@@ -231,13 +234,24 @@ class Zone {
          struct tm tm_dt;
          ::memset(&tm_dt, 0, sizeof(tm_dt));
          tm_dt.tm_isdst = -1;  // Determine if daylight savings should apply.
-         if (::strptime(dt_str.c_str(), format.c_str(), &tm_dt) == nullptr) {
-             THROW(core::ValueError, "Date string \"" + dt_str + "\" does not match format \"" + format + ".");
-         }
+         const char* end = ::strptime(dt_str.c_str(), format.c_str(), &tm_dt);
          set_env_tz(env_tz);
+         if (end == nullptr) {
+             return core::Error{
+                 core::ErrorCode::SYNTAX_ERROR,
+                 "Date string \"" + dt_str + "\" does not match format \"" + format + "\"."};
+         }
          return tm_dt;
      }
 
+     struct tm strptime(const std::string& format, const std::string& dt_str) const {
+         auto result = try_strptime(format, dt_str);
+         if (! result) {
+             THROW(core::ValueError, result.error().message);
+         }
+         return *result;
+     }
+
  private:
      Zone() : _tz_name({}) { }
 
@@ -483,14 +497,36 @@ class Date {
      Date(const struct tm& tm_dt)
      : Date(tm_dt.tm_year + 1900, tm_dt.tm_mon + 1, tm_dt.tm_mday) { }
 
+     static bool is_valid(int year, Month month, int day) {
+         return day >= 1 && day <= last_day_of_month(year, month);
+     }
+
+     static core::Result<Date> try_strptime(const std::string& date_str,
+                                            const std::string& format = DATE_FORMAT) {
+         auto tm_date = Zone::utc().try_strptime(format, date_str);
+         if (! tm_date) {
+             return tm_date.error();
+         }
+         if (struct_tm_is_empty(*tm_date)) {
+             return core::Error{
+                 core::ErrorCode::SYNTAX_ERROR,
+                 "Could not parse Date from \"" + date_str + "\" with format string \"" + format + "\"."};
+         }
+         if (! is_valid(tm_date->tm_year + 1900, static_cast<Month>(tm_date->tm_mon), tm_date->tm_mday)) {
+             return core::Error{
+                 core::ErrorCode::OUT_OF_RANGE,
+                 "Day is out of range in Date \"" + date_str + "\"."};
+         }
+         return Date(*tm_date);
+     }
+
      static Date strptime(const std::string& date_str,
                           const std::string& format = DATE_FORMAT) {
-         auto tm_date = Zone::utc().strptime(format, date_str);
-         if (struct_tm_is_empty(tm_date)) {
-             THROW(core::ValueError,
-                   "Could not parse Date from \"" + date_str + "\" with format string \"" + format + "\".");
+         auto result = try_strptime(date_str, format);
+         if (! result) {
+             THROW(core::ValueError, result.error().message);
          }
-         return Date(tm_date);
+         return *result;
      }
 
      static Date today(const Zone& tz = Zone::utc()) {
@@ -498,6 +534,10 @@ class Date {
                      std::chrono::system_clock::now().time_since_epoch())));
      }
 
+     static core::Result<Date> try_from_isoformat(const std::string& iso_date) {
+         return try_strptime(iso_date, DATE_FORMAT);
+     }
+
      static Date from_isoformat(const std::string& iso_date) {
          return strptime(iso_date, DATE_FORMAT);
      }
@@ -942,15 +982,33 @@ class Datetime {
                  std::chrono::system_clock::now().time_since_epoch()));
      }
 
+     static core::Result<Datetime> try_strptime(const std::string& dt_str,
+                                                const std::string& format = DATETIME_FORMAT,
+                                                const Zone& tz = Zone::utc()) {
+         auto tm_dt = tz.try_strptime(format, dt_str);
+         if (! tm_dt) {
+             return tm_dt.error();
+         }
+         if (struct_tm_is_empty(*tm_dt)) {
+             return core::Error{
+                 core::ErrorCode::SYNTAX_ERROR,
+                 "Could not parse Datetime from \"" + dt_str + "\" using format string \"" + format + "\"."};
+         }
+         return Datetime(tz, ::date::floor<Millis>(std::chrono::seconds{tz.mk_timestamp(*tm_dt)}));
+     }
+
      static Datetime strptime(const std::string& dt_str,
                               const std::string& format = DATETIME_FORMAT,
                               const Zone& tz = Zone::utc()) {
-         auto tm_dt = tz.strptime(format, dt_str);
-         if (struct_tm_is_empty(tm_dt)) {
-             THROW(core::ValueError,
-                   "Could not parse Datetime from \"" + dt_str + "\" using format string \"" + format + "\".");
+         auto result = try_strptime(dt_str, format, tz);
+         if (! result) {
+             THROW(core::ValueError, result.error().message);
          }
-         return Datetime(tz, ::date::floor<Millis>(std::chrono::seconds{tz.mk_timestamp(tm_dt)}));
+         return *result;
+     }
+
+     static core::Result<Datetime> try_from_isoformat(const std::string& iso_dt_str) {
+         return try_strptime(iso_dt_str, DATETIME_8601_UTC, Zone::utc());
      }
 
      static Datetime from_isoformat(const std::string& iso_dt_str) {
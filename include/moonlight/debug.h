@@ -9,9 +9,12 @@
  * ## Dependencies --------------------------------------------------
  * This library has runtime dependencies in order to utilize it fully:
  *
- * - The executable needs to be compiled with debugging symbols, i.e. `-g`.
- * - The `addr2line` utility needs to be available in order to locate the
- *   filename and line offset of stack frames.
+ * - The executable needs to be compiled with debugging symbols, i.e. `-g`, in
+ *   order to locate the filename and line offset of stack frames.  These are
+ *   read in-process from the DWARF line tables of the executable and loaded
+ *   shared objects via `elf.h`, and cached per frame address.
+ * - The `addr2line` utility is only needed if the executable's debug sections
+ *   are compressed, e.g. with `-gz`.
  * - Your compiler must support `abi::__cxa_demangle()` in order to demangle C++
  *   symbols into their class and member parts.
  */
@@ -20,18 +23,28 @@
 #define __MOONLIGHT_DEBUG_H
 
 #include <cxxabi.h>
+#include <dlfcn.h>
+#include <link.h>
 #include <unistd.h>
 #include <execinfo.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
-#include <algorithm>
 
 #include "moonlight/constants.h"
 #include "moonlight/collect.h"
+#include "moonlight/elf.h"
 #include "moonlight/finally.h"
 #include "moonlight/string.h"
 
@@ -151,7 +164,7 @@ inline std::string demangle(const std::string& name) {
     });
 
     int status;
-    fname_buffer = abi::__cxa_demangle(fname_buffer, nullptr, nullptr, &status);
+    fname_buffer = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
 
     if (status == 0) {
         return std::string(fname_buffer);
@@ -160,6 +173,45 @@ inline std::string demangle(const std::string& name) {
     return name;
 }
 
+/* ------------------------------------------------------------------
+ * A value computed on first use, which is safe to request from many
+ * threads at once.  If two threads race to compute it, the first result
+ * stored is kept and returned to both.  Copies share the computed value.
+ */
+template<class T>
+class Lazy {
+ public:
+     Lazy() { }
+     explicit Lazy(T value) : _value(std::make_shared<const T>(std::move(value))) { }
+     Lazy(const Lazy& other) : _value(other._value.load()) { }
+
+     Lazy& operator=(const Lazy& other) {
+         _value.store(other._value.load());
+         return *this;
+     }
+
+     template<class F>
+     const T& get(F&& compute) const {
+         auto value = _value.load();
+         if (value == nullptr) {
+             auto computed = std::make_shared<const T>(compute());
+             if (_value.compare_exchange_strong(value, computed)) {
+                 value = computed;
+             }
+         }
+         // The stored value is never replaced while `this` is const, so the
+         // reference outlives the local shared pointer.
+         return *value;
+     }
+
+     void reset() {
+         _value.store(nullptr);
+     }
+
+ private:
+     mutable std::atomic<std::shared_ptr<const T>> _value;
+};
+
 // Forward declarations ---------------------------------------------
 class Source;
 
@@ -228,7 +280,10 @@ class BacktraceSymbol {
          }
 
          if (function_name.size() > 0) {
-             function_name = demangle(function_name) + "()";
+             function_name = demangle(function_name);
+             if (! function_name.ends_with(")")) {
+                 function_name += "()";
+             }
          }
 
          if (offset_hex.size() > 0) {
@@ -349,7 +404,7 @@ class Source {
                              sources.push_back(Source(source_path, function_name, line_number));
 
                          } else {
-                             symbols[z / 2].function_name(function_name);
+                             symbols[x + z / 2].function_name(function_name);
                              sources.push_back({});
                          }
 
@@ -424,6 +479,154 @@ class StackInfo {
      Source _source;
 };
 
+namespace _debug {
+
+/* ------------------------------------------------------------------
+ * Resolves stack frames in-process using `dladdr1()` and the symbol and
+ * line tables of the loaded images, caching the result for each frame
+ * address for the life of the process.
+ */
+class FrameCache {
+ public:
+     static FrameCache& instance() {
+         // Never destroyed, so traces may be resolved during static
+         // destruction.
+         static FrameCache* cache = new FrameCache();
+         return *cache;
+     }
+
+     std::vector<StackInfo> resolve(std::span<const BacktraceFrame> frames) {
+         std::vector<StackInfo> stack_infos;
+         std::vector<size_t> misses;
+
+         {
+             std::shared_lock lock(_mutex);
+             for (auto frame : frames) {
+                 auto iter = _cache.find(frame);
+                 if (iter != _cache.end()) {
+                     stack_infos.push_back(iter->second);
+                 } else {
+                     misses.push_back(stack_infos.size());
+                     stack_infos.push_back(StackInfo(BacktraceSymbol(frame, "", "", "", 0), {}));
+                 }
+             }
+         }
+
+         if (misses.empty()) {
+             return stack_infos;
+         }
+
+         // Frames in images whose line table can't be decoded, e.g. because
+         // the debug sections are compressed, are left to `addr2line`.
+         std::vector<size_t> fallbacks;
+         std::vector<BacktraceSymbol> fallback_symbols;
+         for (size_t x : misses) {
+             bool use_addr2line = false;
+             stack_infos[x] = _resolve(frames[x], use_addr2line);
+             if (use_addr2line) {
+                 fallbacks.push_back(x);
+                 fallback_symbols.push_back(stack_infos[x].symbol());
+             }
+         }
+
+         if (! fallbacks.empty()) {
+             auto sources = Source::from_backtrace_symbols(fallback_symbols);
+             for (size_t x = 0; x < fallbacks.size() && x < sources.size(); x++) {
+                 stack_infos[fallbacks[x]] = StackInfo(fallback_symbols[x], sources[x]);
+             }
+         }
+
+         std::unique_lock lock(_mutex);
+         for (size_t x : misses) {
+             _cache.emplace(frames[x], stack_infos[x]);
+         }
+         return stack_infos;
+     }
+
+     size_t size() const {
+         std::shared_lock lock(_mutex);
+         return _cache.size();
+     }
+
+ private:
+     FrameCache() { }
+
+     const elf::Image* _image(const fs::path& path) {
+         std::lock_guard lock(_images_mutex);
+         auto iter = _images.find(path.string());
+         if (iter == _images.end()) {
+             iter = _images.emplace(path.string(), elf::Image::open(path)).first;
+         }
+         return iter->second.get();
+     }
+
+     StackInfo _resolve(BacktraceFrame frame, bool& use_addr2line) {
+         Dl_info info;
+         struct link_map* map = nullptr;
+
+         if (dladdr1(frame, &info, (void**)&map, RTLD_DL_LINKMAP) == 0 || map == nullptr) {
+             return StackInfo(BacktraceSymbol(frame, "", "", "", 0), {});
+         }
+
+         fs::path module_path = map->l_name;
+         bool is_executable = module_path.empty();
+         if (is_executable) {
+             module_path = get_executable_path();
+         }
+
+         // Frames are return addresses, so the call itself is found by
+         // looking up the address just before.
+         uint64_t offset = (uintptr_t)frame - map->l_addr;
+         uint64_t address = offset > 0 ? offset - 1 : 0;
+
+         const elf::Image* image = _image(module_path);
+         std::string function_name;
+
+         if (image != nullptr) {
+             auto symbol = image->find_symbol(address);
+             if (symbol) {
+                 function_name = demangle(std::string(symbol->name));
+             }
+         }
+         if (function_name.empty() && info.dli_sname != nullptr) {
+             function_name = demangle(info.dli_sname);
+         }
+         if (! function_name.empty() && ! function_name.ends_with(")")) {
+             function_name += "()";
+         }
+
+         std::ostringstream raw;
+         raw << module_path.string() << "(+0x" << std::hex << offset << ") [" << frame << "]";
+         BacktraceSymbol symbol(frame, raw.str(), module_path, function_name, offset);
+
+         Source source;
+         if (image != nullptr) {
+             auto line = image->find_line(address);
+             if (line) {
+                 source = Source(line->path, function_name, line->line);
+             }
+             use_addr2line = (is_executable && image->line_table() == elf::LineTable::UNSUPPORTED);
+         }
+
+         return StackInfo(symbol, source);
+     }
+
+     mutable std::shared_mutex _mutex;
+     std::unordered_map<BacktraceFrame, StackInfo> _cache;
+
+     std::mutex _images_mutex;
+     std::unordered_map<std::string, std::unique_ptr<elf::Image>> _images;
+};
+
+}  // namespace _debug
+
+/* ------------------------------------------------------------------
+ * Resolve the given stack frames to symbols and source locations.
+ */
+inline std::vector<StackInfo> resolve_frames(std::span<const BacktraceFrame> frames) {
+    return _debug::FrameCache::instance().resolve(frames);
+}
+
 // ----------------------------------------------------------------------------
 class StackTrace {
  public:
@@ -431,19 +634,36 @@ class StackTrace {
      explicit StackTrace(const Source& where)
      : _where(where) { }
      explicit StackTrace(const std::vector<StackInfo>& stack_infos, Source where = {})
-     : _where(where), _stack_infos(stack_infos) {
-         chop_to_where();
-     }
+     : _where(where), _stack_infos(chopped(stack_infos)) { }
 
+     /**
+      * Capture the raw frame addresses of the current stack.  Symbols and
+      * source locations are resolved only when the trace is first examined.
+      */
      static StackTrace generate(Source where = {}, size_t skip_frames = 2) {
-         auto frames = backtrace_frames(skip_frames);
-         auto symbols = BacktraceSymbol::parse_frames(frames);
-         auto stack_infos = StackInfo::parse_symbols(symbols);
-         return StackTrace(stack_infos, where);
+         StackTrace trace(where);
+         void* frames[MOONLIGHT_STACKTRACE_MAX_FRAMES];
+         size_t total_frames = backtrace(frames, MOONLIGHT_STACKTRACE_MAX_FRAMES);
+         if (total_frames > skip_frames) {
+             trace._frame_count = total_frames - skip_frames;
+             std::copy(frames + skip_frames, frames + total_frames, trace._frames.begin());
+         }
+         return trace;
      }
 
      const std::vector<StackInfo>& stack() const {
-         return _stack_infos;
+         return _stack_infos.get([this]() {
+             std::vector<StackInfo> stack_infos;
+             if (_frame_count > 0) {
+                 stack_infos = resolve_frames(frames());
+                 chop_to_where(stack_infos);
+             }
+             return stack_infos;
+         });
+     }
+
+     std::span<BacktraceFrame const> frames() const {
+         return {_frames.data(), _frame_count};
      }
 
      const Source& where() const {
@@ -451,7 +671,7 @@ class StackTrace {
      }
 
      bool contains_where() const {
-         return find_where() != _stack_infos.end();
+         return find_where(stack()) != stack().end();
      }
 
      const void format(std::ostream& out, const std::string& prefix = "") const {
@@ -480,14 +700,14 @@ class StackTrace {
      }
 
  private:
-     std::vector<StackInfo>::const_iterator find_where() const {
-         auto iter = _stack_infos.begin();
+     std::vector<StackInfo>::const_iterator find_where(const std::vector<StackInfo>& stack_infos) const {
+         auto iter = stack_infos.begin();
 
          if (_where.is_nowhere()) {
-             return _stack_infos.end();
+             return stack_infos.end();
          }
 
-         for (; iter != _stack_infos.end(); iter++) {
+         for (; iter != stack_infos.end(); iter++) {
              if (iter->source().file() == _where.file() &&
                  iter->source().line_number() == _where.line_number()) {
                  break;
@@ -497,16 +717,24 @@ class StackTrace {
          return iter;
      }
 
-     void chop_to_where() {
-         auto iter = find_where();
+     void chop_to_where(std::vector<StackInfo>& stack_infos) const {
+         auto iter = find_where(stack_infos);
 
-         if (iter != _stack_infos.end()) {
-             _stack_infos.erase(_stack_infos.begin(), iter);
+         if (iter != stack_infos.end()) {
+             stack_infos.erase(stack_infos.begin(), iter);
          }
      }
 
+     Lazy<std::vector<StackInfo>> chopped(std::vector<StackInfo> stack_infos) const {
+         chop_to_where(stack_infos);
+         return Lazy<std::vector<StackInfo>>(std::move(stack_infos));
+     }
+
      Source _where;
-     std::vector<StackInfo> _stack_infos;
+     std::array<BacktraceFrame, MOONLIGHT_STACKTRACE_MAX_FRAMES> _frames;
+     size_t _frame_count = 0;
+     // Resolved on first use and shared between copies of the trace.
+     Lazy<std::vector<StackInfo>> _stack_infos;
 };
 
 }  // namespace debug
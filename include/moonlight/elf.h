@@ -0,0 +1,811 @@
+/*
+ * ## elf.h: Symbol and line lookup in ELF images. ------------------
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * ## Usage ---------------------------------------------------------
+ * This library offers `elf::Image`, a read-only view of an ELF executable or
+ * shared object, used by `debug.h` to resolve stack frames in-process instead
+ * of by running `addr2line`.
+ *
+ * ```
+ * auto image = elf::Image::open("/proc/self/exe");
+ * if (image) {
+ *     auto symbol = image->find_symbol(address);
+ *     auto line = image->find_line(address);
+ * }
+ * ```
+ *
+ * - `elf::Image::open(path)`: Map the given file into memory and index its
+ *   function symbols.  Returns `nullptr` if the file can't be read or isn't
+ *   an ELF image for the host architecture.
+ * - `find_symbol(addr)`: Find the function symbol containing the given
+ *   link-time address, using `.symtab` or, for stripped images, `.dynsym`.
+ * - `find_line(addr)`: Find the source file and line number of the given
+ *   link-time address using the DWARF line table in `.debug_line`.  The line
+ *   table is decoded the first time this is called.
+ * - `line_table()`: Whether the image has a line table, and if so, whether it
+ *   could be decoded.  DWARF versions 2 through 5 are supported, but
+ *   compressed debug sections and separate debug info files are not.
+ *
+ * Addresses are link-time virtual addresses, i.e. runtime addresses less the
+ * load bias of the image, which can be found via `dladdr1()` or
+ * `dl_iterate_phdr()`.  None of these methods throw, so that they may be used
+ * while reporting other errors.
+ */
+
+#ifndef __MOONLIGHT_ELF_H
+#define __MOONLIGHT_ELF_H
+
+#include <elf.h>
+#include <fcntl.h>
+#include <link.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace moonlight {
+namespace elf {
+
+namespace fs = std::filesystem;
+
+namespace _elf {
+
+/**
+ * A bounds-checked cursor over little-endian DWARF data.  Reading past the
+ * end sets `ok` to false and yields zeroes rather than failing outright.
+ */
+struct Reader {
+    const uint8_t* pos;
+    const uint8_t* end;
+    bool ok = true;
+
+    Reader(const uint8_t* begin, const uint8_t* end) : pos(begin), end(end) { }
+
+    bool at_end() const {
+        return pos >= end;
+    }
+
+    bool skip(uint64_t n) {
+        if (n > (uint64_t)(end - pos)) {
+            pos = end;
+            ok = false;
+            return false;
+        }
+        pos += n;
+        return true;
+    }
+
+    template<class T>
+    T fixed() {
+        T value = 0;
+        if (sizeof(T) > (size_t)(end - pos)) {
+            pos = end;
+            ok = false;
+            return value;
+        }
+        memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    uint64_t sized(size_t size) {
+        switch (size) {
+        case 1:
+            return fixed<uint8_t>();
+        case 2:
+            return fixed<uint16_t>();
+        case 4:
+            return fixed<uint32_t>();
+        case 8:
+            return fixed<uint64_t>();
+        default:
+            ok = false;
+            return 0;
+        }
+    }
+
+    uint64_t uleb() {
+        uint64_t value = 0;
+        for (int shift = 0; pos < end; shift += 7) {
+            uint8_t byte = *pos++;
+            if (shift < 64) {
+                value |= (uint64_t)(byte & 0x7f) << shift;
+            }
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        ok = false;
+        return value;
+    }
+
+    int64_t sleb() {
+        int64_t value = 0;
+        int shift = 0;
+        uint8_t byte = 0;
+        do {
+            if (pos >= end) {
+                ok = false;
+                return value;
+            }
+            byte = *pos++;
+            if (shift < 64) {
+                value |= (int64_t)(byte & 0x7f) << shift;
+            }
+            shift += 7;
+        } while (byte & 0x80);
+
+        if (shift < 64 && (byte & 0x40)) {
+            value |= -((int64_t)1 << shift);
+        }
+        return value;
+    }
+
+    std::string_view cstr() {
+        auto nul = (const uint8_t*)memchr(pos, 0, end - pos);
+        if (nul == nullptr) {
+            pos = end;
+            ok = false;
+            return {};
+        }
+        std::string_view s((const char*)pos, nul - pos);
+        pos = nul + 1;
+        return s;
+    }
+};
+
+/**
+ * A row of the decoded line table.  Rows which end a sequence mark the first
+ * address past its end and carry no file.
+ */
+struct LineRow {
+    static constexpr uint32_t END_SEQUENCE = UINT32_MAX;
+
+    uint64_t address;
+    uint32_t file;
+    int32_t line;
+};
+
+// DWARF constants used by the line table decoder.
+enum : uint8_t {
+    DW_LNS_copy = 1,
+    DW_LNS_advance_pc = 2,
+    DW_LNS_advance_line = 3,
+    DW_LNS_set_file = 4,
+    DW_LNS_const_add_pc = 8,
+    DW_LNS_fixed_advance_pc = 9,
+
+    DW_LNE_end_sequence = 1,
+    DW_LNE_set_address = 2,
+    DW_LNE_define_file = 3,
+
+    DW_LNCT_path = 1,
+    DW_LNCT_directory_index = 2,
+
+    DW_FORM_block2 = 0x03,
+    DW_FORM_block4 = 0x04,
+    DW_FORM_data2 = 0x05,
+    DW_FORM_data4 = 0x06,
+    DW_FORM_data8 = 0x07,
+    DW_FORM_string = 0x08,
+    DW_FORM_block = 0x09,
+    DW_FORM_block1 = 0x0a,
+    DW_FORM_data1 = 0x0b,
+    DW_FORM_sdata = 0x0d,
+    DW_FORM_strp = 0x0e,
+    DW_FORM_udata = 0x0f,
+    DW_FORM_data16 = 0x1e,
+    DW_FORM_line_strp = 0x1f,
+};
+
+}  // namespace _elf
+
+/**------------------------------------------------------------------
+ * A function symbol found in an image.
+ */
+struct SymbolInfo {
+    std::string_view name;
+    uint64_t address;
+    uint64_t size;
+};
+
+/**------------------------------------------------------------------
+ * A source location found in the line table of an image.
+ */
+struct LineInfo {
+    const fs::path& path;
+    int line;
+};
+
+enum class LineTable {
+    ABSENT,
+    LOADED,
+    UNSUPPORTED
+};
+
+/**------------------------------------------------------------------
+ * A memory-mapped ELF executable or shared object.
+ */
+class Image {
+ public:
+     ~Image() {
+         if (_data != nullptr) {
+             munmap((void*)_data, _size);
+         }
+     }
+
+     Image(const Image&) = delete;
+     Image& operator=(const Image&) = delete;
+
+     static std::unique_ptr<Image> open(const fs::path& path) noexcept {
+         int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+         if (fd < 0) {
+             return nullptr;
+         }
+
+         struct stat st;
+         void* data = MAP_FAILED;
+         if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(ElfW(Ehdr))) {
+             data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+         }
+         ::close(fd);
+
+         if (data == MAP_FAILED) {
+             return nullptr;
+         }
+
+         try {
+             std::unique_ptr<Image> image(new Image((const uint8_t*)data, st.st_size));
+             if (! image->_index()) {
+                 return nullptr;
+             }
+             return image;
+
+         } catch (...) {
+             return nullptr;
+         }
+     }
+
+     std::optional<SymbolInfo> find_symbol(uint64_t address) const noexcept {
+         auto iter = std::upper_bound(_symbols.begin(), _symbols.end(), address,
+                                      [](uint64_t addr, const SymbolInfo& sym) {
+                                          return addr < sym.address;
+                                      });
+         if (iter == _symbols.begin()) {
+             return {};
+         }
+         iter--;
+
+         // Symbols without a size are assumed to extend to the next symbol.
+         if (iter->size > 0 && address >= iter->address + iter->size) {
+             return {};
+         }
+         return *iter;
+     }
+
+     std::optional<LineInfo> find_line(uint64_t address) const noexcept {
+         if (line_table() != LineTable::LOADED) {
+             return {};
+         }
+
+         auto iter = std::upper_bound(_rows.begin(), _rows.end(), address,
+                                      [](uint64_t addr, const _elf::LineRow& row) {
+                                          return addr < row.address;
+                                      });
+         if (iter == _rows.begin()) {
+             return {};
+         }
+         iter--;
+
+         if (iter->file == _elf::LineRow::END_SEQUENCE) {
+             return {};
+         }
+         return LineInfo{_files[iter->file], iter->line};
+     }
+
+     LineTable line_table() const noexcept {
+         std::call_once(_rows_loaded, [this]() {
+             try {
+                 _line_table = _load_line_table();
+             } catch (...) {
+                 _rows.clear();
+                 _line_table = LineTable::UNSUPPORTED;
+             }
+         });
+         return _line_table;
+     }
+
+ private:
+     Image(const uint8_t* data, size_t size) : _data(data), _size(size) { }
+
+     struct Section {
+         const uint8_t* data = nullptr;
+         size_t size = 0;
+         uint32_t link = 0;
+         bool compressed = false;
+
+         explicit operator bool() const {
+             return data != nullptr;
+         }
+
+         _elf::Reader reader() const {
+             return _elf::Reader(data, data + size);
+         }
+     };
+
+     bool _index() {
+         auto ehdr = (const ElfW(Ehdr)*)_data;
+         if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0
+             || ehdr->e_ident[EI_CLASS] != (sizeof(void*) == 8 ? ELFCLASS64 : ELFCLASS32)
+             || ehdr->e_ident[EI_DATA] != ELFDATA2LSB
+             || ehdr->e_shentsize != sizeof(ElfW(Shdr))
+             || ehdr->e_shoff == 0
+             || ehdr->e_shoff + (uint64_t)ehdr->e_shnum * sizeof(ElfW(Shdr)) > _size
+             || ehdr->e_shstrndx >= ehdr->e_shnum) {
+             return false;
+         }
+
+         _sections = (const ElfW(Shdr)*)(_data + ehdr->e_shoff);
+         _section_count = ehdr->e_shnum;
+         _shstrtab = _section(ehdr->e_shstrndx);
+
+         Section symtab = _find_section(".symtab");
+         if (! symtab) {
+             symtab = _find_section(".dynsym");
+         }
+         if (symtab && symtab.link < _section_count) {
+             _index_symbols(symtab, _section(symtab.link));
+         }
+
+         _debug_line = _find_section(".debug_line");
+         _debug_line_str = _find_section(".debug_line_str");
+         _debug_str = _find_section(".debug_str");
+         return true;
+     }
+
+     Section _section(size_t index) const {
+         Section section;
+         const auto& shdr = _sections[index];
+         if (shdr.sh_type != SHT_NOBITS && shdr.sh_offset + shdr.sh_size <= _size) {
+             section.data = _data + shdr.sh_offset;
+             section.size = shdr.sh_size;
+             section.link = shdr.sh_link;
+             section.compressed = shdr.sh_flags & SHF_COMPRESSED;
+         }
+         return section;
+     }
+
+     Section _find_section(std::string_view name) const {
+         for (size_t x = 0; x < _section_count; x++) {
+             size_t offset = _sections[x].sh_name;
+             if (offset >= _shstrtab.size) {
+                 continue;
+             }
+             auto s = (const char*)_shstrtab.data + offset;
+             if (strnlen(s, _shstrtab.size - offset) == name.size()
+                 && name.compare(0, name.size(), s, name.size()) == 0) {
+                 return _section(x);
+             }
+         }
+         return {};
+     }
+
+     void _index_symbols(const Section& symtab, const Section& strtab) {
+         auto syms = (const ElfW(Sym)*)symtab.data;
+         size_t count = symtab.size / sizeof(ElfW(Sym));
+
+         for (size_t x = 0; x < count; x++) {
+             const auto& sym = syms[x];
+             int type = ELF64_ST_TYPE(sym.st_info);
+             if ((type != STT_FUNC && type != STT_GNU_IFUNC)
+                 || sym.st_shndx == SHN_UNDEF || sym.st_value == 0
+                 || sym.st_name >= strtab.size) {
+                 continue;
+             }
+             auto name = (const char*)strtab.data + sym.st_name;
+             _symbols.push_back({
+                 {name, strnlen(name, strtab.size - sym.st_name)},
+                 sym.st_value, sym.st_size});
+         }
+
+         // Prefer the sized, and then the global, of several symbols at the
+         // same address, e.g. a function and its local alias.
+         std::sort(_symbols.begin(), _symbols.end(), [](const auto& a, const auto& b) {
+             if (a.address != b.address) {
+                 return a.address < b.address;
+             }
+             return a.size > b.size;
+         });
+         _symbols.erase(std::unique(_symbols.begin(), _symbols.end(), [](const auto& a, const auto& b) {
+             return a.address == b.address;
+         }), _symbols.end());
+     }
+
+     LineTable _load_line_table() const {
+         if (! _debug_line) {
+             return LineTable::ABSENT;
+         }
+         if (_debug_line.compressed) {
+             return LineTable::UNSUPPORTED;
+         }
+
+         auto reader = _debug_line.reader();
+         while (! reader.at_end()) {
+             if (! _load_unit(reader)) {
+                 _rows.clear();
+                 _files.clear();
+                 return LineTable::UNSUPPORTED;
+             }
+         }
+
+         // At a shared address, the end of one sequence sorts before the
+         // start of the next so that lookups land on the latter.
+         std::stable_sort(_rows.begin(), _rows.end(), [](const auto& a, const auto& b) {
+             if (a.address != b.address) {
+                 return a.address < b.address;
+             }
+             return a.file == _elf::LineRow::END_SEQUENCE && b.file != _elf::LineRow::END_SEQUENCE;
+         });
+         return LineTable::LOADED;
+     }
+
+     std::optional<std::string_view> _read_string(_elf::Reader& reader, uint64_t form, bool dwarf64) const {
+         const Section* strings = nullptr;
+
+         switch (form) {
+         case _elf::DW_FORM_string:
+             return reader.cstr();
+         case _elf::DW_FORM_line_strp:
+             strings = &_debug_line_str;
+             break;
+         case _elf::DW_FORM_strp:
+             strings = &_debug_str;
+             break;
+         default:
+             return {};
+         }
+
+         uint64_t offset = reader.sized(dwarf64 ? 8 : 4);
+         if (! *strings || strings->compressed || offset >= strings->size) {
+             return {};
+         }
+         auto s = (const char*)strings->data + offset;
+         return std::string_view(s, strnlen(s, strings->size - offset));
+     }
+
+     bool _skip_form(_elf::Reader& reader, uint64_t form, bool dwarf64) const {
+         switch (form) {
+         case _elf::DW_FORM_data1:
+             return reader.skip(1);
+         case _elf::DW_FORM_data2:
+             return reader.skip(2);
+         case _elf::DW_FORM_data4:
+             return reader.skip(4);
+         case _elf::DW_FORM_data8:
+             return reader.skip(8);
+         case _elf::DW_FORM_data16:
+             return reader.skip(16);
+         case _elf::DW_FORM_udata:
+             reader.uleb();
+             return reader.ok;
+         case _elf::DW_FORM_sdata:
+             reader.sleb();
+             return reader.ok;
+         case _elf::DW_FORM_block:
+             return reader.skip(reader.uleb());
+         case _elf::DW_FORM_block1:
+             return reader.skip(reader.fixed<uint8_t>());
+         case _elf::DW_FORM_block2:
+             return reader.skip(reader.fixed<uint16_t>());
+         case _elf::DW_FORM_block4:
+             return reader.skip(reader.fixed<uint32_t>());
+         case _elf::DW_FORM_string:
+             reader.cstr();
+             return reader.ok;
+         case _elf::DW_FORM_strp:
+         case _elf::DW_FORM_line_strp:
+             return reader.skip(dwarf64 ? 8 : 4);
+         default:
+             return false;
+         }
+     }
+
+     std::optional<uint64_t> _read_index(_elf::Reader& reader, uint64_t form) const {
+         switch (form) {
+         case _elf::DW_FORM_data1:
+         case _elf::DW_FORM_data2:
+         case _elf::DW_FORM_data4:
+         case _elf::DW_FORM_data8:
+             return reader.sized(form == _elf::DW_FORM_data1 ? 1 :
+                                 form == _elf::DW_FORM_data2 ? 2 :
+                                 form == _elf::DW_FORM_data4 ? 4 : 8);
+         case _elf::DW_FORM_udata:
+             return reader.uleb();
+         default:
+             return {};
+         }
+     }
+
+     /**
+      * Read a DWARF 5 directory or file name table, as a list of paths and
+      * directory indices.
+      */
+     bool _read_entries(_elf::Reader& reader, bool dwarf64,
+                        std::vector<std::pair<std::string_view, uint64_t>>& entries) const {
+         uint8_t format_count = reader.fixed<uint8_t>();
+         std::vector<std::pair<uint64_t, uint64_t>> formats;
+         for (int x = 0; x < format_count; x++) {
+             uint64_t content = reader.uleb();
+             uint64_t form = reader.uleb();
+             formats.push_back({content, form});
+         }
+
+         uint64_t count = reader.uleb();
+         for (uint64_t x = 0; x < count && reader.ok; x++) {
+             std::pair<std::string_view, uint64_t> entry = {{}, 0};
+             for (auto [content, form] : formats) {
+                 if (content == _elf::DW_LNCT_path) {
+                     auto s = _read_string(reader, form, dwarf64);
+                     if (! s) {
+                         return false;
+                     }
+                     entry.first = *s;
+
+                 } else if (content == _elf::DW_LNCT_directory_index) {
+                     auto index = _read_index(reader, form);
+                     if (! index) {
+                         return false;
+                     }
+                     entry.second = *index;
+
+                 } else if (! _skip_form(reader, form, dwarf64)) {
+                     return false;
+                 }
+             }
+             entries.push_back(entry);
+         }
+         return reader.ok;
+     }
+
+     bool _load_unit(_elf::Reader& reader) const {
+         bool dwarf64 = false;
+         uint64_t unit_length = reader.fixed<uint32_t>();
+         if (unit_length == 0xffffffff) {
+             dwarf64 = true;
+             unit_length = reader.fixed<uint64_t>();
+         }
+         if (! reader.ok || unit_length > (uint64_t)(reader.end - reader.pos)) {
+             return false;
+         }
+
+         _elf::Reader unit(reader.pos, reader.pos + unit_length);
+         reader.skip(unit_length);
+
+         uint16_t version = unit.fixed<uint16_t>();
+         if (version < 2 || version > 5) {
+             return false;
+         }
+         if (version >= 5) {
+             unit.fixed<uint8_t>();  // address_size
+             unit.fixed<uint8_t>();  // segment_selector_size
+         }
+
+         uint64_t header_length = unit.sized(dwarf64 ? 8 : 4);
+         if (! unit.ok || header_length > (uint64_t)(unit.end - unit.pos)) {
+             return false;
+         }
+         const uint8_t* program = unit.pos + header_length;
+
+         uint8_t min_inst_length = unit.fixed<uint8_t>();
+         if (version >= 4) {
+             unit.fixed<uint8_t>();  // maximum_operations_per_instruction
+         }
+         unit.fixed<uint8_t>();  // default_is_stmt
+         int8_t line_base = unit.fixed<int8_t>();
+         uint8_t line_range = unit.fixed<uint8_t>();
+         uint8_t opcode_base = unit.fixed<uint8_t>();
+         if (line_range == 0 || opcode_base == 0) {
+             return false;
+         }
+
+         std::vector<uint8_t> opcode_lengths(opcode_base, 0);
+         for (int x = 1; x < opcode_base; x++) {
+             opcode_lengths[x] = unit.fixed<uint8_t>();
+         }
+
+         // Resolve file names against their directories up front, assigning
+         // each an index into `_files`.
+         std::vector<uint32_t> file_ids;
+         std::vector<std::string> dirs;
+         auto add_file = [&](std::string_view name, uint64_t dir) {
+             fs::path path(name);
+             if (path.is_relative() && dir < dirs.size()) {
+                 path = fs::path(dirs[dir]) / path;
+             }
+             file_ids.push_back(_files.size());
+             _files.push_back(path);
+         };
+
+         if (version >= 5) {
+             std::vector<std::pair<std::string_view, uint64_t>> entries;
+             if (! _read_entries(unit, dwarf64, entries)) {
+                 return false;
+             }
+             for (const auto& entry : entries) {
+                 dirs.push_back(std::string(entry.first));
+             }
+             // Relative directories are relative to the compilation
+             // directory, which is directory 0.
+             for (size_t x = 1; x < dirs.size(); x++) {
+                 if (fs::path(dirs[x]).is_relative()) {
+                     dirs[x] = (fs::path(dirs[0]) / dirs[x]).string();
+                 }
+             }
+
+             entries.clear();
+             if (! _read_entries(unit, dwarf64, entries)) {
+                 return false;
+             }
+             for (const auto& entry : entries) {
+                 add_file(entry.first, entry.second);
+             }
+
+         } else {
+             // Directory 0 is the compilation directory, which is only
+             // recorded in `.debug_info`, so paths relative to it are left
+             // as they are.
+             dirs.push_back({});
+             for (;;) {
+                 auto dir = unit.cstr();
+                 if (dir.empty() || ! unit.ok) {
+                     break;
+                 }
+                 dirs.push_back(std::string(dir));
+             }
+             // Files are numbered from 1.
+             file_ids.push_back(_elf::LineRow::END_SEQUENCE);
+             for (;;) {
+                 auto name = unit.cstr();
+                 if (name.empty() || ! unit.ok) {
+                     break;
+                 }
+                 uint64_t dir = unit.uleb();
+                 unit.uleb();  // modification time
+                 unit.uleb();  // file length
+                 add_file(name, dir);
+             }
+         }
+
+         if (! unit.ok) {
+             return false;
+         }
+         unit.pos = program;
+
+         // Run the line number program, recording one row per emitted
+         // address.  Sequences placed at address 0 were discarded by the
+         // linker and are dropped.
+         uint64_t address = 0;
+         uint64_t file = 1;
+         int64_t line = 1;
+         size_t sequence_start = _rows.size();
+
+         auto emit = [&](bool end_sequence) {
+             uint32_t id = _elf::LineRow::END_SEQUENCE;
+             if (! end_sequence && file < file_ids.size()) {
+                 id = file_ids[file];
+             }
+             if (! end_sequence && id == _elf::LineRow::END_SEQUENCE) {
+                 return;
+             }
+             _rows.push_back({address, id, (int32_t)line});
+         };
+
+         auto end_sequence = [&]() {
+             if (sequence_start < _rows.size() && _rows[sequence_start].address == 0) {
+                 _rows.resize(sequence_start);
+             } else {
+                 emit(true);
+             }
+             sequence_start = _rows.size();
+             address = 0;
+             file = 1;
+             line = 1;
+         };
+
+         while (! unit.at_end() && unit.ok) {
+             uint8_t opcode = unit.fixed<uint8_t>();
+
+             if (opcode >= opcode_base) {
+                 int adjusted = opcode - opcode_base;
+                 address += (adjusted / line_range) * min_inst_length;
+                 line += line_base + (adjusted % line_range);
+                 emit(false);
+                 continue;
+             }
+
+             switch (opcode) {
+             case 0: {
+                 uint64_t length = unit.uleb();
+                 if (length == 0 || length > (uint64_t)(unit.end - unit.pos)) {
+                     return false;
+                 }
+                 const uint8_t* next = unit.pos + length;
+                 uint8_t sub_opcode = unit.fixed<uint8_t>();
+                 if (sub_opcode == _elf::DW_LNE_end_sequence) {
+                     end_sequence();
+                 } else if (sub_opcode == _elf::DW_LNE_set_address) {
+                     address = unit.sized(length - 1);
+                 } else if (sub_opcode == _elf::DW_LNE_define_file) {
+                     auto name = unit.cstr();
+                     uint64_t dir = unit.uleb();
+                     add_file(name, dir);
+                 }
+                 unit.pos = next;
+                 break;
+             }
+             case _elf::DW_LNS_copy:
+                 emit(false);
+                 break;
+             case _elf::DW_LNS_advance_pc:
+                 address += unit.uleb() * min_inst_length;
+                 break;
+             case _elf::DW_LNS_advance_line:
+                 line += unit.sleb();
+                 break;
+             case _elf::DW_LNS_set_file:
+                 file = unit.uleb();
+                 break;
+             case _elf::DW_LNS_const_add_pc:
+                 address += ((255 - opcode_base) / line_range) * min_inst_length;
+                 break;
+             case _elf::DW_LNS_fixed_advance_pc:
+                 address += unit.fixed<uint16_t>();
+                 break;
+             default:
+                 // Other standard opcodes, e.g. `DW_LNS_set_column`, only
+                 // take ULEB128 operands which aren't needed here.
+                 for (int x = 0; x < opcode_lengths[opcode]; x++) {
+                     unit.uleb();
+                 }
+                 break;
+             }
+         }
+
+         return unit.ok;
+     }
+
+     const uint8_t* _data;
+     size_t _size;
+     const ElfW(Shdr)* _sections = nullptr;
+     size_t _section_count = 0;
+     Section _shstrtab;
+     Section _debug_line;
+     Section _debug_line_str;
+     Section _debug_str;
+     std::vector<SymbolInfo> _symbols;
+
+     mutable std::once_flag _rows_loaded;
+     mutable LineTable _line_table = LineTable::ABSENT;
+     mutable std::vector<_elf::LineRow> _rows;
+     mutable std::vector<fs::path> _files;
+};
+
+}  // namespace elf
+}  // namespace moonlight
+
+#endif /* !__MOONLIGHT_ELF_H */
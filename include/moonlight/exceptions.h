@@ -73,6 +73,7 @@
 
 
 #include "moonlight/debug.h"
+#include "moonlight/format.h"
 #include "moonlight/string.h"
 #include "moonlight/constants.h"
 #include "moonlight/finally.h"
@@ -93,9 +94,7 @@ class Exception : public std::runtime_error {
 #else
      _stacktrace(where)
 #endif
-     {
-         _full_message = full_message();
-     }
+     { }
 
      Exception(const Exception& e) : std::runtime_error(e.message().c_str()) {
          _type = e._type;
@@ -104,7 +103,6 @@ class Exception : public std::runtime_error {
          if (e._cause != nullptr) {
              _cause = new Exception(*e._cause);
          }
-         _full_message = full_message();
      }
 
      virtual ~Exception() {
@@ -113,8 +111,29 @@ class Exception : public std::runtime_error {
          }
      }
 
+     Exception& operator=(const Exception& e) {
+         if (this != &e) {
+             std::runtime_error::operator=(e);
+             _type = e._type;
+             _message = e._message;
+             _stacktrace = e._stacktrace;
+             delete _cause;
+             _cause = e._cause != nullptr ? new Exception(*e._cause) : nullptr;
+             _full_message.reset();
+         }
+         return *this;
+     }
+
+     /**
+      * The full message is only formatted, and the stack trace only
+      * symbolized, the first time it is requested.  Exceptions which are
+      * caught and handled without being described cost no more than capturing
+      * the raw stack frames.
+      */
      virtual const char* what() const throw() {
-         return _full_message.c_str();
+         return _full_message.get([this]() {
+             return full_message();
+         }).c_str();
      }
 
      const std::string& type() const {
@@ -150,9 +169,7 @@ class Exception : public std::runtime_error {
      }
 
      std::string type_and_message() const {
-         std::ostringstream sb;
-         sb << type() << ": " << message();
-         return sb.str();
+         return fmt::format("{}: {}", type(), message());
      }
 
      const std::string& message() const {
@@ -160,11 +177,11 @@ class Exception : public std::runtime_error {
      }
 
      Exception& caused_by(const Exception& cause) {
+         if (_cause != nullptr) {
+             delete _cause;
+         }
          _cause = new Exception(cause);
-#ifdef MOONLIGHT_STACKTRACE_IN_DESCRIPTION
-         // Need to update _full_message to reflect the cause.
-         this->_full_message = full_message();
-#endif
+         _full_message.reset();
          return *this;
      }
 
@@ -183,7 +200,7 @@ class Exception : public std::runtime_error {
  private:
      std::string _type;
      std::string _message;
-     std::string _full_message;
+     debug::Lazy<std::string> _full_message;
      moonlight::debug::StackTrace _stacktrace;
      Exception* _cause = nullptr;
 };
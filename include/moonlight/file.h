@@ -39,6 +39,7 @@
  *   Provides the current location in the output stream as a `file::Location`
  *   via `location()`.  Extremely useful in the construction of look-ahead
  *   parsers that wish to read from an input stream rather than a byte buffer.
+ *   Input arriving in chunks can be pushed to it with `append()`.
  */
 #ifndef __MOONLIGHT_FILE_H
 #define __MOONLIGHT_FILE_H
@@ -50,6 +51,7 @@
 
 #include "moonlight/exceptions.h"
 #include "moonlight/nanoid.h"
+#include "moonlight/symbol.h"
 
 namespace moonlight {
 namespace file {
@@ -59,7 +61,7 @@ struct Location {
     unsigned int line = 1;
     unsigned int col = 1;
     unsigned int offset = 0;
-    std::string name = "";
+    str::Symbol name;
 
     static Location nowhere() {
         return {
@@ -88,10 +90,8 @@ inline std::ifstream open_r(const std::string& filename,
         return infile;
 
     } catch (std::exception& e) {
-        std::ostringstream sb;
-        sb << "Cannot open file " << filename << " for reading: "
-        << strerror(errno);
-        THROW(core::RuntimeError, sb.str());
+        THROW(core::RuntimeError, fmt::format("Cannot open file {} for reading: {}",
+                                              filename, strerror(errno)));
     }
 }
 
@@ -106,10 +106,8 @@ inline std::ofstream open_w(const std::string& filename,
         return outfile;
 
     } catch (std::exception& e) {
-        std::ostringstream sb;
-        sb << "Cannot open file " << filename << " for writing: "
-        << strerror(errno);
-        THROW(core::RuntimeError, sb.str());
+        THROW(core::RuntimeError, fmt::format("Cannot open file {} for writing: {}",
+                                              filename, strerror(errno)));
     }
 }
 
@@ -124,10 +122,8 @@ inline std::fstream open_rw(const std::string& filename,
         return outfile;
 
     } catch (std::exception& e) {
-        std::ostringstream sb;
-        sb << "Cannot open file " << filename << " for reading and writing: "
-        << strerror(errno);
-        THROW(core::RuntimeError, sb.str());
+        THROW(core::RuntimeError, fmt::format("Cannot open file {} for reading and writing: {}",
+                                              filename, strerror(errno)));
     }
 }
 
@@ -258,6 +254,19 @@ class BufferedInput {
          return _exhausted;
      }
 
+     /**
+      * Append `size` bytes to the buffer, to be read after anything already
+      * buffered and before the rest of the input stream.
+      */
+     void append(const char* data, size_t size) {
+         for (size_t x = 0; x < size; x++) {
+             _buffer.push_back(static_cast<unsigned char>(data[x]));
+         }
+         if (size > 0) {
+             _exhausted = false;
+         }
+     }
+
      int peek(size_t offset = 1) {
          if (offset == 0) {
              return EOF;
@@ -319,8 +328,8 @@ class BufferedInput {
          return dump;
      }
 
-     const std::string& name() const {
-         return _loc.name;
+     std::string_view name() const {
+         return _loc.name.view();
      }
 
      int line() const {
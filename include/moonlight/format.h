@@ -0,0 +1,766 @@
+/*
+ * ## format.h: Fast, compile-time checked string formatting. -------
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * ## Usage ---------------------------------------------------------
+ * This library offers a lightweight alternative to `std::ostringstream` and
+ * `tinyformat` for building strings.  Format strings use the same `{}`
+ * replacement field syntax as `std::format`, and are parsed and checked
+ * against the argument types at compile time.  Values are written directly
+ * into a `fmt::Buffer`, which stores up to `MOONLIGHT_FMT_INLINE_BUFSIZE`
+ * bytes on the stack before spilling over to the heap, and numbers are
+ * converted using `std::to_chars`.
+ *
+ * ```
+ * std::string s = fmt::format("{} items in {:.2f}s", count, elapsed);
+ * fmt::print(std::cout, "{:>8} | {:08x}\n", name, flags);
+ * ```
+ *
+ * The following are defined in the `moonlight::fmt` namespace:
+ *
+ * - `fmt::format(f, ...)`: Format the arguments according to the format string
+ *   `f` and return the result as an `std::string`.
+ * - `fmt::format_to(buf, f, ...)`: Same as `fmt::format()`, but appends the
+ *   result to the given `fmt::Buffer` instead.
+ * - `fmt::print(out, f, ...)`: Same as `fmt::format()`, but writes the result
+ *   to the given `std::ostream` in a single write.
+ * - `fmt::cat(v, ...)`: Concatenate the default representations of each of
+ *   the given values into a string.  This backs `str::cat()`.
+ * - `fmt::write(buf, v, spec={})`: Append the representation of a single
+ *   value to a `fmt::Buffer`.
+ * - `fmt::write_default(buf, v)`: Append the default representation of a
+ *   single value, which matches `operator<<`: booleans are written as `1` or
+ *   `0`, and `int8_t` and `uint8_t` as characters.  `fmt::cat()` uses this.
+ * - `fmt::Buffer`: A growable, stack-first character buffer.
+ * - `fmt::Formatter<T>`: Specialize this template with a static
+ *   `write(fmt::Buffer&, const T&)` method to control how values of type `T`
+ *   are formatted.  Types without a `Formatter` specialization are written
+ *   using their `operator<<` if one exists, or as their type name enclosed in
+ *   angle brackets otherwise.
+ *
+ * Replacement fields are filled from the arguments in order, positional
+ * indices such as `{0}` are not supported.  Literal braces are written as
+ * `{{` and `}}`.  A replacement field may contain a format spec following a
+ * colon, of the form `{:[[fill]align][0][width][.precision][type]}`:
+ *
+ * - `align`: One of `<` (left), `>` (right), or `^` (center).  Numbers are
+ *   right aligned by default, everything else is left aligned.  Width is
+ *   measured in bytes.
+ * - `0`: Pad numbers with zeroes after the sign instead of the fill character.
+ * - `precision`: Digits after the decimal point for `f` and `e`, significant
+ *   digits for `g` and untyped floats, or the maximum length of a string.
+ * - `type`: `d`, `x`, `X`, `o`, `b`, or `c` for integers, `f`, `F`, `e`, `E`,
+ *   `g`, or `G` for floating point values, `s` for strings and booleans, and
+ *   `p` for pointers.
+ *
+ * Floating point values without a type or precision are formatted like `%g`,
+ * matching the default behavior of `std::ostream`.
+ */
+
+#ifndef __MOONLIGHT_FORMAT_H
+#define __MOONLIGHT_FORMAT_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "moonlight/constants.h"
+#include "moonlight/traits.h"
+
+namespace moonlight {
+namespace fmt {
+
+/**------------------------------------------------------------------
+ * A growable character buffer which keeps its first
+ * `MOONLIGHT_FMT_INLINE_BUFSIZE` bytes on the stack.
+ */
+class Buffer {
+ public:
+     Buffer() : _data(_inline), _capacity(sizeof(_inline)) { }
+     Buffer(const Buffer&) = delete;
+     Buffer& operator=(const Buffer&) = delete;
+
+     ~Buffer() {
+         if (! is_inline()) {
+             delete[] _data;
+         }
+     }
+
+     void push_back(char c) {
+         reserve(_size + 1);
+         _data[_size++] = c;
+     }
+
+     void append(const char* s, size_t n) {
+         reserve(_size + n);
+         std::memcpy(_data + _size, s, n);
+         _size += n;
+     }
+
+     void append(std::string_view s) {
+         append(s.data(), s.size());
+     }
+
+     void append(size_t n, char c) {
+         reserve(_size + n);
+         std::memset(_data + _size, c, n);
+         _size += n;
+     }
+
+     void insert(size_t offset, size_t n, char c) {
+         reserve(_size + n);
+         std::memmove(_data + offset + n, _data + offset, _size - offset);
+         std::memset(_data + offset, c, n);
+         _size += n;
+     }
+
+     /**
+      * Ensure there are at least `n` writable bytes at the end of the buffer
+      * and return a pointer to them.  Call `commit()` afterwards with the
+      * number of bytes actually written.
+      */
+     char* prepare(size_t n) {
+         reserve(_size + n);
+         return _data + _size;
+     }
+
+     void commit(size_t n) {
+         _size += n;
+     }
+
+     void reserve(size_t capacity) {
+         if (capacity > _capacity) {
+             grow(capacity);
+         }
+     }
+
+     void clear() {
+         _size = 0;
+     }
+
+     char& operator[](size_t offset) {
+         return _data[offset];
+     }
+
+     char operator[](size_t offset) const {
+         return _data[offset];
+     }
+
+     const char* data() const {
+         return _data;
+     }
+
+     size_t size() const {
+         return _size;
+     }
+
+     size_t capacity() const {
+         return _capacity;
+     }
+
+     bool is_inline() const {
+         return _data == _inline;
+     }
+
+     std::string_view view() const {
+         return std::string_view(_data, _size);
+     }
+
+     std::string str() const {
+         return std::string(_data, _size);
+     }
+
+ private:
+     void grow(size_t capacity) {
+         capacity = std::max(capacity, _capacity * 2);
+         char* data = new char[capacity];
+         std::memcpy(data, _data, _size);
+         if (! is_inline()) {
+             delete[] _data;
+         }
+         _data = data;
+         _capacity = capacity;
+     }
+
+     char* _data;
+     size_t _size = 0;
+     size_t _capacity;
+     char _inline[MOONLIGHT_FMT_INLINE_BUFSIZE];
+};
+
+/**------------------------------------------------------------------
+ * An `std::streambuf` which appends to a `fmt::Buffer`, used to
+ * format values through their `operator<<` without an intermediate string.
+ */
+class BufferStreambuf : public std::streambuf {
+ public:
+     explicit BufferStreambuf(Buffer& buf) : _buf(buf) { }
+
+ protected:
+     int_type overflow(int_type c) override {
+         if (! traits_type::eq_int_type(c, traits_type::eof())) {
+             _buf.push_back(traits_type::to_char_type(c));
+         }
+         return traits_type::not_eof(c);
+     }
+
+     std::streamsize xsputn(const char* s, std::streamsize n) override {
+         _buf.append(s, n);
+         return n;
+     }
+
+ private:
+     Buffer& _buf;
+};
+
+/**------------------------------------------------------------------
+ * Specialize this template with a static `write(Buffer&, const T&)`
+ * method to define how values of type `T` are formatted.
+ */
+template<class T>
+struct Formatter;
+
+// ------------------------------------------------------------------
+struct Spec {
+    char fill = ' ';
+    char align = '\0';
+    bool zero = false;
+    size_t width = 0;
+    int precision = -1;
+    char type = '\0';
+};
+
+namespace _format {
+
+enum class Kind {
+    NONE,
+    BOOL,
+    CHAR,
+    INTEGER,
+    FLOAT,
+    STRING,
+    POINTER,
+    CUSTOM
+};
+
+template<class T>
+constexpr Kind kind_of() {
+    typedef std::remove_cvref_t<T> U;
+
+    if constexpr (std::is_array_v<U> &&
+                  std::is_same_v<std::remove_cv_t<std::remove_extent_t<U>>, char>) {
+        return Kind::STRING;
+    } else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*> ||
+                         std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>) {
+        return Kind::STRING;
+    } else if constexpr (std::is_same_v<U, bool>) {
+        return Kind::BOOL;
+    } else if constexpr (std::is_same_v<U, char>) {
+        return Kind::CHAR;
+    } else if constexpr (std::is_integral_v<U>) {
+        return Kind::INTEGER;
+    } else if constexpr (std::is_floating_point_v<U>) {
+        return Kind::FLOAT;
+    } else if constexpr (std::is_pointer_v<U> || std::is_null_pointer_v<U>) {
+        return Kind::POINTER;
+    } else {
+        return Kind::CUSTOM;
+    }
+}
+
+constexpr bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+constexpr bool is_align(char c) {
+    return c == '<' || c == '>' || c == '^';
+}
+
+constexpr bool is_type(char c) {
+    return std::string_view("bcdeEfFgGopsxX").find(c) != std::string_view::npos;
+}
+
+/**
+ * Parse the replacement field beginning with the `{` at `offset`.
+ *
+ * @return The offset of the closing `}`, or `npos` if the field is malformed.
+ */
+constexpr size_t parse_field(std::string_view f, size_t offset, Spec& spec) {
+    size_t x = offset + 1;
+
+    if (x < f.size() && f[x] == '}') {
+        return x;
+    }
+
+    if (x >= f.size() || f[x] != ':') {
+        return std::string_view::npos;
+    }
+    x++;
+
+    if (x + 1 < f.size() && is_align(f[x + 1]) && f[x] != '}') {
+        spec.fill = f[x];
+        spec.align = f[x + 1];
+        x += 2;
+    } else if (x < f.size() && is_align(f[x])) {
+        spec.align = f[x];
+        x++;
+    }
+
+    if (x < f.size() && f[x] == '0') {
+        spec.zero = true;
+        x++;
+    }
+
+    for (; x < f.size() && is_digit(f[x]); x++) {
+        spec.width = spec.width * 10 + (f[x] - '0');
+    }
+
+    if (x < f.size() && f[x] == '.') {
+        x++;
+        if (x >= f.size() || ! is_digit(f[x])) {
+            return std::string_view::npos;
+        }
+        spec.precision = 0;
+        for (; x < f.size() && is_digit(f[x]); x++) {
+            spec.precision = spec.precision * 10 + (f[x] - '0');
+        }
+    }
+
+    if (x < f.size() && is_type(f[x])) {
+        spec.type = f[x];
+        x++;
+    }
+
+    if (x >= f.size() || f[x] != '}') {
+        return std::string_view::npos;
+    }
+
+    return x;
+}
+
+constexpr bool spec_allowed(Kind kind, const Spec& spec) {
+    std::string_view types;
+
+    switch (kind) {
+    case Kind::BOOL:
+    case Kind::STRING:
+        types = "s";
+        break;
+    case Kind::CHAR:
+    case Kind::INTEGER:
+        types = "bcdoxX";
+        break;
+    case Kind::FLOAT:
+        types = "eEfFgG";
+        break;
+    case Kind::POINTER:
+        types = "p";
+        break;
+    default:
+        break;
+    }
+
+    if (spec.type != '\0' && types.find(spec.type) == std::string_view::npos) {
+        return false;
+    }
+
+    if (spec.precision >= 0 && kind != Kind::FLOAT && kind != Kind::STRING) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Not `constexpr` on purpose: reaching a call to this function while
+ * checking a format string at compile time is a compile error, and the
+ * message argument shows up in the diagnostic.
+ */
+inline void invalid_format_string(const char* msg) {
+    (void) msg;
+}
+
+}  // namespace _format
+
+/**------------------------------------------------------------------
+ * A format string that has been checked at compile time against the
+ * types of the arguments `Args`.
+ */
+template<class... Args>
+class FormatString {
+ public:
+     template<class S>
+     requires std::is_convertible_v<const S&, std::string_view>
+     consteval FormatString(const S& s) : _str(s) {
+         check();
+     }
+
+     constexpr std::string_view view() const {
+         return _str;
+     }
+
+ private:
+     consteval void check() const {
+         constexpr _format::Kind kinds[] = {_format::kind_of<Args>()..., _format::Kind::NONE};
+         size_t arg = 0;
+
+         for (size_t x = 0; x < _str.size(); x++) {
+             if (_str[x] == '{') {
+                 if (x + 1 < _str.size() && _str[x + 1] == '{') {
+                     x++;
+                     continue;
+                 }
+
+                 Spec spec;
+                 size_t end = _format::parse_field(_str, x, spec);
+                 if (end == std::string_view::npos) {
+                     _format::invalid_format_string("Malformed replacement field.");
+                 }
+                 if (arg >= sizeof...(Args)) {
+                     _format::invalid_format_string("Not enough arguments for format string.");
+                 }
+                 if (! _format::spec_allowed(kinds[arg], spec)) {
+                     _format::invalid_format_string("Format spec is not valid for argument type.");
+                 }
+                 arg++;
+                 x = end;
+
+             } else if (_str[x] == '}') {
+                 if (x + 1 < _str.size() && _str[x + 1] == '}') {
+                     x++;
+                     continue;
+                 }
+                 _format::invalid_format_string("Unmatched '}' in format string.");
+             }
+         }
+
+         if (arg != sizeof...(Args)) {
+             _format::invalid_format_string("Too many arguments for format string.");
+         }
+     }
+
+     std::string_view _str;
+};
+
+namespace _format {
+
+template<class T>
+concept has_formatter = requires(Buffer& buf, const T& value) {
+    Formatter<T>::write(buf, value);
+};
+
+template<class T>
+concept has_ostream_operator = requires(std::ostream& out, const T& value) {
+    out << value;
+};
+
+inline void align(Buffer& buf, size_t start, const Spec& spec, bool numeric) {
+    size_t length = buf.size() - start;
+    if (spec.width <= length) {
+        return;
+    }
+    size_t padding = spec.width - length;
+
+    if (numeric && spec.zero && spec.align == '\0') {
+        if (length > 0 && (buf[start] == '-' || buf[start] == '+')) {
+            start++;
+        }
+        buf.insert(start, padding, '0');
+        return;
+    }
+
+    switch (spec.align != '\0' ? spec.align : (numeric ? '>' : '<')) {
+    case '<':
+        buf.append(padding, spec.fill);
+        break;
+    case '>':
+        buf.insert(start, padding, spec.fill);
+        break;
+    case '^':
+        buf.insert(start, padding / 2, spec.fill);
+        buf.append(padding - padding / 2, spec.fill);
+        break;
+    }
+}
+
+inline void to_upper(Buffer& buf, size_t start) {
+    for (size_t x = start; x < buf.size(); x++) {
+        if (buf[x] >= 'a' && buf[x] <= 'z') {
+            buf[x] = buf[x] - 'a' + 'A';
+        }
+    }
+}
+
+template<class T>
+inline void write_integer(Buffer& buf, T value, const Spec& spec) {
+    size_t start = buf.size();
+
+    if (spec.type == 'c') {
+        buf.push_back(static_cast<char>(value));
+        align(buf, start, spec, false);
+        return;
+    }
+
+    int base = 10;
+    switch (spec.type) {
+    case 'x':
+    case 'X':
+        base = 16;
+        break;
+    case 'o':
+        base = 8;
+        break;
+    case 'b':
+        base = 2;
+        break;
+    }
+
+    constexpr size_t max_digits = sizeof(T) * 8 + 1;
+    char* p = buf.prepare(max_digits);
+    auto result = std::to_chars(p, p + max_digits, value, base);
+    buf.commit(result.ptr - p);
+
+    if (spec.type == 'X') {
+        to_upper(buf, start);
+    }
+    align(buf, start, spec, true);
+}
+
+template<class T>
+inline void write_float(Buffer& buf, T value, const Spec& spec) {
+    size_t start = buf.size();
+    std::chars_format format = std::chars_format::general;
+    int precision = spec.precision >= 0 ? spec.precision : 6;
+
+    switch (spec.type) {
+    case 'f':
+    case 'F':
+        format = std::chars_format::fixed;
+        break;
+    case 'e':
+    case 'E':
+        format = std::chars_format::scientific;
+        break;
+    }
+
+    for (size_t size = MOONLIGHT_FMT_FLOAT_BUFSIZE;; size *= 2) {
+        char* p = buf.prepare(size);
+        auto result = std::to_chars(p, p + size, value, format, precision);
+        if (result.ec == std::errc()) {
+            buf.commit(result.ptr - p);
+            break;
+        }
+    }
+
+    if (spec.type == 'F' || spec.type == 'E' || spec.type == 'G') {
+        to_upper(buf, start);
+    }
+    align(buf, start, spec, true);
+}
+
+inline void write_string(Buffer& buf, std::string_view s, const Spec& spec) {
+    size_t start = buf.size();
+    if (spec.precision >= 0 && static_cast<size_t>(spec.precision) < s.size()) {
+        s = s.substr(0, spec.precision);
+    }
+    buf.append(s);
+    align(buf, start, spec, false);
+}
+
+inline void write_pointer(Buffer& buf, const void* ptr, const Spec& spec) {
+    size_t start = buf.size();
+    buf.append("0x", 2);
+    char* p = buf.prepare(sizeof(uintptr_t) * 2);
+    auto result = std::to_chars(p, p + sizeof(uintptr_t) * 2,
+                                reinterpret_cast<uintptr_t>(ptr), 16);
+    buf.commit(result.ptr - p);
+    align(buf, start, spec, false);
+}
+
+}  // namespace _format
+
+/**------------------------------------------------------------------
+ * Append the representation of a single value to the buffer.
+ */
+template<class T>
+inline void write(Buffer& buf, const T& value, const Spec& spec = {}) {
+    constexpr _format::Kind kind = _format::kind_of<T>();
+
+    if constexpr (kind == _format::Kind::STRING) {
+        _format::write_string(buf, std::string_view(value), spec);
+
+    } else if constexpr (kind == _format::Kind::BOOL) {
+        _format::write_string(buf, value ? "true" : "false", spec);
+
+    } else if constexpr (kind == _format::Kind::CHAR) {
+        if (spec.type == '\0' || spec.type == 'c') {
+            size_t start = buf.size();
+            buf.push_back(value);
+            _format::align(buf, start, spec, false);
+        } else {
+            _format::write_integer(buf, static_cast<int>(value), spec);
+        }
+
+    } else if constexpr (kind == _format::Kind::INTEGER) {
+        _format::write_integer(buf, value, spec);
+
+    } else if constexpr (kind == _format::Kind::FLOAT) {
+        _format::write_float(buf, value, spec);
+
+    } else if constexpr (kind == _format::Kind::POINTER) {
+        _format::write_pointer(buf, static_cast<const void*>(value), spec);
+
+    } else {
+        size_t start = buf.size();
+
+        if constexpr (_format::has_formatter<T>) {
+            Formatter<T>::write(buf, value);
+
+        } else if constexpr (_format::has_ostream_operator<T>) {
+            BufferStreambuf streambuf(buf);
+            std::ostream out(&streambuf);
+            out << value;
+
+        } else {
+            buf.push_back('<');
+            buf.append(type_name_view<T>());
+            buf.push_back('>');
+        }
+
+        _format::align(buf, start, spec, false);
+    }
+}
+
+/**------------------------------------------------------------------
+ * Append the value as `operator<<` would write it to a default
+ * `std::ostream`.  This is the same as `write()`, except that booleans are
+ * written as `1` or `0`, and `signed char` and `unsigned char`, e.g. `int8_t`
+ * and `uint8_t`, are written as characters rather than numbers.
+ */
+template<class T>
+inline void write_default(Buffer& buf, const T& value) {
+    typedef std::remove_cvref_t<T> U;
+
+    if constexpr (std::is_same_v<U, bool>) {
+        buf.push_back(value ? '1' : '0');
+    } else if constexpr (std::is_same_v<U, signed char> || std::is_same_v<U, unsigned char>) {
+        buf.push_back(static_cast<char>(value));
+    } else {
+        write(buf, value);
+    }
+}
+
+namespace _format {
+
+/**
+ * Walks a checked format string, copying literal text into the buffer
+ * and writing each argument into its replacement field.
+ */
+class Cursor {
+ public:
+     Cursor(Buffer& buf, std::string_view f) : _buf(buf), _f(f) { }
+
+     template<class T>
+     void next(const T& value) {
+         literal();
+         Spec spec;
+         _offset = parse_field(_f, _offset, spec) + 1;
+         write(_buf, value, spec);
+     }
+
+     void finish() {
+         literal();
+     }
+
+ private:
+     void literal() {
+         size_t start = _offset;
+
+         for (; _offset < _f.size(); _offset++) {
+             char c = _f[_offset];
+             if (c != '{' && c != '}') {
+                 continue;
+             }
+
+             _buf.append(_f.data() + start, _offset - start);
+             if (_offset + 1 < _f.size() && _f[_offset + 1] == c) {
+                 _buf.push_back(c);
+                 _offset++;
+                 start = _offset + 1;
+             } else {
+                 return;
+             }
+         }
+
+         _buf.append(_f.data() + start, _offset - start);
+     }
+
+     Buffer& _buf;
+     std::string_view _f;
+     size_t _offset = 0;
+};
+
+}  // namespace _format
+
+/**------------------------------------------------------------------
+ * Format the arguments into the given buffer.
+ */
+template<class... Args>
+inline void format_to(Buffer& buf, FormatString<std::type_identity_t<Args>...> f, const Args&... args) {
+    _format::Cursor cursor(buf, f.view());
+    (cursor.next(args), ...);
+    cursor.finish();
+}
+
+/**------------------------------------------------------------------
+ * Format the arguments into a new string.
+ */
+template<class... Args>
+inline std::string format(FormatString<std::type_identity_t<Args>...> f, const Args&... args) {
+    Buffer buf;
+    format_to<Args...>(buf, f, args...);
+    return buf.str();
+}
+
+/**------------------------------------------------------------------
+ * Format the arguments and write them to the given output stream.
+ */
+template<class... Args>
+inline void print(std::ostream& out, FormatString<std::type_identity_t<Args>...> f, const Args&... args) {
+    Buffer buf;
+    format_to<Args...>(buf, f, args...);
+    out.write(buf.data(), buf.size());
+}
+
+/**------------------------------------------------------------------
+ * Append the default representations of the values to the buffer.
+ */
+template<class... Args>
+inline void cat_to(Buffer& buf, const Args&... args) {
+    (write_default(buf, args), ...);
+}
+
+/**------------------------------------------------------------------
+ * Concatenate the default representations of the values into a string.
+ */
+template<class... Args>
+inline std::string cat(const Args&... args) {
+    Buffer buf;
+    cat_to(buf, args...);
+    return buf.str();
+}
+
+}  // namespace fmt
+}  // namespace moonlight
+
+#endif /* !__MOONLIGHT_FORMAT_H */
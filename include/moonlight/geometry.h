@@ -18,8 +18,11 @@
 #include <optional>
 #include <ostream>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
+#include "moonlight/traits.h"
+
 #ifndef MOONLIGHT_GEO_PRECISION
 #define MOONLIGHT_GEO_PRECISION 3
 #endif
@@ -81,18 +84,17 @@ class Vector2d {
 
      template<class R>
      Vector2d<R> as() const {
-         return Vector2d<R>(
-             static_cast<R>(x),
-             static_cast<R>(y)
-         );
-     }
-
-     template<>
-     Vector2d<int> as() const {
-         return Vector2d<int>(
-             static_cast<int>(x < 0 ? x - 0.5 : x + 0.5),
-             static_cast<int>(y < 0 ? y - 0.5 : y + 0.5)
-         );
+         if constexpr (std::is_same_v<R, int>) {
+             return Vector2d<int>(
+                 static_cast<int>(x < 0 ? x - 0.5 : x + 0.5),
+                 static_cast<int>(y < 0 ? y - 0.5 : y + 0.5)
+             );
+         } else {
+             return Vector2d<R>(
+                 static_cast<R>(x),
+                 static_cast<R>(y)
+             );
+         }
      }
 
      T angle_between(const Vector2d<T>& other) {
@@ -340,23 +342,23 @@ public:
 // ------------------------------------------------------------------
 template<class T = int>
 class Size2d {
+public:
     Size2d() : w(0), h(0) { }
     Size2d(const T& width, const T& height) : w(width), h(height) { }
 
     template<class R>
     Size2d<R> as() const {
-        return Size2d<R>(
-            static_cast<R>(w),
-            static_cast<R>(h)
-        );
-    }
-
-    template<>
-    Size2d<int> as() const {
-        return Size2d<int>(
-            static_cast<int>(w < 0 ? w - 0.5 : w + 0.5),
-            static_cast<int>(h < 0 ? h - 0.5 : h + 0.5)
-        );
+        if constexpr (std::is_same_v<R, int>) {
+            return Size2d<int>(
+                static_cast<int>(w < 0 ? w - 0.5 : w + 0.5),
+                static_cast<int>(h < 0 ? h - 0.5 : h + 0.5)
+            );
+        } else {
+            return Size2d<R>(
+                static_cast<R>(w),
+                static_cast<R>(h)
+            );
+        }
     }
 
     Rect<T> as_rect() const {
@@ -7,15 +7,61 @@
  * Distributed under terms of the MIT license.
  *
  * ## Usage ---------------------------------------------------------
- * This library just contains `hash::combine`, lifted from `boost::hash_combine`,
+ * This library contains `hash::combine`, lifted from `boost::hash_combine`,
  * a useful function for combining the result of a series of hashes over different
  * objects into a single hash value.
+ *
+ * It also offers a fast non-cryptographic hash, based on `wyhash`, which is
+ * much faster than `std::hash` for long strings and distributes integer keys
+ * well enough for power-of-two and open-addressing tables, where the identity
+ * hash used by libstdc++ for integers performs poorly.  These hashes are not
+ * suitable for anything security related, and they aren't stable across
+ * platforms of different endianness, so don't persist them.
+ *
+ * - `hash::bytes(data, len, seed=0)`: Hash a span of bytes.
+ * - `hash::mix(x)`: Mix the bits of a 64-bit integer so that every input bit
+ *   affects every output bit.  This is a bijection.
+ * - `hash::of(value, seed=0)`: Hash a value.  Strings and anything
+ *   convertible to `std::string_view` are hashed as bytes, so `std::string`,
+ *   `std::string_view`, and `const char*` hash alike.  Integers, enums,
+ *   pointers and floating point values are mixed, tuples, pairs and iterable
+ *   containers are hashed element by element, and anything else falls back on
+ *   `std::hash`.
+ * - `hash::values(a, b, ...)`: Hash a sequence of values into one hash.
+ * - `hash::State`: Streaming hashing of composite objects, e.g. in a custom
+ *   `std::hash` specialization.
+ *
+ * ```
+ * struct Point {
+ *     int x, y;
+ *     std::string label;
+ * };
+ *
+ * size_t h = hash::State().add(pt.x).add(pt.y).add(pt.label).digest();
+ * ```
+ *
+ * - `hash::Hash`: A transparent hasher functor for `std::unordered_map`,
+ *   `linked_map` and the like.  Use it with `std::equal_to<>` to look up
+ *   `std::string` keys by `std::string_view` without allocating.
+ *
+ * ```
+ * std::unordered_map<std::string, int, hash::Hash, std::equal_to<>> counts;
+ * counts.find(std::string_view("key"));
+ * ```
  */
 
 #ifndef __MOONLIGHT_HASH_H
 #define __MOONLIGHT_HASH_H
 
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "moonlight/traits.h"
 
 namespace moonlight {
 namespace hash {
@@ -29,6 +75,221 @@ inline void combine(std::size_t& seed, const T& value) {
     seed ^= hash_function(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 }
 
+namespace _wyhash {
+
+const uint64_t P0 = 0x2d358dccaa6c78a5ull;
+const uint64_t P1 = 0x8bb84b93962eacc9ull;
+const uint64_t P2 = 0x4b33a62ed433d4a3ull;
+const uint64_t P3 = 0x4d5a2da51de1aa47ull;
+
+inline void mum(uint64_t* a, uint64_t* b) {
+    __uint128_t r = *a;
+    r *= *b;
+    *a = static_cast<uint64_t>(r);
+    *b = static_cast<uint64_t>(r >> 64);
+}
+
+inline uint64_t mix(uint64_t a, uint64_t b) {
+    mum(&a, &b);
+    return a ^ b;
+}
+
+inline uint64_t r8(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint64_t r4(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+inline uint64_t r3(const uint8_t* p, size_t k) {
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+}
+
+}  // namespace _wyhash
+
+/**------------------------------------------------------------------
+ * Hash a span of bytes.
+ */
+inline uint64_t bytes(const void* data, size_t len, uint64_t seed = 0) {
+    using namespace _wyhash;
+
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint64_t a, b;
+    seed ^= _wyhash::mix(seed ^ P0, P1);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (r4(p) << 32) | r4(p + ((len >> 3) << 2));
+            b = (r4(p + len - 4) << 32) | r4(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = r3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+
+    } else {
+        size_t i = len;
+        if (i >= 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = _wyhash::mix(r8(p) ^ P1, r8(p + 8) ^ seed);
+                see1 = _wyhash::mix(r8(p + 16) ^ P2, r8(p + 24) ^ see1);
+                see2 = _wyhash::mix(r8(p + 32) ^ P3, r8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i >= 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = _wyhash::mix(r8(p) ^ P1, r8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = r8(p + i - 16);
+        b = r8(p + i - 8);
+    }
+
+    a ^= P1;
+    b ^= seed;
+    mum(&a, &b);
+    return _wyhash::mix(a ^ P0 ^ len, b ^ P1);
+}
+
+inline uint64_t bytes(std::string_view s, uint64_t seed = 0) {
+    return bytes(s.data(), s.size(), seed);
+}
+
+/**------------------------------------------------------------------
+ * Mix the bits of a 64-bit integer, using the `splitmix64` finalizer.
+ */
+inline uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+template<class T>
+uint64_t of(const T& value, uint64_t seed = 0);
+
+/**------------------------------------------------------------------
+ * Accumulates the hashes of a sequence of values into one hash.  The
+ * result depends on the order of the values.
+ */
+class State {
+ public:
+     explicit State(uint64_t seed = 0) : _state(seed ^ _wyhash::P0) { }
+
+     State& add_bytes(const void* data, size_t len) {
+         return _add(bytes(data, len));
+     }
+
+     template<class T>
+     State& add(const T& value) {
+         return _add(of(value));
+     }
+
+     template<class... TD>
+     State& operator()(const TD&... values) {
+         (add(values), ...);
+         return *this;
+     }
+
+     uint64_t digest() const {
+         return _wyhash::mix(_state ^ _count, _wyhash::P2);
+     }
+
+ private:
+     State& _add(uint64_t h) {
+         _state = _wyhash::mix(_state ^ _wyhash::P1, h ^ _wyhash::P3);
+         _count++;
+         return *this;
+     }
+
+     uint64_t _state;
+     uint64_t _count = 0;
+};
+
+namespace _hash {
+
+template<class T, class = void>
+struct is_tuple_like : public std::false_type { };
+
+template<class T>
+struct is_tuple_like<T, std::void_t<decltype(std::tuple_size<T>::value)>>
+: public std::true_type { };
+
+}  // namespace _hash
+
+/**------------------------------------------------------------------
+ * Hash a value.
+ */
+template<class T>
+uint64_t of(const T& value, uint64_t seed) {
+    if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        return bytes(std::string_view(value), seed);
+
+    } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+        return mix(static_cast<uint64_t>(value) ^ seed);
+
+    } else if constexpr (std::is_pointer_v<T>) {
+        return mix(reinterpret_cast<uintptr_t>(value) ^ seed);
+
+    } else if constexpr (std::is_floating_point_v<T>) {
+        double d = value == 0 ? 0.0 : static_cast<double>(value);
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        return mix(bits ^ seed);
+
+    } else if constexpr (_hash::is_tuple_like<T>::value) {
+        State state(seed);
+        std::apply([&](const auto&... items) {
+            state(items...);
+        }, value);
+        return state.digest();
+
+    } else if constexpr (is_iterable_type<T>::value) {
+        State state(seed);
+        uint64_t count = 0;
+        for (const auto& item : value) {
+            state.add(item);
+            count++;
+        }
+        return state.add(count).digest();
+
+    } else {
+        return mix(static_cast<uint64_t>(std::hash<T>()(value)) ^ seed);
+    }
+}
+
+/**------------------------------------------------------------------
+ * Hash a sequence of values into one hash.
+ */
+template<class... TD>
+uint64_t values(const TD&... values) {
+    return State()(values...).digest();
+}
+
+/**------------------------------------------------------------------
+ * A transparent hasher functor using `hash::of()`.
+ */
+struct Hash {
+    typedef void is_transparent;
+
+    template<class T>
+    size_t operator()(const T& value) const {
+        return of(value);
+    }
+};
+
 }  // namespace hash
 }  // namespace moonlight
 
@@ -46,7 +46,14 @@
  *   file, which is referenced in JSON parsing diagnostic output such as
  *   exception messages.
  * - `read<T>(s)`: Reads an object of type `T` from the JSON string `s`.
+ * - `try_read<T>(in, filename="<input>")`, `try_read<T>(s)`: Like `read<T>()`,
+ *   but returns a `core::Result<T>` holding the parse error, if any, instead
+ *   of throwing `json::parser::ParseError`.  Errors mapping the parsed value
+ *   to `T` are still thrown as `core::TypeError`.
  * - `read_file<T>(name)`: Opens a JSON file and reads an object of type `T`.
+ * - `parser::PushParser`: Parses input pushed to it in chunks with `feed()`
+ *   and `finish()`, e.g. from non-blocking I/O, without buffering it all
+ *   first.  Completed values are returned by `next()`.
  * - `write(out, v, idt=FormatOptions())`: Writes an object `v` as JSON to the
  *   output stream `out`, using the given indent settings if provided.
  * - `write_file(name, v, idt=FormatOptions())`: Writes an object `v` as JSON
@@ -106,6 +113,7 @@
 
 #include <memory>
 #include <string>
+#include <type_traits>
 
 #include "moonlight/json/parser.h"
 #include "moonlight/json/serializer.h"
@@ -182,14 +190,14 @@ Value::Pointer _adt_to_json_impl(const T& adt) {
         return const_cast<T&>(adt).__json__().map_to_json().clone();
 
     } else if constexpr (is_map_type<T>()) {
-        std::shared_ptr<Object> json_adt = std::make_shared<Object>();
+        std::shared_ptr<Object> json_adt = alloc::make_shared<Object>();
         for (auto iter = adt.begin(); iter != adt.end(); iter++) {
             json_adt->set(iter->first, iter->second);
         }
         return json_adt;
 
     } else /* if (is_iterable_type<T>() */ {
-        std::shared_ptr<Array> array = std::make_shared<Array>();
+        std::shared_ptr<Array> array = alloc::make_shared<Array>();
 
         for (auto item : adt) {
             array->append(item);
@@ -205,14 +213,33 @@ Value::Pointer _adt_to_json(const T& adt) {
 }
 
 template<class T>
-T read(std::istream& input, const std::string& filename = "<input>") {
-    auto value = _parse(input, filename);
-    return value->get<T>();
+core::Result<T> try_read(std::istream& input, const std::string& filename = "<input>") {
+    parser::Parser parser(input, filename);
+    auto result = parser.try_parse();
+    if (! result) {
+        return result.error();
+    }
+
+    if constexpr (std::is_same_v<T, Value::Pointer>) {
+        return std::move(result).value();
+    } else {
+        return result.value()->template get<T>();
+    }
 }
 
-template<>
-inline Value::Pointer read(std::istream& input, const std::string& filename) {
-    return _parse(input, filename);
+template<class T>
+core::Result<T> try_read(const std::string& json_str) {
+    std::istringstream infile(json_str);
+    return try_read<T>(infile, "<str>");
+}
+
+template<class T>
+T read(std::istream& input, const std::string& filename = "<input>") {
+    auto result = try_read<T>(input, filename);
+    if (! result) {
+        THROW(parser::ParseError, result.error().message, result.error().loc);
+    }
+    return std::move(result).value();
 }
 
 template<class T>
@@ -45,7 +45,12 @@ class Array : public Value {
      }
 
      Value::Pointer clone() const override {
-         return std::make_shared<Array>(_vec);
+         auto array = alloc::make_shared<Array>();
+         array->_vec.reserve(_vec.size());
+         for (const auto& v : _vec) {
+             array->_vec.push_back(v->clone());
+         }
+         return array;
      }
 
      Array& clear() {
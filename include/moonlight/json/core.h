@@ -14,6 +14,7 @@
 #include <map>
 #include <string>
 
+#include "moonlight/alloc.h"
 #include "moonlight/exceptions.h"
 #include "moonlight/traits.h"
 #include "moonlight/meta.h"
@@ -171,7 +172,7 @@ class Null : public Value {
      Null() : Value(Type::NONE) { }
 
      Value::Pointer clone() const override {
-         return std::make_shared<Null>();
+         return alloc::make_shared<Null>();
      }
 };
 
@@ -198,7 +199,7 @@ class Boolean : public Value {
      }
 
      Value::Pointer clone() const override {
-         return std::make_shared<Boolean>(_value);
+         return alloc::make_shared<Boolean>(_value);
      }
 
  private:
@@ -229,7 +230,7 @@ class Number : public Value {
      }
 
      Value::Pointer clone() const override {
-         return std::make_shared<Number>(_value);
+         return alloc::make_shared<Number>(_value);
      }
 
  private:
@@ -270,7 +271,7 @@ class String : public Value {
      }
 
      Value::Pointer clone() const override {
-         return std::make_shared<String>(_str);
+         return alloc::make_shared<String>(_str);
      }
 
  private:
@@ -114,7 +114,7 @@ class ObjectMapping : public Mapping {
      : Mapping(name, required), _obj_ref(obj_ref) { }
 
      Value::Pointer get() const override {
-         auto obj = std::make_shared<Object>();
+         auto obj = alloc::make_shared<Object>();
 
          for (auto mapping : _obj_ref.json_mapper()) {
              obj->set(mapping->name(), Value::of(mapping->get()));
@@ -12,11 +12,14 @@
 
 #include <memory>
 #include <algorithm>
+#include <list>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <string>
 
 #include "moonlight/json/core.h"
+#include "moonlight/hash.h"
 #include "moonlight/linked_map.h"
 #include "moonlight/generator.h"
 #include "moonlight/traits.h"
@@ -28,7 +31,9 @@ namespace json {
 //-------------------------------------------------------------------
 class Object : public Value {
  public:
-     typedef linked_map<std::string, Value::Pointer> Namespace;
+     typedef std::list<std::pair<std::string, Value::Pointer>> Entries;
+     typedef linked_map<std::string, Value::Pointer, Entries,
+             std::unordered_map<std::string, Entries::iterator, hash::Hash>> Namespace;
 
      explicit Object(const Namespace& ns) : Value(Type::OBJECT), _ns(ns) { }
      Object(const Object& obj) : Object((Namespace){}) {
@@ -56,7 +61,7 @@ class Object : public Value {
      }
 
      Value::Pointer clone() const override {
-         return std::make_shared<Object>(*this);
+         return alloc::make_shared<Object>(*this);
      }
 
      Object& clear() {
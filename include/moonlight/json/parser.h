@@ -10,9 +10,14 @@
 #ifndef __MOONLIGHT_JSON_PARSER_H
 #define __MOONLIGHT_JSON_PARSER_H
 
+#include <charconv>
+#include <deque>
 #include <set>
 #include <map>
 #include <iostream>
+#include <optional>
+#include <span>
+#include <sstream>
 #include <vector>
 #include <string>
 
@@ -22,6 +27,11 @@
 #include "moonlight/file.h"
 #include "moonlight/automata.h"
 #include "moonlight/collect.h"
+#include "moonlight/result.h"
+
+#ifdef MOONLIGHT_ENABLE_METRICS
+#include "moonlight/metrics.h"
+#endif
 
 namespace moonlight {
 namespace json {
@@ -36,9 +46,7 @@ class ParseError : public moonlight::core::RuntimeError {
 
      static std::string format_message(const std::string& msg,
                                        const file::Location& loc) {
-         std::ostringstream sb;
-         sb << msg << " (" << loc << ")";
-         return sb.str();
+         return fmt::format("{} ({})", msg, loc);
      }
 
      const file::Location& loc() const {
@@ -52,6 +60,7 @@ class ParseError : public moonlight::core::RuntimeError {
 //-------------------------------------------------------------------
 struct Context {
     file::BufferedInput input;
+    std::optional<core::Error> error = {};
 
     file::Location loc() const {
         return input.location();
@@ -69,17 +78,27 @@ struct Context {
     }
 };
 
+//-------------------------------------------------------------------
+inline bool is_double_char(int c) {
+    static const std::set<char> DOUBLE_CHARS = {
+        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+        '-', '+', '.', 'e', 'E'};
+    return DOUBLE_CHARS.find(c) != DOUBLE_CHARS.end();
+}
+
 //-------------------------------------------------------------------
 class State : public automata::State<Context> {
  protected:
-     bool is_double_char(int c) {
-         static const std::set<char> DOUBLE_CHARS = {
-             '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
-             '-', '+', '.', 'e', 'E'};
-         return DOUBLE_CHARS.find(c) != DOUBLE_CHARS.end();
+     /**
+      * Record a parse error and stop the machine.  States must return
+      * immediately after calling this.
+      */
+     void fail(core::ErrorCode code, const char* message) {
+         context().error = core::Error{code, message, context().loc()};
+         terminate();
      }
 
-     double parse_double() {
+     bool parse_double(double& result) {
          std::string double_str;
 
          for (;;) {
@@ -92,16 +111,23 @@ class State : public automata::State<Context> {
              }
          }
 
-         size_t pos;
-         double result = std::stod(double_str, &pos);
-         if (pos != double_str.size()) {
-             THROW(ParseError, "Malformed double precision value.", context().loc());
+         // Unlike `stod`, `from_chars` doesn't accept a leading '+'.
+         const char* begin = double_str.data();
+         const char* end = begin + double_str.size();
+         if (end - begin > 1 && begin[0] == '+' && begin[1] != '-' && begin[1] != '+') {
+             begin++;
+         }
+
+         auto [ptr, ec] = std::from_chars(begin, end, result);
+         if (ec != std::errc() || ptr != end) {
+             fail(core::ErrorCode::SYNTAX_ERROR, "Malformed double precision value.");
+             return false;
          }
 
-         return result;
+         return true;
      }
 
-     std::string parse_literal() {
+     bool parse_literal(std::string& result) {
          static const std::map<char, char> ESCAPED_CHARS = {
              {'a', '\a'},
              {'b', '\b'},
@@ -114,15 +140,20 @@ class State : public automata::State<Context> {
              {'"', '"'},
              {'\\', '\\'}
          };
-         std::string result;
+         result.clear();
 
          int c = getc();
          if (c != '"') {
-             THROW(ParseError, "Input is not a string literal.", context().loc());
+             fail(core::ErrorCode::SYNTAX_ERROR, "Input is not a string literal.");
+             return false;
          }
 
          while ((c = getc()) != '"') {
-             if (c == '\\') {
+             if (c == EOF) {
+                 fail(core::ErrorCode::UNEXPECTED_EOF, "Unexpected end of file in string literal.");
+                 return false;
+
+             } else if (c == '\\') {
                  int c2 = getc();
                  auto iter = ESCAPED_CHARS.find(c2);
                  if (iter != ESCAPED_CHARS.end()) {
@@ -132,14 +163,16 @@ class State : public automata::State<Context> {
                      int hexA = getc();
                      int hexB = getc();
                      if (hexA == EOF || hexB == EOF) {
-                         THROW(ParseError, "Unexpected end of file while parsing '\\x' escape sequence.",
-                               context().loc());
+                         fail(core::ErrorCode::UNEXPECTED_EOF,
+                              "Unexpected end of file while parsing '\\x' escape sequence.");
+                         return false;
                      }
-                     std::string hex = {static_cast<char>(hexA), static_cast<char>(hexB)};
-                     size_t pos;
-                     int c_hex = std::stoi(hex, &pos, 16);
-                     if (pos != 2) {
-                         THROW(ParseError, "Malformed hexidecimal number in '\\x' escape sequence.", context().loc());
+                     char hex[2] = {static_cast<char>(hexA), static_cast<char>(hexB)};
+                     int c_hex = 0;
+                     auto [ptr, ec] = std::from_chars(hex, hex + 2, c_hex, 16);
+                     if (ec != std::errc() || ptr != hex + 2) {
+                         fail(core::ErrorCode::SYNTAX_ERROR, "Malformed hexidecimal number in '\\x' escape sequence.");
+                         return false;
                      }
                      result.push_back(c_hex);
                  }
@@ -148,7 +181,7 @@ class State : public automata::State<Context> {
              }
          }
 
-         return result;
+         return true;
      }
 
      int peek(size_t offset = 1) {
@@ -188,12 +221,13 @@ class ObjectValueState : public State {
          skip_whitespace();
 
          if (key == "") {
-             key = parse_literal();
+             parse_literal(key);
 
          } else if (value == nullptr) {
              int c = getc();
              if (c != ':') {
-                 THROW(ParseError, "Missing colon between object key and value.", context().loc());
+                 fail(core::ErrorCode::SYNTAX_ERROR, "Missing colon between object key and value.");
+                 return;
              }
              push<ValueState>(&value);
 
@@ -209,7 +243,7 @@ class ObjectValueState : public State {
              if (c == ',' || c == '}') {
                  pop();
              } else {
-                 THROW(ParseError, "Missing comma between object values.", context().loc());
+                 fail(core::ErrorCode::SYNTAX_ERROR, "Missing comma between object values.");
              }
          }
      }
@@ -278,7 +312,7 @@ class ArrayValueState : public State {
          if (c == ',' || c == ']') {
              pop();
          } else {
-             THROW(ParseError, "Missing comma between array values.", context().loc());
+             fail(core::ErrorCode::SYNTAX_ERROR, "Missing comma between array values.");
          }
      }
 
@@ -341,12 +375,18 @@ class ValueState : public State {
              transition<ArrayState>(*value_out);
 
          } else if (c == '"') {
-             (*value_out) = Value::of(parse_literal());
-             pop();
+             std::string literal;
+             if (parse_literal(literal)) {
+                 (*value_out) = Value::of(literal);
+                 pop();
+             }
 
          } else if (c == '-' || c == '.' || isdigit(c)) {
-             (*value_out) = Value::of(parse_double());
-             pop();
+             double number;
+             if (parse_double(number)) {
+                 (*value_out) = Value::of(number);
+                 pop();
+             }
 
          } else if (scan_eq_advance("true")) {
              (*value_out) = Value::of(true);
@@ -361,7 +401,8 @@ class ValueState : public State {
              pop();
 
          } else {
-             THROW(ParseError, "Unexpected character in value expression.", context().loc());
+             fail(c == EOF ? core::ErrorCode::UNEXPECTED_EOF : core::ErrorCode::SYNTAX_ERROR,
+                  "Unexpected character in value expression.");
          }
      }
 
@@ -372,11 +413,17 @@ class ValueState : public State {
 //-------------------------------------------------------------------
 class Parser {
  public:
-     explicit Parser(std::istream& in, const std::string& filename = "<input>")
+     /**
+      * If a memory resource is given, the parsed values and the parser's
+      * states are allocated from it.  See `alloc.h`.
+      */
+     explicit Parser(std::istream& in, const std::string& filename = "<input>",
+                     std::pmr::memory_resource* resource = nullptr)
      : ctx({
          .input = file::BufferedInput(in, filename)
      }),
-     machine(State::Machine::init<ValueState>(ctx, &value)) {
+     resource(resource),
+     machine(init_machine(ctx, &value, resource)) {
 #ifdef MOONLIGHT_JSON_PARSER_DEBUG
          machine.add_tracer([](State::Machine::TraceEvent event,
                                Context& context,
@@ -401,17 +448,201 @@ class Parser {
 #endif
      }
 
-     Value::Pointer parse() {
+     core::Result<Value::Pointer> try_parse() {
+#ifdef MOONLIGHT_ENABLE_METRICS
+         static auto& parses = metrics::counter("moonlight_json_parses_total", "JSON documents parsed.");
+         static auto& errors = metrics::counter("moonlight_json_parse_errors_total", "JSON parse errors.");
+         static auto& parse_ns = metrics::histogram("moonlight_json_parse_ns", "JSON parse time in nanoseconds.");
+         metrics::Timer timer(parse_ns, &errors);
+         parses.inc();
+#endif
+         alloc::Scope scope(resource == nullptr ? alloc::current_resource() : resource);
          machine.run_until_complete();
+         if (ctx.error.has_value()) {
+#ifdef MOONLIGHT_ENABLE_METRICS
+             errors.inc();
+#endif
+             return *ctx.error;
+         }
          return value;
      }
 
+     Value::Pointer parse() {
+         auto result = try_parse();
+         if (! result) {
+             THROW(ParseError, result.error().message, result.error().loc);
+         }
+         return *result;
+     }
+
  private:
+     static State::Machine init_machine(Context& ctx, Value::Pointer* value,
+                                        std::pmr::memory_resource* resource) {
+         alloc::Scope scope(resource == nullptr ? alloc::current_resource() : resource);
+         return State::Machine::init<ValueState>(ctx, value);
+     }
+
      Value::Pointer value = nullptr;
      Context ctx;
+     std::pmr::memory_resource* resource;
      State::Machine machine;
 };
 
+//-------------------------------------------------------------------
+/**
+ * A push parser for input arriving in chunks, e.g. a request body read from
+ * a non-blocking socket.  `feed()` parses as much of each chunk as it can,
+ * keeping the parser's state stack between chunks, and `finish()` marks the
+ * end of the input.  Completed values are queued and returned by `next()`.
+ * The input may hold any number of values, e.g. JSON Lines.
+ *
+ * The machine is only run once the next token has fully arrived, so each
+ * chunk takes time in proportion to its size, plus that of any token split
+ * across chunks.
+ */
+class PushParser {
+ public:
+     explicit PushParser(const std::string& filename = "<input>",
+                         std::pmr::memory_resource* resource = nullptr)
+     : ctx({
+         .input = file::BufferedInput(empty, filename)
+     }),
+     resource(resource),
+     machine(State::Machine::init_empty(ctx)) { }
+
+     PushParser(const PushParser&) = delete;
+     PushParser& operator=(const PushParser&) = delete;
+
+     std::optional<core::Error> try_feed(std::span<const char> chunk) {
+         if (finished) {
+             THROW(core::UsageError, "Input was fed after finish().");
+         }
+         ctx.input.append(chunk.data(), chunk.size());
+         return drive();
+     }
+
+     void feed(std::span<const char> chunk) {
+         check(try_feed(chunk));
+     }
+
+     std::optional<core::Error> try_finish() {
+         finished = true;
+         return drive();
+     }
+
+     void finish() {
+         check(try_finish());
+     }
+
+     /**
+      * Take the next completed value, if any.
+      */
+     std::optional<Value::Pointer> next() {
+         if (values.empty()) {
+             return {};
+         }
+         auto value = values.front();
+         values.pop_front();
+         return value;
+     }
+
+     /**
+      * Whether the input ended partway through a value.
+      */
+     bool is_partial() const {
+         return machine.current() != nullptr;
+     }
+
+ private:
+     static void check(const std::optional<core::Error>& error) {
+         if (error.has_value()) {
+             THROW(ParseError, error->message, error->loc);
+         }
+     }
+
+     std::optional<core::Error> drive() {
+         alloc::Scope scope(resource == nullptr ? alloc::current_resource() : resource);
+         while (! ctx.error.has_value() && token_ready()) {
+             if (! machine.current()) {
+                 machine.push(alloc::make_shared<ValueState>(&value));
+             }
+             auto offset = ctx.input.location().offset;
+             machine.update();
+             if (ctx.input.location().offset != offset) {
+                 scanned = 0;
+                 escape = 0;
+             }
+             if (! machine.current() && ! ctx.error.has_value()) {
+                 values.push_back(value);
+                 value = nullptr;
+             }
+         }
+         return ctx.error;
+     }
+
+     /**
+      * Skip whitespace, then determine if the machine can run: if the next
+      * token has fully arrived, or the input is finished partway through a
+      * value.  Every state skips whitespace and then reads at most one
+      * token, so it never reads past what has arrived.  The scan of a
+      * partial string or number resumes where it left off.
+      */
+     bool token_ready() {
+         auto& input = ctx.input;
+         while (isspace(input.peek())) {
+             input.advance();
+         }
+
+         int c = input.peek();
+         if (c == EOF) {
+             return finished && machine.current() != nullptr;
+         }
+         if (finished) {
+             return true;
+         }
+
+         if (c == '"') {
+             for (scanned = std::max(scanned, size_t(2)); (c = input.peek(scanned)) != EOF; scanned++) {
+                 if (escape < 0) {
+                     // A '\x' escape is followed by two hex digits.
+                     escape = c == 'x' ? 2 : 0;
+                 } else if (escape > 0) {
+                     escape--;
+                 } else if (c == '\\') {
+                     escape = -1;
+                 } else if (c == '"') {
+                     return true;
+                 }
+             }
+             return false;
+         }
+
+         if (c == '-' || c == '.' || isdigit(c)) {
+             for (scanned = std::max(scanned, size_t(2)); is_double_char(input.peek(scanned)); scanned++) { }
+             return input.peek(scanned) != EOF;
+         }
+
+         for (std::string_view keyword : {"true", "false", "null"}) {
+             for (size_t x = 0; x < keyword.size() && input.peek(x + 1) == keyword[x]; x++) {
+                 if (input.peek(x + 2) == EOF && x + 1 < keyword.size()) {
+                     return false;
+                 }
+             }
+         }
+         return true;
+     }
+
+     std::istringstream empty;
+     Context ctx;
+     std::pmr::memory_resource* resource;
+     State::Machine machine;
+     Value::Pointer value = nullptr;
+     std::deque<Value::Pointer> values;
+     bool finished = false;
+     size_t scanned = 0;
+     int escape = 0;
+};
+
 }  // namespace parser
 }  // namespace json
 }  // namespace moonlight
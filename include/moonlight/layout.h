@@ -0,0 +1,308 @@
+/*
+ * ## layout.h: Incremental line wrapping for terminal text. --------
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * ## Dependencies --------------------------------------------------
+ * To install dependencies, run `./build.py deps` at the moonlight project root.
+ *
+ * - utfcpp (via `unicode.h`)
+ *   - Add `moonlight/deps` to your C++ include path.
+ *
+ * ## Usage ---------------------------------------------------------
+ * This library offers `layout::TextLayout`, which wraps UTF8 text to a given
+ * number of terminal columns, breaking lines between words and never within a
+ * grapheme cluster.  Wide characters count as two columns and combining marks
+ * as none, per `unicode::display_width()`.
+ *
+ * Text is measured once, when it is appended, into runs of words and spaces.
+ * Line breaks are cached per paragraph and recomputed from the measured runs
+ * only for paragraphs which change, or for all of them when the width
+ * changes.  Finding a line is a binary search over paragraphs, so rendering
+ * the visible part of a large scrollback buffer is proportional to the number
+ * of visible lines.
+ *
+ * ```
+ * layout::TextLayout text(40);
+ * text.append(log_output);
+ * for (auto line : text.lines(text.line_count() - 10, 10)) {
+ *     std::cout << line << std::endl;
+ * }
+ * ```
+ *
+ * - `append(s)`: Append text, where `\n` begins a new paragraph.
+ * - `width()`, `width(cols)`: Get or set the wrapping width.
+ * - `line_count()`: The number of wrapped lines.
+ * - `line(n)`: A view of the text of the given wrapped line, without
+ *   trailing spaces at which the line was broken.
+ * - `lines(first, count)`: Views of a range of wrapped lines.
+ * - `clear()`: Remove all text.
+ *
+ * Tabs are not expanded, and should be replaced with spaces beforehand.
+ */
+
+#ifndef __MOONLIGHT_LAYOUT_H
+#define __MOONLIGHT_LAYOUT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "moonlight/unicode.h"
+
+namespace moonlight {
+namespace layout {
+
+namespace _layout {
+
+/**
+ * A maximal run of either spaces or non-space grapheme clusters.
+ */
+struct Run {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t width;
+    bool space;
+};
+
+// ------------------------------------------------------------------
+class Paragraph {
+ public:
+     const std::string& text() const {
+         return _text;
+     }
+
+     size_t line_count() const {
+         return _lines.size();
+     }
+
+     std::string_view line(size_t n) const {
+         auto& [begin, end] = _lines[n];
+         return std::string_view(_text).substr(begin, end - begin);
+     }
+
+     bool is_wrapped_for(int width) const {
+         return _wrapped_for == width;
+     }
+
+     void append(std::string_view s) {
+         // The last run may continue into the appended text, so it is measured
+         // again along with it.
+         size_t offset = _text.size();
+         if (! _runs.empty()) {
+             offset = _runs.back().offset;
+             _runs.pop_back();
+         }
+         _text.append(s);
+         _measure(offset);
+         _wrapped_for = -1;
+     }
+
+     void wrap(int width) {
+         width = std::max(width, 1);
+         _lines.clear();
+
+         uint32_t line_start = 0;
+         uint32_t line_end = 0;
+         uint32_t col = 0;
+         uint32_t spaces = 0;
+         bool has_word = false;
+
+         for (const auto& run : _runs) {
+             if (run.space) {
+                 spaces += run.width;
+                 continue;
+             }
+
+             if (col + spaces + run.width <= (uint32_t)width) {
+                 col += spaces + run.width;
+                 line_end = run.offset + run.length;
+                 spaces = 0;
+                 has_word = true;
+                 continue;
+             }
+
+             if (has_word) {
+                 _lines.push_back({line_start, line_end});
+             }
+             line_start = run.offset;
+             col = 0;
+             spaces = 0;
+
+             if (run.width <= (uint32_t)width) {
+                 col = run.width;
+
+             } else {
+                 // Words wider than the line are broken between clusters.
+                 uint32_t x = run.offset;
+                 while (x < run.offset + run.length) {
+                     int w;
+                     uint32_t next = unicode::next_grapheme(_text, x, &w);
+                     if (col + w > (uint32_t)width && col > 0) {
+                         _lines.push_back({line_start, x});
+                         line_start = x;
+                         col = 0;
+                     }
+                     col += w;
+                     x = next;
+                 }
+             }
+             line_end = run.offset + run.length;
+             has_word = true;
+         }
+
+         _lines.push_back({line_start, has_word ? line_end : line_start});
+         _wrapped_for = width;
+     }
+
+ private:
+     void _measure(size_t offset) {
+         while (offset < _text.size()) {
+             unsigned char c = _text[offset];
+             bool space = c == ' ' || c == '\t';
+             size_t next = offset + 1;
+             int w = 1;
+
+             if (c >= 0x20 && c < 0x7F) {
+                 // Printable ASCII is one column per byte, so a run of it of
+                 // the same kind is measured all at once.
+                 while (next < _text.size()) {
+                     unsigned char d = _text[next];
+                     if (d < 0x20 || d >= 0x7F || (d == ' ') != space) {
+                         break;
+                     }
+                     next++;
+                 }
+                 w = next - offset;
+             } else {
+                 next = unicode::next_grapheme(_text, offset, &w);
+             }
+
+             if (! _runs.empty() && _runs.back().space == space
+                 && _runs.back().offset + _runs.back().length == offset) {
+                 _runs.back().length += next - offset;
+                 _runs.back().width += w;
+             } else {
+                 _runs.push_back({(uint32_t)offset, (uint32_t)(next - offset), (uint32_t)w, space});
+             }
+             offset = next;
+         }
+     }
+
+     std::string _text;
+     std::vector<Run> _runs;
+     std::vector<std::pair<uint32_t, uint32_t>> _lines;
+     int _wrapped_for = -1;
+};
+
+}  // namespace _layout
+
+/**------------------------------------------------------------------
+ * UTF8 text wrapped to a number of terminal columns.
+ */
+class TextLayout {
+ public:
+     explicit TextLayout(int width = 80) : _width(width) { }
+
+     TextLayout& append(std::string_view s) {
+         if (_paragraphs.empty()) {
+             _paragraphs.emplace_back();
+         }
+         _dirty_from = std::min(_dirty_from, _paragraphs.size() - 1);
+
+         for (;;) {
+             size_t newline = s.find('\n');
+             _paragraphs.back().append(s.substr(0, newline));
+             if (newline == std::string_view::npos) {
+                 break;
+             }
+             _paragraphs.emplace_back();
+             s.remove_prefix(newline + 1);
+         }
+         return *this;
+     }
+
+     int width() const {
+         return _width;
+     }
+
+     TextLayout& width(int cols) {
+         if (cols != _width) {
+             _width = cols;
+             _dirty_from = 0;
+         }
+         return *this;
+     }
+
+     size_t paragraph_count() const {
+         return _paragraphs.size();
+     }
+
+     size_t line_count() {
+         _update();
+         return _first_line.empty() ? 0 : _first_line.back();
+     }
+
+     std::string_view line(size_t n) {
+         _update();
+         auto iter = std::upper_bound(_first_line.begin(), _first_line.end(), n);
+         size_t p = iter - _first_line.begin() - 1;
+         return _paragraphs[p].line(n - _first_line[p]);
+     }
+
+     std::vector<std::string_view> lines(size_t first, size_t count) {
+         std::vector<std::string_view> result;
+         size_t last = std::min(first + count, line_count());
+         for (size_t n = first; n < last; n++) {
+             result.push_back(line(n));
+         }
+         return result;
+     }
+
+     void clear() {
+         _paragraphs.clear();
+         _first_line.clear();
+         _dirty_from = 0;
+     }
+
+ private:
+     /**
+      * Rewrap changed paragraphs and update the index of the first line of
+      * each paragraph, starting from the first paragraph that changed.  The
+      * index has one more entry than there are paragraphs, the last being the
+      * total line count.
+      */
+     void _update() {
+         if (_dirty_from >= _paragraphs.size()) {
+             return;
+         }
+
+         _first_line.resize(_paragraphs.size() + 1);
+         if (_dirty_from == 0) {
+             _first_line[0] = 0;
+         }
+         for (size_t p = _dirty_from; p < _paragraphs.size(); p++) {
+             if (! _paragraphs[p].is_wrapped_for(_width)) {
+                 _paragraphs[p].wrap(_width);
+             }
+             _first_line[p + 1] = _first_line[p] + _paragraphs[p].line_count();
+         }
+         _dirty_from = _paragraphs.size();
+     }
+
+     std::vector<_layout::Paragraph> _paragraphs;
+     std::vector<size_t> _first_line;
+     size_t _dirty_from = 0;
+     int _width;
+};
+
+}  // namespace layout
+}  // namespace moonlight
+
+#endif /* !__MOONLIGHT_LAYOUT_H */
@@ -79,6 +79,12 @@
 // auto lex = root.lexer();
 // std::vector<lex::Token> tokens = lex.lex(file::to_string("input.scheme"));
 // ```
+//
+// `lex()` throws `lex::NoMatchError` if no rule matches the input, or
+// `lex::UnexpectedEndOfContentError` if the root grammar is popped before the
+// end of the input.  `try_lex()` instead returns a `core::Result` holding
+// either the tokens or a `core::Error`, which is much cheaper when rejecting
+// malformed input is a common case.
 
 #ifndef __MOONLIGHT_LEX_H
 #define __MOONLIGHT_LEX_H
@@ -86,6 +92,7 @@
 #include <optional>
 #include <algorithm>
 #include <memory>
+#include <memory_resource>
 #include <map>
 #include <string>
 #include <vector>
@@ -94,8 +101,13 @@
 #include "moonlight/file.h"
 #include "moonlight/exceptions.h"
 #include "moonlight/string.h"
+#include "moonlight/result.h"
 #include "moonlight/rx.h"
 
+#ifdef MOONLIGHT_ENABLE_METRICS
+#include "moonlight/metrics.h"
+#endif
+
 namespace moonlight {
 namespace lex {
 
@@ -125,12 +137,11 @@ class NoMatchError : public LexParseError {
 
  private:
      static std::string format_message(const file::Location& loc, const char chr) {
-         std::ostringstream sb;
-         sb << "No lexical rules matched content starting at " << loc << " [" << str::literal(str::chr(chr)) << "].";
-         return sb.str();
+         return fmt::format("No lexical rules matched content starting at {} [{}].",
+                            loc, str::literal(str::chr(chr)));
      }
 
-     const file::Location& _loc;
+     const file::Location _loc;
      const std::vector<std::string> _gstack;
      const char _chr;
 };
@@ -147,12 +158,10 @@ class UnexpectedEndOfContentError : public LexParseError {
 
  private:
      static std::string format_message(const file::Location& loc) {
-         std::ostringstream sb;
-         sb << "Parsing terminated early (at " << loc << ").";
-         return sb.str();
+         return fmt::format("Parsing terminated early (at {}).", loc);
      }
 
-     const file::Location& _loc;
+     const file::Location _loc;
 };
 
 // ------------------------------------------------------------------
@@ -368,9 +377,7 @@ class Rule {
      template<class T>
      GrammarImpl<T>::ConstPointer target() const {
          if (_target == nullptr) {
-             std::ostringstream sb;
-             sb << "Rule type has no subgrammar target.";
-             THROW(core::UsageError, sb.str());
+             THROW(core::UsageError, "Rule type has no subgrammar target.");
          }
          return _target;
      }
@@ -703,6 +710,81 @@ class Lexer {
 
      std::vector<Token<T>> lex(const std::string& content) const {
          std::vector<Token<T>> tokens;
+         std::vector<std::string> error_gstack;
+         auto error = _lex(content, tokens, &error_gstack);
+
+         if (error.has_value() && _throw_on_error) {
+             if (error->code == core::ErrorCode::SYNTAX_ERROR) {
+                 THROW(NoMatchError, error->loc, content[error->loc.offset], error_gstack);
+             }
+             THROW(UnexpectedEndOfContentError, error->loc);
+         }
+         return tokens;
+     }
+
+     /**
+      * Lex the given content, returning a `core::Error` rather than throwing
+      * if no rule matches or the root grammar is popped early.
+      */
+     core::Result<std::vector<Token<T>>> try_lex(const std::string& content) const {
+         std::vector<Token<T>> tokens;
+         auto error = _lex(content, tokens);
+         if (error.has_value()) {
+             return std::move(*error);
+         }
+         return tokens;
+     }
+
+     core::Result<std::vector<Token<T>>> try_lex(std::istream& infile) const {
+         return try_lex(file::to_string(infile));
+     }
+
+     /**
+      * Lex the given content, appending tokens to a vector which may be
+      * backed by an arena or other memory resource.  See `alloc.h`.
+      */
+     std::optional<core::Error> try_lex(const std::string& content,
+                                        std::pmr::vector<Token<T>>& tokens) const {
+         return _lex(content, tokens);
+     }
+
+     Lexer& throw_on_error(bool value) {
+         _throw_on_error = value;
+         return *this;
+     }
+
+ private:
+     explicit Lexer(const Grammar<T>& grammar)
+     : _grammar(grammar) { }
+
+     template<class V>
+     std::optional<core::Error> _lex(const std::string& content,
+                                     V& tokens,
+                                     std::vector<std::string>* error_gstack = nullptr) const {
+#ifdef MOONLIGHT_ENABLE_METRICS
+         static auto& runs = metrics::counter("moonlight_lex_runs_total", "Lexer runs.");
+         static auto& errors = metrics::counter("moonlight_lex_errors_total", "Lexer errors.");
+         static auto& token_count = metrics::counter("moonlight_lex_tokens_total", "Tokens lexed.");
+         static auto& lex_ns = metrics::histogram("moonlight_lex_ns", "Lexer run time in nanoseconds.");
+         metrics::Timer timer(lex_ns, &errors);
+         size_t initial_size = tokens.size();
+         runs.inc();
+
+         auto error = _scan(content, tokens, error_gstack);
+         token_count.inc(tokens.size() - initial_size);
+         if (error.has_value()) {
+             errors.inc();
+         }
+         return error;
+#else
+         return _scan(content, tokens, error_gstack);
+#endif
+     }
+
+     template<class V>
+     std::optional<core::Error> _scan(const std::string& content,
+                                      V& tokens,
+                                      std::vector<std::string>* error_gstack) const {
          std::stack<typename Grammar<T>::ConstPointer> gstack;
          gstack.push(_grammar.pointer());
          file::Location loc;
@@ -719,11 +801,14 @@ class Lexer {
              auto result_opt = g->scan(loc, content);
 
              if (! result_opt.has_value()) {
-                 if (_throw_on_error) {
-                     THROW(NoMatchError, loc, content[loc.offset], GrammarImpl<T>::gstack_to_strv(gstack));
-                 } else {
-                     break;
+                 if (error_gstack != nullptr) {
+                     *error_gstack = GrammarImpl<T>::gstack_to_strv(gstack);
                  }
+                 return core::Error{
+                     core::ErrorCode::SYNTAX_ERROR,
+                     fmt::format("No lexical rules matched content starting at {} [{}].",
+                                 loc, str::literal(str::chr(content[loc.offset]))),
+                     loc};
              }
 
              auto result = result_opt.value();
@@ -736,10 +821,8 @@ class Lexer {
                  if (result.token.has_value()) {
                      append_token(result.token.value());
                  } else if (! result.rule.is_typeless()) {
-                     std::ostringstream sb;
-                     sb << "Match rule " << result.rule.type()
-                     << " didn't yield a token (at " << loc << ").";
-                     THROW(core::UsageError, sb.str());
+                     THROW(core::UsageError, fmt::format("Match rule {} didn't yield a token (at {}).",
+                                                         result.rule.type(), loc));
                  }
                  break;
 
@@ -763,22 +846,16 @@ class Lexer {
              }
          }
 
-         if (loc.offset < content.size() && _throw_on_error) {
-             THROW(UnexpectedEndOfContentError, loc);
+         if (loc.offset < content.size()) {
+             return core::Error{
+                 core::ErrorCode::TRAILING_INPUT,
+                 fmt::format("Parsing terminated early (at {}).", loc),
+                 loc};
          }
 
-         return tokens;
-     }
-
-     Lexer& throw_on_error(bool value) {
-         _throw_on_error = value;
-         return *this;
+         return {};
      }
 
- private:
-     explicit Lexer(const Grammar<T>& grammar)
-     : _grammar(grammar) { }
-
      const Grammar<T> _grammar;
      bool _debug_print = false;
      bool _throw_on_error = true;
@@ -30,6 +30,15 @@
  * order sequence type is `std::list`.  If "O(1)" insertion order offset access
  * time is required, use `std::vector` instead, but note the tradeoff that item
  * removal will then become "O(n)".
+ *
+ * The hasher can be replaced by supplying the map type, e.g. to use the faster
+ * `hash::Hash` from `hash.h`:
+ *
+ * ```
+ * typedef std::list<std::pair<std::string, int>> List;
+ * linked_map<std::string, int, List,
+ *            std::unordered_map<std::string, List::iterator, hash::Hash>> map;
+ * ```
  */
 #ifndef __MOONLIGHT_LINKED_MAP_H
 #define __MOONLIGHT_LINKED_MAP_H
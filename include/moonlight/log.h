@@ -66,6 +66,11 @@
 
 #include "moonlight/date.h"
 #include "moonlight/json.h"
+
+#ifdef MOONLIGHT_ENABLE_METRICS
+#include "moonlight/metrics.h"
+#endif
+
 #include <sstream>
 #include <string>
 #include <vector>
@@ -124,8 +129,8 @@ public:
         return *this;
     }
 
-    const std::string& name() const {
-        return _name;
+    std::string_view name() const {
+        return _name.view();
     }
 
     void ok(Logger* alt_target = nullptr); // defined inline below
@@ -145,7 +150,7 @@ public:
 
     JSON to_json() const {
         return JSON()
-        .set("name", name())
+        .set("name", _name.str())
         .set("dt", dt().isoformat())
         .set("level", level())
         .set("context", context());
@@ -180,7 +185,7 @@ public:
     }
 
 private:
-    std::string _name;
+    str::Symbol _name;
     Datetime _dt;
     int _level;
     int _qty;
@@ -211,6 +216,17 @@ public:
     }
 
     Logger& emit(const Log& log) {
+#ifdef MOONLIGHT_ENABLE_METRICS
+        static auto& events = metrics::counter("moonlight_log_events_total", "Log events emitted.");
+        static auto& warnings = metrics::counter("moonlight_log_warnings_total", "Warning log events emitted.");
+        static auto& errors = metrics::counter("moonlight_log_errors_total", "Error log events emitted.");
+        events.inc();
+        if (log.level() >= ERROR) {
+            errors.inc();
+        } else if (log.level() >= WARNING) {
+            warnings.inc();
+        }
+#endif
         _sync(log);
         return *this;
     }
@@ -226,8 +242,8 @@ public:
         return sb.str();
     }
 
-    const std::string& name() const {
-        return _name;
+    std::string_view name() const {
+        return _name.view();
     }
 
     Logger* parent() const {
@@ -259,7 +275,7 @@ private:
     void _sync(const Log& log); // defined inline below
 
     Logger* _parent = nullptr;
-    const std::string _name;
+    const str::Symbol _name;
     std::vector<LogSync*> _syncs;
     date::Zone _zone;
 };
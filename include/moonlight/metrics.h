@@ -0,0 +1,622 @@
+/*
+ * ## metrics.h: Process-wide counters, gauges and histograms. ------
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * ## Usage ---------------------------------------------------------
+ * This header offers a small metrics subsystem for exposing runtime counters
+ * from a running service.  Metrics are created by name in a `Registry`,
+ * usually the process-wide `metrics::Registry::global()`, and live as long as
+ * the registry.  Creating a metric takes a lock, so look it up once and keep
+ * the reference.  Updating a metric never takes a lock.
+ *
+ * ```
+ * static auto& requests = metrics::counter("http_requests_total", "Requests served.");
+ * static auto& latency = metrics::histogram("http_request_ns", "Request latency.");
+ *
+ * metrics::Timer timer(latency);
+ * requests.inc();
+ * ```
+ *
+ * The following metric types are provided:
+ *
+ * - `metrics::Counter`: A monotonically increasing unsigned count.
+ * - `metrics::Gauge`: A floating point value which may be set, raised or
+ *   lowered.
+ * - `metrics::Histogram`: A distribution of unsigned values, e.g. durations
+ *   in nanoseconds, counted in fixed log-linear buckets.
+ * - `metrics::Timer`: Records the nanoseconds from its construction to its
+ *   destruction (or `stop()`) into a histogram.  If given an error counter,
+ *   it also counts scopes left by an exception.
+ *
+ * Counters and histograms are split into `MOONLIGHT_METRICS_SHARDS` cache
+ * line aligned shards.  Each thread is assigned a shard on first use, and
+ * updates are relaxed atomic adds to that shard, so threads rarely contend on
+ * the same cache line.  Shards are summed when the metric is read, so a read
+ * taken while other threads are updating is a close estimate rather than an
+ * atomic snapshot.  Gauges are a single atomic value, as `set()` must be
+ * seen by every thread.
+ *
+ * Histogram buckets are exact for values below `2^SUB_BITS`, then each power
+ * of two is split into `2^SUB_BITS` equal buckets, where `SUB_BITS` is
+ * `MOONLIGHT_METRICS_HISTOGRAM_SUB_BITS`.  A value's bucket is found with a
+ * count of leading zeros and a shift, and is within `1 / 2^SUB_BITS` of the
+ * value, 25% by default, over the whole range of `uint64_t`.
+ *
+ * A registry can be read in two ways:
+ *
+ * - `registry.snapshot()`: Returns a `json::Object` mapping each metric name
+ *   to an object with its `type`, `help` and value.  Histograms report their
+ *   `count`, `sum`, `max`, the `p50`, `p90` and `p99` quantiles, and the
+ *   non-empty `buckets` as `[upper bound, count]` pairs.  Quantiles and `max`
+ *   are bucket upper bounds.
+ * - `registry.write_text(out)`, `registry.to_text()`: Writes the metrics in
+ *   the Prometheus text exposition format.  Only non-empty histogram buckets
+ *   are written, with cumulative counts.
+ *
+ * `metrics::snapshot()` and `metrics::to_text()` read the global registry.
+ *
+ * Metric names must match `[a-zA-Z_:][a-zA-Z0-9_:]*`, otherwise
+ * `core::ValueError` is thrown.  Asking for an existing name as a different
+ * type of metric throws `core::TypeError`.
+ *
+ * ## Instrumentation -----------------------------------------------
+ * If `MOONLIGHT_ENABLE_METRICS` is defined, the JSON parser, the lexer, the
+ * SQLite client and the logger record the following metrics in the global
+ * registry.  Otherwise they don't include this header and have no overhead.
+ *
+ * - `moonlight_json_parses_total`, `moonlight_json_parse_errors_total`,
+ *   `moonlight_json_parse_ns`
+ * - `moonlight_lex_runs_total`, `moonlight_lex_errors_total`,
+ *   `moonlight_lex_tokens_total`, `moonlight_lex_ns`
+ * - `moonlight_sql_queries_total`, `moonlight_sql_errors_total`,
+ *   `moonlight_sql_rows_total`, `moonlight_sql_query_ns`
+ * - `moonlight_log_events_total`, `moonlight_log_warnings_total`,
+ *   `moonlight_log_errors_total`
+ *
+ * SQL query time covers preparing the statement and stepping to its first
+ * row.  Time spent iterating over the remaining rows is not included.
+ */
+
+#ifndef __MOONLIGHT_METRICS_H
+#define __MOONLIGHT_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "moonlight/constants.h"
+#include "moonlight/exceptions.h"
+#include "moonlight/json/core.h"
+#include "moonlight/json/array.h"
+#include "moonlight/json/object.h"
+
+namespace moonlight {
+namespace metrics {
+
+namespace _metrics {
+
+const size_t CACHE_LINE = 64;
+const size_t SHARDS = MOONLIGHT_METRICS_SHARDS;
+
+inline std::atomic<size_t> next_shard = 0;
+
+/**
+ * The shard assigned to the calling thread.  Threads are assigned shards
+ * round-robin on their first metric update.
+ */
+inline size_t shard() {
+    thread_local size_t index = next_shard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return index;
+}
+
+struct alignas(CACHE_LINE) Cell {
+    std::atomic<uint64_t> value = 0;
+};
+
+inline bool is_valid_name(const std::string& name) {
+    auto is_start = [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':';
+    };
+    if (name.empty() || ! is_start(name[0])) {
+        return false;
+    }
+    for (char c : name) {
+        if (! is_start(c) && ! (c >= '0' && c <= '9')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline void write_number(std::ostream& out, double value) {
+    if (std::isnan(value)) {
+        out << "NaN";
+    } else if (std::isinf(value)) {
+        out << (value > 0 ? "+Inf" : "-Inf");
+    } else {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.write(buffer, result.ptr - buffer);
+    }
+}
+
+inline void write_escaped(std::ostream& out, const std::string& help) {
+    for (char c : help) {
+        if (c == '\\') {
+            out << "\\\\";
+        } else if (c == '\n') {
+            out << "\\n";
+        } else {
+            out << c;
+        }
+    }
+}
+
+}  // namespace _metrics
+
+/**------------------------------------------------------------------
+ * The interface shared by every metric type, used to read it.
+ */
+class Metric {
+ public:
+     Metric(const std::string& name, const std::string& help)
+     : _name(name), _help(help) { }
+     virtual ~Metric() { }
+
+     Metric(const Metric&) = delete;
+     Metric& operator=(const Metric&) = delete;
+
+     const std::string& name() const {
+         return _name;
+     }
+
+     const std::string& help() const {
+         return _help;
+     }
+
+     virtual const char* type() const = 0;
+     virtual json::Value::Pointer to_json() const = 0;
+     virtual void write_text(std::ostream& out) const = 0;
+
+ protected:
+     json::Object _json_header() const {
+         json::Object obj;
+         obj.set("type", std::string(type()));
+         obj.set("help", _help);
+         return obj;
+     }
+
+     void _write_text_header(std::ostream& out) const {
+         if (! _help.empty()) {
+             out << "# HELP " << _name << " ";
+             _metrics::write_escaped(out, _help);
+             out << "\n";
+         }
+         out << "# TYPE " << _name << " " << type() << "\n";
+     }
+
+ private:
+     std::string _name;
+     std::string _help;
+};
+
+/**------------------------------------------------------------------
+ * A monotonically increasing count.
+ */
+class Counter : public Metric {
+ public:
+     using Metric::Metric;
+
+     void inc(uint64_t n = 1) {
+         _cells[_metrics::shard()].value.fetch_add(n, std::memory_order_relaxed);
+     }
+
+     uint64_t value() const {
+         uint64_t total = 0;
+         for (const auto& cell : _cells) {
+             total += cell.value.load(std::memory_order_relaxed);
+         }
+         return total;
+     }
+
+     const char* type() const override {
+         return "counter";
+     }
+
+     json::Value::Pointer to_json() const override {
+         auto obj = std::make_shared<json::Object>(_json_header());
+         obj->set("value", static_cast<double>(value()));
+         return obj;
+     }
+
+     void write_text(std::ostream& out) const override {
+         _write_text_header(out);
+         out << name() << " " << value() << "\n";
+     }
+
+ private:
+     std::array<_metrics::Cell, _metrics::SHARDS> _cells;
+};
+
+/**------------------------------------------------------------------
+ * A value which may go up and down.
+ */
+class Gauge : public Metric {
+ public:
+     using Metric::Metric;
+
+     void set(double value) {
+         _value.store(value, std::memory_order_relaxed);
+     }
+
+     void add(double value) {
+         _value.fetch_add(value, std::memory_order_relaxed);
+     }
+
+     void sub(double value) {
+         _value.fetch_sub(value, std::memory_order_relaxed);
+     }
+
+     void inc() {
+         add(1);
+     }
+
+     void dec() {
+         sub(1);
+     }
+
+     double value() const {
+         return _value.load(std::memory_order_relaxed);
+     }
+
+     const char* type() const override {
+         return "gauge";
+     }
+
+     json::Value::Pointer to_json() const override {
+         auto obj = std::make_shared<json::Object>(_json_header());
+         obj->set("value", value());
+         return obj;
+     }
+
+     void write_text(std::ostream& out) const override {
+         _write_text_header(out);
+         out << name() << " ";
+         _metrics::write_number(out, value());
+         out << "\n";
+     }
+
+ private:
+     std::atomic<double> _value = 0;
+};
+
+/**------------------------------------------------------------------
+ * A distribution of values in fixed log-linear buckets.
+ */
+class Histogram : public Metric {
+ public:
+     static constexpr unsigned SUB_BITS = MOONLIGHT_METRICS_HISTOGRAM_SUB_BITS;
+     static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BITS;
+     static constexpr size_t BUCKETS = (65 - SUB_BITS) * SUB_BUCKETS;
+
+     static_assert(SUB_BITS > 0 && SUB_BITS < 8,
+                   "MOONLIGHT_METRICS_HISTOGRAM_SUB_BITS must be between 1 and 7.");
+
+     /**
+      * A point-in-time read of a histogram, summed over its shards.
+      */
+     struct Snapshot {
+         uint64_t count = 0;
+         uint64_t sum = 0;
+         std::array<uint64_t, BUCKETS> buckets = {};
+
+         /**
+          * The upper bound of the bucket holding the `q`th quantile, where
+          * `q` is between 0 and 1, or 0 if the histogram is empty.
+          */
+         uint64_t quantile(double q) const {
+             if (count == 0) {
+                 return 0;
+             }
+             uint64_t rank = std::max<uint64_t>(1, std::ceil(q * count));
+             uint64_t seen = 0;
+             for (size_t x = 0; x < BUCKETS; x++) {
+                 seen += buckets[x];
+                 if (seen >= rank) {
+                     return upper_bound(x);
+                 }
+             }
+             return upper_bound(BUCKETS - 1);
+         }
+
+         uint64_t max() const {
+             for (size_t x = BUCKETS; x > 0; x--) {
+                 if (buckets[x - 1] != 0) {
+                     return upper_bound(x - 1);
+                 }
+             }
+             return 0;
+         }
+     };
+
+     Histogram(const std::string& name, const std::string& help)
+     : Metric(name, help), _shards(std::make_unique<Shard[]>(_metrics::SHARDS)) {
+         for (size_t x = 0; x < _metrics::SHARDS; x++) {
+             _shards[x].sum.store(0, std::memory_order_relaxed);
+             for (auto& bucket : _shards[x].buckets) {
+                 bucket.store(0, std::memory_order_relaxed);
+             }
+         }
+     }
+
+     /**
+      * The index of the bucket counting `value`.
+      */
+     static constexpr size_t bucket(uint64_t value) {
+         if (value < SUB_BUCKETS) {
+             return value;
+         }
+         unsigned shift = std::bit_width(value) - 1 - SUB_BITS;
+         return (shift + 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+     }
+
+     /**
+      * The smallest and largest values counted by the given bucket.
+      */
+     static constexpr uint64_t lower_bound(size_t index) {
+         if (index < SUB_BUCKETS) {
+             return index;
+         }
+         unsigned shift = index / SUB_BUCKETS - 1;
+         return (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+     }
+
+     static constexpr uint64_t upper_bound(size_t index) {
+         return index + 1 < BUCKETS ? lower_bound(index + 1) - 1 : UINT64_MAX;
+     }
+
+     void record(uint64_t value) {
+         Shard& shard = _shards[_metrics::shard()];
+         shard.buckets[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+         shard.sum.fetch_add(value, std::memory_order_relaxed);
+     }
+
+     Snapshot read() const {
+         Snapshot snapshot;
+         for (size_t x = 0; x < _metrics::SHARDS; x++) {
+             const Shard& shard = _shards[x];
+             snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+             for (size_t y = 0; y < BUCKETS; y++) {
+                 snapshot.buckets[y] += shard.buckets[y].load(std::memory_order_relaxed);
+             }
+         }
+         for (auto n : snapshot.buckets) {
+             snapshot.count += n;
+         }
+         return snapshot;
+     }
+
+     const char* type() const override {
+         return "histogram";
+     }
+
+     json::Value::Pointer to_json() const override {
+         auto snapshot = read();
+         auto obj = std::make_shared<json::Object>(_json_header());
+         auto buckets = std::make_shared<json::Array>();
+
+         for (size_t x = 0; x < BUCKETS; x++) {
+             if (snapshot.buckets[x] != 0) {
+                 auto pair = std::make_shared<json::Array>();
+                 pair->append(static_cast<double>(upper_bound(x)));
+                 pair->append(static_cast<double>(snapshot.buckets[x]));
+                 buckets->append(json::Value::Pointer(pair));
+             }
+         }
+
+         obj->set("count", static_cast<double>(snapshot.count));
+         obj->set("sum", static_cast<double>(snapshot.sum));
+         obj->set("max", static_cast<double>(snapshot.max()));
+         obj->set("p50", static_cast<double>(snapshot.quantile(0.50)));
+         obj->set("p90", static_cast<double>(snapshot.quantile(0.90)));
+         obj->set("p99", static_cast<double>(snapshot.quantile(0.99)));
+         obj->set("buckets", json::Value::Pointer(buckets));
+         return obj;
+     }
+
+     void write_text(std::ostream& out) const override {
+         auto snapshot = read();
+         uint64_t cumulative = 0;
+
+         _write_text_header(out);
+         for (size_t x = 0; x + 1 < BUCKETS; x++) {
+             if (snapshot.buckets[x] != 0) {
+                 cumulative += snapshot.buckets[x];
+                 out << name() << "_bucket{le=\"" << upper_bound(x) << "\"} "
+                     << cumulative << "\n";
+             }
+         }
+         out << name() << "_bucket{le=\"+Inf\"} " << snapshot.count << "\n"
+             << name() << "_sum " << snapshot.sum << "\n"
+             << name() << "_count " << snapshot.count << "\n";
+     }
+
+ private:
+     struct alignas(_metrics::CACHE_LINE) Shard {
+         std::atomic<uint64_t> sum;
+         std::array<std::atomic<uint64_t>, BUCKETS> buckets;
+     };
+
+     std::unique_ptr<Shard[]> _shards;
+};
+
+/**------------------------------------------------------------------
+ * Records the time a scope takes, in nanoseconds, into a histogram.
+ */
+class Timer {
+ public:
+     typedef std::chrono::steady_clock Clock;
+
+     explicit Timer(Histogram& histogram, Counter* errors = nullptr)
+     : _histogram(&histogram), _errors(errors),
+     _exceptions(std::uncaught_exceptions()), _start(Clock::now()) { }
+
+     Timer(const Timer&) = delete;
+     Timer& operator=(const Timer&) = delete;
+
+     ~Timer() {
+         if (_histogram != nullptr) {
+             if (_errors != nullptr && std::uncaught_exceptions() > _exceptions) {
+                 _errors->inc();
+             }
+             stop();
+         }
+     }
+
+     /**
+      * Record the time elapsed so far, once.  Returns the nanoseconds elapsed.
+      */
+     uint64_t stop() {
+         auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Clock::now() - _start).count();
+         if (_histogram != nullptr) {
+             _histogram->record(ns);
+             _histogram = nullptr;
+         }
+         return ns;
+     }
+
+ private:
+     Histogram* _histogram;
+     Counter* _errors;
+     int _exceptions;
+     Clock::time_point _start;
+};
+
+/**------------------------------------------------------------------
+ * A named collection of metrics.
+ */
+class Registry {
+ public:
+     Registry() { }
+     Registry(const Registry&) = delete;
+     Registry& operator=(const Registry&) = delete;
+
+     /**
+      * The process-wide registry.  It is never destroyed, so metrics may be
+      * updated from static destructors.
+      */
+     static Registry& global() {
+         static Registry* registry = new Registry();
+         return *registry;
+     }
+
+     Counter& counter(const std::string& name, const std::string& help = "") {
+         return _get_or_create<Counter>(name, help);
+     }
+
+     Gauge& gauge(const std::string& name, const std::string& help = "") {
+         return _get_or_create<Gauge>(name, help);
+     }
+
+     Histogram& histogram(const std::string& name, const std::string& help = "") {
+         return _get_or_create<Histogram>(name, help);
+     }
+
+     size_t size() const {
+         std::lock_guard lock(_mutex);
+         return _metrics.size();
+     }
+
+     json::Object snapshot() const {
+         json::Object obj;
+         std::lock_guard lock(_mutex);
+         for (const auto& [name, metric] : _metrics) {
+             obj.set(name, metric->to_json());
+         }
+         return obj;
+     }
+
+     void write_text(std::ostream& out) const {
+         std::lock_guard lock(_mutex);
+         for (const auto& [name, metric] : _metrics) {
+             metric->write_text(out);
+         }
+     }
+
+     std::string to_text() const {
+         std::ostringstream sb;
+         write_text(sb);
+         return sb.str();
+     }
+
+ private:
+     template<class T>
+     T& _get_or_create(const std::string& name, const std::string& help) {
+         std::lock_guard lock(_mutex);
+         auto iter = _metrics.find(name);
+         if (iter != _metrics.end()) {
+             T* metric = dynamic_cast<T*>(iter->second.get());
+             if (metric == nullptr) {
+                 THROW(core::TypeError, "Metric '" + name + "' is a " + iter->second->type() + ".");
+             }
+             return *metric;
+         }
+
+         if (! _metrics::is_valid_name(name)) {
+             THROW(core::ValueError, "Invalid metric name: '" + name + "'.");
+         }
+         auto metric = std::make_unique<T>(name, help);
+         T& ref = *metric;
+         _metrics.emplace(name, std::move(metric));
+         return ref;
+     }
+
+     mutable std::mutex _mutex;
+     std::map<std::string, std::unique_ptr<Metric>> _metrics;
+};
+
+/**------------------------------------------------------------------
+ * Shortcuts for the global registry.
+ */
+inline Counter& counter(const std::string& name, const std::string& help = "") {
+    return Registry::global().counter(name, help);
+}
+
+inline Gauge& gauge(const std::string& name, const std::string& help = "") {
+    return Registry::global().gauge(name, help);
+}
+
+inline Histogram& histogram(const std::string& name, const std::string& help = "") {
+    return Registry::global().histogram(name, help);
+}
+
+inline json::Object snapshot() {
+    return Registry::global().snapshot();
+}
+
+inline std::string to_text() {
+    return Registry::global().to_text();
+}
+
+}  // namespace metrics
+}  // namespace moonlight
+
+
+#endif /* !__MOONLIGHT_METRICS_H */
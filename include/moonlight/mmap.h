@@ -14,13 +14,48 @@
  *   assisting in the creation of in-line multimaps.
  * - `mmap::collect(mmap, k)`: Collect all of the items in the multimap matching
  *   the given key `k`.
+ *
+ * ## Flat multimaps ------------------------------------------------
+ * For static lookup tables, `mmap::FlatMultimap<K, T>` stores its keys and
+ * values in two sorted arrays rather than a tree of nodes.  Lookups binary
+ * search the keys alone, and `equal_range(k)` returns a `std::span` of the
+ * matching values rather than copying them.  Values with equal keys keep
+ * the order in which they were given, as in `std::multimap`.  Lookups may use
+ * any type comparable with `K`, e.g. a `std::string_view` for `std::string`
+ * keys.  A flat multimap can't be modified after it is built.
+ *
+ * - `mmap::build_flat(mappings)`: Like `mmap::build()`, but returns a
+ *   `FlatMultimap`.
+ * - `mmap::StaticMultimap<K, T, N>`: A flat multimap of `N` pairs stored in
+ *   `std::array`s, which can be built at compile time with
+ *   `mmap::make_static()` if `K` and `T` are literal types:
+ *
+ * ```
+ * constexpr auto numbers = mmap::make_static<std::string_view, int>({
+ *     {"even", 2}, {"odd", 1}, {"even", 4}, {"odd", 3}
+ * });
+ * static_assert(numbers.count("even") == 2);
+ *
+ * for (int n : numbers.equal_range("odd")) {
+ *     ...
+ * }
+ * ```
+ *
+ * `K` and `T` must be default constructible.
  */
 #ifndef __MOONLIGHT_MMAP_H
 #define __MOONLIGHT_MMAP_H
 
-#include <vector>
+#include <algorithm>
+#include <array>
+#include <functional>
 #include <map>
+#include <span>
+#include <type_traits>
 #include <utility>
+#include <vector>
+
+#include "moonlight/exceptions.h"
 
 namespace moonlight {
 namespace mmap {
@@ -103,6 +138,219 @@ inline std::vector<typename M::mapped_type> collect(const M& mmap,
     return values;
 }
 
+namespace _mmap {
+
+/**
+ * A branch-free binary search over a sorted array of keys, which compiles to
+ * conditional moves rather than unpredictable branches.  Both of the
+ * possible next probes are prefetched, hiding cache misses in large tables.
+ */
+template<class K, class Q, class Compare>
+constexpr size_t lower_bound(const K* keys, size_t size, const Q& key, const Compare& comp) {
+    if (size == 0) {
+        return 0;
+    }
+    const K* base = keys;
+    while (size > 1) {
+        size_t half = size / 2;
+        if (! std::is_constant_evaluated()) {
+            __builtin_prefetch(base + half / 2);
+            __builtin_prefetch(base + half + half / 2);
+        }
+        base = comp(base[half], key) ? base + half : base;
+        size -= half;
+    }
+    return (base - keys) + comp(*base, key);
+}
+
+/**
+ * Find the end of the run of keys equal to `key` beginning at `keys`, by
+ * galloping outwards and then searching the last step.  Runs of equal keys
+ * are short, so this is cheaper than a second search over the whole table.
+ */
+template<class K, class Q, class Compare>
+constexpr size_t end_of_run(const K* keys, size_t size, const Q& key, const Compare& comp) {
+    size_t lo = 0;
+    size_t step = 1;
+    while (lo + step < size && ! comp(key, keys[lo + step])) {
+        lo += step;
+        step *= 2;
+    }
+    size_t hi = std::min(lo + step, size);
+
+    // keys[lo] matches, keys[hi] doesn't if it exists.
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (comp(key, keys[mid])) {
+            hi = mid;
+        } else {
+            lo = mid;
+        }
+    }
+    return hi;
+}
+
+/**
+ * Sort the parallel arrays `keys` and `values` by key, keeping the order of
+ * values with equal keys.
+ */
+template<class K, class T, class Compare>
+constexpr void stable_sort(K* keys, T* values, size_t size, const Compare& comp) {
+    if (std::is_constant_evaluated()) {
+        for (size_t x = 1; x < size; x++) {
+            for (size_t y = x; y > 0 && comp(keys[y], keys[y - 1]); y--) {
+                std::swap(keys[y], keys[y - 1]);
+                std::swap(values[y], values[y - 1]);
+            }
+        }
+        return;
+    }
+
+    std::vector<std::pair<K, T>> pairs;
+    pairs.reserve(size);
+    for (size_t x = 0; x < size; x++) {
+        pairs.emplace_back(std::move(keys[x]), std::move(values[x]));
+    }
+    std::stable_sort(pairs.begin(), pairs.end(), [&](const auto& a, const auto& b) {
+        return comp(a.first, b.first);
+    });
+    for (size_t x = 0; x < size; x++) {
+        keys[x] = std::move(pairs[x].first);
+        values[x] = std::move(pairs[x].second);
+    }
+}
+
+template<class C>
+struct is_resizable : public std::false_type { };
+
+template<class V, class A>
+struct is_resizable<std::vector<V, A>> : public std::true_type { };
+
+}  // namespace _mmap
+
+/**------------------------------------------------------------------
+ * A multimap stored as sorted arrays of keys and values.
+ */
+template<class K, class T, class Compare = std::less<>,
+         class Keys = std::vector<K>, class Values = std::vector<T>>
+class FlatMultimap {
+ public:
+     typedef K key_type;
+     typedef T mapped_type;
+
+     constexpr FlatMultimap() = default;
+
+     /**
+      * Build from a range of key/value pairs, e.g. a `std::multimap`.
+      */
+     template<class Range>
+     constexpr explicit FlatMultimap(const Range& pairs, Compare comp = Compare())
+     : _comp(comp) {
+         if constexpr (_mmap::is_resizable<Keys>::value) {
+             _keys.resize(std::size(pairs));
+             _values.resize(std::size(pairs));
+         } else if (std::size(pairs) != _keys.size()) {
+             THROW(core::ValueError, "Wrong number of pairs for a StaticMultimap.");
+         }
+
+         size_t x = 0;
+         for (const auto& [key, value] : pairs) {
+             _keys[x] = key;
+             _values[x] = value;
+             x++;
+         }
+         _mmap::stable_sort(_keys.data(), _values.data(), _keys.size(), _comp);
+     }
+
+     constexpr size_t size() const {
+         return _keys.size();
+     }
+
+     constexpr bool empty() const {
+         return size() == 0;
+     }
+
+     /**
+      * All keys, in sorted order, and the values in the same order.
+      */
+     constexpr std::span<const K> keys() const {
+         return std::span<const K>(_keys.data(), _keys.size());
+     }
+
+     constexpr std::span<const T> values() const {
+         return std::span<const T>(_values.data(), _values.size());
+     }
+
+     /**
+      * The values matching `key`, in the order they were given.
+      */
+     template<class Q>
+     constexpr std::span<const T> equal_range(const Q& key) const {
+         size_t lo = _mmap::lower_bound(_keys.data(), _keys.size(), key, _comp);
+         if (lo == _keys.size() || _comp(key, _keys[lo])) {
+             return {};
+         }
+         size_t hi = lo + _mmap::end_of_run(_keys.data() + lo, _keys.size() - lo, key, _comp);
+         return values().subspan(lo, hi - lo);
+     }
+
+     template<class Q>
+     constexpr size_t count(const Q& key) const {
+         return equal_range(key).size();
+     }
+
+     template<class Q>
+     constexpr bool contains(const Q& key) const {
+         size_t lo = _mmap::lower_bound(_keys.data(), _keys.size(), key, _comp);
+         return lo < _keys.size() && ! _comp(key, _keys[lo]);
+     }
+
+ private:
+     Keys _keys = {};
+     Values _values = {};
+     Compare _comp = {};
+};
+
+/**------------------------------------------------------------------
+ * A flat multimap of `N` pairs, stored in `std::array`s.
+ */
+template<class K, class T, size_t N, class Compare = std::less<>>
+using StaticMultimap = FlatMultimap<K, T, Compare, std::array<K, N>, std::array<T, N>>;
+
+/**
+ * Build a `StaticMultimap` from an array of pairs, at compile time when
+ * used in a `constexpr` context.
+ */
+template<class K, class T, size_t N>
+constexpr StaticMultimap<K, T, N> make_static(const std::pair<K, T> (&pairs)[N]) {
+    return StaticMultimap<K, T, N>(pairs);
+}
+
+/**
+ * Build a `FlatMultimap` from the given constant mapping, like
+ * `mmap::build()`.
+ */
+template<typename K, typename T>
+inline FlatMultimap<K, T> build_flat(const std::vector<mapping<K, T>>& mappings) {
+    std::vector<std::pair<K, T>> pairs;
+    for (const auto& mapping : mappings) {
+        for (const auto& value : mapping.values) {
+            pairs.emplace_back(mapping.key, value);
+        }
+    }
+    return FlatMultimap<K, T>(pairs);
+}
+
+/**
+ * Collect all values from the given flat multimap that match the given key.
+ */
+template<class K, class T, class Compare, class Keys, class Values, class Q>
+inline std::vector<T> collect(const FlatMultimap<K, T, Compare, Keys, Values>& mmap,
+                              const Q& key) {
+    auto values = mmap.equal_range(key);
+    return std::vector<T>(values.begin(), values.end());
+}
+
 }  // namespace mmap
 }  // namespace moonlight
 
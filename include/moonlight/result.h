@@ -0,0 +1,159 @@
+/*
+ * ## result.h: Non-throwing results for parsing and validation. ----
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * ## Usage ---------------------------------------------------------
+ * This header provides `core::Result<T>`, which holds either a value of type
+ * `T` or a `core::Error`, in the spirit of `std::expected`.  Functions which
+ * parse or validate untrusted input offer `try_` variants returning a
+ * `Result`, so that malformed input can be rejected without the cost of
+ * constructing and throwing a `core::Exception`.  The throwing variants are
+ * implemented on top of them.
+ *
+ * ```
+ * auto result = json::try_read<json::Value::Pointer>(input);
+ * if (! result) {
+ *     std::cerr << result.error() << std::endl;
+ *     return;
+ * }
+ * auto value = *result;
+ * ```
+ *
+ * - `core::Error`: An error code, a message, and the `file::Location` in the
+ *   input where the error was found, which is `file::Location::nowhere()` if
+ *   it isn't known.
+ * - `ok()`, `operator bool`: Whether the result holds a value.
+ * - `value()`, `operator*`, `operator->`: The value.  Throws
+ *   `core::UsageError` if the result holds an error.
+ * - `error()`: The error.  Throws `core::UsageError` if the result holds a
+ *   value.
+ * - `value_or(v)`: The value, or `v` if the result holds an error.
+ */
+
+#ifndef __MOONLIGHT_RESULT_H
+#define __MOONLIGHT_RESULT_H
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <variant>
+
+#include "moonlight/exceptions.h"
+#include "moonlight/file.h"
+
+namespace moonlight {
+namespace core {
+
+enum class ErrorCode {
+    SYNTAX_ERROR,
+    UNEXPECTED_EOF,
+    TRAILING_INPUT,
+    OUT_OF_RANGE,
+    UNKNOWN_NAME,
+    MISSING_VALUE
+};
+
+/**------------------------------------------------------------------
+ * A lightweight description of why input was rejected.
+ */
+struct Error {
+    ErrorCode code;
+    std::string message;
+    file::Location loc = file::Location::nowhere();
+
+    bool has_location() const {
+        return loc.line > 0;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const Error& error) {
+        out << error.message;
+        if (error.has_location()) {
+            out << " (" << error.loc << ")";
+        }
+        return out;
+    }
+};
+
+/**------------------------------------------------------------------
+ * Either a value or the `Error` which prevented it from being produced.
+ */
+template<class T>
+class Result {
+ public:
+     Result(const T& value) : _result(std::in_place_index<0>, value) { }
+     Result(T&& value) : _result(std::in_place_index<0>, std::move(value)) { }
+     Result(const Error& error) : _result(std::in_place_index<1>, error) { }
+     Result(Error&& error) : _result(std::in_place_index<1>, std::move(error)) { }
+
+     bool ok() const {
+         return _result.index() == 0;
+     }
+
+     explicit operator bool() const {
+         return ok();
+     }
+
+     T& value() & {
+         _check_value();
+         return std::get<0>(_result);
+     }
+
+     const T& value() const & {
+         _check_value();
+         return std::get<0>(_result);
+     }
+
+     T&& value() && {
+         _check_value();
+         return std::move(std::get<0>(_result));
+     }
+
+     T& operator*() & {
+         return value();
+     }
+
+     const T& operator*() const & {
+         return value();
+     }
+
+     T&& operator*() && {
+         return std::move(*this).value();
+     }
+
+     T* operator->() {
+         return &value();
+     }
+
+     const T* operator->() const {
+         return &value();
+     }
+
+     T value_or(T default_value) const {
+         return ok() ? std::get<0>(_result) : default_value;
+     }
+
+     const Error& error() const {
+         if (ok()) {
+             THROW(core::UsageError, "Result holds a value, not an error.");
+         }
+         return std::get<1>(_result);
+     }
+
+ private:
+     void _check_value() const {
+         if (! ok()) {
+             THROW(core::UsageError, "Result holds an error: " + std::get<1>(_result).message);
+         }
+     }
+
+     std::variant<T, Error> _result;
+};
+
+}  // namespace core
+}  // namespace moonlight
+
+#endif /* !__MOONLIGHT_RESULT_H */
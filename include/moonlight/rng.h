@@ -0,0 +1,210 @@
+/*
+ * ## rng.h: Fast cryptographically secure random bytes. ------------
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * ## Usage ---------------------------------------------------------
+ * `rng::Stream` is a buffered ChaCha20 random byte stream, used by
+ * `nanoid::Generator` and `uuid::V7Generator`.  Each thread has its own
+ * stream, available via `rng::Stream::thread_local_instance()`, which is
+ * seeded from the operating system with `getrandom()` once, and again in a
+ * child process after `fork()` so that the child doesn't repeat its parent's
+ * stream.  The stream's key is replaced with its own output every
+ * `MOONLIGHT_RNG_BUFSIZE` bytes, so earlier output can't be recovered from
+ * its state.
+ *
+ * ```
+ * auto& random = rng::Stream::thread_local_instance();
+ * uint64_t x = random.next_u64();
+ * ```
+ *
+ * - `fill(data, len)`: Fill a buffer with random bytes.
+ * - `next_u64()`: Get 64 random bits.
+ * - `available(&n)`, `consume(n)`: Read random bytes directly from the
+ *   stream's buffer, for callers which may reject some of them.
+ */
+
+#ifndef __MOONLIGHT_RNG_H
+#define __MOONLIGHT_RNG_H
+
+#include <pthread.h>
+#include <sys/random.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "moonlight/constants.h"
+#include "moonlight/exceptions.h"
+
+namespace moonlight {
+namespace rng {
+
+namespace _chacha {
+
+inline uint32_t rotl(uint32_t x, int n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+inline void quarter_round(uint32_t* s, int a, int b, int c, int d) {
+    s[a] += s[b]; s[d] = rotl(s[d] ^ s[a], 16);
+    s[c] += s[d]; s[b] = rotl(s[b] ^ s[c], 12);
+    s[a] += s[b]; s[d] = rotl(s[d] ^ s[a], 8);
+    s[c] += s[d]; s[b] = rotl(s[b] ^ s[c], 7);
+}
+
+/**
+ * Compute a 64-byte ChaCha20 block, as specified in RFC 8439.
+ */
+inline void block(const uint32_t key[8], uint32_t counter, const uint32_t nonce[3], uint8_t out[64]) {
+    uint32_t input[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+        key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+        counter, nonce[0], nonce[1], nonce[2]
+    };
+    uint32_t s[16];
+    std::memcpy(s, input, sizeof(s));
+
+    for (int x = 0; x < 10; x++) {
+        quarter_round(s, 0, 4, 8, 12);
+        quarter_round(s, 1, 5, 9, 13);
+        quarter_round(s, 2, 6, 10, 14);
+        quarter_round(s, 3, 7, 11, 15);
+        quarter_round(s, 0, 5, 10, 15);
+        quarter_round(s, 1, 6, 11, 12);
+        quarter_round(s, 2, 7, 8, 13);
+        quarter_round(s, 3, 4, 9, 14);
+    }
+
+    for (int x = 0; x < 16; x++) {
+        uint32_t word = s[x] + input[x];
+        out[x * 4] = word & 0xff;
+        out[x * 4 + 1] = (word >> 8) & 0xff;
+        out[x * 4 + 2] = (word >> 16) & 0xff;
+        out[x * 4 + 3] = (word >> 24) & 0xff;
+    }
+}
+
+}  // namespace _chacha
+
+namespace _rng {
+
+// Incremented in the child after `fork()`, so that the child reseeds rather
+// than repeating its parent's random stream.
+inline std::atomic<uint64_t> fork_generation = 0;
+
+inline void on_fork_child() {
+    fork_generation++;
+}
+
+}  // namespace _rng
+
+/**------------------------------------------------------------------
+ * A buffered ChaCha20 random byte stream, seeded from the operating system.
+ */
+class Stream {
+ public:
+     static_assert(MOONLIGHT_RNG_BUFSIZE % 64 == 0 && MOONLIGHT_RNG_BUFSIZE > 64,
+                   "MOONLIGHT_RNG_BUFSIZE must be a multiple of 64 greater than 64.");
+
+     Stream() {
+         static int registered = pthread_atfork(nullptr, nullptr, _rng::on_fork_child);
+         (void)registered;
+         seed();
+     }
+
+     Stream(const Stream&) = delete;
+     Stream& operator=(const Stream&) = delete;
+
+     static Stream& thread_local_instance() {
+         thread_local Stream random;
+         if (random._generation != _rng::fork_generation.load(std::memory_order_relaxed)) {
+             random.seed();
+         }
+         return random;
+     }
+
+     void seed() {
+         uint8_t bytes[sizeof(_key)];
+         size_t n = 0;
+         while (n < sizeof(bytes)) {
+             ssize_t result = getrandom(bytes + n, sizeof(bytes) - n, 0);
+             if (result < 0) {
+                 if (errno == EINTR) {
+                     continue;
+                 }
+                 THROW(core::RuntimeError, std::string("getrandom() failed: ") + strerror(errno));
+             }
+             n += result;
+         }
+         std::memcpy(_key, bytes, sizeof(_key));
+         _generation = _rng::fork_generation.load(std::memory_order_relaxed);
+         _pos = sizeof(_buffer);
+     }
+
+     /**
+      * Get the unread bytes in the buffer, refilling it first if it is
+      * empty.  Call `consume()` with the number of bytes used.
+      */
+     const uint8_t* available(size_t* n) {
+         if (_pos == sizeof(_buffer)) {
+             _refill();
+         }
+         *n = sizeof(_buffer) - _pos;
+         return _buffer + _pos;
+     }
+
+     void consume(size_t n) {
+         _pos += n;
+     }
+
+     /**
+      * Fill `data` with `len` random bytes.
+      */
+     void fill(void* data, size_t len) {
+         uint8_t* out = static_cast<uint8_t*>(data);
+         while (len > 0) {
+             size_t n;
+             const uint8_t* bytes = available(&n);
+             n = std::min(n, len);
+             std::memcpy(out, bytes, n);
+             consume(n);
+             out += n;
+             len -= n;
+         }
+     }
+
+     uint64_t next_u64() {
+         uint64_t x;
+         fill(&x, sizeof(x));
+         return x;
+     }
+
+ private:
+     void _refill() {
+         static const uint32_t nonce[3] = {0, 0, 0};
+         for (size_t x = 0; x < sizeof(_buffer) / 64; x++) {
+             _chacha::block(_key, x, nonce, _buffer + x * 64);
+         }
+         // Replace the key with the first 32 bytes of output.
+         std::memcpy(_key, _buffer, sizeof(_key));
+         std::memset(_buffer, 0, sizeof(_key));
+         _pos = sizeof(_key);
+     }
+
+     uint32_t _key[8];
+     uint8_t _buffer[MOONLIGHT_RNG_BUFSIZE];
+     size_t _pos = MOONLIGHT_RNG_BUFSIZE;
+     uint64_t _generation = 0;
+};
+
+}  // namespace rng
+}  // namespace moonlight
+
+#endif /* !__MOONLIGHT_RNG_H */
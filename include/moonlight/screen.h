@@ -0,0 +1,546 @@
+/*
+ * ## screen.h: A double-buffered, diffing terminal screen. ---------
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * ## Dependencies --------------------------------------------------
+ * To install dependencies, run `./build.py deps` at the moonlight project root.
+ *
+ * - utfcpp (via `unicode.h`)
+ *   - Add `moonlight/deps` to your C++ include path.
+ *
+ * ## Usage ---------------------------------------------------------
+ * This library offers `ansi::Screen`, a grid of cells for full-screen
+ * terminal programs, each holding a grapheme cluster and an `ansi::Style`.
+ * A frame is drawn into the screen, then `present()` compares it with the
+ * frame which was last presented and writes only the cells which changed,
+ * using the shortest cursor movements and the fewest SGR attribute changes
+ * between them, in a single `write()`.
+ *
+ * ```
+ * ansi::Screen screen(80, 24);
+ * auto title = ansi::Style().with_fg(ansi::Color::index(3)).with(ansi::Style::BRIGHT);
+ * for (;;) {
+ *     screen.clear();
+ *     screen.print(0, 0, "Dashboard", title);
+ *     screen.print(0, 2, fmt::format("Requests: {}", requests));
+ *     screen.present(STDOUT_FILENO);
+ * }
+ * ```
+ *
+ * - `ansi::Color`: The terminal's `DEFAULT` color, one of the 256 indexed
+ *   colors, or a 24-bit `RGB` color.
+ * - `ansi::Style`: Foreground and background colors, and attribute flags
+ *   matching the effects in `fg::*`.
+ * - `clear(style)`: Fill the screen with blank cells.
+ * - `print(x, y, text, style)`: Write UTF8 text at a position, clipped at
+ *   the right edge.  Wide characters occupy two cells.  Returns the number of
+ *   columns written.
+ * - `at(x, y)`: The `ansi::Cell` at a position.
+ * - `render()`: The escape sequences which update the terminal from the last
+ *   frame to this one, as a string.  Empty if nothing changed.
+ * - `present(fd)`, `present(out)`: Render the frame and write it.
+ * - `invalidate()`: Clear the terminal and redraw everything on the next
+ *   frame, e.g. after other output was written to it.  This is also done on
+ *   the first frame and after `resize(cols, rows)`.
+ * - `synchronized(bool)`: Whether frames are wrapped in the synchronized
+ *   update sequences (DEC mode 2026), so that terminals which support them
+ *   draw each frame at once without tearing.  Enabled by default, and
+ *   ignored by terminals which don't support it.
+ *
+ * The screen assumes it owns the terminal between frames.  The cursor
+ * position and style are not assumed to persist across frames.
+ */
+
+#ifndef __MOONLIGHT_SCREEN_H
+#define __MOONLIGHT_SCREEN_H
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "moonlight/color.h"
+#include "moonlight/exceptions.h"
+#include "moonlight/unicode.h"
+
+namespace moonlight {
+namespace ansi {
+
+/**------------------------------------------------------------------
+ * A terminal color, packed for cheap comparison.
+ */
+struct Color {
+    enum Kind : uint8_t { DEFAULT, INDEXED, RGB };
+
+    Kind kind = DEFAULT;
+    uint8_t r = 0, g = 0, b = 0;
+
+    static Color none() {
+        return Color();
+    }
+
+    static Color index(uint8_t n) {
+        return Color{INDEXED, n, 0, 0};
+    }
+
+    static Color rgb(uint8_t r, uint8_t g, uint8_t b) {
+        return Color{RGB, r, g, b};
+    }
+
+    static Color rgb(const color::uRGB& color) {
+        return rgb(color.r, color.g, color.b);
+    }
+
+    bool operator==(const Color& rhs) const {
+        return kind == rhs.kind && r == rhs.r && g == rhs.g && b == rhs.b;
+    }
+
+    bool operator!=(const Color& rhs) const {
+        return ! (*this == rhs);
+    }
+};
+
+/**------------------------------------------------------------------
+ * Colors and attributes of a cell.
+ */
+struct Style {
+    enum Attribute : uint8_t {
+        BRIGHT = 1 << 0,
+        DIM = 1 << 1,
+        UNDERSCORE = 1 << 2,
+        BLINK = 1 << 3,
+        REVERSE = 1 << 4,
+        HIDDEN = 1 << 5
+    };
+
+    Color fg;
+    Color bg;
+    uint8_t attrs = 0;
+
+    Style with_fg(const Color& color) const {
+        Style style = *this;
+        style.fg = color;
+        return style;
+    }
+
+    Style with_bg(const Color& color) const {
+        Style style = *this;
+        style.bg = color;
+        return style;
+    }
+
+    Style with(Attribute attr) const {
+        Style style = *this;
+        style.attrs |= attr;
+        return style;
+    }
+
+    Style without(Attribute attr) const {
+        Style style = *this;
+        style.attrs &= ~attr;
+        return style;
+    }
+
+    bool operator==(const Style& rhs) const {
+        return fg == rhs.fg && bg == rhs.bg && attrs == rhs.attrs;
+    }
+
+    bool operator!=(const Style& rhs) const {
+        return ! (*this == rhs);
+    }
+};
+
+/**------------------------------------------------------------------
+ * A grapheme cluster and its style.  A wide cluster is followed by a
+ * continuation cell of width zero, with an empty glyph.
+ */
+struct Cell {
+    std::string glyph = " ";
+    Style style;
+    uint8_t width = 1;
+
+    bool operator==(const Cell& rhs) const {
+        return width == rhs.width && style == rhs.style && glyph == rhs.glyph;
+    }
+
+    bool operator!=(const Cell& rhs) const {
+        return ! (*this == rhs);
+    }
+};
+
+namespace _screen {
+
+inline void append_int(std::string& out, int n) {
+    char buffer[16];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), n);
+    out.append(buffer, result.ptr);
+}
+
+inline void append_color(std::string& out, const Color& color, int base) {
+    switch (color.kind) {
+    case Color::DEFAULT:
+        append_int(out, base + 9);
+        break;
+    case Color::INDEXED:
+        if (color.r < 8) {
+            append_int(out, base + color.r);
+        } else if (color.r < 16) {
+            append_int(out, base + 60 + color.r - 8);
+        } else {
+            append_int(out, base + 8);
+            out.append(";5;");
+            append_int(out, color.r);
+        }
+        break;
+    case Color::RGB:
+        append_int(out, base + 8);
+        out.append(";2;");
+        append_int(out, color.r);
+        out.push_back(';');
+        append_int(out, color.g);
+        out.push_back(';');
+        append_int(out, color.b);
+        break;
+    }
+}
+
+/**
+ * Append the SGR sequence which changes the terminal from style `from` to
+ * style `to`.  Attributes can only be turned off together, so removing any
+ * of them resets the style first.
+ */
+inline void append_sgr(std::string& out, const Style& from, const Style& to) {
+    static constexpr int ATTR_CODES[] = {1, 2, 4, 5, 7, 8};
+
+    bool reset = (from.attrs & ~to.attrs) != 0;
+    Style current = reset ? Style() : from;
+    bool first = true;
+    auto param = [&]() {
+        if (! first) {
+            out.push_back(';');
+        }
+        first = false;
+    };
+
+    out.append("\x1b[");
+    if (reset) {
+        param();
+        out.push_back('0');
+    }
+    for (int x = 0; x < 6; x++) {
+        if ((to.attrs & (1 << x)) && ! (current.attrs & (1 << x))) {
+            param();
+            append_int(out, ATTR_CODES[x]);
+        }
+    }
+    if (to.fg != current.fg) {
+        param();
+        append_color(out, to.fg, 30);
+    }
+    if (to.bg != current.bg) {
+        param();
+        append_color(out, to.bg, 40);
+    }
+    out.push_back('m');
+}
+
+}  // namespace _screen
+
+/**------------------------------------------------------------------
+ * A double-buffered grid of cells which writes only what changed.
+ */
+class Screen {
+ public:
+     Screen(int cols, int rows) {
+         resize(cols, rows);
+     }
+
+     int cols() const {
+         return _cols;
+     }
+
+     int rows() const {
+         return _rows;
+     }
+
+     Screen& resize(int cols, int rows) {
+         _cols = std::max(cols, 1);
+         _rows = std::max(rows, 1);
+         _back.assign(_cols * _rows, Cell());
+         return invalidate();
+     }
+
+     Screen& invalidate() {
+         _front.assign(_cols * _rows, Cell());
+         _invalid = true;
+         return *this;
+     }
+
+     Screen& synchronized(bool value) {
+         _synchronized = value;
+         return *this;
+     }
+
+     Cell& at(int x, int y) {
+         _check_bounds(x, y);
+         return _back[y * _cols + x];
+     }
+
+     const Cell& at(int x, int y) const {
+         _check_bounds(x, y);
+         return _back[y * _cols + x];
+     }
+
+     Screen& clear(const Style& style = Style()) {
+         Cell blank;
+         blank.style = style;
+         std::fill(_back.begin(), _back.end(), blank);
+         return *this;
+     }
+
+     int print(int x, int y, std::string_view text, const Style& style = Style()) {
+         if (y < 0 || y >= _rows || x < 0 || x >= _cols) {
+             return 0;
+         }
+
+         int start = x;
+         size_t offset = 0;
+         while (offset < text.size() && x < _cols) {
+             int width;
+             size_t next = unicode::next_grapheme(text, offset, &width);
+             if (width == 0) {
+                 // Control characters and lone combining marks take no space.
+                 offset = next;
+                 continue;
+             }
+             if (x + width > _cols) {
+                 break;
+             }
+
+             _put(x, y, text.substr(offset, next - offset), style, width);
+             x += width;
+             offset = next;
+         }
+         return x - start;
+     }
+
+     /**
+      * The escape sequences which update the terminal from the previous
+      * frame to this one.  The current frame becomes the previous frame.
+      */
+     std::string render() {
+         std::string out;
+         _Cursor cursor;
+
+         if (_invalid) {
+             out.append("\x1b[0m\x1b[2J");
+             _invalid = false;
+         }
+
+         for (int y = 0; y < _rows; y++) {
+             for (int x = 0; x < _cols;) {
+                 const Cell& cell = _back[y * _cols + x];
+                 int width = std::max<int>(cell.width, 1);
+                 if (! _changed(x, y, width)) {
+                     x += width;
+                     continue;
+                 }
+
+                 _move(out, cursor, x, y);
+                 _emit(out, cursor, cell);
+                 for (int z = 0; z < width; z++) {
+                     _front[y * _cols + x + z] = _back[y * _cols + x + z];
+                 }
+                 x += width;
+             }
+         }
+
+         if (out.empty()) {
+             return out;
+         }
+         if (cursor.style != Style()) {
+             out.append("\x1b[0m");
+         }
+         if (_synchronized) {
+             out.insert(0, "\x1b[?2026h");
+             out.append("\x1b[?2026l");
+         }
+         return out;
+     }
+
+     /**
+      * Render the frame and write it to the given file descriptor with as
+      * few `write()` calls as possible, returning the number of bytes.
+      */
+     size_t present(int fd) {
+         std::string frame = render();
+         size_t written = 0;
+         while (written < frame.size()) {
+             ssize_t n = ::write(fd, frame.data() + written, frame.size() - written);
+             if (n < 0) {
+                 if (errno == EINTR) {
+                     continue;
+                 }
+                 invalidate();
+                 THROW(core::RuntimeError, std::string("Failed to write frame: ") + strerror(errno));
+             }
+             written += n;
+         }
+         return written;
+     }
+
+     size_t present(std::ostream& out) {
+         std::string frame = render();
+         out.write(frame.data(), frame.size());
+         out.flush();
+         return frame.size();
+     }
+
+ private:
+     struct _Cursor {
+         // -1 when unknown, e.g. at the start of a frame or after the
+         // cursor reached the right edge and is pending a wrap.
+         int x = -1;
+         int y = -1;
+         Style style;
+     };
+
+     void _check_bounds(int x, int y) const {
+         if (x < 0 || x >= _cols || y < 0 || y >= _rows) {
+             THROW(core::IndexError, "Cell is out of bounds.");
+         }
+     }
+
+     /**
+      * Write a grapheme cluster into the back buffer, first blanking any
+      * wide cluster it overwrites part of.
+      */
+     void _put(int x, int y, std::string_view glyph, const Style& style, int width) {
+         Cell* row = &_back[y * _cols];
+         for (int z = x; z < x + width; z++) {
+             if (row[z].width == 0 && z > 0) {
+                 row[z - 1].glyph = " ";
+                 row[z - 1].width = 1;
+             }
+             if (row[z].width == 2 && z + 1 < _cols) {
+                 row[z + 1].glyph = " ";
+                 row[z + 1].width = 1;
+             }
+         }
+
+         row[x].glyph.assign(glyph);
+         row[x].style = style;
+         row[x].width = width;
+         for (int z = x + 1; z < x + width; z++) {
+             row[z].glyph.clear();
+             row[z].style = style;
+             row[z].width = 0;
+         }
+     }
+
+     bool _changed(int x, int y, int width) const {
+         for (int z = x; z < x + width && z < _cols; z++) {
+             if (_back[y * _cols + z] != _front[y * _cols + z]) {
+                 return true;
+             }
+         }
+         return false;
+     }
+
+     /**
+      * Move the cursor with the shortest sequence available: nothing, a
+      * relative move, rewriting a few unchanged cells in the current
+      * style, CR LF, or an absolute move.
+      */
+     void _move(std::string& out, _Cursor& cursor, int x, int y) {
+         if (cursor.y == y && cursor.x == x) {
+             return;
+         }
+
+         std::string absolute = "\x1b[";
+         _screen::append_int(absolute, y + 1);
+         absolute.push_back(';');
+         _screen::append_int(absolute, x + 1);
+         absolute.push_back('H');
+
+         if (cursor.y == y && cursor.x >= 0 && cursor.x < x) {
+             int gap = x - cursor.x;
+             if (gap <= (int)absolute.size() && _can_rewrite(cursor, y, gap)) {
+                 for (int z = cursor.x; z < x; z++) {
+                     out.append(_back[y * _cols + z].glyph);
+                 }
+                 cursor.x = x;
+                 return;
+             }
+
+             std::string relative = "\x1b[";
+             if (gap > 1) {
+                 _screen::append_int(relative, gap);
+             }
+             relative.push_back('C');
+             if (relative.size() < absolute.size()) {
+                 out.append(relative);
+                 cursor.x = x;
+                 return;
+             }
+         }
+
+         if (x == 0 && cursor.y >= 0 && y == cursor.y + 1 && cursor.x >= 0) {
+             out.append("\r\n");
+         } else {
+             out.append(absolute);
+         }
+         cursor.x = x;
+         cursor.y = y;
+     }
+
+     // Whether the cells before the cursor's destination can be written
+     // again as they are, which is only worthwhile for single-byte cells
+     // already in the current style.
+     bool _can_rewrite(const _Cursor& cursor, int y, int gap) const {
+         for (int z = cursor.x; z < cursor.x + gap; z++) {
+             const Cell& cell = _back[y * _cols + z];
+             if (cell.width != 1 || cell.glyph.size() != 1 || cell.style != cursor.style
+                 || cell != _front[y * _cols + z]) {
+                 return false;
+             }
+         }
+         return true;
+     }
+
+     void _emit(std::string& out, _Cursor& cursor, const Cell& cell) {
+         if (cell.style != cursor.style) {
+             _screen::append_sgr(out, cursor.style, cell.style);
+             cursor.style = cell.style;
+         }
+         out.append(cell.glyph.empty() ? " " : cell.glyph);
+         cursor.x += std::max<int>(cell.width, 1);
+         if (cursor.x >= _cols) {
+             cursor.x = -1;
+             cursor.y = -1;
+         }
+     }
+
+     int _cols = 0;
+     int _rows = 0;
+     std::vector<Cell> _back;
+     std::vector<Cell> _front;
+     bool _invalid = true;
+     bool _synchronized = true;
+};
+
+}  // namespace ansi
+}  // namespace moonlight
+
+#endif /* !__MOONLIGHT_SCREEN_H */
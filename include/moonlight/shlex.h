@@ -12,45 +12,219 @@
  *
  * - `shlex::split(s)`: Splits a given shell format string into its constituent
  *   parts, ala `argv`.
+ * - `shlex::split_all(lines)`: Splits many lines at once, see below.
  * - `shlex::join(v)`: Joins an array of strings together in shell format as a
  *   single `std::string`.
  * - `shlex.quote(s)`: Quotes any shell-escape characters in the given string.
+ *
+ * ## Tokenizing without copies -------------------------------------
+ * `shlex::Tokenizer` splits a `std::string_view` into `shlex::Token`s.  Each
+ * token's `value` is a view into the input wherever possible: plain words and
+ * quoted strings without escapes aren't copied.  Only tokens with escape
+ * sequences or adjacent quoted strings, e.g. `'a'"b"`, are materialized into
+ * the tokenizer's own buffer, which is reused by the next call to `next()`.
+ * Copy the value if you need it to live longer than that.
+ *
+ * ```
+ * shlex::Tokenizer tokens(line);
+ * while (auto token = tokens.next()) {
+ *     handle(token->value);
+ * }
+ * ```
+ *
+ * `shlex::split_all(lines)` splits each line in a range of lines and returns
+ * a `shlex::SplitLines`, which holds the tokens of every line as views.  Tokens
+ * which needed materializing are stored in one shared buffer, so splitting a
+ * batch of lines costs a handful of allocations rather than one per token.
+ * The views refer to the original lines, which must outlive the result.
+ *
+ * ```
+ * auto argvs = shlex::split_all(lines);
+ * for (size_t x = 0; x < argvs.size(); x++) {
+ *     for (std::string_view arg : argvs[x]) {
+ *         ...
+ *     }
+ * }
+ * ```
  */
 
 #ifndef __MOONLIGHT_SHLEX_H
 #define __MOONLIGHT_SHLEX_H
 
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <set>
-#include <map>
 #include <vector>
 
 #include "moonlight/generator.h"
-#include "moonlight/collect.h"
 #include "moonlight/file.h"
-#include "moonlight/rx.h"
+#include "moonlight/string.h"
 
 namespace moonlight {
 namespace shlex {
 
-//-------------------------------------------------------------------
-class ShellLexer {
+namespace _shlex {
+
+/**
+ * Maps the character after a backslash in a double-quote string to the
+ * character it represents, or to zero if the escape isn't recognized.
+ */
+constexpr std::array<char, 256> make_escape_table() {
+    std::array<char, 256> table = {};
+    table['a'] = '\a';
+    table['b'] = '\b';
+    table['e'] = '\e';
+    table['f'] = '\f';
+    table['n'] = '\n';
+    table['r'] = '\r';
+    table['t'] = '\t';
+    table['v'] = '\v';
+    table['\\'] = '\\';
+    table['\"'] = '\"';
+    return table;
+}
+
+/**
+ * Characters which never need quoting: `[A-Za-z0-9_@%+=:,./-]`.
+ */
+constexpr std::array<bool, 256> make_safe_table() {
+    std::array<bool, 256> table = {};
+    for (int c = '0'; c <= '9'; c++) {
+        table[c] = true;
+    }
+    for (int c = 'a'; c <= 'z'; c++) {
+        table[c] = true;
+        table[c - 'a' + 'A'] = true;
+    }
+    for (char c : std::string_view("_@%+=:,./-")) {
+        table[static_cast<uint8_t>(c)] = true;
+    }
+    return table;
+}
+
+inline constexpr auto ESCAPES = make_escape_table();
+inline constexpr auto SAFE = make_safe_table();
+
+inline bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline bool ends_word(char c) {
+    return is_blank(c) || c == '\n' || c == '#';
+}
+
+inline bool is_safe(std::string_view str) {
+    for (char c : str) {
+        if (! SAFE[static_cast<uint8_t>(c)]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Accumulates the value of a token as a view into the input for as long as
+ * it remains one contiguous span, copying it into `buffer` otherwise.
+ */
+class Value {
  public:
-     static std::string quote(const std::string& str) {
-         if (str.size() == 0) {
-             return "''";
+     explicit Value(std::string& buffer) : _buffer(buffer) { }
+
+     void append(const char* begin, const char* end) {
+         if (! _owned) {
+             if (_begin == nullptr) {
+                 _begin = begin;
+                 _end = end;
+                 return;
+             }
+             if (_end == begin) {
+                 _end = end;
+                 return;
+             }
+             _materialize();
          }
+         _buffer.append(begin, end);
+     }
 
-         if (rx::match(rx_unsafe(), str)) {
-             std::ostringstream sb;
-             auto result = rx::replace(rx_quotes(), str, "\'\"$1\"\'");
-             sb << '\'' << result << '\'';
-             return sb.str();
+     void push_back(char c) {
+         if (! _owned) {
+             _materialize();
+         }
+         _buffer.push_back(c);
+     }
+
+     bool owned() const {
+         return _owned;
+     }
 
-         } else {
-             return str;
+     std::string_view view() const {
+         if (_owned) {
+             return _buffer;
          }
+         return std::string_view(_begin, _end - _begin);
+     }
+
+ private:
+     void _materialize() {
+         _buffer.assign(_begin, _end);
+         _owned = true;
+     }
+
+     std::string& _buffer;
+     const char* _begin = nullptr;
+     const char* _end = nullptr;
+     bool _owned = false;
+};
+
+/**
+ * Append the shell-quoted form of `str` to `out`.
+ */
+inline void quote_into(std::string& out, std::string_view str) {
+    if (str.size() == 0) {
+        out += "''";
+        return;
+    }
+
+    if (is_safe(str)) {
+        out += str;
+        return;
+    }
+
+    // Runs of single quotes are closed out, double quoted, and reopened.
+    out.push_back('\'');
+    for (size_t x = 0; x < str.size();) {
+        if (str[x] != '\'') {
+            size_t next = str.find('\'', x);
+            next = next == std::string_view::npos ? str.size() : next;
+            out.append(str.substr(x, next - x));
+            x = next;
+
+        } else {
+            size_t next = str.find_first_not_of('\'', x);
+            next = next == std::string_view::npos ? str.size() : next;
+            out += "\'\"";
+            out.append(str.substr(x, next - x));
+            out += "\"\'";
+            x = next;
+        }
+    }
+    out.push_back('\'');
+}
+
+}  // namespace _shlex
+
+//-------------------------------------------------------------------
+class ShellLexer {
+ public:
+     static std::string quote(const std::string& str) {
+         std::string result;
+         _shlex::quote_into(result, str);
+         return result;
      }
 
      gen::Iterator<std::string> begin() {
@@ -94,6 +268,9 @@ class ShellLexer {
              return {};
          case ' ':
          case '\t':
+         case '\r':
+         case '\v':
+         case '\f':
              while (isspace(input().peek()) && input().peek() != '\n') input().advance();
              return read_token();
          default:
@@ -159,10 +336,10 @@ class ShellLexer {
                      THROW(core::ValueError, "Incomplete escape sequence in double-quote string.");
                  }
 
-                 auto iter = escape_map().find(c);
-                 if (iter != escape_map().end()) {
+                 char escaped = _shlex::ESCAPES[static_cast<uint8_t>(c)];
+                 if (escaped != 0) {
                      input().advance();
-                     str.push_back(iter->second);
+                     str.push_back(escaped);
 
                  } else {
                      THROW(core::ValueError, "Unrecognized escape sequence in double-quote string.");
@@ -193,32 +370,6 @@ class ShellLexer {
          return str;
      }
 
-     static const std::map<char, char>& escape_map() {
-         static const std::map<char, char> escape_sequences = {
-             {'a', '\a'},
-             {'b', '\b'},
-             {'e', '\e'},
-             {'f', '\f'},
-             {'n', '\n'},
-             {'r', '\r'},
-             {'t', '\t'},
-             {'v', '\v'},
-             {'\\', '\\'},
-             {'\"', '\"'}
-         };
-         return escape_sequences;
-     }
-
-     static const rx::Expression& rx_unsafe() {
-         static const auto regex = rx::def("[^\\w@%\\-+=:,./]");
-         return regex;
-     }
-
-     static const rx::Expression& rx_quotes() {
-         static const auto regex = rx::def("(\'+)");
-         return regex;
-     }
-
      std::set<char> _punctuation = {};
 };
 
@@ -236,24 +387,310 @@ class ShellStringLexer : public ShellLexer {
      file::BufferedInput _input;
 };
 
+/**------------------------------------------------------------------
+ * A token read by `shlex::Tokenizer`.
+ *
+ * `value` is the token's text with quotes removed and escapes resolved,
+ * and `source` is the span of the input it was read from.  If `owned` is
+ * true, `value` lives in the tokenizer's buffer, otherwise it is a view into
+ * the input.
+ */
+struct Token {
+    std::string_view value;
+    std::string_view source;
+    bool owned = false;
+};
+
+/**------------------------------------------------------------------
+ * Splits a string into shell tokens without copying, following the same
+ * rules as `ShellLexer`.
+ */
+class Tokenizer {
+ public:
+     explicit Tokenizer(std::string_view input = {}) : _input(input) { }
+
+     Tokenizer& punctuation(std::string_view punctuation) {
+         _punctuation.fill(false);
+         for (char c : punctuation) {
+             _punctuation[static_cast<uint8_t>(c)] = true;
+         }
+         return *this;
+     }
+
+     /**
+      * Start tokenizing a new input, keeping the punctuation and buffer.
+      */
+     Tokenizer& reset(std::string_view input) {
+         _input = input;
+         _pos = 0;
+         return *this;
+     }
+
+     /**
+      * Read the next token, or nothing at the end of the input or at the
+      * start of a comment.  A materialized token's value is only valid until
+      * the next call.
+      */
+     std::optional<Token> next() {
+         while (_pos < _input.size() && _shlex::is_blank(_input[_pos])) {
+             _pos++;
+         }
+
+         if (_pos >= _input.size()) {
+             return {};
+         }
+
+         size_t start = _pos;
+         char c = _input[_pos];
+
+         if (_punctuation[static_cast<uint8_t>(c)] || c == '\n') {
+             _pos++;
+             return _token(_input.substr(start, 1), start, false);
+         }
+
+         switch (c) {
+         case '#':
+             _pos = _input.size();
+             return {};
+         case '\'':
+         case '\"':
+             return _read_quoted(start);
+         default:
+             while (_pos < _input.size() && ! _shlex::ends_word(_input[_pos])) {
+                 _pos++;
+             }
+             return _token(_input.substr(start, _pos - start), start, false);
+         }
+     }
+
+ private:
+     Token _token(std::string_view value, size_t start, bool owned) const {
+         return Token{value, _input.substr(start, _pos - start), owned};
+     }
+
+     /**
+      * Read a quoted string, along with any quoted strings immediately
+      * following it.
+      */
+     Token _read_quoted(size_t start) {
+         _shlex::Value value(_buffer);
+         const char* data = _input.data();
+
+         while (_pos < _input.size() && (_input[_pos] == '\'' || _input[_pos] == '\"')) {
+             char quote = _input[_pos++];
+             size_t run = _pos;
+
+             for (;;) {
+                 if (_pos >= _input.size()) {
+                     if (quote == '\'') {
+                         THROW(core::ValueError, "Unterminated single-quote string.");
+                     }
+                     THROW(core::ValueError, "Unterminated double-quote string.");
+                 }
+
+                 char c = _input[_pos];
+
+                 if (c == quote) {
+                     value.append(data + run, data + _pos);
+                     _pos++;
+                     break;
+                 }
+
+                 if (c != '\\') {
+                     _pos++;
+                     continue;
+                 }
+
+                 if (_pos + 1 >= _input.size()) {
+                     if (quote == '\'') {
+                         THROW(core::ValueError, "Incomplete escape sequence in single-quote string.");
+                     }
+                     THROW(core::ValueError, "Incomplete escape sequence in double-quote string.");
+                 }
+
+                 char next = _input[_pos + 1];
+                 char escaped;
+
+                 if (quote == '\'') {
+                     if (next != '\\' && next != '\'') {
+                         // Any other backslash is taken literally.
+                         _pos++;
+                         continue;
+                     }
+                     escaped = next;
+
+                 } else {
+                     escaped = _shlex::ESCAPES[static_cast<uint8_t>(next)];
+                     if (escaped == 0) {
+                         THROW(core::ValueError, "Unrecognized escape sequence in double-quote string.");
+                     }
+                 }
+
+                 value.append(data + run, data + _pos);
+                 value.push_back(escaped);
+                 _pos += 2;
+                 run = _pos;
+             }
+         }
+
+         return _token(value.view(), start, value.owned());
+     }
+
+     std::string_view _input;
+     size_t _pos = 0;
+     std::string _buffer;
+     std::array<bool, 256> _punctuation = {};
+};
+
+/**------------------------------------------------------------------
+ * The tokens of a batch of lines, see `shlex::split_all()`.
+ */
+class SplitLines {
+ public:
+     SplitLines() { }
+
+     // Tokens in the arena view the arena itself, which moves when the
+     // arena is copied or moved, or may even live inside it when it is
+     // short.  These re-point them at the new arena.
+     SplitLines(const SplitLines& other)
+     : _tokens(other._tokens), _line_ends(other._line_ends),
+     _owned(other._owned), _arena(other._arena) {
+         _resolve();
+     }
+
+     SplitLines(SplitLines&& other) noexcept
+     : _tokens(std::move(other._tokens)), _line_ends(std::move(other._line_ends)),
+     _owned(std::move(other._owned)), _arena(std::move(other._arena)) {
+         _resolve();
+     }
+
+     SplitLines& operator=(const SplitLines& other) {
+         if (this != &other) {
+             _tokens = other._tokens;
+             _line_ends = other._line_ends;
+             _owned = other._owned;
+             _arena = other._arena;
+             _resolve();
+         }
+         return *this;
+     }
+
+     SplitLines& operator=(SplitLines&& other) noexcept {
+         if (this != &other) {
+             _tokens = std::move(other._tokens);
+             _line_ends = std::move(other._line_ends);
+             _owned = std::move(other._owned);
+             _arena = std::move(other._arena);
+             _resolve();
+         }
+         return *this;
+     }
+
+     size_t size() const {
+         return _line_ends.size();
+     }
+
+     bool empty() const {
+         return size() == 0;
+     }
+
+     std::span<const std::string_view> operator[](size_t line) const {
+         size_t start = line == 0 ? 0 : _line_ends[line - 1];
+         return std::span<const std::string_view>(
+             _tokens.data() + start, _line_ends[line] - start);
+     }
+
+     std::vector<std::string> argv(size_t line) const {
+         auto tokens = (*this)[line];
+         return std::vector<std::string>(tokens.begin(), tokens.end());
+     }
+
+ private:
+     template<class Range>
+     friend SplitLines split_all(const Range& lines);
+
+     /**
+      * Tokenize a line and add its tokens as the next line.
+      */
+     void add(Tokenizer& tokenizer, std::string_view line) {
+         tokenizer.reset(line);
+         while (auto token = tokenizer.next()) {
+             if (token->owned) {
+                 // Point into the arena once it has stopped growing.
+                 _owned.push_back({_tokens.size(), _arena.size()});
+                 _arena.append(token->value);
+                 _tokens.push_back(std::string_view(nullptr, token->value.size()));
+
+             } else {
+                 _tokens.push_back(token->value);
+             }
+         }
+         _line_ends.push_back(_tokens.size());
+     }
+
+     /**
+      * Resolve materialized tokens into views of the arena.  The arena
+      * offsets in `_owned` are kept so that copies can resolve them again.
+      */
+     void _resolve() {
+         for (auto [index, offset] : _owned) {
+             _tokens[index] = std::string_view(_arena).substr(offset, _tokens[index].size());
+         }
+     }
+
+     std::vector<std::string_view> _tokens;
+     std::vector<size_t> _line_ends;
+     std::vector<std::pair<size_t, size_t>> _owned;
+     std::string _arena;
+};
+
 //-------------------------------------------------------------------
-inline std::vector<std::string> split(const std::string& str) {
-    auto lex = ShellStringLexer(str);
+inline std::vector<std::string> split(std::string_view str) {
+    Tokenizer tokenizer(str);
     std::vector<std::string> argv;
-    for (auto iter = lex.begin(); iter != lex.end(); iter++) {
-        argv.push_back(*iter);
+    while (auto token = tokenizer.next()) {
+        argv.emplace_back(token->value);
     }
     return argv;
 }
 
+/**------------------------------------------------------------------
+ * Split each line in a range of lines.  The lines must outlive the result.
+ */
+template<class Range>
+SplitLines split_all(const Range& lines) {
+    SplitLines result;
+    Tokenizer tokenizer;
+    for (const auto& line : lines) {
+        result.add(tokenizer, line);
+    }
+    result._resolve();
+    return result;
+}
+
 //-------------------------------------------------------------------
-inline std::string quote(const std::string& str) {
-    return ShellLexer::quote(str);
+inline std::string quote(std::string_view str) {
+    std::string result;
+    _shlex::quote_into(result, str);
+    return result;
 }
 
 //-------------------------------------------------------------------
 inline std::string join(const std::vector<std::string>& cmd) {
-    return str::join(collect::map<std::string>(cmd, quote), " ");
+    size_t size = cmd.size();
+    for (const auto& arg : cmd) {
+        size += arg.size() + 2;
+    }
+
+    std::string result;
+    result.reserve(size);
+    for (size_t x = 0; x < cmd.size(); x++) {
+        if (x > 0) {
+            result.push_back(' ');
+        }
+        _shlex::quote_into(result, cmd[x]);
+    }
+    return result;
 }
 
 }  // namespace shlex
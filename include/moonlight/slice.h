@@ -11,14 +11,50 @@
  * It offers the following function templates:
  *
  * - `slice(C, start=None, end=None)`: Slices the given collection.
+ * - `slice(C, start, end, step)`: Slices the given collection, taking every
+ *   `step`th item.  A negative step walks the collection backwards.
  * - `slice_offset(C, offset, clip=false)`: Gets the offset into the iterable
  *   collection represented by the given offset value.
+ *
+ * `slice()` returns a copy of the sliced items.  To slice without copying,
+ * use `slice_view()`, which takes the same arguments and returns a view into
+ * the collection in constant time, without allocating:
+ *
+ * - Strings and string views are sliced into a `std::basic_string_view`.
+ * - Other contiguous collections, e.g. `std::vector` and `std::array`, are
+ *   sliced into a `std::span`, which is mutable if the collection is.
+ * - Slices with a step, and slices of other random access collections, e.g.
+ *   `std::deque`, are `StridedView`s, a random access range over every
+ *   `step`th item.
+ *
+ * Views may be passed to `gen::stream()` and the `collect` functions, or
+ * sliced again.  A view doesn't own its items, so the collection must outlive
+ * it and must not be resized while it is in use.  `slice_view()` won't take
+ * a temporary collection, unless it is itself a view.
+ *
+ * ```
+ * std::vector<int> v = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+ * slice_view(v, -3, {});         // {7, 8, 9}
+ * slice_view(v, {}, {}, -2);     // {9, 7, 5, 3, 1}
+ * slice_view("moonlight"sv, 4, {});  // "light"
+ * ```
+ *
+ * As in Python, out of range start and end offsets are clipped to the
+ * collection, and a step of zero throws `core::ValueError`.
  */
 
 #ifndef __MOONLIGHT_SLICE_H
 #define __MOONLIGHT_SLICE_H
 
+#include <compare>
+#include <cstddef>
+#include <iterator>
 #include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
 #include "moonlight/exceptions.h"
 
@@ -38,7 +74,7 @@ inline size_t slice_offset(const C& coll, int offset, bool clip = false) {
         }
     }
 
-    if (offset >= coll.size()) {
+    if (size_t(offset) >= coll.size()) {
         if (clip) {
             offset = coll.size();
         } else {
@@ -59,15 +95,284 @@ inline typename C::value_type slice(const C& coll, int int_offset) {
 //-------------------------------------------------------------------
 template<class C>
 inline C slice(const C& coll, std::optional<int> int_offset_start, std::optional<int> int_offset_end) {
-    C result;
     size_t offset_start = slice_offset(coll, int_offset_start.value_or(0), true);
     size_t offset_end = slice_offset(coll, int_offset_end.value_or(coll.size()), true);
 
-    for (size_t x = offset_start; x < offset_end; x++) {
-        result.push_back(coll[x]);
+    if (offset_end <= offset_start) {
+        return C();
+    }
+    return C(coll.begin() + offset_start, coll.begin() + offset_end);
+}
+
+namespace _slice {
+
+/**
+ * The offset of the first item, the step, and the number of items in a
+ * slice, following Python's `slice.indices()`.
+ */
+struct Indices {
+    ptrdiff_t start;
+    ptrdiff_t step;
+    size_t count;
+};
+
+inline Indices indices(size_t size, std::optional<ptrdiff_t> start,
+                       std::optional<ptrdiff_t> end, ptrdiff_t step) {
+    if (step == 0) {
+        THROW(core::ValueError, "Slice step cannot be zero.");
+    }
+
+    ptrdiff_t len = size;
+    auto clip = [&](std::optional<ptrdiff_t> offset, ptrdiff_t default_offset) {
+        if (! offset.has_value()) {
+            return default_offset;
+        }
+        ptrdiff_t x = *offset;
+        if (x < 0) {
+            x += len;
+            if (x < 0) {
+                x = step < 0 ? -1 : 0;
+            }
+        } else if (x >= len) {
+            x = step < 0 ? len - 1 : len;
+        }
+        return x;
+    };
+
+    ptrdiff_t first = clip(start, step < 0 ? len - 1 : 0);
+    ptrdiff_t last = clip(end, step < 0 ? -1 : len);
+    size_t count = 0;
+
+    if (step > 0 && first < last) {
+        count = (last - first - 1) / step + 1;
+    } else if (step < 0 && last < first) {
+        count = (first - last - 1) / -step + 1;
+    }
+    return {count == 0 ? 0 : first, step, count};
+}
+
+template<class T>
+struct is_string : public std::false_type { };
+
+template<class CharT, class Traits, class Alloc>
+struct is_string<std::basic_string<CharT, Traits, Alloc>> : public std::true_type { };
+
+template<class CharT, class Traits>
+struct is_string<std::basic_string_view<CharT, Traits>> : public std::true_type { };
+
+template<class C>
+concept Sliceable = std::ranges::random_access_range<C> && std::ranges::sized_range<C>;
+
+template<class C>
+concept Viewable = Sliceable<C> && (std::is_lvalue_reference_v<C> || std::ranges::borrowed_range<C>);
+
+/**
+ * The iterator type of views over `C`, a pointer if `C` is contiguous.
+ */
+template<class C>
+auto view_begin(C& coll) {
+    if constexpr (std::ranges::contiguous_range<C>) {
+        return std::ranges::data(coll);
+    } else {
+        return std::ranges::begin(coll);
+    }
+}
+
+}  // namespace _slice
+
+//-------------------------------------------------------------------
+/**
+ * A random access view over every `step`th item of a range, starting at
+ * `first`.  The step may be negative.
+ */
+template<class I>
+class StridedView : public std::ranges::view_base {
+ public:
+     typedef std::iter_value_t<I> value_type;
+     typedef std::iter_reference_t<I> reference;
+     typedef size_t size_type;
+     typedef ptrdiff_t difference_type;
+
+     class iterator {
+      public:
+          typedef std::random_access_iterator_tag iterator_category;
+          typedef std::random_access_iterator_tag iterator_concept;
+          typedef std::iter_value_t<I> value_type;
+          typedef std::iter_reference_t<I> reference;
+          typedef ptrdiff_t difference_type;
+          typedef void pointer;
+
+          iterator() { }
+          iterator(I first, ptrdiff_t step, ptrdiff_t index)
+          : _first(first), _step(step), _index(index) { }
+
+          reference operator*() const {
+              return _first[_index * _step];
+          }
+
+          reference operator[](difference_type n) const {
+              return _first[(_index + n) * _step];
+          }
+
+          iterator& operator++() {
+              _index++;
+              return *this;
+          }
+
+          iterator operator++(int) {
+              iterator prev = *this;
+              _index++;
+              return prev;
+          }
+
+          iterator& operator--() {
+              _index--;
+              return *this;
+          }
+
+          iterator operator--(int) {
+              iterator prev = *this;
+              _index--;
+              return prev;
+          }
+
+          iterator& operator+=(difference_type n) {
+              _index += n;
+              return *this;
+          }
+
+          iterator& operator-=(difference_type n) {
+              _index -= n;
+              return *this;
+          }
+
+          friend iterator operator+(iterator iter, difference_type n) {
+              return iter += n;
+          }
+
+          friend iterator operator+(difference_type n, iterator iter) {
+              return iter += n;
+          }
+
+          friend iterator operator-(iterator iter, difference_type n) {
+              return iter -= n;
+          }
+
+          friend difference_type operator-(const iterator& a, const iterator& b) {
+              return a._index - b._index;
+          }
+
+          friend bool operator==(const iterator& a, const iterator& b) {
+              return a._index == b._index;
+          }
+
+          friend auto operator<=>(const iterator& a, const iterator& b) {
+              return a._index <=> b._index;
+          }
+
+      private:
+          I _first = I();
+          ptrdiff_t _step = 1;
+          ptrdiff_t _index = 0;
+     };
+
+     typedef iterator const_iterator;
+
+     StridedView() { }
+     StridedView(I first, ptrdiff_t step, size_t count)
+     : _first(first), _step(step), _count(count) { }
+
+     iterator begin() const {
+         return iterator(_first, _step, 0);
+     }
+
+     iterator end() const {
+         return iterator(_first, _step, _count);
+     }
+
+     size_t size() const {
+         return _count;
+     }
+
+     bool empty() const {
+         return _count == 0;
+     }
+
+     ptrdiff_t step() const {
+         return _step;
+     }
+
+     reference operator[](size_t offset) const {
+         return _first[offset * _step];
+     }
+
+     reference front() const {
+         return (*this)[0];
+     }
+
+     reference back() const {
+         return (*this)[_count - 1];
+     }
+
+ private:
+     I _first = I();
+     ptrdiff_t _step = 1;
+     size_t _count = 0;
+};
+
+}  // namespace moonlight
+
+namespace std::ranges {
+
+template<class I>
+inline constexpr bool enable_borrowed_range<moonlight::StridedView<I>> = true;
+
+}  // namespace std::ranges
+
+namespace moonlight {
+
+//-------------------------------------------------------------------
+/**
+ * Slice the given collection into a view, without copying.
+ */
+template<class C>
+requires _slice::Viewable<C>
+inline auto slice_view(C&& coll, std::optional<ptrdiff_t> start = {}, std::optional<ptrdiff_t> end = {}) {
+    auto ix = _slice::indices(std::ranges::size(coll), start, end, 1);
+    auto first = _slice::view_begin(coll) + ix.start;
+    typedef std::remove_cvref_t<C> Collection;
+
+    if constexpr (_slice::is_string<Collection>::value) {
+        return std::basic_string_view<typename Collection::value_type,
+                                      typename Collection::traits_type>(first, ix.count);
+    } else if constexpr (std::ranges::contiguous_range<C>) {
+        return std::span(first, ix.count);
+    } else {
+        return StridedView<decltype(first)>(first, 1, ix.count);
     }
+}
+
+/**
+ * Slice the given collection into a view of every `step`th item, without
+ * copying.
+ */
+template<class C>
+requires _slice::Viewable<C>
+inline auto slice_view(C&& coll, std::optional<ptrdiff_t> start, std::optional<ptrdiff_t> end, ptrdiff_t step) {
+    auto ix = _slice::indices(std::ranges::size(coll), start, end, step);
+    auto first = _slice::view_begin(coll) + ix.start;
+    return StridedView<decltype(first)>(first, ix.step, ix.count);
+}
 
-    return result;
+//-------------------------------------------------------------------
+/**
+ * Copy every `step`th item of the given slice of the collection.
+ */
+template<class C>
+requires _slice::Sliceable<const C&>
+inline C slice(const C& coll, std::optional<ptrdiff_t> start, std::optional<ptrdiff_t> end, ptrdiff_t step) {
+    auto view = slice_view(coll, start, end, step);
+    return C(view.begin(), view.end());
 }
 
 }  // namespace moonlight
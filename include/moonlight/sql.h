@@ -9,9 +9,11 @@
 #ifndef __MOONLIGHT_SQL_H
 #define __MOONLIGHT_SQL_H
 
-#include <format>
+#include "moonlight/format.h"
 #include "moonlight/linked_map.h"
+#include "moonlight/meta.h"
 #include "moonlight/generator.h"
+#include "moonlight/symbol.h"
 
 namespace moonlight {
 namespace sql {
@@ -28,32 +30,19 @@ public:
 
     template<class T>
     T get() const {
-        static_assert(always_false<T>(), "Column value can't be converted to the given type.");
-    }
-
-    template<>
-    std::string get<std::string>() const {
-        return as_str();
-    }
-
-    template<>
-    int get<int>() const {
-        return as_int();
-    }
-
-    template<>
-    double get<double>() const {
-        return as_double();
-    }
-
-    template<>
-    float get<float>() const {
-        return as_float();
-    }
-
-    template<>
-    std::vector<char> get<std::vector<char>>() const {
-        return as_bytes();
+        if constexpr (std::is_same_v<T, std::string>) {
+            return as_str();
+        } else if constexpr (std::is_same_v<T, int>) {
+            return as_int();
+        } else if constexpr (std::is_same_v<T, double>) {
+            return as_double();
+        } else if constexpr (std::is_same_v<T, float>) {
+            return as_float();
+        } else if constexpr (std::is_same_v<T, std::vector<char>>) {
+            return as_bytes();
+        } else {
+            static_assert(always_false<T>::value, "Column value can't be converted to the given type.");
+        }
     }
 
     virtual std::string name() const = 0;
@@ -80,25 +69,28 @@ public:
 
     Column& at(int offset) const {
         if (offset >= length()) {
-            THROW(Error, std::format("Column offset out of bounds: {}", offset));
+            THROW(Error, fmt::format("Column offset out of bounds: {}", offset));
         }
         return *_columns.at_offset(offset);
     }
 
-    Column& at(const std::string& key) const {
-        auto iter = _columns.find(key);
+    Column& at(std::string_view key) const {
+        // Column names are interned, so a name which was never interned
+        // cannot be a column in any row.
+        auto symbol = str::Symbol::find(key);
+        auto iter = symbol.has_value() ? _columns.find(*symbol) : _columns.end();
         if (iter == _columns.end()) {
-            THROW(Error, std::format("Column not found: '{}'", key));
+            THROW(Error, fmt::format("Column not found: '{}'", key));
         }
         return *iter->second;
     }
 
+    Column& at(const std::string& key) const {
+        return at(std::string_view(key));
+    }
+
     Column& at(const char* name) const {
-        auto iter = _columns.find(std::string(name));
-        if (iter == _columns.end()) {
-            THROW(Error, std::format("Column not found: '{}'", name));
-        }
-        return *iter->second;
+        return at(std::string_view(name));
     }
 
 protected:
@@ -107,7 +99,7 @@ protected:
     }
 
 private:
-    moonlight::linked_map<std::string, Column::Pointer> _columns;
+    moonlight::linked_map<str::Symbol, Column::Pointer> _columns;
 };
 
 //-------------------------------------------------------------------
@@ -9,8 +9,13 @@
 #define __MOONLIGHT_SQLITE3_H
 
 #include <sqlite3.h>
+#include "moonlight/alloc.h"
 #include "moonlight/sql.h"
 
+#ifdef MOONLIGHT_ENABLE_METRICS
+#include "moonlight/metrics.h"
+#endif
+
 namespace moonlight {
 namespace sqlite {
 
@@ -86,7 +91,7 @@ class Row : public sql::Row {
      : _statement(statement) {
          int size = sqlite3_data_count(statement);
          for (int x = 0; x < size; x++) {
-             add_column(std::make_shared<Column>(_statement, x));
+             add_column(alloc::make_shared<Column>(_statement, x));
          }
      }
 
@@ -122,6 +127,14 @@ class Client : public sql::Client {
 
      moonlight::gen::Stream<sql::Row::Pointer> vquery(const std::string& query,
                                                       const std::vector<std::string>& params) override {
+#ifdef MOONLIGHT_ENABLE_METRICS
+         static auto& queries = metrics::counter("moonlight_sql_queries_total", "SQL queries run.");
+         static auto& errors = metrics::counter("moonlight_sql_errors_total", "SQL query errors.");
+         static auto& rows = metrics::counter("moonlight_sql_rows_total", "SQL result rows read.");
+         static auto& query_ns = metrics::histogram("moonlight_sql_query_ns", "SQL query time to the first row in nanoseconds.");
+         metrics::Timer timer(query_ns, &errors);
+         queries.inc();
+#endif
          int status;
          sqlite3_stmt* statement = nullptr;
 
@@ -147,6 +160,7 @@ class Client : public sql::Client {
 
              if (status != SQLITE_OK) {
                  auto message = std::string(sqlite3_errstr(status));
+                 sqlite3_finalize(statement);
                  THROW(BindError, message);
              }
          }
@@ -156,10 +170,12 @@ class Client : public sql::Client {
          switch (status) {
          case SQLITE_OK:
          case SQLITE_DONE:
+             sqlite3_finalize(statement);
              return moonlight::gen::nothing<sql::Row::Pointer>();
          case SQLITE_ROW:
              break;
          default:
+             sqlite3_finalize(statement);
              THROW(QueryError, std::string(sqlite3_errstr(status)));
          }
 
@@ -178,13 +194,19 @@ class Client : public sql::Client {
              }
 
              if (status == SQLITE_ROW) {
-                 return std::make_shared<Row>(statement);
+#ifdef MOONLIGHT_ENABLE_METRICS
+                 rows.inc();
+#endif
+                 return alloc::make_shared<Row>(statement);
 
              } else if (status == SQLITE_DONE) {
                  sqlite3_finalize(statement);
                  return {};
 
              } else {
+#ifdef MOONLIGHT_ENABLE_METRICS
+                 errors.inc();
+#endif
                  THROW(IterationError, std::string(sqlite3_errstr(status)));
              }
          };
@@ -11,11 +11,13 @@
  * other languages to C++.  The following templates and free-functions are
  * offered:
  *
- * - `str::coerce(v)`: Attempts to convert the given value to a string using
- *   `operator<<`.  If this isn't possible, the type name of the value enclosed
- *   in angle brackets `<type>` is emitted instead.
+ * - `str::coerce(v)`: Converts the given value to a string using
+ *   `fmt::write_default()` from `format.h`, which writes values as
+ *   `operator<<` would, and falls back to `operator<<` for user types.  If this
+ *   isn't possible, the type name of the value enclosed in angle brackets
+ *   `<type>` is emitted instead.
  * - `str::cat(v, ...)`: Joins one or more elements together as a single string.
- *   Non-string values are coerced to strings using `operator<<`.
+ *   Non-string values are coerced to strings as with `str::coerce()`.
  * - `str::startswith(s, prefix)`: Determine if `s` begins with `prefix`.
  * - `str::endswith(s, suffix)`: Determine if `s` ends with `suffix`.
  * - `str::join(C, token="")`: Join an iterable into a token delimited string.
@@ -29,42 +31,59 @@
  *   it exists there.
  * - `str::map(s, f(c))`: Apply a function to each character in a string to
  *   create a new string.
- * - `str::to_upper(s)`: Convert all characters in a string to uppercase.
- * - `str::to_lower(s)`: Convert all characters in a string to lowercase.
+ * - `str::to_upper(s)`: Convert all ASCII letters in a string to uppercase.
+ * - `str::to_lower(s)`: Convert all ASCII letters in a string to lowercase.
+ * - `str::to_upper_inplace(s)`, `str::to_lower_inplace(s)`: Same as above, but
+ *   modifies the given string instead of making a copy.
+ * - `str::iequals(a, b)`: Determine if two strings are equal ignoring ASCII
+ *   case.
+ * - `str::icompare(a, b)`: Compare two strings lexicographically ignoring
+ *   ASCII case, returning a negative, zero, or positive value.
+ * - `str::ihash(s)`: Hash a string ignoring ASCII case.
+ * - `str::IHash`, `str::IEqual`, `str::ILess`: Functors wrapping the above,
+ *   for use as the hash, equality, or ordering of case-insensitive map keys,
+ *   e.g. `std::unordered_map<std::string, V, str::IHash, str::IEqual>`.
  * - `str::literal(s)`: Format the given string as a C string literal, minus the
  *   enclosing double quotes.
  * - `str::literalize(s)`: Format the given string as a C literal enclosed in
  *   double quotes.
+ *
+ * Case conversion and comparison use SSE2, or AVX2 where the CPU supports it,
+ * on x86 targets.  Define `MOONLIGHT_NO_SIMD` to use only the scalar versions.
  */
 
 #ifndef __MOONLIGHT_STRING_H
 #define __MOONLIGHT_STRING_H
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <sstream>
+#include <string_view>
 #include <iomanip>
 #include <string>
 #include <vector>
 #include <map>
+#include "moonlight/constants.h"
+#include "moonlight/format.h"
+#include "moonlight/hash.h"
 #include "moonlight/traits.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__SSE2__)) && ! defined(MOONLIGHT_NO_SIMD)
+#define MOONLIGHT_STRING_SIMD_X86
+#include <immintrin.h>
+#endif
+
 namespace moonlight {
 
 namespace str {
 
 template<typename T>
 inline std::string coerce(const T& value) {
-    std::ostringstream sb;
-
-    if constexpr (is_streamable<T>()) {
-        sb << value;
-
-    } else {
-        sb << "<" << type_name<T>() << ">";
-    }
-
-    return sb.str();
+    fmt::Buffer buf;
+    fmt::write_default(buf, value);
+    return buf.str();
 }
 
 template<>
@@ -76,21 +95,9 @@ inline std::string coerce(const char* value) {
     return std::string(value);
 }
 
-inline void _cat(std::ostringstream& sb) {
-    (void) sb;
-}
-
-template<typename T, typename... TD>
-inline void _cat(std::ostringstream& sb, const T& element, const TD&... elements) {
-    sb << element;
-    _cat(sb, elements...);
-}
-
 template<typename T, typename... TD>
 inline std::string cat(const T element, const TD&... elements) {
-    std::ostringstream sb;
-    _cat(sb, element, elements...);
-    return sb.str();
+    return fmt::cat(element, elements...);
 }
 
 /**------------------------------------------------------------------
@@ -116,15 +123,15 @@ inline bool endswith(const std::string& str,
  */
 template<typename T>
 inline std::string join(const T& coll, const std::string& token = "") {
-    std::ostringstream sb;
+    fmt::Buffer buf;
 
     for (typename T::const_iterator i = coll.begin(); i != coll.end();
          i++) {
-        if (i != coll.begin()) sb << std::string(token);
-        sb << *i;
+        if (i != coll.begin()) buf.append(token);
+        fmt::write_default(buf, *i);
     }
 
-    return sb.str();
+    return buf.str();
 }
 
 /**------------------------------------------------------------------
@@ -256,20 +263,289 @@ inline std::string map(const std::string& s, std::function<char(char)> transform
     return result;
 }
 
+namespace _ascii {
+
+/**
+ * Flip the case of every byte of `src` within `lo..hi` into `dst`,
+ * returning the number of bytes processed.  `dst` may equal `src`.
+ */
+inline size_t convert_scalar(char* dst, const char* src, size_t n, char lo, char hi) {
+    for (size_t x = 0; x < n; x++) {
+        char c = src[x];
+        dst[x] = (c >= lo && c <= hi) ? c ^ 0x20 : c;
+    }
+    return n;
+}
+
+/**
+ * Flip the case of each ASCII byte within `lo..hi` in a 64-bit word.
+ */
+inline uint64_t convert_word(uint64_t w, char lo, char hi) {
+    const uint64_t ones = 0x0101010101010101ull;
+    const uint64_t heptets = w & (0x7F * ones);
+    const uint64_t above_hi = heptets + (0x7F - hi) * ones;
+    const uint64_t at_least_lo = heptets + (0x80 - lo) * ones;
+    const uint64_t in_range = ~w & (at_least_lo ^ above_hi) & (0x80 * ones);
+    return w ^ (in_range >> 2);
+}
+
+inline size_t convert_swar(char* dst, const char* src, size_t n, char lo, char hi) {
+    size_t x = 0;
+    for (; x + 8 <= n; x += 8) {
+        uint64_t w;
+        std::memcpy(&w, src + x, 8);
+        w = convert_word(w, lo, hi);
+        std::memcpy(dst + x, &w, 8);
+    }
+    return x;
+}
+
+inline char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? c ^ 0x20 : c;
+}
+
+inline size_t mismatch_scalar(const char* a, const char* b, size_t n) {
+    size_t x = 0;
+    for (; x < n && lower(a[x]) == lower(b[x]); x++) { }
+    return x;
+}
+
+inline size_t mismatch_swar(const char* a, const char* b, size_t n) {
+    size_t x = 0;
+    for (; x + 8 <= n; x += 8) {
+        uint64_t wa, wb;
+        std::memcpy(&wa, a + x, 8);
+        std::memcpy(&wb, b + x, 8);
+        if (wa != wb && convert_word(wa, 'A', 'Z') != convert_word(wb, 'A', 'Z')) {
+            break;
+        }
+    }
+    return x;
+}
+
+#ifdef MOONLIGHT_STRING_SIMD_X86
+inline __m128i lower_sse2(__m128i v) {
+    const __m128i lo = _mm_set1_epi8('A' - 1);
+    const __m128i hi = _mm_set1_epi8('Z' + 1);
+    const __m128i mask = _mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmplt_epi8(v, hi));
+    return _mm_or_si128(v, _mm_and_si128(mask, _mm_set1_epi8(0x20)));
+}
+
+inline size_t convert_sse2(char* dst, const char* src, size_t n, char lo, char hi) {
+    const __m128i vlo = _mm_set1_epi8(lo - 1);
+    const __m128i vhi = _mm_set1_epi8(hi + 1);
+    const __m128i flip = _mm_set1_epi8(0x20);
+    size_t x = 0;
+
+    for (; x + 16 <= n; x += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        __m128i mask = _mm_and_si128(_mm_cmpgt_epi8(v, vlo), _mm_cmplt_epi8(v, vhi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+                         _mm_xor_si128(v, _mm_and_si128(mask, flip)));
+    }
+    return x;
+}
+
+inline size_t mismatch_sse2(const char* a, const char* b, size_t n) {
+    size_t x = 0;
+
+    for (; x + 16 <= n; x += 16) {
+        __m128i va = lower_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x)));
+        __m128i vb = lower_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x)));
+        unsigned int eq = _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+        if (eq != 0xFFFF) {
+            return x + __builtin_ctz(~eq);
+        }
+    }
+    return x;
+}
+
+__attribute__((target("avx2")))
+inline __m256i lower_avx2(__m256i v) {
+    const __m256i lo = _mm256_set1_epi8('A' - 1);
+    const __m256i hi = _mm256_set1_epi8('Z' + 1);
+    const __m256i mask = _mm256_and_si256(_mm256_cmpgt_epi8(v, lo), _mm256_cmpgt_epi8(hi, v));
+    return _mm256_or_si256(v, _mm256_and_si256(mask, _mm256_set1_epi8(0x20)));
+}
+
+__attribute__((target("avx2")))
+inline size_t convert_avx2(char* dst, const char* src, size_t n, char lo, char hi) {
+    const __m256i vlo = _mm256_set1_epi8(lo - 1);
+    const __m256i vhi = _mm256_set1_epi8(hi + 1);
+    const __m256i flip = _mm256_set1_epi8(0x20);
+    size_t x = 0;
+
+    for (; x + 32 <= n; x += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x));
+        __m256i mask = _mm256_and_si256(_mm256_cmpgt_epi8(v, vlo), _mm256_cmpgt_epi8(vhi, v));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x),
+                            _mm256_xor_si256(v, _mm256_and_si256(mask, flip)));
+    }
+    return x;
+}
+
+__attribute__((target("avx2")))
+inline size_t mismatch_avx2(const char* a, const char* b, size_t n) {
+    size_t x = 0;
+
+    for (; x + 32 <= n; x += 32) {
+        __m256i va = lower_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + x)));
+        __m256i vb = lower_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + x)));
+        unsigned int eq = _mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb));
+        if (eq != 0xFFFFFFFF) {
+            return x + __builtin_ctz(~eq);
+        }
+    }
+    return x;
+}
+
+inline bool has_avx2() {
+    static const bool result = __builtin_cpu_supports("avx2");
+    return result;
+}
+#endif
+
+inline void convert(char* dst, const char* src, size_t n, char lo, char hi) {
+    size_t x = 0;
+#ifdef MOONLIGHT_STRING_SIMD_X86
+    if (n >= 32 && has_avx2()) {
+        x = convert_avx2(dst, src, n, lo, hi);
+    }
+    x += convert_sse2(dst + x, src + x, n - x, lo, hi);
+#endif
+    x += convert_swar(dst + x, src + x, n - x, lo, hi);
+    convert_scalar(dst + x, src + x, n - x, lo, hi);
+}
+
+/**
+ * @return The offset of the first byte where `a` and `b` differ when
+ *    compared case-insensitively, or `n` if they are equal.
+ */
+inline size_t mismatch(const char* a, const char* b, size_t n) {
+    size_t x = 0;
+#ifdef MOONLIGHT_STRING_SIMD_X86
+    if (n >= 32 && has_avx2()) {
+        x = mismatch_avx2(a, b, n);
+        if (x < n - n % 32) {
+            return x;
+        }
+    }
+    size_t y = mismatch_sse2(a + x, b + x, n - x);
+    if (y < (n - x) - (n - x) % 16) {
+        return x + y;
+    }
+    x += y;
+#endif
+    x += mismatch_swar(a + x, b + x, n - x);
+    return x + mismatch_scalar(a + x, b + x, n - x);
+}
+
+}  // namespace _ascii
+
+/**------------------------------------------------------------------
+ * Convert ASCII letters in the string to uppercase in place.
+ */
+inline void to_upper_inplace(std::string& s) {
+    _ascii::convert(s.data(), s.data(), s.size(), 'a', 'z');
+}
+
+/**------------------------------------------------------------------
+ * Convert ASCII letters in the string to lowercase in place.
+ */
+inline void to_lower_inplace(std::string& s) {
+    _ascii::convert(s.data(), s.data(), s.size(), 'A', 'Z');
+}
+
+/**------------------------------------------------------------------
+ * Convert ASCII letters in the string to uppercase.
+ */
+inline std::string to_upper(std::string_view s) {
+    std::string result(s.size(), '\0');
+    _ascii::convert(result.data(), s.data(), s.size(), 'a', 'z');
+    return result;
+}
+
+/**------------------------------------------------------------------
+ * Convert ASCII letters in the string to lowercase.
+ */
+inline std::string to_lower(std::string_view s) {
+    std::string result(s.size(), '\0');
+    _ascii::convert(result.data(), s.data(), s.size(), 'A', 'Z');
+    return result;
+}
+
 /**------------------------------------------------------------------
- * Apply `toupper` to each character in the string.
+ * Determine if two strings are equal, ignoring ASCII case.
  */
-inline std::string to_upper(const std::string& s) {
-    return map(s, [](char c) { return toupper(c); });
+inline bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+    _ascii::mismatch(a.data(), b.data(), a.size()) == a.size();
 }
 
 /**------------------------------------------------------------------
- * Apply `tolower` to each character in the string.
+ * Compare two strings lexicographically, ignoring ASCII case.
+ *
+ * @return A negative value if `a` sorts before `b`, a positive value if
+ *    `a` sorts after `b`, or zero if they are equal.
  */
-inline std::string to_lower(const std::string& s) {
-    return map(s, [](char c) { return tolower(c); });
+inline int icompare(std::string_view a, std::string_view b) {
+    size_t n = std::min(a.size(), b.size());
+    size_t x = _ascii::mismatch(a.data(), b.data(), n);
+
+    if (x < n) {
+        return static_cast<unsigned char>(_ascii::lower(a[x])) -
+        static_cast<unsigned char>(_ascii::lower(b[x]));
+    }
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
 }
 
+/**------------------------------------------------------------------
+ * Hash a string, ignoring ASCII case.  Strings which are `iequals()`
+ * have the same hash.
+ */
+inline size_t ihash(std::string_view s) {
+    char chunk[MOONLIGHT_STRING_IHASH_CHUNK];
+    size_t seed = 0;
+
+    do {
+        size_t n = std::min(s.size(), sizeof(chunk));
+        _ascii::convert(chunk, s.data(), n, 'A', 'Z');
+        hash::combine(seed, std::string_view(chunk, n));
+        s.remove_prefix(n);
+    } while (! s.empty());
+
+    return seed;
+}
+
+/**------------------------------------------------------------------
+ * Case-insensitive hash, equality, and ordering functors, usable as
+ * keys for `std::unordered_map` and `std::map`.  Each supports
+ * heterogeneous lookup by `std::string_view`.
+ */
+struct IHash {
+    typedef void is_transparent;
+
+    size_t operator()(std::string_view s) const {
+        return ihash(s);
+    }
+};
+
+struct IEqual {
+    typedef void is_transparent;
+
+    bool operator()(std::string_view a, std::string_view b) const {
+        return iequals(a, b);
+    }
+};
+
+struct ILess {
+    typedef void is_transparent;
+
+    bool operator()(std::string_view a, std::string_view b) const {
+        return icompare(a, b) < 0;
+    }
+};
+
 // ------------------------------------------------------------------
 inline std::string literal(const std::string& str, bool xsieve = true) {
     static const std::map<char, std::string> ESCAPE_SEQUENCES = {
@@ -0,0 +1,774 @@
+/*
+ * ## subprocess.h: Running child processes without a shell. --------
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * ## Usage ---------------------------------------------------------
+ * This library runs commands with `posix_spawn`, passing `argv` directly to
+ * the program rather than through `/bin/sh`, in the spirit of Python's
+ * `subprocess` module.  A command's stdout and stderr are captured separately,
+ * and input may be fed to its stdin.  Many commands may be run at once by a
+ * `sys::ProcessPool`, which multiplexes their I/O with `epoll` on a single
+ * thread and starts no more than a given number of them at a time.
+ *
+ * ```
+ * auto result = sys::run("git rev-parse HEAD");
+ * if (result.ok()) {
+ *     std::cout << result.out;
+ * }
+ *
+ * sys::ProcessPool pool(8);
+ * auto future = pool.submit(sys::Command({"sort", "-u"}).with_input(text));
+ * for (auto& result : pool.map(commands)) {
+ *     std::cout << result.argv[0] << ": " << result.returncode << std::endl;
+ * }
+ * ```
+ *
+ * - `sys::Command`: The `argv` of a program to run, along with optional
+ *   stdin input, environment, working directory and timeout.  A command may
+ *   be constructed from a string, which is split into `argv` with
+ *   `shlex::split()`.  Without input, stdin is `/dev/null`.
+ * - `sys::CompletedProcess`: The `returncode`, which is negative if the
+ *   process was killed by a signal, the captured `out` and `err`, whether it
+ *   `timed_out`, and the `elapsed` time.  `check()` returns `out`, or throws
+ *   `core::RuntimeError` like `sys::check()` if the command failed.
+ * - `sys::run(cmd)`: Run a command and wait for it to complete.
+ * - `sys::ProcessPool(max_procs)`: Run commands on a background thread, at
+ *   most `max_procs` at a time.
+ *   - `submit(cmd)`: Returns a `std::future<CompletedProcess>`.
+ *   - `map(cmds)`: Returns a `gen::Stream<CompletedProcess>` yielding
+ *     results in the order in which the commands complete.
+ *
+ * A command which can't be started, e.g. because the program doesn't exist,
+ * throws `core::RuntimeError` from `run()`, or from `get()` on its future.
+ * When a command times out it is sent `SIGKILL`.  Destroying a
+ * `ProcessPool` waits for the commands submitted to it to complete.
+ */
+
+#ifndef __MOONLIGHT_SUBPROCESS_H
+#define __MOONLIGHT_SUBPROCESS_H
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "moonlight/constants.h"
+#include "moonlight/exceptions.h"
+#include "moonlight/generator.h"
+#include "moonlight/shlex.h"
+
+namespace moonlight {
+namespace sys {
+
+namespace fs = std::filesystem;
+
+/**------------------------------------------------------------------
+ * A program to run, and how to run it.
+ */
+struct Command {
+    std::vector<std::string> argv;
+    std::string input;
+    std::optional<std::vector<std::string>> env;
+    std::optional<fs::path> cwd;
+    std::chrono::milliseconds timeout = std::chrono::milliseconds::zero();
+
+    Command() { }
+    Command(const std::vector<std::string>& argv) : argv(argv) { }
+    Command(std::initializer_list<std::string> argv) : argv(argv) { }
+    Command(const std::string& cmdline) : argv(shlex::split(cmdline)) { }
+    Command(const char* cmdline) : Command(std::string(cmdline)) { }
+
+    Command& with_input(const std::string& input) {
+        this->input = input;
+        return *this;
+    }
+
+    // Replace the environment, as a list of "NAME=value" strings.
+    Command& with_env(const std::vector<std::string>& env) {
+        this->env = env;
+        return *this;
+    }
+
+    Command& with_cwd(const fs::path& cwd) {
+        this->cwd = cwd;
+        return *this;
+    }
+
+    Command& with_timeout(std::chrono::milliseconds timeout) {
+        this->timeout = timeout;
+        return *this;
+    }
+
+    std::string str() const {
+        return shlex::join(argv);
+    }
+};
+
+/**------------------------------------------------------------------
+ * The outcome of running a `Command`.
+ */
+struct CompletedProcess {
+    std::vector<std::string> argv;
+    int returncode = -1;
+    std::string out;
+    std::string err;
+    bool timed_out = false;
+    std::chrono::microseconds elapsed = std::chrono::microseconds::zero();
+
+    bool ok() const {
+        return returncode == 0 && ! timed_out;
+    }
+
+    const std::string& check() const {
+        if (timed_out) {
+#ifdef MOONLIGHT_SYS_HIDE_COMMANDS
+            THROW(core::RuntimeError, "Command timed out.");
+#else
+            THROW(core::RuntimeError, "Command \"" + shlex::join(argv) + "\" timed out.");
+#endif
+        }
+
+        if (returncode != 0) {
+#ifdef MOONLIGHT_SYS_HIDE_COMMANDS
+            THROW(core::RuntimeError, "Command failed with exit code " + std::to_string(returncode));
+#else
+            THROW(core::RuntimeError, "Command \"" + shlex::join(argv) + "\" failed with exit code " + std::to_string(returncode));
+#endif
+        }
+
+        return out;
+    }
+};
+
+namespace _subprocess {
+
+typedef std::chrono::steady_clock Clock;
+
+inline void close_fd(int& fd) {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+inline void set_nonblocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+/**
+ * A pidfd becomes readable when the process exits, which lets child exit be
+ * waited for with epoll alongside the child's pipes.  Returns -1 if pidfds
+ * aren't supported by the kernel.
+ */
+inline int pidfd_open(pid_t pid) {
+#ifdef SYS_pidfd_open
+    return syscall(SYS_pidfd_open, pid, 0);
+#else
+    return -1;
+#endif
+}
+
+/**
+ * Writing to the stdin of a child which has exited raises SIGPIPE, which is
+ * blocked on the thread running the children so that `write()` fails with
+ * EPIPE instead.  A SIGPIPE left pending is discarded before the previous
+ * signal mask is restored.
+ */
+class BlockSigpipe {
+ public:
+     BlockSigpipe() {
+         sigemptyset(&_sigpipe);
+         sigaddset(&_sigpipe, SIGPIPE);
+         pthread_sigmask(SIG_BLOCK, &_sigpipe, &_previous);
+     }
+
+     ~BlockSigpipe() {
+         if (! sigismember(&_previous, SIGPIPE)) {
+             struct timespec zero = {0, 0};
+             while (sigtimedwait(&_sigpipe, nullptr, &zero) > 0) { }
+             pthread_sigmask(SIG_SETMASK, &_previous, nullptr);
+         }
+     }
+
+ private:
+     sigset_t _sigpipe;
+     sigset_t _previous;
+};
+
+// ------------------------------------------------------------------
+class Child {
+ public:
+     enum Stream { STDIN, STDOUT, STDERR, EXIT };
+
+     explicit Child(Command cmd) : _cmd(std::move(cmd)) {
+         _result.argv = _cmd.argv;
+     }
+
+     Child(const Child&) = delete;
+     Child& operator=(const Child&) = delete;
+
+     ~Child() {
+         for (auto& fd : _fds) {
+             close_fd(fd);
+         }
+         if (_pid > 0 && ! _reaped) {
+             kill(_pid, SIGKILL);
+             waitpid(_pid, nullptr, 0);
+         }
+     }
+
+     void spawn() {
+         if (_cmd.argv.empty()) {
+             THROW(core::UsageError, "Command has no arguments.");
+         }
+
+         int in[2] = {-1, -1}, out[2] = {-1, -1}, err[2] = {-1, -1};
+         bool feed = ! _cmd.input.empty();
+
+         if ((feed && pipe2(in, O_CLOEXEC) != 0)
+             || pipe2(out, O_CLOEXEC) != 0
+             || pipe2(err, O_CLOEXEC) != 0) {
+             int error = errno;
+             for (int fd : {in[0], in[1], out[0], out[1], err[0], err[1]}) {
+                 close_fd(fd);
+             }
+             _throw_spawn_error(error);
+         }
+
+         posix_spawn_file_actions_t actions;
+         posix_spawn_file_actions_init(&actions);
+         if (feed) {
+             posix_spawn_file_actions_adddup2(&actions, in[0], STDIN_FILENO);
+         } else {
+             posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+         }
+         posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+         posix_spawn_file_actions_adddup2(&actions, err[1], STDERR_FILENO);
+         if (_cmd.cwd.has_value()) {
+             posix_spawn_file_actions_addchdir_np(&actions, _cmd.cwd->c_str());
+         }
+
+         // SIGPIPE is blocked while spawning, which the child shouldn't inherit.
+         posix_spawnattr_t attr;
+         sigset_t mask, defaults;
+         posix_spawnattr_init(&attr);
+         sigemptyset(&mask);
+         sigemptyset(&defaults);
+         sigaddset(&defaults, SIGPIPE);
+         posix_spawnattr_setsigmask(&attr, &mask);
+         posix_spawnattr_setsigdefault(&attr, &defaults);
+         posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+         std::vector<char*> argv = _cstrings(_cmd.argv);
+         std::vector<char*> envp;
+         if (_cmd.env.has_value()) {
+             envp = _cstrings(*_cmd.env);
+         }
+
+         _started = Clock::now();
+         int error = posix_spawnp(&_pid, argv[0], &actions, &attr, argv.data(),
+                                  _cmd.env.has_value() ? envp.data() : environ);
+
+         posix_spawn_file_actions_destroy(&actions);
+         posix_spawnattr_destroy(&attr);
+         close_fd(in[0]);
+         close_fd(out[1]);
+         close_fd(err[1]);
+
+         _fds[STDIN] = in[1];
+         _fds[STDOUT] = out[0];
+         _fds[STDERR] = err[0];
+
+         if (error != 0) {
+             _pid = -1;
+             _throw_spawn_error(error);
+         }
+
+         for (int fd : {_fds[STDIN], _fds[STDOUT], _fds[STDERR]}) {
+             if (fd >= 0) {
+                 set_nonblocking(fd);
+             }
+         }
+         _fds[EXIT] = pidfd_open(_pid);
+
+         if (_cmd.timeout > std::chrono::milliseconds::zero()) {
+             _deadline = _started + _cmd.timeout;
+         }
+     }
+
+     int fd(Stream stream) const {
+         return _fds[stream];
+     }
+
+     const std::optional<Clock::time_point>& deadline() const {
+         return _deadline;
+     }
+
+     /**
+      * Handle readiness of one of the child's descriptors.  Returns true if
+      * the descriptor was closed, and should no longer be watched.
+      */
+     bool handle(Stream stream) {
+         switch (stream) {
+         case STDIN:
+             return _write_input();
+         case STDOUT:
+             return _read_output(STDOUT, _result.out);
+         case STDERR:
+             return _read_output(STDERR, _result.err);
+         case EXIT:
+             _reap(WNOHANG);
+             return _fds[EXIT] < 0;
+         }
+         return false;
+     }
+
+     /**
+      * Kill the child if it has passed its deadline.  Once a killed child
+      * has been reaped, its output pipes are closed even if they haven't
+      * reached EOF, since they may have been inherited by its own children.
+      */
+     void check_deadline(Clock::time_point now) {
+         if (! _reaped && _deadline.has_value() && now >= *_deadline && ! _result.timed_out) {
+             kill(_pid, SIGKILL);
+             _result.timed_out = true;
+         }
+     }
+
+     /**
+      * Called when the output pipes are closed.  Without a pidfd, the
+      * child is waited for here, which blocks only if the child closed its
+      * stdout and stderr before exiting.
+      */
+     void finish_output() {
+         if (! _reaped && _fds[EXIT] < 0) {
+             _reap(0);
+         }
+     }
+
+     bool done() const {
+         return _reaped && _fds[STDOUT] < 0 && _fds[STDERR] < 0;
+     }
+
+     CompletedProcess& result() {
+         return _result;
+     }
+
+ private:
+     static std::vector<char*> _cstrings(const std::vector<std::string>& strings) {
+         std::vector<char*> result;
+         result.reserve(strings.size() + 1);
+         for (auto& s : strings) {
+             result.push_back(const_cast<char*>(s.c_str()));
+         }
+         result.push_back(nullptr);
+         return result;
+     }
+
+     [[noreturn]] void _throw_spawn_error(int error) {
+#ifdef MOONLIGHT_SYS_HIDE_COMMANDS
+         THROW(core::RuntimeError, std::string("Command could not be started: ") + strerror(error));
+#else
+         THROW(core::RuntimeError, "Command \"" + _cmd.str() + "\" could not be started: " + strerror(error));
+#endif
+     }
+
+     bool _write_input() {
+         while (_input_offset < _cmd.input.size()) {
+             ssize_t n = ::write(_fds[STDIN], _cmd.input.data() + _input_offset,
+                                 _cmd.input.size() - _input_offset);
+             if (n < 0) {
+                 if (errno == EAGAIN || errno == EINTR) {
+                     return false;
+                 }
+                 // The child closed its stdin (EPIPE), so the rest is dropped.
+                 break;
+             }
+             _input_offset += n;
+         }
+         close_fd(_fds[STDIN]);
+         return true;
+     }
+
+     bool _read_output(Stream stream, std::string& buffer) {
+         char chunk[MOONLIGHT_SUBPROCESS_READ_BUFSIZE];
+         for (;;) {
+             ssize_t n = ::read(_fds[stream], chunk, sizeof(chunk));
+             if (n > 0) {
+                 buffer.append(chunk, n);
+             } else if (n < 0 && errno == EINTR) {
+                 continue;
+             } else if (n < 0 && errno == EAGAIN) {
+                 return false;
+             } else {
+                 close_fd(_fds[stream]);
+                 return true;
+             }
+         }
+     }
+
+     void _reap(int options) {
+         int status;
+         pid_t pid;
+         while ((pid = waitpid(_pid, &status, options)) < 0 && errno == EINTR) { }
+         if (pid == 0) {
+             return;
+         }
+
+         _reaped = true;
+         _result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - _started);
+         if (pid > 0 && WIFEXITED(status)) {
+             _result.returncode = WEXITSTATUS(status);
+         } else if (pid > 0 && WIFSIGNALED(status)) {
+             _result.returncode = -WTERMSIG(status);
+         }
+
+         close_fd(_fds[EXIT]);
+         close_fd(_fds[STDIN]);
+         if (_result.timed_out) {
+             _read_output(STDOUT, _result.out);
+             _read_output(STDERR, _result.err);
+             close_fd(_fds[STDOUT]);
+             close_fd(_fds[STDERR]);
+         }
+     }
+
+     Command _cmd;
+     CompletedProcess _result;
+     pid_t _pid = -1;
+     int _fds[4] = {-1, -1, -1, -1};
+     size_t _input_offset = 0;
+     bool _reaped = false;
+     Clock::time_point _started;
+     std::optional<Clock::time_point> _deadline;
+};
+
+/**------------------------------------------------------------------
+ * Multiplexes the I/O of running children with epoll.  `wake()` may be
+ * called from any thread to interrupt `poll()`.
+ */
+class Reactor {
+ public:
+     Reactor() {
+         _epfd = epoll_create1(EPOLL_CLOEXEC);
+         _wakefd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+         if (_epfd < 0 || _wakefd < 0) {
+             close_fd(_epfd);
+             close_fd(_wakefd);
+             THROW(core::RuntimeError, std::string("Failed to create event loop: ") + strerror(errno));
+         }
+         struct epoll_event event = {};
+         event.events = EPOLLIN;
+         event.data.fd = _wakefd;
+         epoll_ctl(_epfd, EPOLL_CTL_ADD, _wakefd, &event);
+     }
+
+     Reactor(const Reactor&) = delete;
+     Reactor& operator=(const Reactor&) = delete;
+
+     ~Reactor() {
+         _children.clear();
+         close_fd(_epfd);
+         close_fd(_wakefd);
+     }
+
+     size_t size() const {
+         return _children.size();
+     }
+
+     void wake() {
+         uint64_t value = 1;
+         [[maybe_unused]] auto n = ::write(_wakefd, &value, sizeof(value));
+     }
+
+     void add(std::unique_ptr<Child> child) {
+         Child* ptr = child.get();
+         _children.emplace(ptr, std::move(child));
+         _watch(ptr, Child::STDIN, EPOLLOUT);
+         _watch(ptr, Child::STDOUT, EPOLLIN);
+         _watch(ptr, Child::STDERR, EPOLLIN);
+         _watch(ptr, Child::EXIT, EPOLLIN);
+     }
+
+     /**
+      * Wait for I/O on the running children, for at most `timeout_ms` or
+      * until the next child's deadline, and return those which completed.
+      */
+     std::vector<std::unique_ptr<Child>> poll(int timeout_ms = -1) {
+         auto now = Clock::now();
+         for (auto& [ptr, child] : _children) {
+             if (child->deadline().has_value() && ! child->result().timed_out) {
+                 auto until = std::chrono::ceil<std::chrono::milliseconds>(*child->deadline() - now).count();
+                 until = std::max<decltype(until)>(until, 0);
+                 timeout_ms = timeout_ms < 0 ? until : std::min<int>(timeout_ms, until);
+             }
+         }
+
+         struct epoll_event events[MOONLIGHT_SUBPROCESS_MAX_EVENTS];
+         int count;
+         while ((count = epoll_wait(_epfd, events, MOONLIGHT_SUBPROCESS_MAX_EVENTS, timeout_ms)) < 0
+                && errno == EINTR) { }
+
+         for (int x = 0; x < count; x++) {
+             int fd = events[x].data.fd;
+             if (fd == _wakefd) {
+                 uint64_t value;
+                 [[maybe_unused]] auto n = ::read(_wakefd, &value, sizeof(value));
+                 continue;
+             }
+
+             auto iter = _watches.find(fd);
+             if (iter == _watches.end()) {
+                 continue;
+             }
+             auto [child, stream] = iter->second;
+             if (child->fd(stream) != fd) {
+                 continue;
+             }
+             if (child->handle(stream)) {
+                 _unwatch(fd);
+             }
+         }
+
+         now = Clock::now();
+         std::vector<std::unique_ptr<Child>> completed;
+         for (auto iter = _children.begin(); iter != _children.end();) {
+             Child* child = iter->first;
+             child->check_deadline(now);
+             if (child->fd(Child::STDOUT) < 0 && child->fd(Child::STDERR) < 0) {
+                 child->finish_output();
+             }
+             _forget_closed(child);
+             if (child->done()) {
+                 completed.push_back(std::move(iter->second));
+                 iter = _children.erase(iter);
+             } else {
+                 iter++;
+             }
+         }
+         return completed;
+     }
+
+ private:
+     void _watch(Child* child, Child::Stream stream, uint32_t events) {
+         int fd = child->fd(stream);
+         if (fd < 0) {
+             return;
+         }
+         struct epoll_event event = {};
+         event.events = events;
+         event.data.fd = fd;
+         epoll_ctl(_epfd, EPOLL_CTL_ADD, fd, &event);
+         _watches.emplace(fd, std::make_pair(child, stream));
+     }
+
+     void _unwatch(int fd) {
+         // The descriptor is already closed, which removes it from epoll.
+         _watches.erase(fd);
+     }
+
+     /**
+      * Descriptors can be closed by a child other than in `handle()`, such
+      * as when it is reaped, and must be forgotten before they're reused.
+      */
+     void _forget_closed(Child* child) {
+         for (auto iter = _watches.begin(); iter != _watches.end();) {
+             auto [owner, stream] = iter->second;
+             if (owner == child && child->fd(stream) != iter->first) {
+                 iter = _watches.erase(iter);
+             } else {
+                 iter++;
+             }
+         }
+     }
+
+     int _epfd = -1;
+     int _wakefd = -1;
+     std::unordered_map<Child*, std::unique_ptr<Child>> _children;
+     std::unordered_map<int, std::pair<Child*, Child::Stream>> _watches;
+};
+
+}  // namespace _subprocess
+
+/**------------------------------------------------------------------
+ * Run a command and wait for it to complete.
+ */
+inline CompletedProcess run(const Command& cmd) {
+    _subprocess::BlockSigpipe block_sigpipe;
+    _subprocess::Reactor reactor;
+    auto child = std::make_unique<_subprocess::Child>(cmd);
+    child->spawn();
+    reactor.add(std::move(child));
+
+    for (;;) {
+        auto completed = reactor.poll();
+        if (! completed.empty()) {
+            return std::move(completed.front()->result());
+        }
+    }
+}
+
+/**------------------------------------------------------------------
+ * Runs commands on a background thread, at most `max_procs` at a time.
+ */
+class ProcessPool {
+ public:
+     explicit ProcessPool(size_t max_procs = std::thread::hardware_concurrency())
+     : _max_procs(std::max<size_t>(max_procs, 1)) {
+         _thread = std::thread([this]() { _run(); });
+     }
+
+     ProcessPool(const ProcessPool&) = delete;
+     ProcessPool& operator=(const ProcessPool&) = delete;
+
+     ~ProcessPool() {
+         std::unique_lock<std::mutex> lock(_mutex);
+         _stopping = true;
+         lock.unlock();
+         _reactor.wake();
+         _thread.join();
+     }
+
+     size_t max_procs() const {
+         return _max_procs;
+     }
+
+     std::future<CompletedProcess> submit(const Command& cmd) {
+         return _submit(cmd, nullptr);
+     }
+
+     gen::Stream<CompletedProcess> map(const std::vector<Command>& cmds) {
+         struct State {
+             std::mutex mutex;
+             std::condition_variable cv;
+             std::deque<size_t> ready;
+             std::vector<std::future<CompletedProcess>> futures;
+             size_t remaining;
+         };
+
+         auto state = std::make_shared<State>();
+         state->remaining = cmds.size();
+         state->futures.reserve(cmds.size());
+         for (size_t x = 0; x < cmds.size(); x++) {
+             state->futures.push_back(_submit(cmds[x], [state, x]() {
+                 std::unique_lock<std::mutex> lock(state->mutex);
+                 state->ready.push_back(x);
+                 lock.unlock();
+                 state->cv.notify_one();
+             }));
+         }
+
+         return gen::Stream<CompletedProcess>([state]() -> std::optional<CompletedProcess> {
+             if (state->remaining == 0) {
+                 return {};
+             }
+             std::unique_lock<std::mutex> lock(state->mutex);
+             state->cv.wait(lock, [&]() { return ! state->ready.empty(); });
+             size_t x = state->ready.front();
+             state->ready.pop_front();
+             state->remaining--;
+             lock.unlock();
+             return state->futures[x].get();
+         });
+     }
+
+ private:
+     struct Job {
+         Command cmd;
+         std::promise<CompletedProcess> promise;
+         std::function<void()> notify;
+     };
+
+     std::future<CompletedProcess> _submit(const Command& cmd, std::function<void()> notify) {
+         Job job{cmd, {}, notify};
+         auto future = job.promise.get_future();
+         std::unique_lock<std::mutex> lock(_mutex);
+         _pending.push_back(std::move(job));
+         lock.unlock();
+         _reactor.wake();
+         return future;
+     }
+
+     void _run() {
+         _subprocess::BlockSigpipe block_sigpipe;
+         std::unordered_map<_subprocess::Child*, Job> running;
+
+         for (;;) {
+             std::deque<Job> starting;
+             std::unique_lock<std::mutex> lock(_mutex);
+             while (! _pending.empty() && running.size() + starting.size() < _max_procs) {
+                 starting.push_back(std::move(_pending.front()));
+                 _pending.pop_front();
+             }
+             if (_stopping && _pending.empty() && starting.empty() && running.empty()) {
+                 break;
+             }
+             lock.unlock();
+
+             for (auto& job : starting) {
+                 auto child = std::make_unique<_subprocess::Child>(job.cmd);
+                 try {
+                     child->spawn();
+                 } catch (...) {
+                     _complete(job, std::current_exception());
+                     continue;
+                 }
+                 running.emplace(child.get(), std::move(job));
+                 _reactor.add(std::move(child));
+             }
+
+             for (auto& child : _reactor.poll()) {
+                 auto iter = running.find(child.get());
+                 iter->second.promise.set_value(std::move(child->result()));
+                 if (iter->second.notify) {
+                     iter->second.notify();
+                 }
+                 running.erase(iter);
+             }
+         }
+     }
+
+     void _complete(Job& job, std::exception_ptr error) {
+         job.promise.set_exception(error);
+         if (job.notify) {
+             job.notify();
+         }
+     }
+
+     size_t _max_procs;
+     _subprocess::Reactor _reactor;
+     std::mutex _mutex;
+     std::deque<Job> _pending;
+     bool _stopping = false;
+     std::thread _thread;
+};
+
+}  // namespace sys
+}  // namespace moonlight
+
+#endif /* !__MOONLIGHT_SUBPROCESS_H */
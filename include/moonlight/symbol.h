@@ -0,0 +1,343 @@
+/*
+ * ## symbol.h: A global, thread-safe string interning pool. --------
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * ## Usage ---------------------------------------------------------
+ * This library offers `str::Symbol`, a pointer-sized handle to an interned,
+ * immutable string.  Each distinct string is stored exactly once in a
+ * process-wide pool, so symbols are cheap to copy, compare for equality in
+ * constant time, and carry a precomputed hash.  Use symbols for names which
+ * are repeated many times over, such as logger names, column names, or lexer
+ * token types.
+ *
+ * ```
+ * str::Symbol a = "Content-Type";
+ * str::Symbol b = std::string("Content-Type");
+ * assert(a == b && a.c_str() == b.c_str());
+ * ```
+ *
+ * - `str::Symbol(s)`: Intern the given string, returning a handle to it.  The
+ *   default constructed symbol is the empty string.
+ * - `str::Symbol::find(s)`: Look up the given string without interning it,
+ *   returning an empty `std::optional` if it has never been interned.
+ * - `str::Symbol::stats()`: Get the number of interned strings and the
+ *   number of bytes used to store them.
+ *
+ * Symbols convert implicitly to `std::string` and `std::string_view` and
+ * compare with plain strings, so they can often replace `std::string`
+ * members without changing how those members are used.  Symbols order
+ * lexicographically and provide `std::hash`, so they may be used as keys in
+ * ordered and unordered containers, including `linked_map`.
+ *
+ * The pool is split into `MOONLIGHT_SYMBOL_SHARDS` shards, each guarded by a
+ * reader-writer lock, so that lookups of existing symbols from many threads
+ * do not contend with each other.  Each shard stores its strings in an arena
+ * of `MOONLIGHT_SYMBOL_CHUNK_SIZE` byte chunks, so interning a string does
+ * not allocate it separately.  Interned strings are never freed.
+ */
+
+#ifndef __MOONLIGHT_SYMBOL_H
+#define __MOONLIGHT_SYMBOL_H
+
+#include <compare>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "moonlight/constants.h"
+#include "moonlight/format.h"
+
+namespace moonlight {
+namespace str {
+
+namespace _symbol {
+
+/**
+ * The header of an interned string, which is followed immediately by the
+ * string's bytes and a terminating NUL in the shard's arena.
+ */
+struct Entry {
+    size_t hash;
+    size_t size;
+
+    const char* data() const {
+        return reinterpret_cast<const char*>(this + 1);
+    }
+
+    std::string_view view() const {
+        return std::string_view(data(), size);
+    }
+};
+
+struct Key {
+    std::string_view view;
+    size_t hash;
+
+    bool operator==(const Key& rhs) const {
+        return view == rhs.view;
+    }
+};
+
+struct KeyHash {
+    size_t operator()(const Key& key) const {
+        return key.hash;
+    }
+};
+
+// ------------------------------------------------------------------
+class Shard {
+ public:
+     const Entry* find(const Key& key) const {
+         std::shared_lock lock(_mutex);
+         auto iter = _index.find(key);
+         return iter == _index.end() ? nullptr : iter->second;
+     }
+
+     const Entry* intern(const Key& key) {
+         const Entry* entry = find(key);
+         if (entry != nullptr) {
+             return entry;
+         }
+
+         std::unique_lock lock(_mutex);
+         auto iter = _index.find(key);
+         if (iter != _index.end()) {
+             return iter->second;
+         }
+
+         // Arena chunks are never moved or freed, so the index can refer to
+         // the bytes stored after the entry itself.
+         size_t size = sizeof(Entry) + key.view.size() + 1;
+         Entry* new_entry = new (allocate(size)) Entry{key.hash, key.view.size()};
+         char* data = reinterpret_cast<char*>(new_entry + 1);
+         key.view.copy(data, key.view.size());
+         data[key.view.size()] = '\0';
+
+         _index.emplace(Key{new_entry->view(), key.hash}, new_entry);
+         _bytes += size;
+         return new_entry;
+     }
+
+     size_t size() const {
+         std::shared_lock lock(_mutex);
+         return _index.size();
+     }
+
+     size_t bytes() const {
+         std::shared_lock lock(_mutex);
+         return _bytes;
+     }
+
+ private:
+     /**
+      * Take `size` bytes aligned for an `Entry` from the current chunk,
+      * starting a new chunk if it is full.  Strings too large to share a
+      * chunk get one of their own.
+      */
+     char* allocate(size_t size) {
+         size = (size + alignof(Entry) - 1) & ~(alignof(Entry) - 1);
+
+         if (size > MOONLIGHT_SYMBOL_CHUNK_SIZE / 4) {
+             return _chunks.emplace_back(new char[size]).get();
+         }
+
+         if (_chunk_used + size > MOONLIGHT_SYMBOL_CHUNK_SIZE) {
+             _chunk = _chunks.emplace_back(new char[MOONLIGHT_SYMBOL_CHUNK_SIZE]).get();
+             _chunk_used = 0;
+         }
+
+         char* ptr = _chunk + _chunk_used;
+         _chunk_used += size;
+         return ptr;
+     }
+
+     mutable std::shared_mutex _mutex;
+     std::vector<std::unique_ptr<char[]>> _chunks;
+     char* _chunk = nullptr;
+     size_t _chunk_used = MOONLIGHT_SYMBOL_CHUNK_SIZE;
+     std::unordered_map<Key, const Entry*, KeyHash> _index;
+     size_t _bytes = 0;
+};
+
+// ------------------------------------------------------------------
+class Pool {
+ public:
+     static Pool& instance() {
+         // Never destroyed, so symbols remain valid during static destruction.
+         static Pool* pool = new Pool();
+         return *pool;
+     }
+
+     Shard& shard(size_t hash) {
+         return _shards[(hash >> 8) % MOONLIGHT_SYMBOL_SHARDS];
+     }
+
+     const Shard& shard_at(size_t offset) const {
+         return _shards[offset];
+     }
+
+ private:
+     Pool() { }
+
+     Shard _shards[MOONLIGHT_SYMBOL_SHARDS];
+};
+
+inline const Entry* empty_entry() {
+    struct Empty {
+        Entry entry;
+        char data = '\0';
+    };
+    static const Empty empty = {{std::hash<std::string_view>()(""), 0}};
+    return &empty.entry;
+}
+
+}  // namespace _symbol
+
+/**------------------------------------------------------------------
+ * Statistics about the global symbol pool.
+ */
+struct SymbolStats {
+    size_t count = 0;
+    size_t bytes = 0;
+};
+
+/**------------------------------------------------------------------
+ * A handle to an interned string.
+ */
+class Symbol {
+ public:
+     Symbol() : _entry(_symbol::empty_entry()) { }
+     Symbol(std::string_view s) : _entry(intern(s)) { }
+     Symbol(const std::string& s) : Symbol(std::string_view(s)) { }
+     Symbol(const char* s) : Symbol(std::string_view(s)) { }
+
+     static std::optional<Symbol> find(std::string_view s) {
+         if (s.empty()) {
+             return Symbol();
+         }
+
+         size_t hash = std::hash<std::string_view>()(s);
+         const _symbol::Entry* entry = _symbol::Pool::instance().shard(hash).find({s, hash});
+         if (entry == nullptr) {
+             return {};
+         }
+         return Symbol(entry);
+     }
+
+     static SymbolStats stats() {
+         SymbolStats stats;
+         const auto& pool = _symbol::Pool::instance();
+         for (size_t x = 0; x < MOONLIGHT_SYMBOL_SHARDS; x++) {
+             stats.count += pool.shard_at(x).size();
+             stats.bytes += pool.shard_at(x).bytes();
+         }
+         return stats;
+     }
+
+     std::string str() const {
+         return std::string(view());
+     }
+
+     std::string_view view() const {
+         return _entry->view();
+     }
+
+     const char* c_str() const {
+         return _entry->data();
+     }
+
+     size_t size() const {
+         return _entry->size;
+     }
+
+     bool empty() const {
+         return _entry->size == 0;
+     }
+
+     size_t hash() const {
+         return _entry->hash;
+     }
+
+     operator std::string() const {
+         return str();
+     }
+
+     operator std::string_view() const {
+         return view();
+     }
+
+     bool operator==(const Symbol& rhs) const {
+         return _entry == rhs._entry;
+     }
+
+     bool operator==(std::string_view rhs) const {
+         return view() == rhs;
+     }
+
+     bool operator==(const std::string& rhs) const {
+         return view() == rhs;
+     }
+
+     bool operator==(const char* rhs) const {
+         return view() == rhs;
+     }
+
+     std::strong_ordering operator<=>(const Symbol& rhs) const {
+         if (_entry == rhs._entry) {
+             return std::strong_ordering::equal;
+         }
+         return view() <=> rhs.view();
+     }
+
+     friend std::ostream& operator<<(std::ostream& out, const Symbol& symbol) {
+         return out << symbol.view();
+     }
+
+ private:
+     explicit Symbol(const _symbol::Entry* entry) : _entry(entry) { }
+
+     static const _symbol::Entry* intern(std::string_view s) {
+         if (s.empty()) {
+             return _symbol::empty_entry();
+         }
+
+         size_t hash = std::hash<std::string_view>()(s);
+         return _symbol::Pool::instance().shard(hash).intern({s, hash});
+     }
+
+     const _symbol::Entry* _entry;
+};
+
+}  // namespace str
+
+// ------------------------------------------------------------------
+template<>
+struct fmt::Formatter<str::Symbol> {
+    static void write(fmt::Buffer& buf, const str::Symbol& symbol) {
+        buf.append(symbol.view());
+    }
+};
+
+}  // namespace moonlight
+
+// ------------------------------------------------------------------
+template<>
+struct std::hash<moonlight::str::Symbol> {
+    size_t operator()(const moonlight::str::Symbol& symbol) const {
+        return symbol.hash();
+    }
+};
+
+#endif /* !__MOONLIGHT_SYMBOL_H */
@@ -13,6 +13,8 @@
  * - `sys::getenv(name)`: Get an env variable value if defined.  Use `cli::getenv` instead.
  * - `sys::check(cmd)`: Fetch the output from a given shell command.  Throws
  *   `core::RuntimeError` if the command yielded a non-zero return code.`
+ *
+ * To run commands without a shell, or many at once, see `subprocess.h`.
  */
 
 #ifndef __MOONLIGHT_SYSTEM_H
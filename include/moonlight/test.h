@@ -32,6 +32,15 @@
  *   which they were defined.
  * - `run()`: Runs the unit tests in the suite in random order, returning the
  *   number of failed tests.
+ * - `seed(n)`: Shuffles the tests deterministically with the given seed.
+ *   When any tests fail, the seed used is reported so that the order can be
+ *   reproduced with `MOONLIGHT_TEST_SEED`.
+ * - `jobs(n)`: Runs each test in its own forked process, at most `n` at a
+ *   time, so that a crash fails only the test which crashed, including those
+ *   caught by `die_on_signal()`.  The output of each test is written once it
+ *   completes.  Also set by `MOONLIGHT_TEST_JOBS`.
+ * - `timeout(ms)`: Kills tests run with `jobs(n)` after the given time.  Also
+ *   set by `MOONLIGHT_TEST_TIMEOUT`, in milliseconds.
  *
  * The following assertion macros are defined for use in tests, which throw
  * `core::AssertionFailure` if the assertions are false.
@@ -46,6 +55,10 @@
  *   suitable for the comparison.
  * - `FAIL(msg)`: Use this macro to trigger an assertion failure in your test
  *   with the given explanation message.
+ * - `ASSERT_MAX_ALLOCATIONS(n, code)`: Asserts that running `code` makes at
+ *   most `n` allocations on the current thread.  Requires the allocation
+ *   counting hooks in `moonlight/alloc_hooks.h`, and otherwise throws
+ *   `core::UsageError`.  Use `AllocationSnapshot` to inspect the counts.
  *
  * There are a few different ways in which you can compose your different test
  * suites.  For smaller sets of tests, it may be appropriate to just define all
@@ -58,11 +71,18 @@
 #ifndef __MOONLIGHT_TEST_H
 #define __MOONLIGHT_TEST_H
 
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 #include <csignal>
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
 #include <cfloat>
+#include <chrono>
+#include <cstdint>
+#include <optional>
 #include <iostream>
 #include <algorithm>
 #include <random>
@@ -126,55 +146,66 @@ class TestSuite {
          return *this;
      }
 
-     int run(std::ostream& out = std::cout) {
-         int tests_failed = 0;
-
-         std::random_device random_device;
-         std::mt19937 rng(random_device());
-
-         std::shuffle(tests.begin(), tests.end(), rng);
+     // Run each test in a forked process, at most `n` at a time.
+     TestSuite& jobs(int n) {
+         job_count = n;
+         return *this;
+     }
 
-         out << "===== " << name << " =====" << std::endl;
+     // Kill tests run in a forked process after the given time.
+     TestSuite& timeout(std::chrono::milliseconds ms) {
+         test_timeout = ms;
+         return *this;
+     }
 
-         for (const UnitTest& test : tests) {
-             if (sys::getenv("MOONLIGHT_TEST_UNGUARDED")) {
-                 test.run();
-                 out << "    PASSED" << std::endl;
-                 continue;
-             }
+     // Shuffle the tests deterministically with the given seed.
+     TestSuite& seed(unsigned int seed) {
+         shuffle_seed = seed;
+         return *this;
+     }
 
-             try {
-                 out << "Running test: '" << test.get_name() << "'..." << std::endl;
-                 test.run();
-                 out << "    PASSED" << std::endl;
+     int run(std::ostream& out = std::cout) {
+         auto seed_str = sys::getenv("MOONLIGHT_TEST_SEED");
+         if (seed_str.has_value()) {
+             shuffle_seed = std::stoul(*seed_str);
+         }
+         if (! shuffle_seed.has_value()) {
+             std::random_device random_device;
+             shuffle_seed = random_device();
+         }
 
-             } catch (...) {
-                 std::exception_ptr eptr = std::current_exception();
+         std::mt19937 rng(*shuffle_seed);
+         std::shuffle(tests.begin(), tests.end(), rng);
 
-                 try {
-                     std::rethrow_exception(eptr);
+         auto jobs_str = sys::getenv("MOONLIGHT_TEST_JOBS");
+         if (jobs_str.has_value()) {
+             job_count = std::stoi(*jobs_str);
+         }
+         auto timeout_str = sys::getenv("MOONLIGHT_TEST_TIMEOUT");
+         if (timeout_str.has_value()) {
+             test_timeout = std::chrono::milliseconds(std::stol(*timeout_str));
+         }
 
-                 } catch (const std::exception& e) {
-                     out << "    FAILED " << e.what() << std::endl;
-                     if (sys::getenv("MOONLIGHT_TEST_RETHROW")) {
-                         throw e;
-                     }
+         out << "===== " << name << " =====" << std::endl;
 
-                 } catch (...) {
-                     out << "    FAILED (exotic type thrown)" <<  std::endl;
-#ifdef MOONLIGHT_ENABLE_STACKTRACE
-                     auto trace = debug::StackTrace::generate();
-                     trace.format(out, "        at ");
-#endif
-                 }
+         std::vector<std::string> failed;
+         if (job_count > 0 && ! sys::getenv("MOONLIGHT_TEST_UNGUARDED")) {
+             failed = run_forked(out);
+         } else {
+             failed = run_serial(out);
+         }
 
-                 tests_failed ++;
+         if (! failed.empty()) {
+             out << "FAILED " << failed.size() << " of " << tests.size() << " tests "
+             << "(MOONLIGHT_TEST_SEED=" << *shuffle_seed << "):" << std::endl;
+             for (const auto& name : failed) {
+                 out << "    '" << name << "'" << std::endl;
              }
          }
 
          out << std::endl;
 
-         return tests_failed;
+         return failed.size();
      }
 
      int size() const {
@@ -182,6 +213,18 @@ class TestSuite {
      }
 
  private:
+     // Exit code of a forked test which failed and reported why.
+     static constexpr int FAILED_EXIT_CODE = 125;
+
+     struct Worker {
+         const UnitTest* test;
+         pid_t pid;
+         int fd;
+         std::string output;
+         std::chrono::steady_clock::time_point deadline;
+         bool timed_out = false;
+     };
+
      static void signal_callback(int signal) {
          std::cout << std::endl << "FATAL: Caught signal " << signal
          << " (" << strsignal(signal) << ")"
@@ -193,8 +236,242 @@ class TestSuite {
          exit(1);
      }
 
+     /**
+      * Run a test and report whether it passed.
+      */
+     static bool run_test(const UnitTest& test, std::ostream& out) {
+         try {
+             test.run();
+             out << "    PASSED" << std::endl;
+             return true;
+
+         } catch (...) {
+             std::exception_ptr eptr = std::current_exception();
+
+             try {
+                 std::rethrow_exception(eptr);
+
+             } catch (const std::exception& e) {
+                 out << "    FAILED " << e.what() << std::endl;
+                 if (sys::getenv("MOONLIGHT_TEST_RETHROW")) {
+                     throw e;
+                 }
+
+             } catch (...) {
+                 out << "    FAILED (exotic type thrown)" <<  std::endl;
+#ifdef MOONLIGHT_ENABLE_STACKTRACE
+                 auto trace = debug::StackTrace::generate();
+                 trace.format(out, "        at ");
+#endif
+             }
+             return false;
+         }
+     }
+
+     std::vector<std::string> run_serial(std::ostream& out) {
+         std::vector<std::string> failed;
+
+         for (const UnitTest& test : tests) {
+             if (sys::getenv("MOONLIGHT_TEST_UNGUARDED")) {
+                 test.run();
+                 out << "    PASSED" << std::endl;
+                 continue;
+             }
+
+             out << "Running test: '" << test.get_name() << "'..." << std::endl;
+             if (! run_test(test, out)) {
+                 failed.push_back(test.get_name());
+             }
+         }
+
+         return failed;
+     }
+
+     /**
+      * Run each test in a forked child process, at most `job_count` at a
+      * time, so that a crash fails only the test which crashed.  The output
+      * of each test is captured and written once the test completes.
+      */
+     std::vector<std::string> run_forked(std::ostream& out) {
+         std::vector<std::string> failed;
+         std::vector<Worker> workers;
+         size_t next = 0;
+
+         while (next < tests.size() || ! workers.empty()) {
+             while (next < tests.size() && workers.size() < (size_t)job_count) {
+                 workers.push_back(fork_test(tests[next++], out));
+             }
+
+             std::vector<struct pollfd> fds;
+             int wait_ms = -1;
+             auto now = std::chrono::steady_clock::now();
+             for (auto& worker : workers) {
+                 fds.push_back({worker.fd, POLLIN, 0});
+                 if (test_timeout.has_value() && ! worker.timed_out) {
+                     auto remaining = std::chrono::ceil<std::chrono::milliseconds>(worker.deadline - now).count();
+                     remaining = std::max<decltype(remaining)>(remaining, 0);
+                     wait_ms = wait_ms < 0 ? remaining : std::min<int>(wait_ms, remaining);
+                 }
+             }
+             poll(fds.data(), fds.size(), wait_ms);
+
+             now = std::chrono::steady_clock::now();
+             for (size_t x = 0; x < workers.size();) {
+                 auto& worker = workers[x];
+                 bool eof = (fds[x].revents & (POLLIN | POLLHUP)) && ! read_output(worker);
+                 if (! eof && test_timeout.has_value() && ! worker.timed_out && now >= worker.deadline) {
+                     kill(-worker.pid, SIGKILL);
+                     worker.timed_out = true;
+                 }
+                 if (eof) {
+                     if (! finish_test(worker, out)) {
+                         failed.push_back(worker.test->get_name());
+                     }
+                     workers.erase(workers.begin() + x);
+                     fds.erase(fds.begin() + x);
+                 } else {
+                     x++;
+                 }
+             }
+         }
+
+         return failed;
+     }
+
+     Worker fork_test(const UnitTest& test, std::ostream& out) {
+         int pipefd[2];
+         if (pipe(pipefd) != 0) {
+             THROW(core::RuntimeError, std::string("Failed to create pipe: ") + strerror(errno));
+         }
+
+         out.flush();
+         std::cout.flush();
+         std::cerr.flush();
+
+         pid_t pid = fork();
+         if (pid < 0) {
+             THROW(core::RuntimeError, std::string("Failed to fork: ") + strerror(errno));
+         }
+
+         if (pid == 0) {
+             setpgid(0, 0);
+             close(pipefd[0]);
+             dup2(pipefd[1], STDOUT_FILENO);
+             dup2(pipefd[1], STDERR_FILENO);
+             close(pipefd[1]);
+             bool passed = run_test(test, std::cout);
+             std::cout.flush();
+             std::cerr.flush();
+             _exit(passed ? 0 : FAILED_EXIT_CODE);
+         }
+
+         // The test is run in its own process group, so that any processes
+         // it forks are also killed if it times out.
+         setpgid(pid, pid);
+         close(pipefd[1]);
+         Worker worker{&test, pid, pipefd[0], {}, {}};
+         if (test_timeout.has_value()) {
+             worker.deadline = std::chrono::steady_clock::now() + *test_timeout;
+         }
+         return worker;
+     }
+
+     // Read available output, returning false at EOF.
+     static bool read_output(Worker& worker) {
+         char buffer[4096];
+         ssize_t n = read(worker.fd, buffer, sizeof(buffer));
+         if (n > 0) {
+             worker.output.append(buffer, n);
+             return true;
+         }
+         return n < 0 && errno == EINTR;
+     }
+
+     bool finish_test(Worker& worker, std::ostream& out) {
+         close(worker.fd);
+         int status = 0;
+         while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) { }
+
+         out << "Running test: '" << worker.test->get_name() << "'..." << std::endl;
+         out << worker.output;
+
+         if (worker.timed_out) {
+             out << "    FAILED (timed out after " << test_timeout->count() << " ms)" << std::endl;
+             return false;
+         } else if (WIFSIGNALED(status)) {
+             out << "    FAILED (killed by signal " << WTERMSIG(status)
+             << " (" << strsignal(WTERMSIG(status)) << "))" << std::endl;
+             return false;
+         } else if (WEXITSTATUS(status) != 0 && WEXITSTATUS(status) != FAILED_EXIT_CODE) {
+             out << "    FAILED (exited with code " << WEXITSTATUS(status) << ")" << std::endl;
+             return false;
+         }
+         return WEXITSTATUS(status) == 0;
+     }
+
      std::vector<UnitTest> tests;
      std::string name;
+     int job_count = 0;
+     std::optional<std::chrono::milliseconds> test_timeout;
+     std::optional<unsigned int> shuffle_seed;
+};
+
+//-------------------------------------------------------------------
+namespace _alloc {
+
+struct Counters {
+    uint64_t allocs = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0;
+};
+
+inline thread_local Counters thread_counters;
+
+// Set when `moonlight/alloc_hooks.h` replaces the global allocator.
+inline bool installed = false;
+
+}  // namespace _alloc
+
+/**
+ * Allocations made by the current thread, as counted by the global
+ * `operator new` and `operator delete` in `moonlight/alloc_hooks.h`.
+ */
+struct AllocationStats {
+    uint64_t allocs = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0;
+
+    static bool tracked() {
+        return _alloc::installed;
+    }
+
+    static AllocationStats current() {
+        const auto& counters = _alloc::thread_counters;
+        return {counters.allocs, counters.frees, counters.bytes};
+    }
+
+    AllocationStats operator-(const AllocationStats& rhs) const {
+        return {allocs - rhs.allocs, frees - rhs.frees, bytes - rhs.bytes};
+    }
+};
+
+/**
+ * Counts the allocations made by the current thread since it was created.
+ */
+class AllocationSnapshot {
+ public:
+     AllocationSnapshot() : start(AllocationStats::current()) {
+         if (! AllocationStats::tracked()) {
+             THROW(core::UsageError, "Allocations are not tracked, include \"moonlight/alloc_hooks.h\".");
+         }
+     }
+
+     AllocationStats delta() const {
+         return AllocationStats::current() - start;
+     }
+
+ private:
+     AllocationStats start;
 };
 
 //-------------------------------------------------------------------
@@ -222,7 +499,7 @@ template<class T>
 inline bool lists_equal(const T& listA, const T& listB) {
 
     return generic_list_size(listA) == generic_list_size(listB) &&
-    equal(listA.begin(), listA.end(), listB.begin());
+    std::equal(listA.begin(), listA.end(), listB.begin());
 }
 
 //-------------------------------------------------------------------
@@ -290,6 +567,17 @@ inline bool test_equal(float a, float b) {
 #define ASSERT_NOT_EQUAL(...) _ASSERT(!test_equal(__VA_ARGS__), "Value inequivalence assertion failed", #__VA_ARGS__)
 #define ASSERT_EP_EQUAL(...) _ASSERT(ep_test_equal(__VA_ARGS__), "Value equivalence assertion failed", #__VA_ARGS__)
 
+#define ASSERT_MAX_ALLOCATIONS(n, ...) \
+{ \
+    moonlight::test::AllocationSnapshot _alloc_snapshot; \
+    __VA_ARGS__; \
+    auto _allocs = _alloc_snapshot.delta().allocs; \
+    if (_allocs > (uint64_t)(n)) { \
+        THROW(moonlight::core::AssertionFailure, "Allocation assertion failed: " #__VA_ARGS__ \
+              " made " + std::to_string(_allocs) + " allocations, expected at most " #n "."); \
+    } \
+}
+
 }  // namespace test
 }  // namespace moonlight
 
@@ -15,7 +15,39 @@
  *
  * - `unicode::BufferedInput`: A unicode-aware variant of `file::BufferedInput`
  *   originally defined in `file.h`.  This class supports peeking through UTF8
- *   multi-byte sequences as single characters.
+ *   multi-byte sequences as single characters.  Whatever input is already
+ *   buffered by the stream is decoded in chunks of up to
+ *   `MOONLIGHT_UNICODE_CHUNK_SIZE` bytes.  When nothing is buffered, only the
+ *   next character is read, so reading from a terminal or pipe doesn't wait
+ *   for more input than was asked for.
+ * - `unicode::is_valid_utf8(s)`: Determine if the given bytes are valid UTF8.
+ * - `unicode::utf8_to_utf32(src, dst)`: Decode UTF8 bytes from the `src` span
+ *   into code points in the `dst` span.  Decoding stops when `dst` is full, at
+ *   an invalid sequence, or at a sequence truncated by the end of `src`.
+ *   Returns a `unicode::TranscodeResult` with the number of bytes read, the
+ *   number of code points written, and a `unicode::TranscodeStatus`.
+ * - `unicode::utf32_to_utf8(src, dst)`: Encode code points from the `src`
+ *   span as UTF8 bytes into the `dst` span, in the same manner.
+ * - `unicode::decode(s)`, `unicode::encode(s)`: Convert an entire string,
+ *   throwing `unicode::UnicodeError` if it is invalid.
+ * - `unicode::width(cp)`: The number of terminal columns a code point
+ *   occupies, 0, 1, or 2.
+ * - `unicode::grapheme_break(cp)`: The grapheme cluster break property of a
+ *   code point, as a `unicode::GraphemeBreak`.
+ * - `unicode::GraphemeSegmenter`: Finds grapheme cluster boundaries per
+ *   UAX #29 as it is fed code points.
+ * - `unicode::next_grapheme(s, offset)`: Find the byte offset of the end of
+ *   the grapheme cluster beginning at `offset` in UTF8 text.
+ * - `unicode::display_width(s)`: The number of terminal columns UTF8 text
+ *   occupies, counting each grapheme cluster by the width of its base.
+ *
+ * Display width and grapheme break properties are looked up in the generated
+ * two-level tables in `unicode_data.h`.  Run `./build.py unicode_data` to
+ * regenerate them from the Unicode Character Database.
+ *
+ * Validation uses SSSE3 or AVX2 where the CPU supports it, and transcoding
+ * converts runs of ASCII 16 bytes at a time with SSE2 on x86 targets.  Define
+ * `MOONLIGHT_NO_SIMD` to use only the scalar versions.
  *
  * This header also imports the `utf8` namespace from `utfcpp`, of which offers
  * `utf8::utf32to8()` for converting wide character sequences into UTF8 encoded
@@ -25,9 +57,24 @@
 #ifndef __MOONLIGHT_UNICODE_H
 #define __MOONLIGHT_UNICODE_H
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "moonlight/constants.h"
 #include "moonlight/file.h"
+#include "moonlight/unicode_data.h"
 #include "utfcpp/source/utf8.h"
-#include "tinyformat/tinyformat.h"
+#include "moonlight/format.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__SSE2__)) && ! defined(MOONLIGHT_NO_SIMD)
+#define MOONLIGHT_UNICODE_SIMD_X86
+#include <immintrin.h>
+#endif
 
 namespace moonlight {
 
@@ -42,7 +89,7 @@ class UnicodeError : public core::Exception {
      core::Exception(create_message(msg, loc), where, name), _loc(loc) { }
 
      static std::string create_message(const std::string& msg, const file::Location& loc) {
-         return tfm::format("%s (%s)", msg, loc);
+         return fmt::format("{} ({})", msg, loc);
      }
 
      const file::Location& loc() const {
@@ -50,30 +97,747 @@ class UnicodeError : public core::Exception {
      }
 
  private:
-     const file::Location& _loc;
+     file::Location _loc;
 };
 
-class BufferedInput {
+// ------------------------------------------------------------------
+enum class TranscodeStatus {
+    COMPLETE,
+    INVALID,
+    INCOMPLETE
+};
+
+struct TranscodeResult {
+    size_t read = 0;
+    size_t written = 0;
+    TranscodeStatus status = TranscodeStatus::COMPLETE;
+};
+
+namespace _utf8 {
+
+/**
+ * Decode one multi-byte sequence at `s`, per Table 3-7 of the Unicode
+ * standard.  Returns the length of the sequence, zero if it is truncated by
+ * `end`, or -1 if it is invalid.
+ */
+inline int decode_one(const unsigned char* s, const unsigned char* end, u32_t& cp) {
+    unsigned char c = s[0];
+    int len;
+
+    if (c < 0x80) {
+        cp = c;
+        return 1;
+    } else if (c < 0xC2) {
+        return -1;
+    } else if (c < 0xE0) {
+        len = 2;
+        cp = c & 0x1F;
+    } else if (c < 0xF0) {
+        len = 3;
+        cp = c & 0x0F;
+    } else if (c < 0xF5) {
+        len = 4;
+        cp = c & 0x07;
+    } else {
+        return -1;
+    }
+
+    unsigned char lo = 0x80, hi = 0xBF;
+    if (c == 0xE0) {
+        lo = 0xA0;
+    } else if (c == 0xED) {
+        hi = 0x9F;
+    } else if (c == 0xF0) {
+        lo = 0x90;
+    } else if (c == 0xF4) {
+        hi = 0x8F;
+    }
+
+    for (int x = 1; x < len; x++) {
+        if (s + x >= end) {
+            return 0;
+        }
+        unsigned char d = s[x];
+        if (d < lo || d > hi) {
+            return -1;
+        }
+        lo = 0x80;
+        hi = 0xBF;
+        cp = (cp << 6) | (d & 0x3F);
+    }
+
+    return len;
+}
+
+/**
+ * The length of the sequence which starts with `lead`, or 1 if `lead` can't
+ * start a multi-byte sequence.
+ */
+inline int sequence_length(unsigned char lead) {
+    if (lead < 0xC2 || lead >= 0xF5) {
+        return 1;
+    } else if (lead < 0xE0) {
+        return 2;
+    } else if (lead < 0xF0) {
+        return 3;
+    }
+    return 4;
+}
+
+inline int encode_one(u32_t cp, char* out) {
+    if (cp < 0x80) {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    } else if (cp < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    } else if (cp < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    } else {
+        out[0] = static_cast<char>(0xF0 | (cp >> 18));
+        out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 4;
+    }
+}
+
+inline int encoded_length(u32_t cp) {
+    if (cp < 0x80) {
+        return 1;
+    } else if (cp < 0x800) {
+        return 2;
+    } else if (cp < 0x10000) {
+        return (cp >= 0xD800 && cp <= 0xDFFF) ? -1 : 3;
+    } else if (cp <= 0x10FFFF) {
+        return 4;
+    }
+    return -1;
+}
+
+inline bool validate_scalar(const unsigned char* s, size_t n) {
+    const unsigned char* end = s + n;
+    while (s < end) {
+        if (end - s >= 8) {
+            uint64_t word;
+            std::memcpy(&word, s, 8);
+            if ((word & 0x8080808080808080ull) == 0) {
+                s += 8;
+                continue;
+            }
+        }
+        u32_t cp;
+        int len = decode_one(s, end, cp);
+        if (len <= 0) {
+            return false;
+        }
+        s += len;
+    }
+    return true;
+}
+
+/**
+ * Vectorized validation after Keiser and Lemire, "Validating UTF-8 In Less
+ * Than One Instruction Per Byte".  Each byte is classified by the high and low
+ * nibbles of the byte before it and the high nibble of itself, and the three
+ * classifications are ANDed together so that any bit left set is an error.
+ */
+const uint8_t TOO_SHORT = 1 << 0;
+const uint8_t TOO_LONG = 1 << 1;
+const uint8_t OVERLONG_3 = 1 << 2;
+const uint8_t TOO_LARGE = 1 << 3;
+const uint8_t SURROGATE = 1 << 4;
+const uint8_t OVERLONG_2 = 1 << 5;
+const uint8_t TOO_LARGE_1000 = 1 << 6;
+const uint8_t OVERLONG_4 = 1 << 6;
+const uint8_t TWO_CONTS = 1 << 7;
+const uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+alignas(16) const uint8_t BYTE_1_HIGH[16] = {
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+    TOO_SHORT | OVERLONG_2,
+    TOO_SHORT,
+    TOO_SHORT | OVERLONG_3 | SURROGATE,
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+};
+
+alignas(16) const uint8_t BYTE_1_LOW[16] = {
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+    CARRY | OVERLONG_2,
+    CARRY,
+    CARRY,
+    CARRY | TOO_LARGE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000
+};
+
+alignas(16) const uint8_t BYTE_2_HIGH[16] = {
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+};
+
+// Bytes at the end of a block which begin a sequence that must continue into
+// the next block: a 4-byte lead in the last 3, a 3-byte lead in the last 2, or
+// any lead in the last byte.
+alignas(32) const uint8_t INCOMPLETE_MAX[32] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+};
+
+#ifdef MOONLIGHT_UNICODE_SIMD_X86
+struct StateSSSE3 {
+    __m128i error = _mm_setzero_si128();
+    __m128i prev_input = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+};
+
+__attribute__((target("ssse3")))
+inline void check_block_ssse3(StateSSSE3& state, __m128i input) {
+    if (_mm_movemask_epi8(input) == 0) {
+        state.error = _mm_or_si128(state.error, state.prev_incomplete);
+
+    } else {
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+        __m128i prev1 = _mm_alignr_epi8(input, state.prev_input, 15);
+        __m128i prev2 = _mm_alignr_epi8(input, state.prev_input, 14);
+        __m128i prev3 = _mm_alignr_epi8(input, state.prev_input, 13);
+
+        __m128i byte_1_high = _mm_shuffle_epi8(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(BYTE_1_HIGH)),
+            _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+        __m128i byte_1_low = _mm_shuffle_epi8(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(BYTE_1_LOW)),
+            _mm_and_si128(prev1, nibble));
+        __m128i byte_2_high = _mm_shuffle_epi8(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(BYTE_2_HIGH)),
+            _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+        __m128i special = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+        __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+        __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+        __m128i must_continue = _mm_and_si128(_mm_or_si128(third, fourth),
+                                              _mm_set1_epi8(static_cast<char>(0x80)));
+
+        state.error = _mm_or_si128(state.error, _mm_xor_si128(must_continue, special));
+        state.prev_incomplete = _mm_subs_epu8(input,
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(INCOMPLETE_MAX + 16)));
+    }
+    state.prev_input = input;
+}
+
+__attribute__((target("ssse3")))
+inline bool validate_ssse3(const unsigned char* s, size_t n) {
+    StateSSSE3 state;
+    size_t x = 0;
+    for (; x + 16 <= n; x += 16) {
+        check_block_ssse3(state, _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + x)));
+    }
+
+    // The zero padding after the last bytes catches any truncated sequence.
+    alignas(16) unsigned char tail[16] = {0};
+    std::memcpy(tail, s + x, n - x);
+    check_block_ssse3(state, _mm_load_si128(reinterpret_cast<const __m128i*>(tail)));
+
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(state.error, _mm_setzero_si128())) == 0xFFFF;
+}
+
+struct StateAVX2 {
+    __m256i error;
+    __m256i prev_input;
+    __m256i prev_incomplete;
+};
+
+__attribute__((target("avx2")))
+inline void check_block_avx2(StateAVX2& state, __m256i input) {
+    if (_mm256_movemask_epi8(input) == 0) {
+        state.error = _mm256_or_si256(state.error, state.prev_incomplete);
+
+    } else {
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        __m256i shifted = _mm256_permute2x128_si256(state.prev_input, input, 0x21);
+        __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+        __m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+        __m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+
+        __m256i byte_1_high = _mm256_shuffle_epi8(
+            _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(BYTE_1_HIGH))),
+            _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+        __m256i byte_1_low = _mm256_shuffle_epi8(
+            _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(BYTE_1_LOW))),
+            _mm256_and_si256(prev1, nibble));
+        __m256i byte_2_high = _mm256_shuffle_epi8(
+            _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(BYTE_2_HIGH))),
+            _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+        __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+        __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+        __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+        __m256i must_continue = _mm256_and_si256(_mm256_or_si256(third, fourth),
+                                                 _mm256_set1_epi8(static_cast<char>(0x80)));
+
+        state.error = _mm256_or_si256(state.error, _mm256_xor_si256(must_continue, special));
+        state.prev_incomplete = _mm256_subs_epu8(input,
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(INCOMPLETE_MAX)));
+    }
+    state.prev_input = input;
+}
+
+__attribute__((target("avx2")))
+inline bool validate_avx2(const unsigned char* s, size_t n) {
+    StateAVX2 state = {
+        _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()
+    };
+    size_t x = 0;
+    for (; x + 32 <= n; x += 32) {
+        check_block_avx2(state, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + x)));
+    }
+
+    alignas(32) unsigned char tail[32] = {0};
+    std::memcpy(tail, s + x, n - x);
+    check_block_avx2(state, _mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+
+    return _mm256_testz_si256(state.error, state.error);
+}
+
+/**
+ * Widen whole 16-byte blocks of ASCII from `s` into `out`, stopping at the
+ * first block containing a non-ASCII byte.  Returns the number of bytes
+ * converted.
+ */
+inline size_t widen_ascii_sse2(const unsigned char* s, u32_t* out, size_t limit) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t x = 0;
+    for (; x + 16 <= limit; x += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + x));
+        if (_mm_movemask_epi8(v) != 0) {
+            break;
+        }
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i* dst = reinterpret_cast<__m128i*>(out + x);
+        _mm_storeu_si128(dst, _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(hi, zero));
+    }
+    return x;
+}
+
+/**
+ * Narrow whole blocks of 16 ASCII code points from `src` into `out`, stopping
+ * at the first block containing a code point above 0x7F.  Returns the number
+ * of code points converted.
+ */
+inline size_t narrow_ascii_sse2(const u32_t* src, char* out, size_t limit) {
+    const __m128i mask = _mm_set1_epi32(~0x7F);
+    const __m128i zero = _mm_setzero_si128();
+    size_t x = 0;
+    for (; x + 16 <= limit; x += 16) {
+        const __m128i* s = reinterpret_cast<const __m128i*>(src + x);
+        __m128i a = _mm_loadu_si128(s);
+        __m128i b = _mm_loadu_si128(s + 1);
+        __m128i c = _mm_loadu_si128(s + 2);
+        __m128i d = _mm_loadu_si128(s + 3);
+        __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(any, mask), zero)) != 0xFFFF) {
+            break;
+        }
+        __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), packed);
+    }
+    return x;
+}
+
+inline bool has_avx2() {
+    static const bool result = __builtin_cpu_supports("avx2");
+    return result;
+}
+
+inline bool has_ssse3() {
+    static const bool result = __builtin_cpu_supports("ssse3");
+    return result;
+}
+#endif
+
+}  // namespace _utf8
+
+/**------------------------------------------------------------------
+ * Determine if the given bytes are entirely valid UTF8.
+ */
+inline bool is_valid_utf8(std::string_view s) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+#ifdef MOONLIGHT_UNICODE_SIMD_X86
+    if (s.size() >= 32 && _utf8::has_avx2()) {
+        return _utf8::validate_avx2(p, s.size());
+    } else if (s.size() >= 16 && _utf8::has_ssse3()) {
+        return _utf8::validate_ssse3(p, s.size());
+    }
+#endif
+    return _utf8::validate_scalar(p, s.size());
+}
+
+/**------------------------------------------------------------------
+ * Decode UTF8 bytes from `src` into code points in `dst`.
+ */
+inline TranscodeResult utf8_to_utf32(std::span<const char> src, std::span<u32_t> dst) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(src.data());
+    const unsigned char* end = s + src.size();
+    u32_t* out = dst.data();
+    size_t n = src.size();
+    size_t m = dst.size();
+    size_t x = 0, y = 0;
+
+    while (x < n && y < m) {
+        if (s[x] < 0x80) {
+#ifdef MOONLIGHT_UNICODE_SIMD_X86
+            size_t run = _utf8::widen_ascii_sse2(s + x, out + y, std::min(n - x, m - y));
+            x += run;
+            y += run;
+            if (x == n || y == m) {
+                break;
+            }
+            if (s[x] >= 0x80) {
+                continue;
+            }
+#endif
+            out[y++] = s[x++];
+            continue;
+        }
+
+        u32_t cp;
+        int len = _utf8::decode_one(s + x, end, cp);
+        if (len < 0) {
+            return {x, y, TranscodeStatus::INVALID};
+        } else if (len == 0) {
+            return {x, y, TranscodeStatus::INCOMPLETE};
+        }
+        out[y++] = cp;
+        x += len;
+    }
+
+    return {x, y, TranscodeStatus::COMPLETE};
+}
+
+/**------------------------------------------------------------------
+ * Encode code points from `src` as UTF8 bytes into `dst`.
+ */
+inline TranscodeResult utf32_to_utf8(std::span<const u32_t> src, std::span<char> dst) {
+    const u32_t* s = src.data();
+    char* out = dst.data();
+    size_t n = src.size();
+    size_t m = dst.size();
+    size_t x = 0, y = 0;
+
+    while (x < n) {
+        if (s[x] < 0x80) {
+#ifdef MOONLIGHT_UNICODE_SIMD_X86
+            size_t run = _utf8::narrow_ascii_sse2(s + x, out + y, std::min(n - x, m - y));
+            x += run;
+            y += run;
+            if (x == n) {
+                break;
+            }
+            if (s[x] >= 0x80) {
+                continue;
+            }
+#endif
+            if (y == m) {
+                break;
+            }
+            out[y++] = static_cast<char>(s[x++]);
+            continue;
+        }
+
+        int len = _utf8::encoded_length(s[x]);
+        if (len < 0) {
+            return {x, y, TranscodeStatus::INVALID};
+        } else if (y + len > m) {
+            break;
+        }
+        y += _utf8::encode_one(s[x], out + y);
+        x++;
+    }
+
+    return {x, y, TranscodeStatus::COMPLETE};
+}
+
+/**------------------------------------------------------------------
+ * Decode an entire UTF8 string into code points.
+ */
+inline string decode(std::string_view s) {
+    string result(s.size(), 0);
+    auto status = utf8_to_utf32(s, result);
+    if (status.status != TranscodeStatus::COMPLETE) {
+        std::string_view prefix = s.substr(0, status.read);
+        size_t line_start = prefix.rfind('\n');
+        line_start = line_start == std::string_view::npos ? 0 : line_start + 1;
+        file::Location loc;
+        loc.line = 1 + std::count(prefix.begin(), prefix.end(), '\n');
+        loc.col = 1 + std::count_if(prefix.begin() + line_start, prefix.end(), [](char c) {
+            return (c & 0xC0) != 0x80;
+        });
+        loc.offset = status.read;
+        THROW(UnicodeError, status.status == TranscodeStatus::INVALID ?
+              "Invalid utf-8 sequence." : "Truncated utf-8 sequence.", loc);
+    }
+    result.resize(status.written);
+    return result;
+}
+
+/**------------------------------------------------------------------
+ * Encode an entire sequence of code points as UTF8.
+ */
+inline std::string encode(std::span<const u32_t> s) {
+    std::string result(s.size(), '\0');
+    size_t x = 0, y = 0;
+    for (;;) {
+        auto status = utf32_to_utf8(s.subspan(x), std::span<char>(result).subspan(y));
+        x += status.read;
+        y += status.written;
+        if (status.status == TranscodeStatus::INVALID) {
+            file::Location loc;
+            loc.col = 1 + x;
+            loc.offset = x;
+            THROW(UnicodeError, "Invalid unicode codepoint.", loc);
+        }
+        if (x == s.size()) {
+            break;
+        }
+        result.resize(result.size() * 2 + 4);
+    }
+    result.resize(y);
+    return result;
+}
+
+// ------------------------------------------------------------------
+enum class GraphemeBreak : uint8_t {
+    OTHER,
+    CR,
+    LF,
+    CONTROL,
+    EXTEND,
+    ZWJ,
+    REGIONAL_INDICATOR,
+    PREPEND,
+    SPACING_MARK,
+    L,
+    V,
+    T,
+    LV,
+    LVT
+};
+
+namespace _utf8 {
+
+inline uint8_t properties(u32_t cp) {
+    if (cp >= _data::MAX_CODEPOINT) {
+        return 1 << _data::WIDTH_SHIFT;
+    }
+    return _data::STAGE2[_data::STAGE1[cp / _data::BLOCK_SIZE] * _data::BLOCK_SIZE
+                         + cp % _data::BLOCK_SIZE];
+}
+
+}  // namespace _utf8
+
+/**------------------------------------------------------------------
+ * The number of terminal columns the code point occupies: 0 for control
+ * characters and combining marks, 2 for East Asian wide and fullwidth
+ * characters, and 1 otherwise.
+ */
+inline int width(u32_t cp) {
+    return _utf8::properties(cp) >> _data::WIDTH_SHIFT;
+}
+
+inline GraphemeBreak grapheme_break(u32_t cp) {
+    return static_cast<GraphemeBreak>(_utf8::properties(cp) & _data::GCB_MASK);
+}
+
+inline bool is_extended_pictographic(u32_t cp) {
+    return _utf8::properties(cp) & _data::EXT_PICT_BIT;
+}
+
+/**------------------------------------------------------------------
+ * Finds extended grapheme cluster boundaries per UAX #29 when fed code
+ * points one at a time.
+ */
+class GraphemeSegmenter {
  public:
-     explicit BufferedInput(std::istream& input, const std::string& name = "") {
-         _loc.name = name;
-         _iter = std::istream_iterator<unsigned char>(input);
+     /**
+      * Returns true if a cluster boundary falls before the given code point.
+      */
+     bool is_boundary(u32_t cp) {
+         GraphemeBreak next = grapheme_break(cp);
+         bool pict = is_extended_pictographic(cp);
+         bool boundary = _boundary(next, pict);
+
+         if (next == GraphemeBreak::REGIONAL_INDICATOR) {
+             _ri_count = _prev == GraphemeBreak::REGIONAL_INDICATOR ? _ri_count + 1 : 1;
+         }
+         if (pict) {
+             _emoji = EMOJI;
+         } else if (_emoji == EMOJI && next == GraphemeBreak::ZWJ) {
+             _emoji = EMOJI_ZWJ;
+         } else if (! (_emoji == EMOJI && next == GraphemeBreak::EXTEND)) {
+             _emoji = NONE;
+         }
+         _prev = next;
+         _start = false;
+         return boundary;
      }
 
-     u32_t getc() {
-         u32_t c;
+     void reset() {
+         *this = GraphemeSegmenter();
+     }
+
+ private:
+     enum EmojiState {
+         NONE,
+         EMOJI,
+         EMOJI_ZWJ
+     };
 
-         if (_buffer.size() > 0) {
-             c = _buffer.front();
-             _buffer.pop_front();
+     bool _boundary(GraphemeBreak next, bool pict) const {
+         using GB = GraphemeBreak;
 
-         } else {
-             c = _next();
+         if (_start) {
+             return true;
+         }
+         if (_prev == GB::CR && next == GB::LF) {
+             return false;
+         }
+         if (_prev == GB::CR || _prev == GB::LF || _prev == GB::CONTROL
+             || next == GB::CR || next == GB::LF || next == GB::CONTROL) {
+             return true;
+         }
+         if (_prev == GB::L && (next == GB::L || next == GB::V || next == GB::LV || next == GB::LVT)) {
+             return false;
+         }
+         if ((_prev == GB::LV || _prev == GB::V) && (next == GB::V || next == GB::T)) {
+             return false;
          }
+         if ((_prev == GB::LVT || _prev == GB::T) && next == GB::T) {
+             return false;
+         }
+         if (next == GB::EXTEND || next == GB::ZWJ || next == GB::SPACING_MARK || _prev == GB::PREPEND) {
+             return false;
+         }
+         if (_emoji == EMOJI_ZWJ && pict) {
+             return false;
+         }
+         if (_prev == GB::REGIONAL_INDICATOR && next == GB::REGIONAL_INDICATOR) {
+             return _ri_count % 2 == 0;
+         }
+         return true;
+     }
+
+     GraphemeBreak _prev = GraphemeBreak::OTHER;
+     EmojiState _emoji = NONE;
+     unsigned int _ri_count = 0;
+     bool _start = true;
+};
+
+/**------------------------------------------------------------------
+ * Find the end of the grapheme cluster in UTF8 text beginning at the given
+ * byte offset, optionally storing the number of terminal columns it occupies
+ * in `width`.  Invalid bytes are treated as single column clusters.
+ */
+inline size_t next_grapheme(std::string_view s, size_t offset, int* cluster_width = nullptr) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+    const unsigned char* end = p + s.size();
+    GraphemeSegmenter segmenter;
+    size_t x = offset;
+    int w = 0;
+    bool pict = false;
+
+    while (x < s.size()) {
+        u32_t cp;
+        int len = _utf8::decode_one(p + x, end, cp);
+        if (len <= 0) {
+            if (x == offset) {
+                x++;
+                w = 1;
+            }
+            break;
+        }
+        if (segmenter.is_boundary(cp) && x != offset) {
+            break;
+        }
+        if (x == offset) {
+            w = width(cp);
+            pict = is_extended_pictographic(cp);
+        } else if (cp == 0xFE0F && pict) {
+            // An emoji presentation selector makes a narrow pictograph wide.
+            w = 2;
+        }
+        x += len;
+    }
+
+    if (cluster_width != nullptr) {
+        *cluster_width = w;
+    }
+    return x;
+}
+
+/**------------------------------------------------------------------
+ * The number of terminal columns the given UTF8 text occupies.
+ */
+inline size_t display_width(std::string_view s) {
+    size_t total = 0;
+    size_t x = 0;
+
+    while (x < s.size()) {
+        unsigned char c = s[x];
+        if (c >= 0x20 && c < 0x7F) {
+            // Printable ASCII is one column per byte, and any combining marks
+            // which follow it are zero width clusters of their own below.
+            total++;
+            x++;
+            continue;
+        }
+        int w;
+        x = next_grapheme(s, x, &w);
+        total += w;
+    }
+
+    return total;
+}
+
+// ------------------------------------------------------------------
+class BufferedInput {
+ public:
+     explicit BufferedInput(std::istream& input, const std::string& name = "")
+     : _input(input) {
+         _loc.name = name;
+     }
+
+     u32_t getc() {
+         u32_t c = peek();
 
          if (c == EOF) {
              _exhausted = true;
          } else {
+             _head ++;
              _loc.offset ++;
 
              if (c == '\n') {
@@ -111,15 +875,13 @@ class BufferedInput {
              return EOF;
          }
 
-         while (_buffer.size() < offset) {
-             int c = _next();
-             if (c == EOF) {
+         while (_buffer.size() - _head < offset) {
+             if (! _decode_chunk()) {
                  return EOF;
              }
-             _buffer.push_back(c);
          }
 
-         return _buffer[offset-1];
+         return _buffer[_head + offset - 1];
      }
 
      void advance(size_t offset = 1) {
@@ -167,8 +929,8 @@ class BufferedInput {
          return dump;
      }
 
-     const std::string& name() const {
-         return _loc.name;
+     std::string_view name() const {
+         return _loc.name.view();
      }
 
      int line() const {
@@ -184,24 +946,95 @@ class BufferedInput {
      }
 
  private:
-     u32_t _next() {
-         try {
-             return utf8::next(_iter, _end);
+     /**
+      * Read the bytes the stream has already buffered, or the next character
+      * if it has none, and decode them onto the end of the buffer.  Bytes of
+      * a sequence split across reads are kept for the next call.  A decoding
+      * error is raised only once the reader reaches it.  Returns false once
+      * the input is exhausted.
+      */
+     bool _decode_chunk() {
+         if (_error.has_value()) {
+             THROW(UnicodeError, *_error, _loc);
+         }
+         if (_eof) {
+             return false;
+         }
 
-         } catch (const utf8::not_enough_room& e) {
-             return EOF;
-         } catch (const utf8::invalid_utf8& e) {
-             THROW(UnicodeError, "Invalid utf-8 sequence.", _loc);
-         } catch (const utf8::invalid_code_point& e) {
-             THROW(UnicodeError, "Invalid unicode codepoint.", _loc);
+         _buffer.erase(_buffer.begin(), _buffer.begin() + _head);
+         _head = 0;
+
+         if (! _read_buffered() && ! _read_sequence()) {
+             _eof = true;
+         }
+
+         size_t base = _buffer.size();
+         _buffer.resize(base + _bytes.size());
+         auto result = utf8_to_utf32(_bytes, std::span<u32_t>(_buffer).subspan(base));
+         _buffer.resize(base + result.written);
+         _bytes.erase(0, result.read);
+
+         if (result.status == TranscodeStatus::INVALID) {
+             _error = "Invalid utf-8 sequence.";
+         } else if (_eof && ! _bytes.empty()) {
+             _error = "Truncated utf-8 sequence.";
+         }
+
+         return true;
+     }
+
+     /**
+      * Read up to a chunk of the bytes the stream has already buffered,
+      * without waiting for more.  Returns false if none were buffered.
+      */
+     bool _read_buffered() {
+         std::streamsize avail = _input.rdbuf()->in_avail();
+         if (avail <= 0) {
+             return false;
          }
+
+         size_t carry = _bytes.size();
+         size_t size = std::min<size_t>(avail, MOONLIGHT_UNICODE_CHUNK_SIZE);
+         _bytes.resize(carry + size);
+         size_t count = _input.readsome(_bytes.data() + carry, size);
+         _bytes.resize(carry + count);
+         return count > 0;
+     }
+
+     /**
+      * Read a single utf-8 sequence, or the rest of the one kept from the last
+      * read, waiting for its bytes to arrive.  A byte which can't continue the
+      * sequence ends it, and is left for decoding to report.  Returns false
+      * if nothing could be read.
+      */
+     bool _read_sequence() {
+         size_t carry = _bytes.size();
+         size_t length = carry == 0 ? 1 : _utf8::sequence_length(_bytes[0]);
+
+         while (_bytes.size() < length) {
+             int c = _input.get();
+             if (c == EOF) {
+                 break;
+             }
+             _bytes.push_back(static_cast<char>(c));
+             if (_bytes.size() == 1) {
+                 length = _utf8::sequence_length(static_cast<unsigned char>(c));
+             } else if ((c & 0xC0) != 0x80) {
+                 break;
+             }
+         }
+
+         return _bytes.size() > carry;
      }
 
-     std::istream_iterator<unsigned char> _iter;
-     std::istream_iterator<unsigned char> _end;
+     std::istream& _input;
      file::Location _loc;
      bool _exhausted = false;
-     std::deque<u32_t> _buffer;
+     bool _eof = false;
+     std::optional<std::string> _error;
+     std::string _bytes;
+     std::vector<u32_t> _buffer;
+     size_t _head = 0;
 };
 
 }
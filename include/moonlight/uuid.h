@@ -19,12 +19,52 @@
  * - `uuid::UUID`: A type alias for `uuids::uuid`.
  * - `uuid::Generator`: A function class with `operator()` for generating UUIDs.
  *   Acts as a container for the random device and seeded generator.
+ * - `uuid::V7Generator`: A function class with `operator()` for generating
+ *   time-ordered version 7 UUIDs.  See below.
+ * - `uuid::format(uuid, out)`: Write the 36 character text form of a UUID
+ *   into a caller's buffer, without allocating.
+ * - `uuid::try_parse(s)`, `uuid::parse(s)`: Parse the 36 character text form
+ *   of a UUID, in either case, without allocating.  `parse()` throws
+ *   `core::ValueError` if the text isn't a UUID.
+ * - `uuid::version(uuid)`: Get the version number of a UUID.
+ * - `uuid::timestamp_ms(uuid)`: Get the Unix timestamp in milliseconds
+ *   of a version 7 UUID.
+ *
+ * ## Version 7 UUIDs -----------------------------------------------
+ * Random (version 4) UUIDs make poor database keys, because each insert lands
+ * in a random place in the index.  Version 7 UUIDs begin with a millisecond
+ * Unix timestamp, so UUIDs generated later sort later and inserts land at the
+ * end of the index.
+ *
+ * Each thread keeps its own generator state, so `V7Generator` needs no
+ * locks.  After the timestamp, each UUID holds a 42 bit counter, which starts
+ * at a random value each millisecond and is incremented for every UUID
+ * generated by the thread during that millisecond, followed by 32 random bits
+ * from `rng.h`.  UUIDs generated by one thread are therefore strictly
+ * increasing, even if the system clock steps backwards.  UUIDs from
+ * different threads within the same millisecond are unique, but not ordered
+ * with respect to each other.
+ *
+ * ```
+ * uuid::V7Generator gen;
+ * char text[36];
+ * uuid::format(gen(), text);
+ * ```
  */
 
 #ifndef __MOONLIGHT_UUID_H
 #define __MOONLIGHT_UUID_H
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
 #include "stduuid/include/uuid.h"
+#include "moonlight/exceptions.h"
+#include "moonlight/result.h"
+#include "moonlight/rng.h"
 
 namespace moonlight {
 namespace uuid {
@@ -44,25 +84,182 @@ inline std::ostream& operator<<(std::ostream& out, const UUID& uuid) {
  */
 class Generator {
  public:
-     Generator() : _generator(_init_generator()) {}
+     Generator() : _engine(_init_engine()), _generator(_engine.get()) {}
 
      UUID operator()() {
          return _generator();
      }
 
  private:
-     static uuids::uuid_random_generator _init_generator() {
+     static std::shared_ptr<std::mt19937> _init_engine() {
          std::random_device rd;
          auto seed_data = std::array<int, std::mt19937::state_size>{};
          std::generate(std::begin(seed_data), std::end(seed_data), std::ref(rd));
          std::seed_seq seq(std::begin(seed_data), std::end(seed_data));
-         std::mt19937 generator(seq);
-         return uuids::uuid_random_generator(generator);
+         return std::make_shared<std::mt19937>(seq);
      }
 
+     // `uuid_random_generator` keeps a pointer to the engine, which must
+     // outlive it.
+     std::shared_ptr<std::mt19937> _engine;
      uuids::uuid_random_generator _generator;
 };
 
+namespace _uuid {
+
+const size_t TEXT_SIZE = 36;
+
+inline bool is_dash_offset(size_t offset) {
+    return offset == 8 || offset == 13 || offset == 18 || offset == 23;
+}
+
+inline int unhex(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+inline const uint8_t* bytes(const UUID& uuid) {
+    return reinterpret_cast<const uint8_t*>(uuid.as_bytes().data());
+}
+
+/**
+ * Per-thread version 7 generator state.
+ */
+struct V7State {
+    uint64_t ms = 0;
+    uint64_t counter = 0;
+};
+
+const uint64_t V7_COUNTER_MAX = (1ull << 42) - 1;
+
+// The counter starts each millisecond at a random value with its top bit
+// clear, leaving at least 2^41 increments before it overflows.
+const uint64_t V7_COUNTER_SEED_MASK = (1ull << 41) - 1;
+
+}  // namespace _uuid
+
+/**------------------------------------------------------------------
+ * Write the 36 character lowercase text form of `uuid` into `out`.  The
+ * result is not null terminated.
+ */
+inline void format(const UUID& uuid, char* out) {
+    static const char HEX[] = "0123456789abcdef";
+    const uint8_t* bytes = _uuid::bytes(uuid);
+
+    for (size_t x = 0; x < 16; x++) {
+        if (x == 4 || x == 6 || x == 8 || x == 10) {
+            *out++ = '-';
+        }
+        *out++ = HEX[bytes[x] >> 4];
+        *out++ = HEX[bytes[x] & 0x0f];
+    }
+}
+
+/**------------------------------------------------------------------
+ * Parse the 36 character text form of a UUID.
+ */
+inline core::Result<UUID> try_parse(std::string_view s) {
+    std::array<uint8_t, 16> bytes;
+    bool valid = s.size() == _uuid::TEXT_SIZE;
+
+    for (size_t x = 0, n = 0; valid && x < _uuid::TEXT_SIZE; x++) {
+        if (_uuid::is_dash_offset(x)) {
+            valid = s[x] == '-';
+            continue;
+        }
+        int hi = _uuid::unhex(s[x]);
+        int lo = _uuid::unhex(s[++x]);
+        valid = hi >= 0 && lo >= 0;
+        bytes[n++] = (hi << 4) | lo;
+    }
+
+    if (! valid) {
+        return core::Error{core::ErrorCode::SYNTAX_ERROR, "Invalid UUID."};
+    }
+    return UUID(bytes);
+}
+
+inline UUID parse(std::string_view s) {
+    auto result = try_parse(s);
+    if (! result) {
+        THROW(core::ValueError, result.error().message);
+    }
+    return *result;
+}
+
+inline int version(const UUID& uuid) {
+    return _uuid::bytes(uuid)[6] >> 4;
+}
+
+inline uint64_t timestamp_ms(const UUID& uuid) {
+    const uint8_t* bytes = _uuid::bytes(uuid);
+    uint64_t ms = 0;
+    for (size_t x = 0; x < 6; x++) {
+        ms = (ms << 8) | bytes[x];
+    }
+    return ms;
+}
+
+/**------------------------------------------------------------------
+ * A generator functor for time-ordered version 7 UUIDs.
+ */
+class V7Generator {
+ public:
+     UUID operator()() const {
+         auto now = std::chrono::system_clock::now().time_since_epoch();
+         return generate(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+     }
+
+     /**
+      * Generate a UUID for the given Unix time in milliseconds.
+      */
+     UUID generate(uint64_t unix_ms) const {
+         thread_local _uuid::V7State state;
+         auto& random = rng::Stream::thread_local_instance();
+         uint64_t r = random.next_u64();
+
+         if (unix_ms > state.ms) {
+             state.ms = unix_ms;
+             state.counter = r & _uuid::V7_COUNTER_SEED_MASK;
+             r = random.next_u64();
+
+         } else if (++state.counter > _uuid::V7_COUNTER_MAX) {
+             // The counter is exhausted, so borrow from the next millisecond.
+             state.ms++;
+             state.counter = r & _uuid::V7_COUNTER_SEED_MASK;
+             r = random.next_u64();
+         }
+
+         uint64_t ms = state.ms;
+         uint64_t counter = state.counter;
+         std::array<uint8_t, 16> bytes = {
+             static_cast<uint8_t>(ms >> 40),
+             static_cast<uint8_t>(ms >> 32),
+             static_cast<uint8_t>(ms >> 24),
+             static_cast<uint8_t>(ms >> 16),
+             static_cast<uint8_t>(ms >> 8),
+             static_cast<uint8_t>(ms),
+             static_cast<uint8_t>(0x70 | ((counter >> 38) & 0x0f)),
+             static_cast<uint8_t>(counter >> 30),
+             static_cast<uint8_t>(0x80 | ((counter >> 24) & 0x3f)),
+             static_cast<uint8_t>(counter >> 16),
+             static_cast<uint8_t>(counter >> 8),
+             static_cast<uint8_t>(counter),
+             static_cast<uint8_t>(r >> 24),
+             static_cast<uint8_t>(r >> 16),
+             static_cast<uint8_t>(r >> 8),
+             static_cast<uint8_t>(r)
+         };
+         return UUID(bytes);
+     }
+};
+
 }  // namespace uuid
 }  // namespace moonlight
 
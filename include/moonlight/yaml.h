@@ -0,0 +1,524 @@
+/*
+ * ## yaml.h: Reading YAML into JSON values. ------------------------
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * ## Dependencies --------------------------------------------------
+ * To install dependencies, run `./build.py deps` at the moonlight project root.
+ *
+ * - rapidyaml
+ *   - Add `moonlight/deps` to your C++ include path.
+ *   - rapidyaml is a single header library.  Define
+ *     `RYML_SINGLE_HDR_DEFINE_NOW` in exactly one translation unit before
+ *     including this header.
+ *
+ * ## Usage ---------------------------------------------------------
+ * This library parses YAML with rapidyaml's in-place parser and converts the
+ * result directly into `json::Value` trees, so that YAML configuration files
+ * can be read with the same types and `json/mapping.h` mappings as JSON.
+ *
+ * - `yaml::read<T>(in, filename="<input>")`, `yaml::read<T>(s)`: Reads a data
+ *   structure of type `T` from a single YAML document.  `T` may be
+ *   `json::Value::Pointer`, `json::Object`, or any JSON-mappable type.
+ *   Throws `yaml::ParseError` if the input isn't valid YAML or holds more
+ *   than one document.
+ * - `yaml::try_read<T>(in, filename="<input>")`, `yaml::try_read<T>(s)`: Like
+ *   `read<T>()`, but returns a `core::Result<T>` holding the parse error, if
+ *   any.
+ * - `yaml::read_file<T>(name)`: Opens a YAML file and reads an object of
+ *   type `T`.
+ * - `yaml::parse_in_place(buffer, filename="<str>")`: Parses a YAML document
+ *   held in a `std::string` without copying it first.  The buffer is
+ *   modified.
+ * - `yaml::documents(in, filename="<input>")`: Returns a
+ *   `gen::Stream<json::Value::Pointer>` of the documents in a multi-document
+ *   YAML stream.  Documents are read from `in` and parsed one at a time, so
+ *   memory use is bounded by the largest document rather than the file.
+ *
+ * ```
+ * for (auto doc : yaml::documents(infile, "jobs.yaml")) {
+ *     auto job = doc->get<Job>();
+ *     ...
+ * }
+ * ```
+ *
+ * Plain scalars are resolved with the YAML 1.2 core schema: `null`, `~` and
+ * empty values become `json::Null`, `true` and `false` become
+ * `json::Boolean`, integers (including `0x` and `0o` forms) and floats
+ * (including `.inf` and `.nan`) become `json::Number`, and anything else
+ * becomes a `json::String`.  Quoted and block scalars, and scalars tagged
+ * `!!str`, are always strings.  Anchors, aliases and `<<` merge keys are
+ * resolved.  Mapping keys are converted to strings.
+ */
+
+#ifndef __MOONLIGHT_YAML_H
+#define __MOONLIGHT_YAML_H
+
+#include <charconv>
+#include <deque>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "rapidyaml/rapidyaml.h"
+#include "moonlight/file.h"
+#include "moonlight/generator.h"
+#include "moonlight/json.h"
+#include "moonlight/result.h"
+
+namespace moonlight {
+namespace yaml {
+
+typedef json::parser::ParseError ParseError;
+
+namespace _yaml {
+
+/**
+ * Thrown from rapidyaml's error callback, which must not return.
+ */
+struct Failure {
+    std::string message;
+    file::Location loc;
+};
+
+[[noreturn]] inline void on_error(const char* msg, size_t len, ryml::Location loc, void* user_data) {
+    (void) user_data;
+    throw Failure{std::string(msg, len), file::Location{
+        static_cast<unsigned int>(loc.line),
+        static_cast<unsigned int>(loc.col),
+        static_cast<unsigned int>(loc.offset)
+    }};
+}
+
+inline ryml::Callbacks callbacks() {
+    ryml::Callbacks cb = ryml::get_callbacks();
+    cb.m_error = &on_error;
+    return cb;
+}
+
+inline std::string_view view(ryml::csubstr s) {
+    return std::string_view(s.str, s.len);
+}
+
+inline bool is_null(std::string_view s) {
+    return s.empty() || s == "~" || s == "null" || s == "Null" || s == "NULL";
+}
+
+inline std::optional<bool> to_bool(std::string_view s) {
+    if (s == "true" || s == "True" || s == "TRUE") {
+        return true;
+    }
+    if (s == "false" || s == "False" || s == "FALSE") {
+        return false;
+    }
+    return {};
+}
+
+inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline size_t skip_digits(std::string_view s, size_t x) {
+    while (x < s.size() && is_digit(s[x])) {
+        x++;
+    }
+    return x;
+}
+
+/**
+ * Whether `s` is a YAML 1.2 core schema decimal number, without its sign:
+ * `( \. [0-9]+ | [0-9]+ ( \. [0-9]* )? ) ( [eE] [-+]? [0-9]+ )?`
+ */
+inline bool is_decimal(std::string_view s) {
+    size_t x = skip_digits(s, 0);
+    size_t int_digits = x;
+
+    if (x < s.size() && s[x] == '.') {
+        size_t end = skip_digits(s, x + 1);
+        if (int_digits == 0 && end == x + 1) {
+            return false;
+        }
+        x = end;
+
+    } else if (int_digits == 0) {
+        return false;
+    }
+
+    if (x < s.size() && (s[x] == 'e' || s[x] == 'E')) {
+        x++;
+        if (x < s.size() && (s[x] == '+' || s[x] == '-')) {
+            x++;
+        }
+        size_t end = skip_digits(s, x);
+        if (end == x) {
+            return false;
+        }
+        x = end;
+    }
+
+    return x == s.size();
+}
+
+inline std::optional<double> to_integer(std::string_view s, int base) {
+    uint64_t value = 0;
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value, base);
+    if (s.empty() || ec != std::errc() || ptr != s.data() + s.size()) {
+        return {};
+    }
+    return static_cast<double>(value);
+}
+
+inline std::optional<double> to_number(std::string_view s) {
+    if (s == ".nan" || s == ".NaN" || s == ".NAN") {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    if (s.starts_with("0x")) {
+        return to_integer(s.substr(2), 16);
+    }
+    if (s.starts_with("0o")) {
+        return to_integer(s.substr(2), 8);
+    }
+
+    bool negative = false;
+    if (! s.empty() && (s[0] == '-' || s[0] == '+')) {
+        negative = s[0] == '-';
+        s.remove_prefix(1);
+    }
+
+    if (s == ".inf" || s == ".Inf" || s == ".INF") {
+        return negative ? -std::numeric_limits<double>::infinity()
+                        : std::numeric_limits<double>::infinity();
+    }
+
+    if (! is_decimal(s)) {
+        return {};
+    }
+
+    double value = 0;
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+    if (ec == std::errc::invalid_argument || ptr != s.data() + s.size()) {
+        return {};
+    }
+    return negative ? -value : value;
+}
+
+inline bool is_str_tag(std::string_view tag) {
+    return tag == "!!str" || tag == "tag:yaml.org,2002:str" || tag == "<tag:yaml.org,2002:str>";
+}
+
+inline json::Value::Pointer scalar(const ryml::Tree& tree, size_t node) {
+    auto s = view(tree.val(node));
+
+    if (tree.is_val_quoted(node) ||
+        (tree.has_val_tag(node) && is_str_tag(view(tree.val_tag(node))))) {
+        return std::make_shared<json::String>(std::string(s));
+    }
+
+    if (is_null(s)) {
+        return std::make_shared<json::Null>();
+    }
+
+    if (auto b = to_bool(s)) {
+        return std::make_shared<json::Boolean>(*b);
+    }
+
+    if (auto n = to_number(s)) {
+        return std::make_shared<json::Number>(*n);
+    }
+
+    return std::make_shared<json::String>(std::string(s));
+}
+
+inline json::Value::Pointer convert(const ryml::Tree& tree, size_t node) {
+    if (tree.is_map(node)) {
+        auto obj = std::make_shared<json::Object>();
+        for (size_t child = tree.first_child(node); child != ryml::NONE;
+             child = tree.next_sibling(child)) {
+            obj->set(std::string(view(tree.key(child))), convert(tree, child));
+        }
+        return obj;
+    }
+
+    if (tree.is_seq(node)) {
+        auto array = std::make_shared<json::Array>();
+        for (size_t child = tree.first_child(node); child != ryml::NONE;
+             child = tree.next_sibling(child)) {
+            array->append(convert(tree, child));
+        }
+        return array;
+    }
+
+    if (tree.has_val(node)) {
+        return scalar(tree, node);
+    }
+
+    return std::make_shared<json::Null>();
+}
+
+/**
+ * Parse the YAML in `buffer` in place, calling `f(value)` for each
+ * document.  The buffer is modified and may be discarded afterwards.
+ */
+template<class F>
+void parse_documents(char* buffer, size_t size, const std::string& filename, F f) {
+    auto cb = callbacks();
+    ryml::Tree tree(cb);
+    ryml::Parser parser(cb);
+
+    parser.parse_in_place(ryml::csubstr(filename.data(), filename.size()),
+                          ryml::substr(buffer, size), &tree);
+    tree.resolve();
+
+    size_t root = tree.root_id();
+    if (tree.is_stream(root)) {
+        for (size_t doc = tree.first_child(root); doc != ryml::NONE;
+             doc = tree.next_sibling(doc)) {
+            f(convert(tree, doc));
+        }
+
+    } else {
+        f(convert(tree, root));
+    }
+}
+
+inline core::Error error(const Failure& failure, const std::string& filename,
+                         unsigned int line_offset = 0) {
+    file::Location loc = failure.loc;
+    loc.line += line_offset;
+    loc.name = filename;
+    return core::Error{core::ErrorCode::SYNTAX_ERROR, failure.message, loc};
+}
+
+/**
+ * Parse a buffer holding exactly one YAML document.
+ */
+inline core::Result<json::Value::Pointer> parse_one(char* buffer, size_t size,
+                                                    const std::string& filename) {
+    json::Value::Pointer value = nullptr;
+    size_t count = 0;
+
+    try {
+        parse_documents(buffer, size, filename, [&](json::Value::Pointer doc) {
+            value = doc;
+            count++;
+        });
+
+    } catch (const Failure& failure) {
+        return error(failure, filename);
+    }
+
+    if (count > 1) {
+        return core::Error{core::ErrorCode::TRAILING_INPUT,
+            "Expected a single YAML document, found " + std::to_string(count) + ".",
+            file::Location{1, 1, 0, filename}};
+    }
+    if (value == nullptr) {
+        return json::Value::Pointer(std::make_shared<json::Null>());
+    }
+    return value;
+}
+
+/**
+ * Whether a line begins with the document marker `marker`, i.e. `---` or
+ * `...`.  YAML forbids these at the start of a line within a document's
+ * content, so they always separate documents.
+ */
+inline bool is_marker(std::string_view line, std::string_view marker) {
+    return line.starts_with(marker) &&
+        (line.size() == marker.size() || line[marker.size()] == ' ' ||
+         line[marker.size()] == '\t' || line[marker.size()] == '\r');
+}
+
+/**
+ * Whether a line holds anything other than whitespace, a comment or a
+ * directive.
+ */
+inline bool is_content(std::string_view line) {
+    if (line.starts_with('%')) {
+        return false;
+    }
+    size_t x = line.find_first_not_of(" \t\r");
+    return x != std::string_view::npos && line[x] != '#';
+}
+
+/**
+ * Reads a multi-document YAML stream one document at a time.
+ */
+class DocumentReader {
+ public:
+     DocumentReader(std::istream& in, const std::string& filename)
+     : _in(in), _filename(filename) { }
+
+     std::optional<json::Value::Pointer> next() {
+         while (_ready.empty()) {
+             if (! _read_document()) {
+                 return {};
+             }
+         }
+         auto value = _ready.front();
+         _ready.pop_front();
+         return value;
+     }
+
+ private:
+     /**
+      * Read and parse the text of the next document.  Returns false at the
+      * end of the stream.
+      */
+     bool _read_document() {
+         std::string text;
+         unsigned int first_line = _line + 1;
+         bool started = false;
+         bool content = false;
+
+         if (_start) {
+             first_line = _line;
+             text = *_start + "\n";
+             started = true;
+             content = is_content(std::string_view(*_start).substr(3));
+             _start.reset();
+         }
+
+         std::string line;
+         while (std::getline(_in, line)) {
+             _line++;
+
+             if (is_marker(line, "---")) {
+                 if (started || content) {
+                     _start = std::move(line);
+                     break;
+                 }
+                 // Comments and directives before the marker belong to
+                 // this document.
+                 started = true;
+                 content = is_content(std::string_view(line).substr(3));
+
+             } else if (is_marker(line, "...")) {
+                 if (started || content) {
+                     break;
+                 }
+                 text.clear();
+                 first_line = _line + 1;
+                 continue;
+
+             } else {
+                 content = content || is_content(line);
+             }
+
+             text += line;
+             text.push_back('\n');
+         }
+
+         if (! started && ! content) {
+             return false;
+         }
+
+         try {
+             parse_documents(text.data(), text.size(), _filename, [this](json::Value::Pointer doc) {
+                 _ready.push_back(doc);
+             });
+
+         } catch (const Failure& failure) {
+             auto err = error(failure, _filename, first_line - 1);
+             THROW(ParseError, err.message, err.loc);
+         }
+         return true;
+     }
+
+     std::istream& _in;
+     std::string _filename;
+     unsigned int _line = 0;
+     std::optional<std::string> _start;
+     std::deque<json::Value::Pointer> _ready;
+};
+
+}  // namespace _yaml
+
+/**------------------------------------------------------------------
+ * Parse a YAML document held in `buffer`, modifying it in place.
+ */
+inline json::Value::Pointer parse_in_place(std::string& buffer, const std::string& filename = "<str>") {
+    auto result = _yaml::parse_one(buffer.data(), buffer.size(), filename);
+    if (! result) {
+        THROW(ParseError, result.error().message, result.error().loc);
+    }
+    return *result;
+}
+
+/**------------------------------------------------------------------
+ * Read a data structure of type `T` from a single YAML document.
+ */
+template<class T>
+core::Result<T> try_read(std::string buffer, const std::string& filename) {
+    auto result = _yaml::parse_one(buffer.data(), buffer.size(), filename);
+    if (! result) {
+        return result.error();
+    }
+
+    if constexpr (std::is_same_v<T, json::Value::Pointer>) {
+        return std::move(result).value();
+    } else {
+        return result.value()->template get<T>();
+    }
+}
+
+template<class T>
+core::Result<T> try_read(std::istream& input, const std::string& filename = "<input>") {
+    return try_read<T>(std::string(std::istreambuf_iterator<char>(input),
+                                   std::istreambuf_iterator<char>()), filename);
+}
+
+template<class T>
+core::Result<T> try_read(const std::string& yaml_str) {
+    return try_read<T>(yaml_str, "<str>");
+}
+
+template<class T>
+T read(std::istream& input, const std::string& filename = "<input>") {
+    auto result = try_read<T>(input, filename);
+    if (! result) {
+        THROW(ParseError, result.error().message, result.error().loc);
+    }
+    return std::move(result).value();
+}
+
+template<class T>
+T read(const std::string& yaml_str) {
+    auto result = try_read<T>(yaml_str);
+    if (! result) {
+        THROW(ParseError, result.error().message, result.error().loc);
+    }
+    return std::move(result).value();
+}
+
+template<class T>
+T read_file(const std::string& filename) {
+    auto infile = file::open_r(filename);
+    return read<T>(infile, filename);
+}
+
+/**------------------------------------------------------------------
+ * Read the documents of a multi-document YAML stream, one at a time.  The
+ * input stream must outlive the result.
+ */
+inline gen::Stream<json::Value::Pointer> documents(std::istream& input,
+                                                   const std::string& filename = "<input>") {
+    auto reader = std::make_shared<_yaml::DocumentReader>(input, filename);
+    return gen::Stream<json::Value::Pointer>([reader]() {
+        return reader->next();
+    });
+}
+
+}  // namespace yaml
+}  // namespace moonlight
+
+#endif /* !__MOONLIGHT_YAML_H */
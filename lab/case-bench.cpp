@@ -0,0 +1,109 @@
+/*
+ * case-bench.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * Compares the ASCII case conversion and case-insensitive comparison in
+ * `string.h` against the previous `str::map()` based implementation and
+ * `strncasecmp()` on a set of HTTP-style header names.
+ */
+
+#include <strings.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "moonlight/string.h"
+
+using namespace moonlight;
+
+const int ROUNDS = 200;
+
+const std::vector<std::string> HEADERS = {
+    "Accept", "Accept-Encoding", "Accept-Language", "Authorization",
+    "Cache-Control", "Connection", "Content-Length", "Content-Type",
+    "Cookie", "Host", "If-Modified-Since", "If-None-Match", "Origin",
+    "Referer", "User-Agent", "X-Forwarded-For", "X-Request-Id",
+    "Strict-Transport-Security", "Access-Control-Allow-Credentials",
+    "X-A-Rather-Long-Custom-Header-Name-Used-By-Some-Middleware"
+};
+
+std::string legacy_to_lower(const std::string& s) {
+    return str::map(s, [](char c) { return tolower(c); });
+}
+
+template<class F>
+void bench(const std::string& name, const std::vector<std::string>& keys, F f) {
+    size_t total = 0;
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int x = 0; x < ROUNDS; x++) {
+        for (const auto& key : keys) {
+            total += f(key);
+            bytes += key.size();
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    fmt::print(std::cout, "{:<40} {:>8.2f} ns/key {:>8.3f} GB/s  ({})\n",
+               name, ns / (ROUNDS * keys.size()), bytes / ns, total);
+}
+
+int main() {
+    std::vector<std::string> keys;
+    std::vector<std::string> upper_keys;
+    for (int x = 0; x < 5000; x++) {
+        for (const auto& header : HEADERS) {
+            keys.push_back(header);
+            upper_keys.push_back(str::to_upper(header));
+        }
+    }
+
+    std::cout << "--- case conversion ---" << std::endl;
+    bench("legacy str::map(tolower)", keys, [](const std::string& s) {
+        return legacy_to_lower(s).size();
+    });
+    bench("str::to_lower", keys, [](const std::string& s) {
+        return str::to_lower(s).size();
+    });
+    bench("str::to_lower_inplace", keys, [](const std::string& s) {
+        std::string copy = s;
+        str::to_lower_inplace(copy);
+        return copy.size();
+    });
+
+    std::cout << "--- case-insensitive equality ---" << std::endl;
+    size_t offset = 0;
+    bench("legacy to_lower(a) == to_lower(b)", keys, [&](const std::string& s) {
+        return legacy_to_lower(s) == legacy_to_lower(upper_keys[offset++ % upper_keys.size()]);
+    });
+    offset = 0;
+    bench("strncasecmp", keys, [&](const std::string& s) {
+        const auto& t = upper_keys[offset++ % upper_keys.size()];
+        return s.size() == t.size() && strncasecmp(s.c_str(), t.c_str(), s.size()) == 0;
+    });
+    offset = 0;
+    bench("str::iequals", keys, [&](const std::string& s) {
+        return str::iequals(s, upper_keys[offset++ % upper_keys.size()]);
+    });
+
+    std::cout << "--- case-insensitive map lookup ---" << std::endl;
+    std::unordered_map<std::string, int> legacy_map;
+    std::unordered_map<std::string, int, str::IHash, str::IEqual> imap;
+    for (size_t x = 0; x < HEADERS.size(); x++) {
+        legacy_map[legacy_to_lower(HEADERS[x])] = x;
+        imap[HEADERS[x]] = x;
+    }
+    bench("unordered_map[legacy to_lower(k)]", upper_keys, [&](const std::string& s) {
+        return legacy_map.find(legacy_to_lower(s))->second;
+    });
+    bench("unordered_map<IHash, IEqual>", upper_keys, [&](const std::string& s) {
+        return imap.find(s)->second;
+    });
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+/*
+ * curses-idle-bench.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * Measures the CPU cost of a mostly idle curses dashboard, four panels of
+ * statistics where one number changes each second, running on a
+ * pseudo-terminal at 30 frames per second.  The naive loop redraws and
+ * refreshes every panel on every frame, while the `curses::Renderer` loop
+ * draws only when the statistics change and skips frames where nothing did.
+ */
+
+#include <pty.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "moonlight/curses.h"
+#include "moonlight/format.h"
+
+using namespace moonlight;
+
+const uint64_t FRAME_MS = 33;
+const uint64_t RUN_MS = 3000;
+
+double cpu_ms() {
+    struct rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0
+    + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+void draw(std::vector<std::shared_ptr<curses::Panel>>& panels, uint64_t seconds) {
+    for (size_t n = 0; n < panels.size(); n++) {
+        auto& win = panels[n]->win();
+        win.erase();
+        win.draw_border();
+        for (int y = 1; y < win.sz().y - 1; y++) {
+            win.go(2, y);
+            win.draw(fmt::format("panel {} row {:>2}: {:>8}", n, y, n == 0 && y == 1 ? seconds : y * 1000));
+        }
+    }
+}
+
+int main() {
+    int master, slave;
+    struct winsize ws = {50, 160, 0, 0};
+    if (openpty(&master, &slave, nullptr, nullptr, &ws) != 0) {
+        perror("openpty");
+        return 1;
+    }
+
+    std::atomic<size_t> received = 0;
+    std::thread reader([&]() {
+        char buffer[65536];
+        ssize_t n;
+        while ((n = read(master, buffer, sizeof(buffer))) > 0) {
+            received += n;
+        }
+    });
+
+    setenv("TERM", "xterm-256color", 1);
+    FILE* tty = fdopen(slave, "r+");
+    SCREEN* screen = newterm(nullptr, tty, tty);
+    set_term(screen);
+    noecho();
+    cbreak();
+
+    std::vector<std::shared_ptr<curses::Panel>> panels;
+    for (int n = 0; n < 4; n++) {
+        panels.push_back(std::make_shared<curses::Panel>(curses::XY{80, 25}, curses::XY{(n % 2) * 80, (n / 2) * 25}));
+    }
+
+    auto report = [&](const std::string& name, size_t frames, size_t bytes, double cpu) {
+        fmt::print(std::cout, "{:<12} {:>6} frames drawn {:>10} bytes {:>8.1f} ms CPU/s\n",
+                   name, frames, bytes, cpu / (RUN_MS / 1000.0));
+    };
+
+    {
+        size_t before = received;
+        double cpu0 = cpu_ms();
+        auto start = time::posix::get_ticks();
+        size_t frames = 0;
+        for (uint64_t now = start; now - start < RUN_MS; now = time::posix::get_ticks()) {
+            draw(panels, (now - start) / 1000);
+            for (auto& panel : panels) {
+                wnoutrefresh(panel->win().raw_ptr());
+            }
+            doupdate();
+            frames++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(FRAME_MS));
+        }
+        report("naive", frames, received - before, cpu_ms() - cpu0);
+    }
+
+    {
+        curses::Renderer renderer(FRAME_MS);
+        renderer.invalidate();
+        size_t before = received;
+        double cpu0 = cpu_ms();
+        auto start = time::posix::get_ticks();
+        std::optional<uint64_t> shown;
+        renderer.run([&]() {
+            uint64_t now = time::posix::get_ticks();
+            uint64_t seconds = (now - start) / 1000;
+            if (shown != seconds) {
+                draw(panels, seconds);
+                shown = seconds;
+            }
+            return now - start < RUN_MS;
+        });
+        report("Renderer", renderer.frames(), received - before, cpu_ms() - cpu0);
+    }
+
+    panels.clear();
+    endwin();
+    delscreen(screen);
+    fclose(tty);
+    reader.join();
+    close(master);
+    return 0;
+}
@@ -0,0 +1,53 @@
+/*
+ * exception-bench.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * Measures the throughput of throwing and catching `core::Exception` in a
+ * loop, as a parser rejecting bad input would, with and without calling
+ * `what()` on the caught exception.  Build with `MOONLIGHT_ENABLE_STACKTRACE`
+ * to include stack trace capture.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "moonlight/exceptions.h"
+
+using namespace moonlight;
+
+__attribute__((noinline))
+void parse_value(int x) {
+    THROW(core::ValueError, "Unexpected character in value expression.");
+    (void) x;
+}
+
+template<class F>
+void bench(const std::string& name, int iterations, F f) {
+    size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int x = 0; x < iterations; x++) {
+        try {
+            parse_value(x);
+        } catch (const core::Exception& e) {
+            total += f(e);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double us = std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+    fmt::print(std::cout, "{:<32} {:>10.2f} us/throw {:>12.0f} throws/s  ({})\n",
+               name, us, 1e6 / us, total);
+}
+
+int main() {
+    bench("throw/catch", 2000, [](const core::Exception& e) {
+        return e.message().size();
+    });
+    bench("throw/catch + what()", 200, [](const core::Exception& e) {
+        return std::string(e.what()).size();
+    });
+    return 0;
+}
@@ -0,0 +1,81 @@
+/*
+ * format-bench.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * Compares `fmt::format()` against `std::ostringstream` and `tinyformat` on
+ * typical log and error message formatting.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include "moonlight/format.h"
+#include "moonlight/file.h"
+#include "tinyformat/tinyformat.h"
+
+using namespace moonlight;
+
+const int ITERATIONS = 1000000;
+
+template<class F>
+void bench(const std::string& name, F f) {
+    size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int x = 0; x < ITERATIONS; x++) {
+        total += f(x).size();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+    fmt::print(std::cout, "{:<32} {:>8.1f} ns/op  ({} bytes)\n", name, ns, total);
+}
+
+int main() {
+    file::Location loc = {42, 7, 1337, "config.json"};
+    std::string level = "INFO";
+    std::string logger = "moonlight.app";
+
+    std::cout << "--- log line ---" << std::endl;
+    bench("std::ostringstream", [&](int x) {
+        std::ostringstream sb;
+        sb << "[" << level << "] " << logger << ": processed " << x << " records in " << x * 0.001 << "s";
+        return sb.str();
+    });
+    bench("tfm::format", [&](int x) {
+        return tfm::format("[%s] %s: processed %d records in %gs", level, logger, x, x * 0.001);
+    });
+    bench("fmt::format", [&](int x) {
+        return fmt::format("[{}] {}: processed {} records in {}s", level, logger, x, x * 0.001);
+    });
+
+    std::cout << "--- error message with location ---" << std::endl;
+    bench("std::ostringstream", [&](int x) {
+        std::ostringstream sb;
+        sb << "Unexpected character in value expression." << " (" << loc << ")";
+        (void) x;
+        return sb.str();
+    });
+    bench("tfm::format", [&](int x) {
+        (void) x;
+        return tfm::format("%s (%s)", "Unexpected character in value expression.", loc);
+    });
+    bench("fmt::format", [&](int x) {
+        (void) x;
+        return fmt::format("{} ({})", "Unexpected character in value expression.", loc);
+    });
+
+    std::cout << "--- str::cat of mixed values ---" << std::endl;
+    bench("std::ostringstream", [&](int x) {
+        std::ostringstream sb;
+        sb << "Undefined state: " << x << "/" << level << "#" << 3.5;
+        return sb.str();
+    });
+    bench("str::cat", [&](int x) {
+        return str::cat("Undefined state: ", x, "/", level, "#", 3.5);
+    });
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * layout-bench.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * Measures `layout::TextLayout` on a large scrollback buffer: appending and
+ * measuring text, rendering the last screenful of lines, appending a line
+ * and rendering again, and rewrapping after a width change, compared against
+ * rewrapping the whole buffer for every frame.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "moonlight/layout.h"
+
+using namespace moonlight;
+
+const int SCROLLBACK = 100000;
+const int ROWS = 50;
+
+template<class F>
+void bench(const std::string& name, int rounds, F f) {
+    size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int x = 0; x < rounds; x++) {
+        total += f(x);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double us = std::chrono::duration<double, std::micro>(end - start).count() / rounds;
+    fmt::print(std::cout, "{:<40} {:>12.2f} us/op  ({})\n", name, us, total);
+}
+
+std::string log_line(int x) {
+    return fmt::format("[{}] worker-{} processed request 間濾 {} with status {} 😺 and a longer tail of text to wrap\n",
+                       x, x % 8, x * 7, x % 5 == 0 ? "error" : "ok");
+}
+
+int main() {
+    std::string scrollback;
+    for (int x = 0; x < SCROLLBACK; x++) {
+        scrollback += log_line(x);
+    }
+
+    layout::TextLayout text(80);
+    bench("append and measure scrollback", 1, [&](int) {
+        text.append(scrollback);
+        return text.line_count();
+    });
+
+    bench("render last screen", 1000, [&](int) {
+        size_t bytes = 0;
+        for (auto line : text.lines(text.line_count() - ROWS, ROWS)) {
+            bytes += line.size();
+        }
+        return bytes;
+    });
+
+    bench("append line and render last screen", 1000, [&](int x) {
+        text.append(log_line(SCROLLBACK + x));
+        size_t bytes = 0;
+        for (auto line : text.lines(text.line_count() - ROWS, ROWS)) {
+            bytes += line.size();
+        }
+        return bytes;
+    });
+
+    bench("rewrap after width change", 10, [&](int x) {
+        text.width(x % 2 ? 80 : 60);
+        return text.line_count();
+    });
+
+    bench("naive: wrap all text for each frame", 3, [&](int) {
+        layout::TextLayout fresh(80);
+        fresh.append(scrollback);
+        size_t bytes = 0;
+        for (auto line : fresh.lines(fresh.line_count() - ROWS, ROWS)) {
+            bytes += line.size();
+        }
+        return bytes;
+    });
+
+    return 0;
+}
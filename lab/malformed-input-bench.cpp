@@ -0,0 +1,103 @@
+/*
+ * malformed-input-bench.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * Measures the throughput of rejecting malformed input via the throwing parse
+ * functions and their `try_` variants.  Build with the same flags as the
+ * tests, i.e. with `MOONLIGHT_ENABLE_STACKTRACE`, to include the cost of
+ * capturing stack traces for thrown exceptions.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "moonlight/cli.h"
+#include "moonlight/color.h"
+#include "moonlight/date.h"
+#include "moonlight/json.h"
+#include "moonlight/lex.h"
+
+using namespace moonlight;
+
+template<class F>
+double bench(int iterations, F f) {
+    size_t rejected = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int x = 0; x < iterations; x++) {
+        rejected += f() ? 0 : 1;
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (rejected != (size_t)iterations) {
+        std::cerr << "Malformed input was accepted!" << std::endl;
+    }
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+template<class E, class F, class T>
+void compare(const std::string& name, int iterations, F f_throw, T f_try) {
+    double us_throw = bench(iterations, [&]() {
+        try {
+            f_throw();
+            return true;
+        } catch (const E& e) {
+            return false;
+        }
+    });
+    double us_try = bench(iterations, f_try);
+    fmt::print(std::cout, "{:<24} {:>10.2f} us/throw {:>10.2f} us/try_ {:>8.1f}x\n",
+               name, us_throw, us_try, us_throw / us_try);
+}
+
+int main() {
+    const int N = 20000;
+
+    const std::string bad_json = "{\"id\": 42, \"tags\": [\"a\", \"b\" \"c\"]}";
+    compare<json::parser::ParseError>("json::read", N, [&]() {
+        json::read<json::Value::Pointer>(bad_json);
+    }, [&]() {
+        return json::try_read<json::Value::Pointer>(bad_json).ok();
+    });
+
+    auto grammar = lex::Grammar<std::string>()
+    .def(lex::ignore("\\s+"))
+    .def(lex::match("[0-9]+"), "number")
+    .def(lex::match("[a-z]+"), "word");
+    auto lexer = grammar.lexer();
+    const std::string bad_lex = "abc 123 def 456 $";
+    compare<lex::LexParseError>("lex::Lexer::lex", N, [&]() {
+        lexer.lex(bad_lex);
+    }, [&]() {
+        return lexer.try_lex(bad_lex).ok();
+    });
+
+    compare<core::ValueError>("Date::from_isoformat", N, []() {
+        moonlight::date::Date::from_isoformat("2021-02-30");
+    }, []() {
+        return moonlight::date::Date::try_from_isoformat("2021-02-30").ok();
+    });
+
+    compare<core::ValueError>("Datetime::strptime", N, []() {
+        moonlight::date::Datetime::strptime("2021-02-28 noon");
+    }, []() {
+        return moonlight::date::Datetime::try_strptime("2021-02-28 noon").ok();
+    });
+
+    compare<core::ValueError>("uRGB::validate", N, []() {
+        color::uRGB::validate("#12345g");
+    }, []() {
+        return color::uRGB::try_validate("#12345g").ok();
+    });
+
+    const std::vector<std::string> bad_argv = {"prog", "-v", "--output"};
+    compare<core::UsageError>("cli::parse", N, [&]() {
+        cli::parse(bad_argv, {"v"}, {"output"});
+    }, [&]() {
+        return cli::try_parse(bad_argv, {"v"}, {"output"}).ok();
+    });
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+/*
+ * screen-bench.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * Compares redrawing a full-screen dashboard on a pseudo-terminal by writing
+ * `scr::move_cursor()` and `Decorator`-wrapped text for every cell against
+ * `ansi::Screen`, by bytes and `write()` calls per frame.  Two workloads
+ * are measured: a dashboard where a few fields change each frame, and a
+ * color animation where every cell changes each frame.
+ */
+
+#include <pty.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include "moonlight/ansi.h"
+#include "moonlight/format.h"
+#include "moonlight/screen.h"
+
+using namespace moonlight;
+
+const int COLS = 200;
+const int ROWS = 60;
+const int FRAMES = 100;
+
+/**
+ * A stdio-like output buffer for a file descriptor, counting writes.
+ */
+class CountingBuf : public std::streambuf {
+ public:
+     explicit CountingBuf(int fd) : _fd(fd) {
+         setp(_buffer, _buffer + sizeof(_buffer));
+     }
+
+     size_t writes = 0;
+
+ protected:
+     int overflow(int c) override {
+         sync();
+         if (c != EOF) {
+             *pptr() = c;
+             pbump(1);
+         }
+         return c;
+     }
+
+     int sync() override {
+         size_t n = pptr() - pbase();
+         if (n > 0) {
+             _write(pbase(), n);
+             setp(_buffer, _buffer + sizeof(_buffer));
+         }
+         return 0;
+     }
+
+ private:
+     void _write(const char* data, size_t n) {
+         while (n > 0) {
+             ssize_t w = ::write(_fd, data, n);
+             writes++;
+             if (w > 0) {
+                 data += w;
+                 n -= w;
+             }
+         }
+     }
+
+     int _fd;
+     char _buffer[BUFSIZ];
+};
+
+struct Frame {
+    std::vector<std::string> glyphs;
+    std::vector<int> colors;
+};
+
+Frame dashboard(int frame) {
+    Frame f{std::vector<std::string>(COLS * ROWS, " "), std::vector<int>(COLS * ROWS, 7)};
+    for (int y = 0; y < ROWS; y++) {
+        std::string line = fmt::format("worker {:>3}  requests {:>8}  errors {:>4}  status {}",
+                                       y, y * 1000 + frame * (y + 1), (frame / 10) * y % 97,
+                                       (frame + y) % 7 == 0 ? "busy" : "idle");
+        for (size_t x = 0; x < line.size() && (int)x < COLS; x++) {
+            f.glyphs[y * COLS + x] = std::string(1, line[x]);
+            f.colors[y * COLS + x] = x < 10 ? 3 : 7;
+        }
+    }
+    return f;
+}
+
+Frame animation(int frame) {
+    Frame f{std::vector<std::string>(COLS * ROWS, "#"), std::vector<int>(COLS * ROWS)};
+    for (int y = 0; y < ROWS; y++) {
+        for (int x = 0; x < COLS; x++) {
+            f.colors[y * COLS + x] = (x + y + frame) % 8;
+        }
+    }
+    return f;
+}
+
+void naive(int fd, Frame (*workload)(int), size_t& writes) {
+    CountingBuf buf(fd);
+    std::ostream out(&buf);
+    for (int n = 0; n < FRAMES; n++) {
+        auto f = workload(n);
+        for (int y = 0; y < ROWS; y++) {
+            for (int x = 0; x < COLS; x++) {
+                out << scr::move_cursor(x + 1, y + 1)
+                << fg::color(f.colors[y * COLS + x])(f.glyphs[y * COLS + x]);
+            }
+        }
+        out << std::flush;
+    }
+    writes = buf.writes;
+}
+
+void screen(int fd, Frame (*workload)(int), size_t& writes) {
+    ansi::Screen screen(COLS, ROWS);
+    writes = 0;
+    for (int n = 0; n < FRAMES; n++) {
+        auto f = workload(n);
+        screen.clear();
+        for (int y = 0; y < ROWS; y++) {
+            for (int x = 0; x < COLS; x++) {
+                auto style = ansi::Style().with_fg(ansi::Color::index(f.colors[y * COLS + x]));
+                screen.print(x, y, f.glyphs[y * COLS + x], style);
+            }
+        }
+        screen.present(fd);
+        writes++;
+    }
+}
+
+int main() {
+    ansi::Options::get().color_enabled(true).control_enabled(true);
+
+    int master, slave;
+    struct winsize ws = {ROWS, COLS, 0, 0};
+    if (openpty(&master, &slave, nullptr, nullptr, &ws) != 0) {
+        perror("openpty");
+        return 1;
+    }
+
+    std::atomic<size_t> received = 0;
+    std::thread reader([&]() {
+        char buffer[65536];
+        ssize_t n;
+        while ((n = read(master, buffer, sizeof(buffer))) > 0) {
+            received += n;
+        }
+    });
+
+    auto bench = [&](const std::string& name, auto renderer, Frame (*workload)(int)) {
+        size_t writes = 0;
+        size_t before = received;
+        auto start = std::chrono::steady_clock::now();
+        renderer(slave, workload, writes);
+        tcdrain(slave);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count() / FRAMES;
+        fmt::print(std::cout, "{:<28} {:>10.1f} KB/frame {:>8.1f} writes/frame {:>8.2f} ms/frame\n",
+                   name, (received - before) / 1024.0 / FRAMES, (double)writes / FRAMES, ms);
+    };
+
+    bench("dashboard, naive", naive, dashboard);
+    bench("dashboard, ansi::Screen", screen, dashboard);
+    bench("animation, naive", naive, animation);
+    bench("animation, ansi::Screen", screen, animation);
+
+    close(slave);
+    reader.join();
+    close(master);
+    return 0;
+}
@@ -0,0 +1,59 @@
+/*
+ * stacktrace-bench.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * Measures the time taken to resolve a stack trace to symbols and source
+ * locations, via `addr2line` and in-process with a cold and a warm frame
+ * cache.  Build with `-g` to include line tables.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "moonlight/debug.h"
+#include "moonlight/format.h"
+
+using namespace moonlight;
+
+template<class F>
+void bench(const std::string& name, int iterations, F f) {
+    size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int x = 0; x < iterations; x++) {
+        total += f();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double us = std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+    fmt::print(std::cout, "{:<32} {:>10.2f} us/trace  ({})\n", name, us, total);
+}
+
+__attribute__((noinline))
+debug::StackTrace capture() {
+    return debug::StackTrace::generate();
+}
+
+int main() {
+    auto trace = capture();
+    std::vector<debug::BacktraceFrame> frames(trace.frames().begin(), trace.frames().end());
+
+    bench("addr2line", 20, [&]() {
+        auto symbols = debug::BacktraceSymbol::parse_frames(frames);
+        return debug::StackInfo::parse_symbols(symbols).size();
+    });
+    bench("in-process, cold cache", 1, [&]() {
+        return debug::resolve_frames(frames).size();
+    });
+    bench("in-process, warm cache", 100000, [&]() {
+        return debug::resolve_frames(frames).size();
+    });
+    bench("generate + format", 100000, [&]() {
+        std::ostringstream sb;
+        sb << capture();
+        return sb.str().size();
+    });
+    return 0;
+}
@@ -0,0 +1,62 @@
+/*
+ * subprocess-bench.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * Measures the time taken to run a batch of short commands sequentially via
+ * `popen` with `check()`, sequentially with `sys::run()`, and concurrently
+ * with a `sys::ProcessPool`.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "moonlight/format.h"
+#include "moonlight/subprocess.h"
+#include "moonlight/system.h"
+
+using namespace moonlight;
+
+const int COMMANDS = 200;
+
+template<class F>
+void bench(const std::string& name, F f) {
+    auto start = std::chrono::steady_clock::now();
+    size_t total = f();
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    fmt::print(std::cout, "{:<32} {:>10.2f} ms  ({} bytes)\n", name, ms, total);
+}
+
+int main() {
+    const std::string cmd = "sed -n 1p /etc/hostname";
+
+    bench("check(), sequential", [&]() {
+        size_t total = 0;
+        for (int x = 0; x < COMMANDS; x++) {
+            total += check(cmd).size();
+        }
+        return total;
+    });
+    bench("sys::run(), sequential", [&]() {
+        size_t total = 0;
+        for (int x = 0; x < COMMANDS; x++) {
+            total += sys::run(cmd).check().size();
+        }
+        return total;
+    });
+    for (size_t procs : {4, 16, 64}) {
+        bench(fmt::format("ProcessPool({}).map()", procs), [&]() {
+            sys::ProcessPool pool(procs);
+            size_t total = 0;
+            for (auto& result : pool.map(std::vector<sys::Command>(COMMANDS, cmd))) {
+                total += result.check().size();
+            }
+            return total;
+        });
+    }
+    return 0;
+}
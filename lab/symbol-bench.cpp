@@ -0,0 +1,84 @@
+/*
+ * symbol-bench.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * Measures the heap used by a log/JSON-like workload of many small records
+ * with repeated logger names and field keys, storing the names either as
+ * `std::string` or as `str::Symbol`, and compares the cost of key equality.
+ */
+
+#include <malloc.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "moonlight/symbol.h"
+
+using namespace moonlight;
+
+const int RECORDS = 200000;
+
+const std::vector<std::string> LOGGERS = {
+    "moonlight.http.server.connection-pool", "moonlight.http.server.request-handler",
+    "moonlight.sql.sqlite3.statement-cache", "moonlight.scheduler.background-worker"
+};
+
+const std::vector<std::string> KEYS = {
+    "request_id", "remote_address", "user_agent_string", "response_status_code",
+    "elapsed_microseconds", "upstream_service_name"
+};
+
+template<class S>
+struct Record {
+    S logger;
+    std::vector<std::pair<S, int>> fields;
+};
+
+size_t heap_used() {
+    return mallinfo2().uordblks;
+}
+
+template<class S>
+void bench(const std::string& name) {
+    size_t before = heap_used();
+    std::vector<Record<S>> records;
+    records.reserve(RECORDS);
+    for (int x = 0; x < RECORDS; x++) {
+        Record<S> record;
+        record.logger = S(LOGGERS[x % LOGGERS.size()]);
+        for (const auto& key : KEYS) {
+            record.fields.push_back({S(key), x});
+        }
+        records.emplace_back(std::move(record));
+    }
+    size_t after = heap_used();
+
+    S target = S(KEYS.back());
+    size_t matches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& record : records) {
+        for (const auto& field : record.fields) {
+            matches += field.first == target;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+
+    fmt::print(std::cout, "{:<16} {:>10.2f} MiB heap {:>8.2f} ns/compare  ({} matches)\n",
+               name, (after - before) / (1024.0 * 1024.0),
+               ns / (RECORDS * KEYS.size()), matches);
+}
+
+int main() {
+    bench<std::string>("std::string");
+    bench<str::Symbol>("str::Symbol");
+
+    auto stats = str::Symbol::stats();
+    fmt::print(std::cout, "symbol pool: {} symbols, {} bytes\n", stats.count, stats.bytes);
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * unicode-bench.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * Measures UTF-8 validation, UTF-8 <-> UTF-32 transcoding, and reading through
+ * `unicode::BufferedInput` in GB/s on ASCII and mixed-script text, compared
+ * against `utfcpp` and the previous code point at a time reader.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "moonlight/unicode.h"
+
+using namespace moonlight;
+
+const int ROUNDS = 5;
+
+/**
+ * The previous `unicode::BufferedInput` decoding loop, for comparison.
+ */
+size_t legacy_read(const std::string& text) {
+    std::istringstream infile(text);
+    std::istream_iterator<unsigned char> iter(infile), end;
+    size_t count = 0;
+    try {
+        for (;;) {
+            utf8::next(iter, end);
+            count++;
+        }
+    } catch (const utf8::not_enough_room& e) { }
+    return count;
+}
+
+template<class F>
+void bench(const std::string& name, const std::string& text, F f) {
+    size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int x = 0; x < ROUNDS; x++) {
+        total += f();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    fmt::print(std::cout, "{:<36} {:>8.3f} GB/s  ({})\n", name, (ROUNDS * text.size()) / ns, total);
+}
+
+void bench_text(const std::string& title, const std::string& text) {
+    std::cout << "--- " << title << " (" << text.size() / (1024 * 1024) << " MiB) ---" << std::endl;
+
+    bench("validate: utf8::is_valid", text, [&]() {
+        return (size_t)utf8::is_valid(text.begin(), text.end());
+    });
+    bench("validate: scalar", text, [&]() {
+        return (size_t)unicode::_utf8::validate_scalar(
+            reinterpret_cast<const unsigned char*>(text.data()), text.size());
+    });
+    bench("validate: unicode::is_valid_utf8", text, [&]() {
+        return (size_t)unicode::is_valid_utf8(text);
+    });
+
+    unicode::string wide;
+    bench("utf8 -> utf32: utf8::utf8to32", text, [&]() {
+        wide = utf8::utf8to32(text);
+        return wide.size();
+    });
+    std::vector<unicode::u32_t> out(text.size());
+    bench("utf8 -> utf32: unicode::utf8_to_utf32", text, [&]() {
+        return unicode::utf8_to_utf32(text, out).written;
+    });
+
+    std::string narrow;
+    bench("utf32 -> utf8: utf8::utf32to8", text, [&]() {
+        narrow = utf8::utf32to8(wide);
+        return narrow.size();
+    });
+    bench("utf32 -> utf8: unicode::encode", text, [&]() {
+        narrow = unicode::encode(wide);
+        return narrow.size();
+    });
+
+    bench("read: legacy istream_iterator", text, [&]() {
+        return legacy_read(text);
+    });
+    bench("read: unicode::BufferedInput", text, [&]() {
+        std::istringstream infile(text);
+        unicode::BufferedInput input(infile);
+        size_t count = 0;
+        while (input.getc() != (unicode::u32_t)EOF) {
+            count++;
+        }
+        return count;
+    });
+}
+
+int main() {
+    const size_t SIZE = 32 * 1024 * 1024;
+    std::string ascii, mixed;
+    while (ascii.size() < SIZE) {
+        ascii += "The quick brown fox jumps over the lazy dog, again and again.\n";
+    }
+    while (mixed.size() < SIZE) {
+        mixed += "Unicode テキスト with ñ, ü, and emoji 😺 mixed into ASCII. 間濾mew\n";
+    }
+
+    bench_text("ASCII", ascii);
+    bench_text("mixed", mixed);
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * uuid-sqlite-bench.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * Compares SQLite insert throughput into a table keyed by UUID text, using
+ * random version 4 keys and time-ordered version 7 keys.  Rows are inserted
+ * in transactions of `BATCH` rows into a file database, and the size of the
+ * database file afterwards shows how fragmented the index became.
+ */
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include "moonlight/format.h"
+#include "moonlight/sql/sqlite3.h"
+#include "moonlight/uuid.h"
+
+using namespace moonlight;
+
+const int ROWS = 200000;
+const int BATCH = 10000;
+
+void bench(const std::string& name, std::function<uuid::UUID()> next_id) {
+    const std::string filename = "/tmp/uuid-sqlite-bench.db";
+    unlink(filename.c_str());
+
+    auto db = sqlite::Client::open(filename);
+    db->exec("pragma cache_size = -8000");
+    db->exec("create table events (id text primary key, payload text) without rowid");
+
+    char text[36];
+    auto start = std::chrono::steady_clock::now();
+    for (int x = 0; x < ROWS; x += BATCH) {
+        db->exec("begin");
+        for (int y = 0; y < BATCH; y++) {
+            uuid::format(next_id(), text);
+            db->exec("insert into events (id, payload) values (?, ?)",
+                     std::string_view(text, sizeof(text)), "payload");
+        }
+        db->exec("commit");
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    db->close();
+
+    struct stat st;
+    stat(filename.c_str(), &st);
+    fmt::print(std::cout, "{:<6} {:>10.0f} rows/s {:>8.1f} MB\n",
+               name, ROWS / seconds, st.st_size / 1048576.0);
+    unlink(filename.c_str());
+}
+
+int main() {
+    uuid::Generator v4;
+    uuid::V7Generator v7;
+    bench("v4", [&]() { return v4(); });
+    bench("v7", [&]() { return v7(); });
+    return 0;
+}
@@ -0,0 +1,236 @@
+/*
+ * alloc.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "moonlight/alloc.h"
+#include "moonlight/json.h"
+#include "moonlight/lex.h"
+#include "moonlight/sql/sqlite3.h"
+#include "moonlight/test.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+/**
+ * Counts the allocations passed through to the default resource.
+ */
+class CountingResource : public std::pmr::memory_resource {
+ public:
+     size_t allocs = 0;
+     size_t frees = 0;
+
+ protected:
+     void* do_allocate(size_t bytes, size_t align) override {
+         allocs++;
+         return std::pmr::new_delete_resource()->allocate(bytes, align);
+     }
+
+     void do_deallocate(void* ptr, size_t bytes, size_t align) override {
+         frees++;
+         std::pmr::new_delete_resource()->deallocate(ptr, bytes, align);
+     }
+
+     bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+         return this == &other;
+     }
+};
+
+struct Tracked {
+    explicit Tracked(int& destroyed) : destroyed(destroyed) { }
+    ~Tracked() {
+        destroyed++;
+    }
+    int& destroyed;
+};
+
+const char* JSON_DOCUMENT = R"({"name": "moonlight", "tags": ["json", "lex", "sql"], "version": 1.5, "nested": {"ok": true, "none": null}})";
+
+int main() {
+    return TestSuite("moonlight alloc.h tests")
+    .test("arena allocations are aligned and grow in chunks", []() {
+        CountingResource upstream;
+        {
+            alloc::Arena arena(256, &upstream);
+            set<void*> seen;
+            for (size_t x = 0; x < 1000; x++) {
+                size_t align = size_t(1) << (x % 6);
+                void* ptr = arena.allocate(x % 50, align);
+                ASSERT_EQUAL(reinterpret_cast<uintptr_t>(ptr) % align, 0ul);
+                ASSERT(ptr != nullptr);
+                if (x % 50 != 0) {
+                    ASSERT(seen.insert(ptr).second);
+                }
+            }
+            void* big = arena.allocate(100000);
+            ASSERT(big != nullptr);
+            ASSERT(arena.capacity() >= 100000);
+            ASSERT(upstream.allocs > 1 && upstream.allocs < 20);
+        }
+        ASSERT_EQUAL(upstream.frees, upstream.allocs);
+    })
+    .test("arena reset keeps one chunk and runs destructors", []() {
+        CountingResource upstream;
+        int destroyed = 0;
+        alloc::Arena arena(256, &upstream);
+
+        for (int round = 0; round < 3; round++) {
+            for (int x = 0; x < 100; x++) {
+                Tracked* tracked = arena.make<Tracked>(destroyed);
+                ASSERT(&tracked->destroyed == &destroyed);
+                arena.make<int>(x);
+            }
+            ASSERT(arena.allocated() > 0);
+            arena.reset();
+            ASSERT_EQUAL(destroyed, (round + 1) * 100);
+            ASSERT_EQUAL(arena.allocated(), 0ul);
+            ASSERT_EQUAL(upstream.allocs - upstream.frees, 1ul);
+        }
+
+        size_t allocs = upstream.allocs;
+        for (int x = 0; x < 10; x++) {
+            arena.allocate(16);
+        }
+        ASSERT_EQUAL(upstream.allocs, allocs);
+    })
+    .test("arena backed by a caller's buffer", []() {
+        CountingResource upstream;
+        alignas(16) char buffer[1024];
+        alloc::Arena arena(buffer, sizeof(buffer), &upstream);
+
+        std::pmr::vector<int> numbers(&arena);
+        numbers.reserve(100);
+        for (int x = 0; x < 100; x++) {
+            numbers.push_back(x);
+        }
+        ASSERT((void*)numbers.data() >= (void*)buffer && (void*)numbers.data() < (void*)(buffer + sizeof(buffer)));
+        ASSERT_EQUAL(upstream.allocs, 0ul);
+        arena.allocate(2048);
+        ASSERT_EQUAL(upstream.allocs, 1ul);
+    })
+    .test("fixed pools reuse blocks across threads", []() {
+        typedef alloc::FixedPool<48> Pool;
+        vector<void*> blocks;
+        for (int x = 0; x < 1000; x++) {
+            void* ptr = Pool::allocate();
+            ASSERT_EQUAL(reinterpret_cast<uintptr_t>(ptr) % alignof(std::max_align_t), 0ul);
+            memset(ptr, x & 0xff, 48);
+            blocks.push_back(ptr);
+        }
+        ASSERT_EQUAL(set<void*>(blocks.begin(), blocks.end()).size(), blocks.size());
+
+        // Free on another thread, then reallocate the same blocks here.
+        thread([&]() {
+            for (void* ptr : blocks) {
+                Pool::deallocate(ptr);
+            }
+        }).join();
+
+        set<void*> freed(blocks.begin(), blocks.end());
+        size_t reused = 0;
+        for (int x = 0; x < 1000; x++) {
+            reused += freed.count(Pool::allocate());
+        }
+        ASSERT(reused > 900);
+    })
+    .test("object pools", []() {
+        int destroyed = 0;
+        Tracked* a = alloc::ObjectPool<Tracked>::create(destroyed);
+        alloc::ObjectPool<Tracked>::destroy(a);
+        ASSERT_EQUAL(destroyed, 1);
+        Tracked* b = alloc::ObjectPool<Tracked>::create(destroyed);
+        ASSERT(a == b);
+        alloc::ObjectPool<Tracked>::destroy(b);
+
+        auto shared = std::allocate_shared<std::string>(alloc::PoolAllocator<std::string>(), "pooled");
+        ASSERT_EQUAL(*shared, std::string("pooled"));
+
+        std::pmr::vector<std::pmr::string> strings(alloc::pool_resource());
+        for (int x = 0; x < 100; x++) {
+            strings.emplace_back(std::string(x, 'x'));
+        }
+        ASSERT_EQUAL(strings[99].size(), 99ul);
+    })
+    .test("scoped make_shared", []() {
+        CountingResource resource;
+        ASSERT(alloc::current_resource() == nullptr);
+        {
+            alloc::Scope scope(resource);
+            auto value = alloc::make_shared<int>(5);
+            ASSERT_EQUAL(resource.allocs, 1ul);
+            {
+                alloc::Scope inner(nullptr);
+                alloc::make_shared<int>(6);
+                ASSERT_EQUAL(resource.allocs, 1ul);
+            }
+            ASSERT(alloc::current_resource() == &resource);
+        }
+        ASSERT(alloc::current_resource() == nullptr);
+        ASSERT_EQUAL(resource.frees, 1ul);
+    })
+    .test("JSON parses scoped to an arena", []() {
+        CountingResource upstream;
+        alloc::Arena arena(4096, &upstream);
+        json::Value::Pointer escaped;
+        {
+            std::istringstream input(JSON_DOCUMENT);
+            json::parser::Parser parser(input, "<input>", &arena);
+            auto value = parser.parse();
+            ASSERT(arena.allocated() > 0);
+            ASSERT_EQUAL(value->ref<json::Object>().get<std::string>("name"), std::string("moonlight"));
+            ASSERT_EQUAL(value->ref<json::Object>().get<json::Array>("tags").size(), 3u);
+
+            size_t allocated = arena.allocated();
+            escaped = value->clone();
+            ASSERT_EQUAL(arena.allocated(), allocated);
+
+            alloc::Scope scope(arena);
+            auto obj = json::read<json::Object>(JSON_DOCUMENT);
+            ASSERT(arena.allocated() > allocated);
+            ASSERT(obj.get<json::Object>("nested").get<bool>("ok"));
+        }
+        arena.reset();
+        ASSERT_EQUAL(json::to_string(escaped), json::to_string(json::read<json::Value::Pointer>(JSON_DOCUMENT)));
+    })
+    .test("lexing into an arena", []() {
+        auto lexer = lex::Grammar<std::string>()
+        .def(lex::ignore("\\s"))
+        .def(lex::match("[a-z]+"), "word")
+        .lexer();
+
+        alloc::Arena arena;
+        std::pmr::vector<lex::Token<std::string>> tokens(&arena);
+        ASSERT(! lexer.try_lex("moon light", tokens).has_value());
+        ASSERT_EQUAL(tokens.size(), 2ul);
+        ASSERT_EQUAL(tokens[1].capture().group(), std::string("light"));
+        ASSERT(arena.allocated() > 0);
+        ASSERT(lexer.try_lex("moon 42", tokens).has_value());
+    })
+    .test("SQL rows scoped to an arena", []() {
+        auto sql = sqlite::Client::open("");
+        sql->exec("create table t (x integer)");
+        sql->exec("insert into t values (1), (2), (3)");
+
+        alloc::Arena arena;
+        int total = 0;
+        {
+            alloc::Scope scope(arena);
+            sql->query("select x from t").for_each([&](auto row) {
+                total += row->at(0).as_int();
+            });
+        }
+        ASSERT_EQUAL(total, 6);
+        ASSERT(arena.allocated() > 0);
+    })
+    .run();
+}
@@ -23,5 +23,22 @@ int main() {
         ASSERT_FALSE(cmd.check("f", "force"));
         ASSERT_EQUAL(cmd.args(), {"oranges"});
     })
+    .test("cli::try_parse reports errors without throwing", []() {
+        auto ok = cli::try_parse({"test", "-v", "--apples=2"}, {"v"}, {"apples"});
+        ASSERT(ok.ok());
+        ASSERT(ok->check("v"));
+
+        auto unknown = cli::try_parse({"test", "-v", "--pears"}, {"v"}, {"apples"});
+        ASSERT(unknown.error().code == core::ErrorCode::UNKNOWN_NAME);
+        ASSERT_EQUAL(unknown.error().loc.offset, 2u);
+
+        auto missing = cli::try_parse({"test", "--apples"}, {"v"}, {"apples"});
+        ASSERT(missing.error().code == core::ErrorCode::MISSING_VALUE);
+        try {
+            cli::parse({"test", "--apples"}, {"v"}, {"apples"});
+            FAIL("Expected UsageError.");
+
+        } catch (const core::UsageError& e) { }
+    })
     .run();
 }
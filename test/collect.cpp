@@ -0,0 +1,208 @@
+/*
+ * collect.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <string>
+#include <vector>
+#include "moonlight/collect.h"
+#include "moonlight/hash.h"
+#include "moonlight/test.h"
+
+using namespace moonlight;
+using namespace moonlight::test;
+
+const std::vector<size_t> SIZES = {0, 1, 7, MOONLIGHT_PAR_MIN_CHUNK + 1, 100003};
+
+std::vector<uint64_t> numbers(size_t size) {
+    std::vector<uint64_t> result(size);
+    for (size_t x = 0; x < size; x++) {
+        result[x] = hash::mix(x) % 1000000;
+    }
+    return result;
+}
+
+int main() {
+    return TestSuite("moonlight collect tests")
+    .test("filter and sorted in place", []() {
+        auto evens = collect::filter(std::vector<int>{5, 2, 4, 1, 6}, [](int x) {
+            return x % 2 == 0;
+        });
+        ASSERT_EQUAL(evens, {2, 4, 6});
+
+        std::vector<int> src = {3, 1, 2};
+        auto data = src.data();
+        auto result = collect::sorted(std::move(src));
+        ASSERT_EQUAL(result, {1, 2, 3});
+        ASSERT_EQUAL(result.data(), data);
+    })
+    .test("par::map", []() {
+        for (size_t threads : {1, 3, 8}) {
+            collect::par::Pool pool(threads);
+            for (size_t size : SIZES) {
+                auto src = numbers(size);
+                auto result = collect::par::map(src, [](uint64_t x) { return x * 2 + 1; }, pool);
+                auto bits = collect::par::map(src, [](uint64_t x) { return x % 2 == 0; }, pool);
+
+                ASSERT_EQUAL(result.size(), size);
+                ASSERT_EQUAL(bits.size(), size);
+                for (size_t x = 0; x < size; x++) {
+                    ASSERT_EQUAL(result[x], src[x] * 2 + 1);
+                    ASSERT_EQUAL((bool)bits[x], src[x] % 2 == 0);
+                }
+            }
+        }
+    })
+    .test("par::map and par::filter move from rvalues", []() {
+        collect::par::Pool pool(4);
+        auto make = []() {
+            std::vector<std::unique_ptr<size_t>> ptrs;
+            for (size_t x = 0; x < 10000; x++) {
+                ptrs.push_back(std::make_unique<size_t>(x));
+            }
+            return ptrs;
+        };
+
+        auto values = collect::par::map(make(), [](std::unique_ptr<size_t> p) {
+            return *p;
+        }, pool);
+        auto odds = collect::par::filter(make(), [](const std::unique_ptr<size_t>& p) {
+            return *p % 2 == 1;
+        }, pool);
+
+        ASSERT_EQUAL(values.size(), (size_t)10000);
+        ASSERT_EQUAL(odds.size(), (size_t)5000);
+        for (size_t x = 0; x < odds.size(); x++) {
+            ASSERT_EQUAL(values[x], x);
+            ASSERT_EQUAL(*odds[x], x * 2 + 1);
+        }
+    })
+    .test("par algorithms don't move from views", []() {
+        collect::par::Pool pool(4);
+        std::vector<std::string> src;
+        for (size_t x = 0; x < 1000; x++) {
+            src.push_back(std::string(32, 'a' + x % 26));
+        }
+        auto expected = src;
+
+        auto sizes = collect::par::map(std::span<std::string>(src), [](std::string s) {
+            return s.size();
+        }, pool);
+        ASSERT_EQUAL(sizes, std::vector<size_t>(1000, 32));
+        ASSERT_EQUAL(src, expected);
+
+        auto kept = collect::par::filter(std::span<std::string>(src), [](const std::string& s) {
+            return s[0] == 'a';
+        }, pool);
+        ASSERT_EQUAL(kept.size(), (size_t)39);
+        ASSERT_EQUAL(src, expected);
+
+        auto sorted = collect::par::sorted(std::span<std::string>(src), std::greater<>(), pool);
+        ASSERT_EQUAL(sorted.front(), std::string(32, 'z'));
+        ASSERT_EQUAL(src, expected);
+    })
+    .test("par::filter keeps order", []() {
+        collect::par::Pool pool(5);
+        for (size_t size : SIZES) {
+            auto src = numbers(size);
+            auto pred = [](uint64_t x) { return x % 3 == 0; };
+            std::vector<uint64_t> expected;
+            std::copy_if(src.begin(), src.end(), std::back_inserter(expected), pred);
+            ASSERT_EQUAL(collect::par::filter(src, pred, pool), expected);
+        }
+    })
+    .test("par::sort and par::sorted", []() {
+        for (size_t threads : {1, 2, 3, 8}) {
+            collect::par::Pool pool(threads);
+            for (size_t size : SIZES) {
+                auto src = numbers(size);
+                auto expected = src;
+                std::sort(expected.begin(), expected.end(), std::greater<>());
+
+                auto copy = collect::par::sorted(src, std::greater<>(), pool);
+                ASSERT_EQUAL(copy, expected);
+                ASSERT_EQUAL(src, numbers(size));
+
+                collect::par::sort(src, std::greater<>(), pool);
+                ASSERT_EQUAL(src, expected);
+            }
+        }
+    })
+    .test("par::reduce combines in order", []() {
+        collect::par::Pool pool(4);
+        for (size_t size : SIZES) {
+            auto src = numbers(size);
+            ASSERT_EQUAL(collect::par::reduce(src, (uint64_t)7, std::plus<>(), pool),
+                         std::accumulate(src.begin(), src.end(), (uint64_t)7));
+        }
+
+        std::vector<std::string> words(20000);
+        for (size_t x = 0; x < words.size(); x++) {
+            words[x] = std::string(1, 'a' + x % 26);
+        }
+        ASSERT_EQUAL(collect::par::reduce(words, std::string(">"), std::plus<>(), pool),
+                     std::accumulate(words.begin(), words.end(), std::string(">")));
+    })
+    .test("par::for_each modifies in place", []() {
+        collect::par::Pool pool(4);
+        auto src = numbers(50000);
+        auto expected = src;
+        collect::par::for_each(src, [](uint64_t& x) { x += 1; }, pool);
+        for (size_t x = 0; x < src.size(); x++) {
+            ASSERT_EQUAL(src[x], expected[x] + 1);
+        }
+    })
+    .test("par exceptions and nesting", []() {
+        collect::par::Pool pool(4);
+        auto src = numbers(50000);
+
+        try {
+            collect::par::for_each(src, [](uint64_t& x) {
+                if (x % 1000 == 999) {
+                    THROW(core::ValueError, "Bad value.");
+                }
+            }, pool);
+            FAIL("Expected ValueError.");
+
+        } catch (const core::ValueError& e) { }
+
+        std::vector<std::vector<uint64_t>> nested(16, src);
+        collect::par::for_each(nested, [&](std::vector<uint64_t>& v) {
+            collect::par::sort(v, std::less<>(), pool);
+        }, pool);
+
+        std::sort(src.begin(), src.end());
+        for (const auto& v : nested) {
+            ASSERT_EQUAL(v, src);
+        }
+    })
+    .test("views are copied, never modified or moved from", []() {
+        std::vector<std::string> words = {"moon", "light", "sun", "star"};
+        const auto original = words;
+        std::span<std::string> view(words);
+
+        std::vector<std::string> sorted = collect::sorted(std::span<std::string>(words));
+        ASSERT_EQUAL(sorted, {"light", "moon", "star", "sun"});
+        auto filtered = collect::filter(std::span<std::string>(words), [](std::string s) {
+            return s.size() > 3;
+        });
+        ASSERT_EQUAL(filtered, {"moon", "light", "star"});
+        ASSERT_EQUAL(collect::par::sorted(std::span<std::string>(words)), sorted);
+        ASSERT_EQUAL(collect::par::filter(std::span<std::string>(words), [](const std::string& s) {
+            return s.size() > 3;
+        }), filtered);
+        ASSERT_EQUAL(collect::par::map(std::move(view), [](std::string s) {
+            return s;
+        }), original);
+        ASSERT_EQUAL(words, original);
+    })
+    .run();
+}
@@ -35,5 +35,18 @@ int main() {
         std::cout << "static_cast<uRGB>(hsvCyan) = " << static_cast<uRGB>(hsvCyan) << std::endl;
         ASSERT_EQUAL(rgbCyan, static_cast<uRGB>(hsvCyan));
     })
+    .test("uRGB::try_validate", []() {
+        ASSERT_EQUAL(*uRGB::try_validate("#AC00ff"), uRGB::of(0xAC00FF));
+        ASSERT_EQUAL(*uRGB::try_validate("00acac"), uRGB::of(0x00ACAC));
+        ASSERT_FALSE(uRGB::try_validate("#AC00f").ok());
+        ASSERT_FALSE(uRGB::try_validate("#AC00ff0").ok());
+        ASSERT_FALSE(uRGB::try_validate("#+C00ff").ok());
+        ASSERT_FALSE(uRGB::is_valid("#AC00fg"));
+        try {
+            uRGB::validate("red");
+            FAIL("Expected ValueError.");
+
+        } catch (const core::ValueError& e) { }
+    })
     .run();
 }
@@ -1,6 +1,9 @@
 #include <map>
 #include <random>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 #include "moonlight/test.h"
 #include "moonlight/file.h"
 #include "moonlight/maps.h"
@@ -33,6 +36,50 @@ int main() {
         ASSERT_EQUAL(mmap::collect(mmap, "fruit"),
                      {"apple", "orange", "banana", "pear"});
     })
+    .test("mmap::FlatMultimap lookups", []() {
+        auto flat = mmap::build_flat<std::string, std::string>({
+            {"meat", {"beef", "chicken"}},
+            {"fruit", {"apple", "orange", "banana", "pear"}},
+            {"drink", {"coffee", "tea", "ice water"}},
+            {"meat", {"pork"}}});
+
+        ASSERT_EQUAL(flat.size(), (size_t)10);
+        ASSERT_EQUAL(mmap::collect(flat, "fruit"),
+                     {"apple", "orange", "banana", "pear"});
+        ASSERT_EQUAL(mmap::collect(flat, std::string("meat")), {"beef", "chicken", "pork"});
+        ASSERT_EQUAL(flat.count(std::string_view("drink")), (size_t)3);
+        ASSERT_EQUAL(flat.count("candy"), (size_t)0);
+        ASSERT_TRUE(flat.contains("drink"));
+        ASSERT_FALSE(flat.contains("aardvark"));
+        ASSERT_FALSE(flat.contains("zebra"));
+        ASSERT_TRUE(flat.equal_range("candy").empty());
+        ASSERT_TRUE((mmap::FlatMultimap<int, int>().equal_range(1).empty()));
+    })
+    .test("mmap::FlatMultimap agrees with std::multimap", []() {
+        std::mt19937 gen(1234);
+        std::uniform_int_distribution<int> keys(0, 200);
+        std::multimap<int, int> tree;
+        for (int x = 0; x < 2000; x++) {
+            tree.insert({keys(gen), x});
+        }
+        mmap::FlatMultimap<int, int> flat(tree);
+
+        for (int key = -1; key <= 201; key++) {
+            ASSERT_EQUAL(mmap::collect(flat, key), mmap::collect(tree, key));
+        }
+    })
+    .test("mmap::StaticMultimap at compile time", []() {
+        static constexpr auto numbers = mmap::make_static<std::string_view, int>({
+            {"odd", 1}, {"even", 2}, {"odd", 3}, {"even", 4}, {"prime", 2}, {"prime", 3}
+        });
+        static_assert(numbers.size() == 6);
+        static_assert(numbers.count("even") == 2);
+        static_assert(numbers.equal_range("odd")[1] == 3);
+        static_assert(! numbers.contains("zero"));
+
+        std::vector<int> primes(numbers.equal_range("prime").begin(), numbers.equal_range("prime").end());
+        ASSERT_EQUAL(primes, {2, 3});
+    })
     .test("Finalizer tests", []() {
         std::random_device rd;
         std::mt19937 gen(rd());
@@ -108,5 +155,42 @@ int main() {
 
         ASSERT_EQUAL(x, 12ul);
     })
+    .test("Exception::what() reflects a later cause", []() {
+        core::ValueError e("Bad value.");
+        std::string before = e.what();
+        ASSERT(str::startswith(before, "moonlight::core::ValueError: Bad value."));
+
+        e.caused_by(core::IndexError("Out of range."));
+        std::string after = e.what();
+        ASSERT(after.find("Caused by moonlight::core::IndexError: Out of range.") != std::string::npos);
+
+        core::ValueError copy(e);
+        ASSERT_EQUAL(std::string(copy.what()), after);
+    })
+    .test("Exception copy assignment and concurrent what()", []() {
+        core::ValueError e("Bad value.");
+        e.caused_by(core::IndexError("Out of range."));
+        core::ValueError other("Other value.");
+        std::string before = other.what();
+        other = e;
+        ASSERT_EQUAL(std::string(other.what()), std::string(e.what()));
+        ASSERT(std::string(other.what()) != before);
+
+        core::ValueError fresh("Fresh.");
+        std::vector<std::string> results(4);
+        std::vector<std::thread> threads;
+        for (size_t x = 0; x < results.size(); x++) {
+            threads.emplace_back([&, x]() {
+                results[x] = fresh.what();
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (const auto& result : results) {
+            ASSERT(result == results[0]);
+        }
+        ASSERT_EQUAL(std::string(fresh.what()), results[0]);
+    })
     .run();
 }
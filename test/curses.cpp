@@ -0,0 +1,140 @@
+/*
+ * curses.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Monday October 19, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <sys/stat.h>
+
+#include <cstdio>
+#include "moonlight/test.h"
+#include "moonlight/curses.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+// The terminal output is written to a temporary file, so that tests can
+// tell whether a frame wrote anything.
+static FILE* term_out = nullptr;
+
+static off_t bytes_written() {
+    fflush(term_out);
+    struct stat st;
+    fstat(fileno(term_out), &st);
+    return st.st_size;
+}
+
+int main() {
+    term_out = tmpfile();
+    FILE* term_in = fopen("/dev/null", "r");
+    SCREEN* screen = newterm("xterm", term_out, term_in);
+    if (screen == nullptr) {
+        std::cerr << "Failed to create a curses screen." << std::endl;
+        return 1;
+    }
+    resizeterm(24, 80);
+
+    int result = TestSuite("moonlight curses tests")
+    .test("Damaged areas accumulate into their bounding rectangle", []() {
+        curses::Panel panel({20, 10}, {0, 0});
+        ASSERT_FALSE(panel.damaged().has_value());
+
+        panel.damage(geo::Rect<int>(2, 3, 4, 1));
+        panel.damage(geo::Rect<int>(10, 1, 2, 5));
+        auto rect = *panel.damaged();
+        ASSERT_EQUAL(rect.pos.x, 2);
+        ASSERT_EQUAL(rect.pos.y, 1);
+        ASSERT_EQUAL(rect.sz.w, 10);
+        ASSERT_EQUAL(rect.sz.h, 5);
+        ASSERT_TRUE(panel.dirty());
+
+        panel.damage();
+        rect = *panel.damaged();
+        ASSERT_EQUAL(rect.pos.x, 0);
+        ASSERT_EQUAL(rect.pos.y, 0);
+        ASSERT_EQUAL(rect.sz.w, 20);
+        ASSERT_EQUAL(rect.sz.h, 10);
+    })
+    .test("Damage touches only the damaged lines", []() {
+        curses::Panel panel({20, 10}, {0, 0});
+        curses::Renderer renderer;
+        renderer.refresh();
+        ASSERT_FALSE(panel.dirty());
+
+        panel.damage(geo::Rect<int>(1, 2, 3, 1));
+        panel.damage(geo::Rect<int>(4, 4, 2, 2));
+        panel.apply_damage();
+        ASSERT_FALSE(panel.damaged().has_value());
+
+        WINDOW* win = panel.win().raw_ptr();
+        for (int y = 0; y < 10; y++) {
+            ASSERT_EQUAL(is_linetouched(win, y) == TRUE, y >= 2 && y < 6);
+        }
+
+        renderer.refresh();
+        panel.damage(geo::Rect<int>(0, -3, 5, 5));
+        panel.damage(geo::Rect<int>(0, 8, 5, 5));
+        panel.apply_damage();
+        for (int y = 0; y < 10; y++) {
+            ASSERT_EQUAL(is_linetouched(win, y) == TRUE, true);
+        }
+    })
+    .test("Renderer skips frames when no panel is dirty", []() {
+        auto a = std::make_shared<curses::Panel>(curses::XY{20, 5}, curses::XY{0, 0});
+        auto b = std::make_shared<curses::Panel>(curses::XY{20, 5}, curses::XY{30, 10});
+        curses::Renderer renderer;
+        ASSERT_TRUE(renderer.refresh());
+
+        auto before = bytes_written();
+        ASSERT_FALSE(renderer.refresh());
+        ASSERT_EQUAL(renderer.skipped(), (uint64_t)1);
+        ASSERT_EQUAL(bytes_written(), before);
+
+        a->win().go(1, 1);
+        a->win().draw("hello");
+        ASSERT_TRUE(a->dirty());
+        ASSERT_FALSE(b->dirty());
+        ASSERT_TRUE(renderer.refresh());
+        ASSERT_TRUE(bytes_written() > before);
+        ASSERT_FALSE(a->dirty());
+        ASSERT_FALSE(b->dirty());
+
+        b->damage(geo::Rect<int>(0, 2, 5, 2));
+        ASSERT_FALSE(a->dirty());
+        ASSERT_TRUE(b->dirty());
+        ASSERT_TRUE(renderer.refresh());
+        ASSERT_FALSE(b->dirty());
+
+        ASSERT_FALSE(renderer.refresh());
+        ASSERT_EQUAL(renderer.frames(), (uint64_t)3);
+        ASSERT_EQUAL(renderer.skipped(), (uint64_t)2);
+    })
+    .test("Each renderer sees panels restacked since its last frame", []() {
+        auto a = std::make_shared<curses::Panel>(curses::XY{20, 5}, curses::XY{0, 0});
+        auto b = std::make_shared<curses::Panel>(curses::XY{20, 5}, curses::XY{10, 2});
+        curses::Renderer first, second;
+        ASSERT_TRUE(first.refresh());
+        ASSERT_TRUE(second.refresh());
+        ASSERT_FALSE(first.dirty());
+        ASSERT_FALSE(second.dirty());
+
+        a->to_top();
+        ASSERT_TRUE(first.refresh());
+        ASSERT_FALSE(first.dirty());
+        ASSERT_TRUE(second.dirty());
+        ASSERT_TRUE(second.refresh());
+
+        first.invalidate();
+        ASSERT_TRUE(first.dirty());
+        ASSERT_FALSE(second.dirty());
+    })
+    .run();
+
+    endwin();
+    delscreen(screen);
+    return result;
+}
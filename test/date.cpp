@@ -232,6 +232,31 @@ int main() {
         ASSERT_EQUAL(dtE.date(), Date(2019, Month::December, 31));
         ASSERT_EQUAL(dtE.time(), Time(16, 00));
     })
+    .test("try_ parsing functions report errors without throwing", []() {
+        auto date = Date::try_from_isoformat("2021-02-28");
+        ASSERT(date.ok());
+        ASSERT_EQUAL(*date, Date(2021, Month::February, 28));
+
+        auto bad_format = Date::try_from_isoformat("Feb 28 2021");
+        ASSERT(bad_format.error().code == core::ErrorCode::SYNTAX_ERROR);
+
+        auto bad_day = Date::try_from_isoformat("2021-02-29");
+        ASSERT(bad_day.error().code == core::ErrorCode::OUT_OF_RANGE);
+        try {
+            Date::from_isoformat("2021-02-29");
+            FAIL("Expected ValueError.");
+
+        } catch (const core::ValueError& e) { }
+
+        auto dt = Datetime::try_from_isoformat("2021-02-28T12:30:00Z");
+        ASSERT(dt.ok());
+        ASSERT_EQUAL(*dt, Datetime(2021, Month::February, 28, 12, 30));
+        ASSERT_FALSE(Datetime::try_from_isoformat("2021-02-28 12:30").ok());
+
+        auto bad_tm = Zone::utc().try_strptime("%Y-%m-%d", "Feb 28 2021");
+        ASSERT(bad_tm.error().code == core::ErrorCode::SYNTAX_ERROR);
+        ASSERT_EQUAL(bad_format.error().message, bad_tm.error().message);
+    })
     .die_on_signal(SIGSEGV)
     .run();
 }
@@ -0,0 +1,60 @@
+/*
+ * elf.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ */
+
+#include <csignal>
+#include <string>
+#include <vector>
+#include "moonlight/test.h"
+#include "moonlight/debug.h"
+#include "moonlight/elf.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+__attribute__((noinline))
+int elf_test_probe(int x) {
+    return x * 3 + 1;
+}
+
+// Resolving a frame looks up the byte before it, as frames are return
+// addresses, so this points just past the start of the probe.
+debug::BacktraceFrame probe_frame() {
+    return (debug::BacktraceFrame)((uintptr_t)&elf_test_probe + 1);
+}
+
+int main() {
+    return TestSuite("moonlight elf.h tests")
+    .die_on_signal(SIGSEGV)
+    .test("open rejects files which aren't ELF images", []() {
+        ASSERT(elf::Image::open("/proc/self/exe") != nullptr);
+        ASSERT(elf::Image::open("/nonexistent") == nullptr);
+        ASSERT(elf::Image::open("test/elf.cpp") == nullptr);
+    })
+    .test("resolve a function in the executable", []() {
+        auto infos = debug::resolve_frames(vector{probe_frame()});
+        ASSERT_EQUAL(infos.size(), 1ul);
+        ASSERT_EQUAL(infos[0].symbol().function_name(), string("elf_test_probe(int)"));
+
+        auto image = elf::Image::open(debug::get_executable_path());
+        if (image->line_table() == elf::LineTable::LOADED) {
+            ASSERT(infos[0].source().path().filename() == "elf.cpp");
+            // Optimized builds attribute the entry point to the body.
+            int line = infos[0].source().line_number();
+            ASSERT(line == 20 || line == 21);
+        } else {
+            ASSERT(infos[0].source().is_nowhere());
+        }
+    })
+    .test("resolved frames are cached", []() {
+        auto first = debug::resolve_frames(vector{probe_frame()});
+        auto second = debug::resolve_frames(vector{probe_frame()});
+        ASSERT_EQUAL(first[0].symbol().raw(), second[0].symbol().raw());
+        ASSERT_EQUAL(first[0].source().line_number(), second[0].source().line_number());
+    })
+    .run();
+}
@@ -7,6 +7,7 @@
  * Distributed under terms of the MIT license.
  */
 
+#include <sstream>
 #include "moonlight/file.h"
 #include "moonlight/test.h"
 
@@ -32,5 +33,11 @@ int main() {
         ASSERT_EQUAL(second_line, std::string("[asdfghjkl\n"));
         ASSERT_EQUAL(input.getc(), EOF);
     })
+    .test("BufferedInput::name() views the interned name", []() {
+        std::istringstream infile("abc");
+        auto input = moonlight::file::BufferedInput(infile, "input.txt");
+        ASSERT_EQUAL(std::string(input.name()), std::string("input.txt"));
+        ASSERT_TRUE(input.name().data() == moonlight::str::Symbol("input.txt").c_str());
+    })
     .run();
 }
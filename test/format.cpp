@@ -0,0 +1,107 @@
+/*
+ * format.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ */
+
+#include <csignal>
+#include <string>
+#include <vector>
+#include "moonlight/test.h"
+#include "moonlight/format.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+struct Point {
+    int x, y;
+
+    friend std::ostream& operator<<(std::ostream& out, const Point& p) {
+        return out << "(" << p.x << ", " << p.y << ")";
+    }
+};
+
+struct Size {
+    int w, h;
+};
+
+struct Opaque { };
+
+template<>
+struct moonlight::fmt::Formatter<Size> {
+    static void write(fmt::Buffer& buf, const Size& size) {
+        fmt::format_to(buf, "{}x{}", size.w, size.h);
+    }
+};
+
+int main() {
+    return TestSuite("moonlight format.h tests")
+    .die_on_signal(SIGSEGV)
+    .test("fmt::format basic replacement fields", []() {
+        ASSERT_EQUAL(fmt::format("hello, {}!", "world"), string("hello, world!"));
+        ASSERT_EQUAL(fmt::format("{} + {} = {}", 1, 2, 3), string("1 + 2 = 3"));
+        ASSERT_EQUAL(fmt::format("{}{}", string("a"), 'b'), string("ab"));
+        ASSERT_EQUAL(fmt::format("no fields"), string("no fields"));
+        ASSERT_EQUAL(fmt::format("{{}} {{{}}}", 7), string("{} {7}"));
+        ASSERT_EQUAL(fmt::format("{} {}", true, false), string("true false"));
+    })
+    .test("fmt::format integers", []() {
+        ASSERT_EQUAL(fmt::format("{}", -42), string("-42"));
+        ASSERT_EQUAL(fmt::format("{}", 18446744073709551615ull), string("18446744073709551615"));
+        ASSERT_EQUAL(fmt::format("{:x}", 255), string("ff"));
+        ASSERT_EQUAL(fmt::format("{:X}", 255), string("FF"));
+        ASSERT_EQUAL(fmt::format("{:o}", 8), string("10"));
+        ASSERT_EQUAL(fmt::format("{:b}", 5), string("101"));
+        ASSERT_EQUAL(fmt::format("{:c}", 65), string("A"));
+        ASSERT_EQUAL(fmt::format("{:08x}", 0xbeef), string("0000beef"));
+        ASSERT_EQUAL(fmt::format("{:05}", -42), string("-0042"));
+        ASSERT_EQUAL(fmt::format("{:d}", 'A'), string("65"));
+    })
+    .test("fmt::format floating point", []() {
+        ASSERT_EQUAL(fmt::format("{}", 0.5), string("0.5"));
+        ASSERT_EQUAL(fmt::format("{}", 100.0), string("100"));
+        ASSERT_EQUAL(fmt::format("{}", 1.0 / 3.0), string("0.333333"));
+        ASSERT_EQUAL(fmt::format("{:.2f}", 3.14159), string("3.14"));
+        ASSERT_EQUAL(fmt::format("{:.3e}", 1234.5), string("1.234e+03"));
+        ASSERT_EQUAL(fmt::format("{:.3E}", 1234.5), string("1.234E+03"));
+        ASSERT_EQUAL(fmt::format("{:8.1f}", 2.25f), string("     2.2"));
+        ASSERT_EQUAL(fmt::format("{:.1f}", 1e300).size(), (size_t)303);
+    })
+    .test("fmt::format alignment and fill", []() {
+        ASSERT_EQUAL(fmt::format("[{:5}]", "ab"), string("[ab   ]"));
+        ASSERT_EQUAL(fmt::format("[{:>5}]", "ab"), string("[   ab]"));
+        ASSERT_EQUAL(fmt::format("[{:^6}]", "ab"), string("[  ab  ]"));
+        ASSERT_EQUAL(fmt::format("[{:*^7}]", "ab"), string("[**ab***]"));
+        ASSERT_EQUAL(fmt::format("[{:5}]", 42), string("[   42]"));
+        ASSERT_EQUAL(fmt::format("[{:<5}]", 42), string("[42   ]"));
+        ASSERT_EQUAL(fmt::format("[{:.3}]", "abcdef"), string("[abc]"));
+        ASSERT_EQUAL(fmt::format("[{:1}]", "abc"), string("[abc]"));
+    })
+    .test("fmt::format user types", []() {
+        ASSERT_EQUAL(fmt::format("at {}", Point{1, 2}), string("at (1, 2)"));
+        ASSERT_EQUAL(fmt::format("[{:>8}]", Point{1, 2}), string("[  (1, 2)]"));
+        ASSERT_EQUAL(fmt::format("{}", Size{640, 480}), string("640x480"));
+        ASSERT_EQUAL(fmt::format("{}", Opaque{}), string("<Opaque>"));
+    })
+    .test("fmt::Buffer spills from the stack to the heap", []() {
+        fmt::Buffer buf;
+        ASSERT(buf.is_inline());
+        std::string expected;
+        for (int x = 0; x < 1000; x++) {
+            fmt::format_to(buf, "{},", x);
+            expected += std::to_string(x) + ",";
+        }
+        ASSERT_FALSE(buf.is_inline());
+        ASSERT_EQUAL(buf.str(), expected);
+    })
+    .test("str::cat, str::coerce, and str::join use fmt", []() {
+        ASSERT_EQUAL(str::cat("a", 1, '/', 2.5, Point{3, 4}), string("a1/2.5(3, 4)"));
+        ASSERT_EQUAL(str::coerce(42), string("42"));
+        ASSERT_EQUAL(str::coerce(Opaque{}), string("<Opaque>"));
+        vector<double> v = {0.25, 1, 1e10};
+        ASSERT_EQUAL(str::join(v, ", "), string("0.25, 1, 1e+10"));
+    })
+    .run();
+}
@@ -0,0 +1,175 @@
+/*
+ * hash.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <bitset>
+#include <cmath>
+#include <list>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+#include "moonlight/hash.h"
+#include "moonlight/linked_map.h"
+#include "moonlight/test.h"
+
+using namespace moonlight;
+using namespace moonlight::test;
+
+/**
+ * The fraction of output bits flipped by flipping each input bit of
+ * `samples` pseudo-random inputs, averaged per output bit.
+ */
+template<class F>
+std::vector<double> avalanche(size_t len, int samples, F hash_function) {
+    std::vector<double> flips(64, 0.0);
+    std::vector<uint8_t> input(len);
+    uint64_t counter = 0;
+
+    for (int n = 0; n < samples; n++) {
+        for (auto& byte : input) {
+            byte = hash::mix(++counter) & 0xff;
+        }
+        uint64_t h0 = hash_function(input);
+        for (size_t bit = 0; bit < len * 8; bit++) {
+            input[bit / 8] ^= 1 << (bit % 8);
+            uint64_t diff = h0 ^ hash_function(input);
+            input[bit / 8] ^= 1 << (bit % 8);
+            for (int out = 0; out < 64; out++) {
+                flips[out] += (diff >> out) & 1;
+            }
+        }
+    }
+
+    for (auto& f : flips) {
+        f /= samples * len * 8;
+    }
+    return flips;
+}
+
+/**
+ * Pearson's chi-squared statistic for `keys` placed into buckets.
+ */
+double chi_squared(const std::vector<size_t>& buckets, size_t keys) {
+    double expected = (double)keys / buckets.size();
+    double chi2 = 0;
+    for (auto count : buckets) {
+        chi2 += (count - expected) * (count - expected) / expected;
+    }
+    return chi2;
+}
+
+int main() {
+    return TestSuite("moonlight hash.h tests")
+    .test("strings hash alike regardless of type", []() {
+        std::string s = "content-type";
+        ASSERT_EQUAL(hash::of(s), hash::of(std::string_view(s)));
+        ASSERT_EQUAL(hash::of(s), hash::of("content-type"));
+        ASSERT_EQUAL(hash::of(s), hash::bytes(s.data(), s.size()));
+        ASSERT_EQUAL(hash::Hash()(s), hash::Hash()(std::string_view("content-type")));
+        ASSERT(hash::of(s) != hash::of(s, 1));
+    })
+    .test("every prefix length hashes differently", []() {
+        std::string buffer;
+        for (int x = 0; x < 300; x++) {
+            buffer.push_back('a' + x % 26);
+        }
+
+        std::set<uint64_t> seen;
+        for (size_t len = 0; len <= buffer.size(); len++) {
+            std::string_view prefix(buffer.data(), len);
+            ASSERT(seen.insert(hash::bytes(prefix)).second);
+
+            if (len > 0) {
+                std::string changed(prefix);
+                changed[len - 1] ^= 1;
+                ASSERT(hash::bytes(changed) != hash::bytes(prefix));
+                changed = prefix;
+                changed[0] ^= 1;
+                ASSERT(hash::bytes(changed) != hash::bytes(prefix));
+            }
+        }
+    })
+    .test("flipping an input bit flips half of the output bits", []() {
+        auto check = [](const std::vector<double>& flips) {
+            double total = 0;
+            for (auto f : flips) {
+                ASSERT(f > 0.45 && f < 0.55);
+                total += f;
+            }
+            ASSERT(std::abs(total / flips.size() - 0.5) < 0.01);
+        };
+
+        for (size_t len : {3, 8, 16, 33, 64, 100}) {
+            check(avalanche(len, 100, [](const std::vector<uint8_t>& input) {
+                return hash::bytes(input.data(), input.size());
+            }));
+        }
+        check(avalanche(8, 400, [](const std::vector<uint8_t>& input) {
+            uint64_t x;
+            std::memcpy(&x, input.data(), sizeof(x));
+            return hash::mix(x);
+        }));
+    })
+    .test("strided integer keys spread across buckets", []() {
+        const size_t KEYS = 65536;
+        const size_t BUCKETS = 1024;
+        // For 1023 degrees of freedom, more than 6 standard deviations above
+        // the expected value of 1023.
+        const double LIMIT = 1300;
+
+        for (uint64_t stride : {1, 1024, 4096, 1 << 20}) {
+            std::vector<size_t> low(BUCKETS), high(BUCKETS);
+            for (uint64_t x = 0; x < KEYS; x++) {
+                uint64_t h = hash::of(x * stride);
+                low[h % BUCKETS]++;
+                high[h >> 54]++;
+            }
+            ASSERT(chi_squared(low, KEYS) < LIMIT);
+            ASSERT(chi_squared(high, KEYS) < LIMIT);
+        }
+
+        std::vector<size_t> strings(BUCKETS);
+        for (uint64_t x = 0; x < KEYS; x++) {
+            strings[hash::of("key-" + std::to_string(x)) % BUCKETS]++;
+        }
+        ASSERT(chi_squared(strings, KEYS) < LIMIT);
+    })
+    .test("composite values are hashed in order", []() {
+        ASSERT(hash::values(1, 2) != hash::values(2, 1));
+        ASSERT_EQUAL(hash::values(1, std::string("a")), hash::State().add(1).add("a").digest());
+        ASSERT_EQUAL(hash::of(std::make_pair(1, std::string("a"))), hash::of(std::make_tuple(1, std::string("a"))));
+        ASSERT(hash::of(std::vector<int>{1, 2, 3}) != hash::of(std::vector<int>{1, 2}));
+        ASSERT(hash::of(std::vector<std::string>{"ab", "c"}) != hash::of(std::vector<std::string>{"a", "bc"}));
+        ASSERT(hash::of(std::vector<std::vector<int>>{{1}, {}}) != hash::of(std::vector<std::vector<int>>{{}, {1}}));
+        ASSERT_EQUAL(hash::of(0.0), hash::of(-0.0));
+        ASSERT(hash::of(1.0) != hash::of(1.0f + 1e-6f));
+    })
+    .test("hash::Hash as a map hasher", []() {
+        std::unordered_map<std::string, int, hash::Hash, std::equal_to<>> counts;
+        counts["apple"] = 1;
+        counts["banana"] = 2;
+        ASSERT_EQUAL(counts.find(std::string_view("banana"))->second, 2);
+        ASSERT(counts.find("cherry") == counts.end());
+
+        std::unordered_map<std::pair<int, int>, std::string, hash::Hash> grid;
+        grid[{1, 2}] = "a";
+        grid[{2, 1}] = "b";
+        ASSERT_EQUAL(grid.at({1, 2}), std::string("a"));
+        ASSERT_EQUAL(grid.at({2, 1}), std::string("b"));
+
+        typedef std::list<std::pair<std::string, int>> List;
+        linked_map<std::string, int, List, std::unordered_map<std::string, List::iterator, hash::Hash>> ordered;
+        ordered.insert({"z", 1});
+        ordered.insert({"a", 2});
+        ASSERT_EQUAL(ordered.begin()->first, std::string("z"));
+        ASSERT_EQUAL(ordered.at("a"), 2);
+    })
+    .run();
+}
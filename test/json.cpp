@@ -239,5 +239,96 @@ int main() {
 
         ASSERT_EQUAL(person, new_person);
     })
+    .test("try_read reports malformed input without throwing", []() {
+        auto ok = json::try_read<json::Value::Pointer>("{\"a\": [1, 2.5, -3e0]}");
+        ASSERT(ok.ok());
+        ASSERT_EQUAL((*ok)->get<json::Object>().get<json::Array>("a").get<double>(2), -3.0);
+
+        auto bad = json::try_read<json::Value::Pointer>("{\"a\": [1 2]}");
+        ASSERT_FALSE(bad.ok());
+        ASSERT(bad.error().code == core::ErrorCode::SYNTAX_ERROR);
+        ASSERT_EQUAL(bad.error().message, std::string("Missing comma between array values."));
+        ASSERT_EQUAL(bad.error().loc.col, 10u);
+
+        auto unterminated = json::try_read<json::Value::Pointer>("[\"abc");
+        ASSERT(unterminated.error().code == core::ErrorCode::UNEXPECTED_EOF);
+
+        try {
+            json::read<json::Value::Pointer>("[-]");
+            FAIL("Expected ParseError.");
+
+        } catch (const json::parser::ParseError& e) { }
+    })
+    .test("PushParser parses input split at any point", []() {
+        const std::string input = R"({"name": "moon\"light\x41", "tags": ["a", "b"], "n": -12.5e1, "ok": true, "none": null}
+[1, 2, false] "tail" 42)";
+        std::vector<std::string> expected;
+        for (auto s : {R"({"name": "moon\"lightA", "tags": ["a", "b"], "n": -125, "ok": true, "none": null})",
+                       "[1, 2, false]", R"("tail")", "42"}) {
+            expected.push_back(json::to_string(json::read<json::Value::Pointer>(s)));
+        }
+
+        for (size_t chunk_size : {1, 2, 3, 7, 1000}) {
+            for (size_t split = 0; split < input.size(); split += chunk_size) {
+                json::parser::PushParser parser;
+                parser.feed(std::span<const char>(input.data(), split));
+                for (size_t x = split; x < input.size(); x += chunk_size) {
+                    parser.feed(std::span<const char>(input.data() + x, std::min(chunk_size, input.size() - x)));
+                }
+                parser.finish();
+
+                std::vector<std::string> values;
+                while (auto value = parser.next()) {
+                    values.push_back(json::to_string(*value));
+                }
+                ASSERT_EQUAL(values, expected);
+                ASSERT_FALSE(parser.is_partial());
+            }
+        }
+    })
+    .test("PushParser emits values as they complete", []() {
+        json::parser::PushParser parser;
+        const std::string a = "{\"a\": [1, 2";
+        const std::string b = "]}\n{\"b\": 12";
+        const std::string c = "3}";
+
+        parser.feed(a);
+        ASSERT_FALSE(parser.next().has_value());
+        ASSERT(parser.is_partial());
+        parser.feed(b);
+        auto value = parser.next();
+        ASSERT(value.has_value());
+        ASSERT_EQUAL((*value)->get<json::Object>().get<json::Array>("a").size(), 2u);
+        ASSERT_FALSE(parser.next().has_value());
+        parser.feed(c);
+        parser.finish();
+        ASSERT_EQUAL(parser.next().value()->get<json::Object>().get<double>("b"), 123.0);
+    })
+    .test("PushParser errors", []() {
+        json::parser::PushParser parser;
+        ASSERT(! parser.try_feed(std::string("[1, ")).has_value());
+        auto error = parser.try_feed(std::string("2 3]"));
+        ASSERT(error.has_value());
+        ASSERT(error->code == core::ErrorCode::SYNTAX_ERROR);
+        ASSERT_EQUAL(error->loc.col, 7u);
+        ASSERT(parser.try_feed(std::string("[]")).has_value());
+
+        json::parser::PushParser unterminated;
+        unterminated.feed(std::string("[\"abc"));
+        error = unterminated.try_finish();
+        ASSERT(error.has_value());
+        ASSERT(error->code == core::ErrorCode::UNEXPECTED_EOF);
+
+        try {
+            unterminated.feed(std::string("\"]"));
+            FAIL("Expected core::UsageError.");
+        } catch (const core::UsageError& e) { }
+
+        json::parser::PushParser bad;
+        try {
+            bad.feed(std::string("{\"a\" 1}"));
+            FAIL("Expected ParseError.");
+        } catch (const json::parser::ParseError& e) { }
+    })
     .run();
 }
@@ -0,0 +1,99 @@
+/*
+ * layout.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ */
+
+#include <csignal>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "moonlight/test.h"
+#include "moonlight/layout.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+vector<string> all_lines(layout::TextLayout& text) {
+    vector<string> result;
+    for (auto line : text.lines(0, text.line_count())) {
+        result.push_back(string(line));
+    }
+    return result;
+}
+
+int main() {
+    return TestSuite("moonlight layout.h tests")
+    .die_on_signal(SIGSEGV)
+    .test("display width of wide and combining characters", []() {
+        ASSERT_EQUAL(unicode::display_width("hello"), 5ul);
+        ASSERT_EQUAL(unicode::display_width("間濾"), 4ul);
+        ASSERT_EQUAL(unicode::display_width("é"), 1ul);
+        ASSERT_EQUAL(unicode::display_width("ｈｉ"), 4ul);
+        ASSERT_EQUAL(unicode::display_width("😺"), 2ul);
+        ASSERT_EQUAL(unicode::display_width("👩‍💻"), 2ul);
+        ASSERT_EQUAL(unicode::display_width("❤️"), 2ul);
+        ASSERT_EQUAL(unicode::display_width("a\tb"), 2ul);
+        ASSERT_EQUAL(unicode::width(U'a'), 1);
+        ASSERT_EQUAL(unicode::width(U'́'), 0);
+        ASSERT_EQUAL(unicode::width(U'間'), 2);
+    })
+    .test("grapheme cluster boundaries", []() {
+        auto clusters = [](string_view s) {
+            vector<string> result;
+            for (size_t x = 0; x < s.size();) {
+                size_t next = unicode::next_grapheme(s, x);
+                result.push_back(string(s.substr(x, next - x)));
+                x = next;
+            }
+            return result;
+        };
+        ASSERT_EQUAL(clusters("ab"), vector<string>({"a", "b"}));
+        ASSERT_EQUAL(clusters("éx"), vector<string>({"é", "x"}));
+        ASSERT_EQUAL(clusters("\r\n\n"), vector<string>({"\r\n", "\n"}));
+        ASSERT_EQUAL(clusters("👩‍💻!"), vector<string>({"👩‍💻", "!"}));
+        ASSERT_EQUAL(clusters("👍🏽"), vector<string>({"👍🏽"}));
+        ASSERT_EQUAL(clusters("🇯🇵🇺🇸🇫"), vector<string>({"🇯🇵", "🇺🇸", "🇫"}));
+        ASSERT_EQUAL(clusters("각가"), vector<string>({"각", "가"}));
+        ASSERT_EQUAL(clusters("\xff" "a"), vector<string>({"\xff", "a"}));
+    })
+    .test("wrapping between words", []() {
+        layout::TextLayout text(10);
+        text.append("the quick brown fox jumps over the lazy dog");
+        ASSERT_EQUAL(all_lines(text), vector<string>({
+            "the quick", "brown fox", "jumps over", "the lazy", "dog"
+        }));
+
+        text.width(20);
+        ASSERT_EQUAL(all_lines(text), vector<string>({
+            "the quick brown fox", "jumps over the lazy", "dog"
+        }));
+    })
+    .test("wrapping wide characters and long words", []() {
+        layout::TextLayout text(5);
+        text.append("間濾間濾間 abcdefghijkl");
+        ASSERT_EQUAL(all_lines(text), vector<string>({
+            "間濾", "間濾", "間", "abcde", "fghij", "kl"
+        }));
+    })
+    .test("paragraphs and incremental appends", []() {
+        layout::TextLayout text(8);
+        text.append("one two three\n\n  four");
+        ASSERT_EQUAL(text.paragraph_count(), 3ul);
+        ASSERT_EQUAL(all_lines(text), vector<string>({"one two", "three", "", "  four"}));
+
+        text.append("teen five");
+        ASSERT_EQUAL(all_lines(text), vector<string>({"one two", "three", "", "fourteen", "five"}));
+
+        text.append("\nsix");
+        ASSERT_EQUAL(text.line_count(), 6ul);
+        ASSERT_EQUAL(string(text.line(5)), string("six"));
+        ASSERT_EQUAL(text.lines(4, 10).size(), 2ul);
+
+        text.clear();
+        ASSERT_EQUAL(text.line_count(), 0ul);
+    })
+    .run();
+}
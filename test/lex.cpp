@@ -10,6 +10,7 @@
 #include "moonlight/lex.h"
 #include "moonlight/test.h"
 #include "moonlight/file.h"
+#include "moonlight/symbol.h"
 
 using namespace std;
 using namespace moonlight;
@@ -57,6 +58,14 @@ Grammar make_abba_grammar() {
     .def(lex::pop("b"), "b");
 }
 
+using SymbolGrammar = lex::Grammar<str::Symbol>;
+
+SymbolGrammar make_symbol_abba_grammar() {
+    return SymbolGrammar()
+    .def(lex::match("a"), "a")
+    .def(lex::pop("b"), "b");
+}
+
 int main() {
     return TestSuite("moonlight lex tests")
     .die_on_signal(SIGSEGV)
@@ -117,5 +126,41 @@ int main() {
         ASSERT_EQUAL(tokens[0].type(), Abba::A);
         ASSERT_EQUAL(tokens[1].type(), Abba::B);
     })
+    .test("grammar with symbol token types", []() {
+        auto abba = make_symbol_abba_grammar();
+        auto lex = abba.lexer().throw_on_error(false);
+        auto tokens = lex.lex("abaaa");
+        ASSERT_EQUAL(tokens.size(), 2ul);
+        ASSERT_EQUAL(tokens[0].type(), str::Symbol("a"));
+        ASSERT_EQUAL(tokens[1].type(), str::Symbol("b"));
+        ASSERT(tokens[0].type().c_str() == str::Symbol("a").c_str());
+    })
+    .test("try_lex reports errors without throwing", []() {
+        auto abba = make_abba_grammar();
+        auto lex = abba.lexer();
+
+        auto ok = lex.try_lex("aab");
+        ASSERT(ok.ok());
+        ASSERT_EQUAL(ok->size(), 3ul);
+
+        auto no_match = lex.try_lex("aac");
+        ASSERT_FALSE(no_match.ok());
+        ASSERT(no_match.error().code == core::ErrorCode::SYNTAX_ERROR);
+        ASSERT_EQUAL(no_match.error().loc.offset, 2u);
+
+        auto early = lex.try_lex("aba");
+        ASSERT(early.error().code == core::ErrorCode::TRAILING_INPUT);
+        try {
+            lex.lex("aba");
+            FAIL("Expected UnexpectedEndOfContentError.");
+
+        } catch (const lex::UnexpectedEndOfContentError& e) { }
+
+        try {
+            lex.lex("aac");
+            FAIL("Expected NoMatchError.");
+
+        } catch (const lex::NoMatchError& e) { }
+    })
     .run();
 }
@@ -0,0 +1,218 @@
+/*
+ * metrics.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#define MOONLIGHT_ENABLE_METRICS
+
+#include <string>
+#include <thread>
+#include <vector>
+#include "moonlight/metrics.h"
+#include "moonlight/json.h"
+#include "moonlight/lex.h"
+#include "moonlight/log.h"
+#include "moonlight/sql/sqlite3.h"
+#include "moonlight/test.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+uint64_t global_count(const string& name) {
+    return metrics::counter(name).value();
+}
+
+int main() {
+    return TestSuite("moonlight metrics.h tests")
+    .test("counters aggregate updates from many threads", []() {
+        metrics::Registry registry;
+        auto& counter = registry.counter("requests_total", "Requests.");
+        vector<thread> threads;
+
+        for (int x = 0; x < 8; x++) {
+            threads.emplace_back([&]() {
+                for (int y = 0; y < 100000; y++) {
+                    counter.inc();
+                }
+                counter.inc(5);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        ASSERT_EQUAL(counter.value(), 800040ul);
+        ASSERT(&registry.counter("requests_total") == &counter);
+    })
+    .test("gauges", []() {
+        metrics::Registry registry;
+        auto& gauge = registry.gauge("temperature");
+        gauge.set(20.5);
+        gauge.add(2);
+        gauge.dec();
+        ASSERT_EQUAL(gauge.value(), 21.5);
+        gauge.set(-3);
+        ASSERT_EQUAL(gauge.value(), -3.0);
+    })
+    .test("histogram buckets are log-linear", []() {
+        typedef metrics::Histogram H;
+        ASSERT_EQUAL(H::bucket(0), 0ul);
+        ASSERT_EQUAL(H::bucket(H::SUB_BUCKETS - 1), H::SUB_BUCKETS - 1);
+        ASSERT_EQUAL(H::bucket(UINT64_MAX), H::BUCKETS - 1);
+        ASSERT_EQUAL(H::upper_bound(H::BUCKETS - 1), UINT64_MAX);
+
+        for (size_t x = 0; x < H::BUCKETS; x++) {
+            ASSERT_EQUAL(H::bucket(H::lower_bound(x)), x);
+            ASSERT_EQUAL(H::bucket(H::upper_bound(x)), x);
+            if (x > 0) {
+                ASSERT_EQUAL(H::lower_bound(x), H::upper_bound(x - 1) + 1);
+            }
+        }
+
+        for (uint64_t v = 1; v < UINT64_MAX / 3; v = v * 3 + 1) {
+            size_t index = H::bucket(v);
+            ASSERT(H::lower_bound(index) <= v && v <= H::upper_bound(index));
+            ASSERT((H::upper_bound(index) - H::lower_bound(index)) <= v / H::SUB_BUCKETS);
+        }
+    })
+    .test("histogram snapshots and quantiles", []() {
+        metrics::Registry registry;
+        auto& histogram = registry.histogram("latency_ns");
+        vector<thread> threads;
+
+        for (int x = 0; x < 4; x++) {
+            threads.emplace_back([&]() {
+                for (uint64_t v = 1; v <= 100; v++) {
+                    histogram.record(v);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        auto snapshot = histogram.read();
+        ASSERT_EQUAL(snapshot.count, 400ul);
+        ASSERT_EQUAL(snapshot.sum, 4 * 5050ul);
+        ASSERT(snapshot.quantile(0.5) >= 50 && snapshot.quantile(0.5) <= 50 + 50 / 4);
+        ASSERT(snapshot.quantile(0.99) >= 99 && snapshot.quantile(0.99) <= 99 + 99 / 4);
+        ASSERT(snapshot.max() >= 100 && snapshot.max() <= 125);
+        ASSERT_EQUAL(metrics::Histogram::Snapshot().quantile(0.5), 0ul);
+
+        metrics::Timer timer(histogram);
+        ASSERT(timer.stop() > 0);
+        ASSERT_EQUAL(histogram.read().count, 401ul);
+    })
+    .test("names and types are checked", []() {
+        metrics::Registry registry;
+        registry.counter("x_total");
+
+        try {
+            registry.gauge("x_total");
+            FAIL("Expected core::TypeError.");
+        } catch (const core::TypeError& e) { }
+
+        try {
+            registry.counter("0bad name");
+            FAIL("Expected core::ValueError.");
+        } catch (const core::ValueError& e) { }
+
+        ASSERT_EQUAL(registry.size(), 1ul);
+    })
+    .test("JSON snapshot", []() {
+        metrics::Registry registry;
+        registry.counter("hits_total", "Cache hits.").inc(3);
+        registry.gauge("load").set(0.25);
+        auto& histogram = registry.histogram("size_bytes");
+        histogram.record(3);
+        histogram.record(1000);
+
+        auto snapshot = registry.snapshot();
+        auto hits = snapshot.get<json::Object>("hits_total");
+        ASSERT_EQUAL(hits.get<std::string>("type"), std::string("counter"));
+        ASSERT_EQUAL(hits.get<std::string>("help"), std::string("Cache hits."));
+        ASSERT_EQUAL(hits.get<int>("value"), 3);
+        ASSERT_EQUAL(snapshot.get<json::Object>("load").get<double>("value"), 0.25);
+
+        auto size = snapshot.get<json::Object>("size_bytes");
+        ASSERT_EQUAL(size.get<std::string>("type"), std::string("histogram"));
+        ASSERT_EQUAL(size.get<int>("count"), 2);
+        ASSERT_EQUAL(size.get<int>("sum"), 1003);
+        auto buckets = size.get<json::Array>("buckets");
+        ASSERT_EQUAL(buckets.size(), 2u);
+        ASSERT_EQUAL(buckets.get<json::Array>(0).get<int>(0), 3);
+        ASSERT_EQUAL(buckets.get<json::Array>(0).get<int>(1), 1);
+    })
+    .test("text exposition", []() {
+        metrics::Registry registry;
+        registry.counter("hits_total", "Cache hits.\nAll of them.").inc(3);
+        registry.gauge("load").set(0.25);
+        auto& histogram = registry.histogram("size_bytes");
+        histogram.record(3);
+        histogram.record(3);
+        histogram.record(1000);
+
+        std::string expected =
+        "# HELP hits_total Cache hits.\\nAll of them.\n"
+        "# TYPE hits_total counter\n"
+        "hits_total 3\n"
+        "# TYPE load gauge\n"
+        "load 0.25\n"
+        "# TYPE size_bytes histogram\n"
+        "size_bytes_bucket{le=\"3\"} 2\n"
+        "size_bytes_bucket{le=\"1023\"} 3\n"
+        "size_bytes_bucket{le=\"+Inf\"} 3\n"
+        "size_bytes_sum 1006\n"
+        "size_bytes_count 3\n";
+        ASSERT_EQUAL(registry.to_text(), expected);
+    })
+    .test("instrumented parser, lexer, SQL client and logger", []() {
+        uint64_t parses = global_count("moonlight_json_parses_total");
+        uint64_t parse_errors = global_count("moonlight_json_parse_errors_total");
+        json::read<json::Object>("{\"a\": [1, 2, 3]}");
+        ASSERT(! json::try_read<json::Object>("{\"a\": ").ok());
+        ASSERT_EQUAL(global_count("moonlight_json_parses_total"), parses + 2);
+        ASSERT_EQUAL(global_count("moonlight_json_parse_errors_total"), parse_errors + 1);
+        ASSERT(metrics::histogram("moonlight_json_parse_ns").read().count >= 2);
+
+        auto lexer = lex::Grammar<std::string>()
+        .def(lex::ignore("\\s"))
+        .def(lex::match("[a-z]+"), "word")
+        .lexer();
+        uint64_t tokens = global_count("moonlight_lex_tokens_total");
+        lexer.lex("moon light");
+        ASSERT(! lexer.try_lex("moon 42").ok());
+        ASSERT_EQUAL(global_count("moonlight_lex_tokens_total"), tokens + 3);
+        ASSERT_EQUAL(global_count("moonlight_lex_errors_total"), 1ul);
+
+        auto sql = sqlite::Client::open("");
+        sql->exec("create table t (x integer)");
+        sql->exec("insert into t values (1), (2), (3)");
+        uint64_t rows = global_count("moonlight_sql_rows_total");
+        ASSERT_EQUAL(sql->query("select x from t").collect().size(), 3ul);
+        try {
+            sql->exec("select * from missing");
+            FAIL("Expected sqlite::Error.");
+        } catch (const sqlite::Error& e) { }
+        ASSERT_EQUAL(global_count("moonlight_sql_rows_total"), rows + 3);
+        ASSERT_EQUAL(global_count("moonlight_sql_errors_total"), 1ul);
+        ASSERT(global_count("moonlight_sql_queries_total") >= 4);
+
+        std::ostringstream sb;
+        auto logger = log::Logger::root();
+        logger.sync_to(new log::StreamSync(sb));
+        logger("Event").ok();
+        logger("Oops").error();
+        ASSERT_EQUAL(global_count("moonlight_log_events_total"), 2ul);
+        ASSERT_EQUAL(global_count("moonlight_log_errors_total"), 1ul);
+
+        auto text = metrics::to_text();
+        ASSERT(text.find("# TYPE moonlight_json_parse_ns histogram\n") != std::string::npos);
+        ASSERT(metrics::snapshot().contains("moonlight_log_events_total"));
+    })
+    .run();
+}
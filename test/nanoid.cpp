@@ -0,0 +1,114 @@
+/*
+ * nanoid.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "moonlight/nanoid.h"
+#include "moonlight/test.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+int main() {
+    return TestSuite("moonlight nanoid.h tests")
+    .test("Generator uses only the alphabet and is uniform", []() {
+        nanoid::Generator ids(10, nanoid::NO_LOOK_ALIKES);
+        ASSERT_EQUAL(ids.generate().size(), size_t(10));
+
+        const size_t N = 20000;
+        auto batch = ids.generate_n(N);
+        ASSERT_EQUAL(batch.size(), N * 10);
+
+        vector<size_t> counts(256, 0);
+        for (char c : batch) {
+            ASSERT(nanoid::NO_LOOK_ALIKES.find(c) != string::npos);
+            counts[(uint8_t)c]++;
+        }
+
+        // Each count is binomial, so allow five standard deviations, which a
+        // fair generator exceeds for any character about once in 30,000 runs.
+        // A modulo bias would skew some characters by far more.
+        double p = 1.0 / nanoid::NO_LOOK_ALIKES.size();
+        double expected = batch.size() * p;
+        double tolerance = 5 * std::sqrt(expected * (1 - p));
+        for (char c : nanoid::NO_LOOK_ALIKES) {
+            ASSERT(std::abs(counts[(uint8_t)c] - expected) < tolerance);
+        }
+    })
+    .test("Generator edge-case alphabets", []() {
+        ASSERT_EQUAL(nanoid::Generator(5, "x").generate(), string("xxxxx"));
+        ASSERT_EQUAL(nanoid::Generator(0).generate(), string(""));
+
+        string all;
+        for (int x = 0; x < 256; x++) {
+            all.push_back((char)x);
+        }
+        ASSERT_EQUAL(nanoid::Generator(100, all).generate().size(), size_t(100));
+
+        try {
+            nanoid::Generator(10, "");
+            FAIL("Expected core::UsageError.");
+        } catch (const core::UsageError& e) { }
+
+        try {
+            nanoid::Generator(10, all + "x");
+            FAIL("Expected core::UsageError.");
+        } catch (const core::UsageError& e) { }
+    })
+    .test("IDs are unique across threads", []() {
+        nanoid::Generator ids;
+        vector<string> batches(4);
+        vector<thread> threads;
+        for (size_t t = 0; t < batches.size(); t++) {
+            threads.emplace_back([&, t]() {
+                batches[t] = ids.generate_n(5000);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        set<string> seen;
+        for (const auto& batch : batches) {
+            for (size_t x = 0; x < batch.size(); x += ids.size()) {
+                ASSERT(seen.insert(batch.substr(x, ids.size())).second);
+            }
+        }
+    })
+    .test("A forked child does not repeat its parent's IDs", []() {
+        nanoid::Generator ids;
+        ids.generate();
+
+        int fds[2];
+        ASSERT_EQUAL(pipe(fds), 0);
+        pid_t pid = fork();
+        if (pid == 0) {
+            auto id = ids.generate();
+            ssize_t rc = write(fds[1], id.data(), id.size());
+            _exit(rc == (ssize_t)id.size() ? 0 : 1);
+        }
+        close(fds[1]);
+        auto parent_id = ids.generate();
+
+        string child_id(ids.size(), '\0');
+        ASSERT_EQUAL(read(fds[0], child_id.data(), child_id.size()), (ssize_t)ids.size());
+        close(fds[0]);
+        int status;
+        waitpid(pid, &status, 0);
+        ASSERT(parent_id != child_id);
+    })
+    .run();
+}
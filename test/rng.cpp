@@ -0,0 +1,66 @@
+/*
+ * rng.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "moonlight/rng.h"
+#include "moonlight/test.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+int main() {
+    return TestSuite("moonlight rng.h tests")
+    .test("ChaCha20 block function (RFC 8439, 2.3.2)", []() {
+        uint8_t key_bytes[32];
+        for (int x = 0; x < 32; x++) {
+            key_bytes[x] = x;
+        }
+        uint32_t key[8];
+        memcpy(key, key_bytes, sizeof(key));
+        const uint32_t nonce[3] = {0x09000000, 0x4a000000, 0x00000000};
+
+        uint8_t out[64];
+        rng::_chacha::block(key, 1, nonce, out);
+
+        const uint8_t expected[64] = {
+            0x10, 0xf1, 0xe7, 0xe4, 0xd1, 0x3b, 0x59, 0x15, 0x50, 0x0f, 0xdd, 0x1f, 0xa3, 0x20, 0x71, 0xc4,
+            0xc7, 0xd1, 0xf4, 0xc7, 0x33, 0xc0, 0x68, 0x03, 0x04, 0x22, 0xaa, 0x9a, 0xc3, 0xd4, 0x6c, 0x4e,
+            0xd2, 0x82, 0x64, 0x46, 0x07, 0x9f, 0xaa, 0x09, 0x14, 0xc2, 0xd7, 0x05, 0xd9, 0x8b, 0x02, 0xa2,
+            0xb5, 0x12, 0x9c, 0xd1, 0xde, 0x16, 0x4e, 0xb9, 0xcb, 0xd0, 0x83, 0xe8, 0xa2, 0x50, 0x3c, 0x4e
+        };
+        ASSERT(memcmp(out, expected, 64) == 0);
+    })
+    .test("fill() across buffer refills", []() {
+        auto& random = rng::Stream::thread_local_instance();
+        const size_t N = MOONLIGHT_RNG_BUFSIZE * 1000 + 17;
+        vector<uint8_t> bytes(N, 0);
+        random.fill(bytes.data(), bytes.size());
+
+        vector<size_t> counts(256, 0);
+        for (auto b : bytes) {
+            counts[b]++;
+        }
+        double expected = (double)N / 256;
+        for (auto count : counts) {
+            ASSERT(count > expected * 0.8 && count < expected * 1.2);
+        }
+    })
+    .test("threads have independent streams", []() {
+        uint64_t a = 0, b = 0;
+        thread ta([&]() { a = rng::Stream::thread_local_instance().next_u64(); });
+        thread tb([&]() { b = rng::Stream::thread_local_instance().next_u64(); });
+        ta.join();
+        tb.join();
+        ASSERT(a != b);
+    })
+    .run();
+}
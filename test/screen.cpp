@@ -0,0 +1,108 @@
+/*
+ * screen.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include "moonlight/screen.h"
+#include "moonlight/test.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+int main() {
+    return TestSuite("moonlight screen tests")
+    .test("the first frame clears and draws what isn't blank", []() {
+        ansi::Screen screen(10, 3);
+        screen.synchronized(false);
+        screen.print(2, 1, "hi");
+        ASSERT_EQUAL(screen.render(), std::string("\x1b[0m\x1b[2J\x1b[2;3Hhi"));
+    })
+    .test("unchanged frames render nothing", []() {
+        ansi::Screen screen(10, 3);
+        screen.print(0, 0, "hello");
+        screen.render();
+        screen.clear();
+        screen.print(0, 0, "hello");
+        ASSERT_EQUAL(screen.render(), std::string(""));
+    })
+    .test("only changed cells are written", []() {
+        ansi::Screen screen(20, 3);
+        screen.synchronized(false);
+        screen.print(0, 0, "count: 100");
+        screen.render();
+        screen.print(7, 0, "101");
+        ASSERT_EQUAL(screen.render(), std::string("\x1b[1;10H1"));
+
+        // Short gaps of unchanged cells are written again rather than moved over.
+        screen.print(7, 0, "202");
+        ASSERT_EQUAL(screen.render(), std::string("\x1b[1;8H202"));
+        screen.print(7, 0, "303");
+        ASSERT_EQUAL(screen.render(), std::string("\x1b[1;8H303"));
+        screen.print(7, 0, "404");
+        ASSERT_EQUAL(screen.render(), std::string("\x1b[1;8H404"));
+        screen.print(0, 0, "C");
+        screen.print(9, 0, "5");
+        ASSERT_EQUAL(screen.render(), std::string("\x1b[1;1HC\x1b[8C5"));
+    })
+    .test("styles are changed with the fewest SGR parameters", []() {
+        ansi::Screen screen(20, 3);
+        screen.synchronized(false);
+        screen.render();
+
+        auto red = ansi::Style().with_fg(ansi::Color::index(1));
+        auto bright_red = red.with(ansi::Style::BRIGHT);
+        auto on_blue = bright_red.with_bg(ansi::Color::rgb(0, 0, 255));
+        screen.print(0, 0, "a", red);
+        screen.print(1, 0, "b", bright_red);
+        screen.print(2, 0, "c", on_blue);
+        screen.print(3, 0, "d", red);
+        ASSERT_EQUAL(screen.render(), std::string(
+            "\x1b[1;1H\x1b[31ma\x1b[1mb\x1b[48;2;0;0;255mc\x1b[0;31md\x1b[0m"));
+    })
+    .test("wide characters occupy two cells", []() {
+        ansi::Screen screen(6, 1);
+        screen.synchronized(false);
+        ASSERT_EQUAL(screen.print(0, 0, "間濾間"), 6);
+        ASSERT_EQUAL(screen.at(1, 0).width, (uint8_t)0);
+        screen.render();
+
+        // Overwriting half of a wide character blanks the other half.
+        screen.print(3, 0, "x");
+        ASSERT_EQUAL(screen.at(2, 0).glyph, std::string(" "));
+        ASSERT_EQUAL(screen.render(), std::string("\x1b[1;3H x"));
+
+        // Wide characters which don't fit are clipped.
+        ASSERT_EQUAL(screen.print(5, 0, "間"), 0);
+    })
+    .test("rows are joined by CR LF when it is shorter", []() {
+        ansi::Screen screen(3, 3);
+        screen.synchronized(false);
+        screen.render();
+        screen.print(0, 0, "ab");
+        screen.print(0, 1, "cd");
+        ASSERT_EQUAL(screen.render(), std::string("\x1b[1;1Hab\r\ncd"));
+    })
+    .test("synchronized updates and present()", []() {
+        ansi::Screen screen(4, 1);
+        screen.print(0, 0, "ok");
+        std::ostringstream sb;
+        size_t bytes = screen.present(sb);
+        ASSERT_EQUAL(sb.str(), std::string("\x1b[?2026h\x1b[0m\x1b[2J\x1b[1;1Hok\x1b[?2026l"));
+        ASSERT_EQUAL(bytes, sb.str().size());
+
+        int fds[2];
+        ASSERT_TRUE(pipe(fds) == 0);
+        screen.print(0, 0, "no");
+        ASSERT_EQUAL(screen.present(fds[1]), (size_t)24);
+        close(fds[1]);
+        char buffer[64];
+        ASSERT_EQUAL(read(fds[0], buffer, sizeof(buffer)), (ssize_t)24);
+        close(fds[0]);
+    })
+    .run();
+}
@@ -7,6 +7,10 @@
  * Distributed under terms of the MIT license.
  */
 
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "moonlight/shlex.h"
 #include "moonlight/test.h"
 
@@ -54,6 +58,125 @@ int main() {
         ASSERT_EQUAL(shlex::split(lineD), {"this", "is"});
         ASSERT_EQUAL(shlex::split(lineE), {"this", "is"});
     })
+    .test("shlex tokenizer - views into the input", []() {
+        std::string_view line = "ls -la 'my dir' \"x\\ty\" 'a'\"b\" 'c\\d'";
+        shlex::Tokenizer tokens(line);
+        std::vector<std::string> values;
+        std::vector<bool> owned;
+
+        while (auto token = tokens.next()) {
+            values.emplace_back(token->value);
+            owned.push_back(token->owned);
+            if (! token->owned) {
+                ASSERT_TRUE(token->value.data() >= line.data());
+                ASSERT_TRUE(token->value.data() + token->value.size() <= line.data() + line.size());
+            }
+        }
+
+        ASSERT_EQUAL(values, {"ls", "-la", "my dir", "x\ty", "ab", "c\\d"});
+        ASSERT_EQUAL(owned, {false, false, false, true, true, false});
+    })
+    .test("shlex tokenizer - source spans", []() {
+        std::string_view line = "  echo \"a b\"'c' # done";
+        shlex::Tokenizer tokens(line);
+
+        auto token = tokens.next();
+        ASSERT_EQUAL(std::string(token->source), std::string("echo"));
+        token = tokens.next();
+        ASSERT_EQUAL(std::string(token->source), std::string("\"a b\"'c'"));
+        ASSERT_EQUAL(std::string(token->value), std::string("a bc"));
+        ASSERT_FALSE(tokens.next().has_value());
+    })
+    .test("shlex tokenizer - agrees with ShellLexer", []() {
+        std::vector<std::string> lines = {
+            "a b c d",
+            "\'banana cream \"\" \\\'pie\\\'\' oranges \"pineapple \n\n\"",
+            "this is#a comment",
+            "one\ntwo 'three''four' \"\\a\\b\\e\\f\\n\\r\\t\\v\\\\\\\"\"",
+            "'x\\y' word'with'quotes \t\t tail",
+            "pipe|to;semi (sub)",
+        };
+
+        for (const auto& line : lines) {
+            std::vector<std::string> expected;
+            auto lex = shlex::ShellStringLexer(line);
+            lex.punctuation("|;()");
+            for (auto iter = lex.begin(); iter != lex.end(); iter++) {
+                expected.push_back(*iter);
+            }
+
+            std::vector<std::string> actual;
+            shlex::Tokenizer tokens(line);
+            tokens.punctuation("|;()");
+            while (auto token = tokens.next()) {
+                actual.emplace_back(token->value);
+            }
+            ASSERT_EQUAL(actual, expected);
+        }
+    })
+    .test("shlex tokenizer - errors", []() {
+        for (std::string line : {"'abc", "\"abc", "'abc\\", "\"abc\\", "\"\\q\""}) {
+            try {
+                shlex::split(line);
+                FAIL("Expected ValueError.");
+
+            } catch (const core::ValueError& e) { }
+        }
+    })
+    .test("shlex split - other whitespace", []() {
+        ASSERT_EQUAL(shlex::split("a\rb\vc\fd"), {"a", "b", "c", "d"});
+        ASSERT_EQUAL(shlex::split(" \r\n"), {"\n"});
+    })
+    .test("shlex quote", []() {
+        ASSERT_EQUAL(shlex::quote(""), std::string("''"));
+        ASSERT_EQUAL(shlex::quote("safe/path-1.2_x@y%z+w=v:u,t"), std::string("safe/path-1.2_x@y%z+w=v:u,t"));
+        ASSERT_EQUAL(shlex::quote("a b"), std::string("'a b'"));
+        ASSERT_EQUAL(shlex::quote("it's"), std::string("'it'\"'\"'s'"));
+        ASSERT_EQUAL(shlex::quote("''x'"), std::string("''\"''\"'x'\"'\"''"));
+        ASSERT_EQUAL(shlex::quote("caf\xc3\xa9"), std::string("'caf\xc3\xa9'"));
+        ASSERT_EQUAL(shlex::split(shlex::quote("''x'")), {"''x'"});
+    })
+    .test("shlex split_all", []() {
+        std::vector<std::string> lines = {
+            "cp 'a file' b",
+            "",
+            "echo \"tab\\there\" 'x'\"y\" # comment",
+        };
+        auto result = shlex::split_all(lines);
+
+        ASSERT_EQUAL(result.size(), (size_t)3);
+        ASSERT_EQUAL(result.argv(0), {"cp", "a file", "b"});
+        ASSERT_EQUAL(result[1].size(), (size_t)0);
+        ASSERT_EQUAL(result.argv(2), {"echo", "tab\there", "xy"});
+
+        for (size_t x = 0; x < lines.size(); x++) {
+            ASSERT_EQUAL(result.argv(x), shlex::split(lines[x]));
+        }
+    })
+    .test("shlex split_all results can be copied and moved", []() {
+        // Short enough that the arena lives in the string's own buffer.
+        std::vector<std::string> lines = {"'x'\"y\" c", "\"d\\\"e\""};
+
+        std::vector<shlex::SplitLines> moved;
+        moved.push_back(std::move(shlex::split_all(lines)));
+        moved.push_back(shlex::split_all(lines));
+
+        std::optional<shlex::SplitLines> copied;
+        {
+            auto source = shlex::split_all(lines);
+            copied = source;
+            shlex::SplitLines assigned;
+            assigned = std::move(source);
+            ASSERT_EQUAL(assigned.argv(1), {"d\"e"});
+        }
+
+        for (auto& result : moved) {
+            ASSERT_EQUAL(result.argv(0), {"xy", "c"});
+            ASSERT_EQUAL(result.argv(1), {"d\"e"});
+        }
+        ASSERT_EQUAL(copied->argv(0), {"xy", "c"});
+        ASSERT_EQUAL(copied->argv(1), {"d\"e"});
+    })
     .run();
 
 }
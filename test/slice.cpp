@@ -7,8 +7,14 @@
  * Distributed under terms of the MIT license.
  */
 
+#include <array>
+#include <deque>
+#include <string>
 #include <vector>
 #include "moonlight/slice.h"
+#include "moonlight/collect.h"
+#include "moonlight/generator.h"
+#include "moonlight/alloc_hooks.h"
 #include "moonlight/test.h"
 
 using namespace moonlight;
@@ -16,12 +22,19 @@ using namespace moonlight::test;
 
 static const std::vector<int> array = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
 
+template<class V>
+std::vector<int> to_vector(const V& view) {
+    return std::vector<int>(view.begin(), view.end());
+}
+
 int main() {
     return TestSuite("moonlight slice tests")
     .test("slice simple tests", []() {
         ASSERT_EQUAL({0, 1, 2}, slice(array, {}, 3));
         ASSERT_EQUAL({7, 8, 9}, slice(array, -3, {}));
         ASSERT_EQUAL({5, 6, 7}, slice(array, -5, -2));
+        ASSERT_EQUAL({}, slice(array, 5, 2));
+        ASSERT_EQUAL(slice(std::string("moonlight"), 4, {}), std::string("light"));
     })
     .test("no out of bounds error in range", []() {
         ASSERT_EQUAL({0, 1}, slice(array, -500, 2));
@@ -35,5 +48,78 @@ int main() {
             std::cerr << "Caught expected " << e << std::endl;
         }
     })
+    .test("slice with a step", []() {
+        ASSERT_EQUAL({0, 3, 6, 9}, slice(array, {}, {}, 3));
+        ASSERT_EQUAL({9, 8, 7, 6, 5, 4, 3, 2, 1, 0}, slice(array, {}, {}, -1));
+        ASSERT_EQUAL({8, 6, 4}, slice(array, -2, 2, -2));
+        ASSERT_EQUAL({}, slice(array, 2, 8, -1));
+        ASSERT_EQUAL({9}, slice(array, 500, -500, -500));
+        ASSERT_EQUAL(slice(std::string("moonlight"), {}, {}, -1), std::string("thgilnoom"));
+
+        try {
+            slice(array, {}, {}, 0);
+            FAIL("Expected core::ValueError.");
+        } catch (const core::ValueError& e) { }
+    })
+    .test("views agree with copies", []() {
+        for (int start = -12; start <= 12; start++) {
+            for (int end = -12; end <= 12; end++) {
+                ASSERT_EQUAL(to_vector(slice_view(array, start, end)), slice(array, start, end));
+                for (int step : {-3, -2, -1, 1, 2, 5}) {
+                    auto view = slice_view(array, start, end, step);
+                    auto copy = slice(array, start, end, step);
+                    ASSERT_EQUAL(to_vector(view), copy);
+                    ASSERT_EQUAL(view.size(), copy.size());
+                }
+            }
+        }
+    })
+    .test("view types", []() {
+        std::string s = "moonlight";
+        std::string_view sv = slice_view(s, 4, {});
+        ASSERT_EQUAL(sv, std::string_view("light"));
+        ASSERT(sv.data() == s.data() + 4);
+        ASSERT_EQUAL(slice_view(std::string_view("moonlight"), -5, -1), std::string_view("ligh"));
+
+        std::vector<int> v = array;
+        std::span<int> span = slice_view(v, 2, 5);
+        span[0] = 100;
+        ASSERT_EQUAL(v[2], 100);
+        std::span<const int> const_span = slice_view(array, 2, 5);
+        ASSERT(const_span.data() == array.data() + 2);
+
+        std::array<int, 4> arr = {1, 2, 3, 4};
+        ASSERT_EQUAL(to_vector(slice_view(arr, 1, {})), {2, 3, 4});
+
+        std::deque<int> deque(array.begin(), array.end());
+        auto deque_view = slice_view(deque, 1, -1, 4);
+        ASSERT_EQUAL(to_vector(deque_view), {1, 5});
+        ASSERT_EQUAL(to_vector(slice_view(deque, -2, {})), {8, 9});
+
+        auto evens = slice_view(v, {}, {}, 2);
+        for (auto& x : evens) {
+            x = -x;
+        }
+        ASSERT_EQUAL(v[4], -4);
+        ASSERT_EQUAL(v[5], 5);
+    })
+    .test("views nest and work with streams and collect", []() {
+        auto reversed = slice_view(array, {}, {}, -1);
+        auto nested = slice_view(reversed, 1, {}, 3);
+        ASSERT_EQUAL(to_vector(nested), {8, 5, 2});
+        ASSERT_EQUAL(nested.back(), 2);
+        ASSERT((std::ranges::random_access_range<decltype(nested)>));
+
+        ASSERT_EQUAL(gen::stream(nested).collect(), {8, 5, 2});
+        ASSERT_EQUAL(collect::map<int>(nested, [](int x) { return x * 10; }), {80, 50, 20});
+        ASSERT_EQUAL(collect::sorted(slice_view(array, 2, 5)), {2, 3, 4});
+    })
+    .test("views don't allocate", []() {
+        std::vector<int> v(1000, 1);
+        std::string s(1000, 'x');
+        ASSERT_MAX_ALLOCATIONS(0, slice_view(v, -500, {}));
+        ASSERT_MAX_ALLOCATIONS(0, slice_view(v, {}, {}, -7));
+        ASSERT_MAX_ALLOCATIONS(0, slice_view(s, 10, -10));
+    })
     .run();
 }
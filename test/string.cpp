@@ -1,3 +1,6 @@
+#include <map>
+#include <string_view>
+#include <unordered_map>
 #include "moonlight/test.h"
 
 using namespace std;
@@ -19,6 +22,15 @@ int main() {
         vector<int> v = {1, 2, 3, 4};
         ASSERT_EQUAL(str::join(v, ","), string("1,2,3,4"));
     })
+    .test("str::cat, str::coerce, and str::join match operator<<", []() {
+        ASSERT_EQUAL(str::cat(true, ' ', false), string("1 0"));
+        ASSERT_EQUAL(str::cat((uint8_t)65, (int8_t)66, (unsigned char)67, 'D'), string("ABCD"));
+        ASSERT_EQUAL(str::coerce(true), string("1"));
+        ASSERT_EQUAL(str::coerce((uint8_t)65), string("A"));
+        ASSERT_EQUAL(str::join(vector<bool>{true, false}, ","), string("1,0"));
+        ASSERT_EQUAL(str::join(vector<uint8_t>{'x', 'y'}, ","), string("x,y"));
+        ASSERT_EQUAL(str::cat(-3, ' ', 2.5, ' ', 1.0 / 3.0), string("-3 2.5 0.333333"));
+    })
     .test("str::split", []() {
         vector<string> tokens;
         str::split(tokens, "1,2,3,4", ",");
@@ -45,5 +57,50 @@ int main() {
         cout << "str::literal(s) = " << str::literal(s) << std::endl;
         ASSERT_EQUAL(repr, str::literal(s));
     })
+    .test("str::to_upper, str::to_lower", []() {
+        ASSERT_EQUAL(str::to_upper("Hello, World! 123"), string("HELLO, WORLD! 123"));
+        ASSERT_EQUAL(str::to_lower("Hello, World! 123"), string("hello, world! 123"));
+
+        string s = "Content-Type: text/HTML; charset=UTF-8 \xc3\x89t\xc3\xa9 [@`{]";
+        string expected;
+        for (char c : s) {
+            expected.push_back(c >= 'A' && c <= 'Z' ? c + 32 : c);
+        }
+        ASSERT_EQUAL(str::to_lower(s), expected);
+        str::to_upper_inplace(s);
+        str::to_lower_inplace(s);
+        ASSERT_EQUAL(s, expected);
+    })
+    .test("str::iequals, str::icompare, str::ihash", []() {
+        string a = "X-Forwarded-For-A-Very-Long-Header-Name-Indeed";
+        string b = "x-forwarded-for-a-very-long-header-name-indeed";
+        ASSERT(str::iequals(a, b));
+        ASSERT(str::iequals("", ""));
+        ASSERT_FALSE(str::iequals(a, b + "!"));
+        ASSERT_FALSE(str::iequals("@", "`"));
+        ASSERT_EQUAL(str::icompare(a, b), 0);
+        ASSERT(str::icompare("apple", "BANANA") < 0);
+        ASSERT(str::icompare("Banana", "apple") > 0);
+        ASSERT(str::icompare("app", "APPLE") < 0);
+        ASSERT_EQUAL(str::ihash(a), str::ihash(b));
+
+        for (size_t x = 0; x < b.size(); x++) {
+            string c = b;
+            c[x] = '#';
+            ASSERT(str::icompare(b, c) > 0);
+            ASSERT(str::icompare(c, a) < 0);
+        }
+    })
+    .test("str::IHash, str::IEqual, str::ILess", []() {
+        unordered_map<string, int, str::IHash, str::IEqual> umap;
+        umap["Content-Length"] = 1;
+        umap["CONTENT-LENGTH"]++;
+        ASSERT_EQUAL(umap.size(), (size_t)1);
+        ASSERT_EQUAL(umap.at("content-length"), 2);
+
+        map<string, int, str::ILess> omap = {{"b", 2}, {"A", 1}, {"C", 3}};
+        ASSERT_EQUAL(omap.begin()->first, string("A"));
+        ASSERT(omap.find(string_view("c")) != omap.end());
+    })
     .run();
 }
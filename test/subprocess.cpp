@@ -0,0 +1,99 @@
+/*
+ * subprocess.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include "moonlight/subprocess.h"
+#include "moonlight/test.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+int main() {
+    return TestSuite("moonlight subprocess tests")
+    .test("run captures stdout and stderr separately", []() {
+        auto result = sys::run({"sh", "-c", "echo out; echo err >&2; exit 3"});
+        ASSERT_EQUAL(result.returncode, 3);
+        ASSERT_EQUAL(result.out, std::string("out\n"));
+        ASSERT_EQUAL(result.err, std::string("err\n"));
+        ASSERT_FALSE(result.ok());
+
+        try {
+            result.check();
+            FAIL("Expected core::RuntimeError.");
+        } catch (const core::RuntimeError& e) { }
+    })
+    .test("commands are split with shlex", []() {
+        auto result = sys::run("printf '%s|' 'a b' c");
+        ASSERT_TRUE(result.ok());
+        ASSERT_EQUAL(result.check(), std::string("a b|c|"));
+    })
+    .test("input larger than a pipe buffer is fed to stdin", []() {
+        std::string input(1 << 20, 'x');
+        auto result = sys::run(sys::Command("cat").with_input(input));
+        ASSERT_TRUE(result.ok());
+        ASSERT_EQUAL(result.out.size(), input.size());
+        ASSERT_TRUE(result.out == input);
+    })
+    .test("input is dropped if the child doesn't read it", []() {
+        auto result = sys::run(sys::Command("true").with_input(std::string(1 << 20, 'x')));
+        ASSERT_TRUE(result.ok());
+    })
+    .test("env and cwd", []() {
+        auto result = sys::run(sys::Command({"sh", "-c", "echo $GREETING; pwd"})
+                               .with_env({"GREETING=hello"})
+                               .with_cwd("/"));
+        ASSERT_EQUAL(result.check(), std::string("hello\n/\n"));
+    })
+    .test("commands which time out are killed", []() {
+        auto result = sys::run(sys::Command("sleep 10").with_timeout(std::chrono::milliseconds(50)));
+        ASSERT_TRUE(result.timed_out);
+        ASSERT_EQUAL(result.returncode, -SIGKILL);
+        ASSERT_TRUE(result.elapsed < std::chrono::seconds(5));
+    })
+    .test("commands which can't be started throw", []() {
+        try {
+            sys::run("/nonexistent/program");
+            FAIL("Expected core::RuntimeError.");
+        } catch (const core::RuntimeError& e) { }
+
+        sys::ProcessPool pool(2);
+        auto future = pool.submit("/nonexistent/program");
+        try {
+            future.get();
+            FAIL("Expected core::RuntimeError.");
+        } catch (const core::RuntimeError& e) { }
+    })
+    .test("ProcessPool runs commands concurrently up to its limit", []() {
+        sys::ProcessPool pool(4);
+        std::vector<std::future<sys::CompletedProcess>> futures;
+        auto start = std::chrono::steady_clock::now();
+        for (int x = 0; x < 8; x++) {
+            futures.push_back(pool.submit({"sh", "-c", "sleep 0.2; echo " + std::to_string(x)}));
+        }
+        for (int x = 0; x < 8; x++) {
+            ASSERT_EQUAL(futures[x].get().check(), std::to_string(x) + "\n");
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        ASSERT_TRUE(elapsed >= std::chrono::milliseconds(400));
+        ASSERT_TRUE(elapsed < std::chrono::milliseconds(1500));
+    })
+    .test("ProcessPool::map yields results as commands complete", []() {
+        sys::ProcessPool pool(3);
+        std::vector<sys::Command> cmds = {"sleep 0.3", "echo fast", "sleep 0.1"};
+        std::vector<std::string> order;
+        for (auto& result : pool.map(cmds)) {
+            order.push_back(result.argv[0] + " " + result.argv[1]);
+        }
+        ASSERT_EQUAL(order.size(), (size_t)3);
+        ASSERT_EQUAL(order[0], std::string("echo fast"));
+        ASSERT_EQUAL(order[1], std::string("sleep 0.1"));
+        ASSERT_EQUAL(order[2], std::string("sleep 0.3"));
+    })
+    .run();
+}
@@ -0,0 +1,124 @@
+/*
+ * symbol.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ */
+
+#include <csignal>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "moonlight/test.h"
+#include "moonlight/symbol.h"
+#include "moonlight/file.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+int main() {
+    return TestSuite("moonlight symbol.h tests")
+    .die_on_signal(SIGSEGV)
+    .test("equal strings intern to the same symbol", []() {
+        str::Symbol a = "content-type";
+        str::Symbol b = string("content-") + "type";
+        str::Symbol c = string_view("content-type-x").substr(0, 12);
+        ASSERT(a == b);
+        ASSERT(b == c);
+        ASSERT(a.c_str() == c.c_str());
+        ASSERT_EQUAL(a.hash(), std::hash<string_view>()("content-type"));
+        ASSERT_EQUAL(a.str(), string("content-type"));
+        ASSERT(a != str::Symbol("content-length"));
+        ASSERT_EQUAL(sizeof(str::Symbol), sizeof(void*));
+    })
+    .test("the empty symbol", []() {
+        str::Symbol a;
+        str::Symbol b = "";
+        ASSERT(a == b);
+        ASSERT(a.empty());
+        ASSERT_EQUAL(a.size(), 0ul);
+        ASSERT(a == "");
+    })
+    .test("comparison with plain strings and ordering", []() {
+        str::Symbol apple = "apple";
+        ASSERT(apple == "apple");
+        ASSERT(apple == string("apple"));
+        ASSERT(apple == string_view("apple"));
+        ASSERT(apple != "pear");
+        ASSERT(apple < str::Symbol("banana"));
+        ASSERT(str::Symbol("cherry") > str::Symbol("banana"));
+
+        map<str::Symbol, int> ordered = {{"pear", 3}, {"apple", 1}, {"banana", 2}};
+        vector<string> keys;
+        for (auto& pair : ordered) {
+            keys.push_back(pair.first);
+        }
+        ASSERT_EQUAL(keys, vector<string>({"apple", "banana", "pear"}));
+
+        unordered_map<str::Symbol, int> unordered = {{"pear", 3}, {"apple", 1}};
+        ASSERT_EQUAL(unordered.at("apple"), 1);
+    })
+    .test("find does not intern new strings", []() {
+        auto before = str::Symbol::stats();
+        ASSERT_FALSE(str::Symbol::find("this string was never interned").has_value());
+        ASSERT_EQUAL(str::Symbol::stats().count, before.count);
+
+        str::Symbol known = "this string is interned";
+        auto found = str::Symbol::find("this string is interned");
+        ASSERT(found.has_value());
+        ASSERT(*found == known);
+        ASSERT_EQUAL(str::Symbol::stats().count, before.count + 1);
+    })
+    .test("interned strings stay in place as the pool grows", []() {
+        str::Symbol first = "arena-first";
+        const char* data = first.c_str();
+        vector<str::Symbol> symbols;
+        for (int x = 0; x < 5000; x++) {
+            symbols.push_back(str::Symbol("arena-" + to_string(x)));
+        }
+        str::Symbol large = string(MOONLIGHT_SYMBOL_CHUNK_SIZE, 'x');
+
+        ASSERT(first.c_str() == data);
+        ASSERT_EQUAL(string(first.c_str()), string("arena-first"));
+        ASSERT_EQUAL(strlen(symbols[4999].c_str()), symbols[4999].size());
+        ASSERT_EQUAL(large.size(), (size_t)MOONLIGHT_SYMBOL_CHUNK_SIZE);
+        ASSERT(str::Symbol::find(string(MOONLIGHT_SYMBOL_CHUNK_SIZE, 'x')) == large);
+        for (int x = 0; x < 5000; x++) {
+            ASSERT(symbols[x] == "arena-" + to_string(x));
+        }
+    })
+    .test("formatting and file::Location names", []() {
+        str::Symbol name = "config.json";
+        ASSERT_EQUAL(fmt::format("[{:>12}]", name), string("[ config.json]"));
+        ASSERT_EQUAL(str::cat(name, "!"), string("config.json!"));
+
+        file::Location loc = {1, 2, 3, "config.json"};
+        ASSERT(loc.name == name);
+        ASSERT_EQUAL(fmt::format("{}", loc), string("<'config.json' L1:2 +3>"));
+    })
+    .test("interning from many threads", []() {
+        const int THREADS = 8;
+        vector<vector<str::Symbol>> results(THREADS);
+        vector<thread> threads;
+        for (int x = 0; x < THREADS; x++) {
+            threads.emplace_back([x, &results]() {
+                for (int y = 0; y < 1000; y++) {
+                    results[x].push_back(str::Symbol("threaded-" + to_string(y)));
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        for (int x = 1; x < THREADS; x++) {
+            for (int y = 0; y < 1000; y++) {
+                ASSERT(results[x][y] == results[0][y]);
+            }
+        }
+    })
+    .run();
+}
@@ -1,5 +1,10 @@
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include "moonlight/alloc_hooks.h"
 #include "moonlight/test.h"
+#include "moonlight/bench.h"
 
 using namespace std;
 using namespace moonlight::test;
@@ -22,5 +27,111 @@ int main() {
                      })
                      .run(cnull), 1);
     })
+    .test("Forked tests are isolated from crashes and timeouts", []() {
+        std::ostringstream sb;
+        int failed = TestSuite("internal test suite")
+        .jobs(4)
+        .timeout(std::chrono::milliseconds(200))
+        .test("passing test", []() {
+            std::cout << "some output" << std::endl;
+        })
+        .test("failing test", []() {
+            ASSERT_TRUE(false);
+        })
+        .test("crashing test", []() {
+            raise(SIGSEGV);
+        })
+        .test("hanging test", []() {
+            sleep(10);
+        })
+        .run(sb);
+
+        std::string output = sb.str();
+        ASSERT_EQUAL(failed, 3);
+        ASSERT_TRUE(output.find("some output\n    PASSED") != std::string::npos);
+        ASSERT_TRUE(output.find("killed by signal 11") != std::string::npos);
+        ASSERT_TRUE(output.find("timed out after 200 ms") != std::string::npos);
+    })
+    .test("Shuffling with a seed is deterministic", []() {
+        auto order = [](unsigned int seed) {
+            std::ostringstream sb;
+            auto suite = TestSuite("internal test suite").seed(seed);
+            for (int x = 0; x < 10; x++) {
+                suite.test("test " + std::to_string(x), []() { });
+            }
+            suite.run(sb);
+            return sb.str();
+        };
+        ASSERT_EQUAL(order(1234), order(1234));
+        ASSERT_NOT_EQUAL(order(1234), order(4321));
+    })
+    .test("Allocations are counted per thread", []() {
+        AllocationSnapshot snapshot;
+        auto ptr = std::make_unique<std::array<char, 100>>();
+        do_not_optimize(ptr);
+        ASSERT_EQUAL(snapshot.delta().allocs, (uint64_t)1);
+        ASSERT_EQUAL(snapshot.delta().bytes, (uint64_t)100);
+        ptr.reset();
+        ASSERT_EQUAL(snapshot.delta().frees, (uint64_t)1);
+
+        std::thread thread([]() {
+            for (int x = 0; x < 1000; x++) {
+                do_not_optimize(std::make_unique<int>(x));
+            }
+        });
+        thread.join();
+        ASSERT_TRUE(snapshot.delta().allocs < 1000);
+    })
+    .test("ASSERT_MAX_ALLOCATIONS", []() {
+        std::string small = "abc";
+        ASSERT_MAX_ALLOCATIONS(0, small += "d");
+
+        try {
+            ASSERT_MAX_ALLOCATIONS(1, small = std::string(100, 'x'); small += small);
+            FAIL("Expected core::AssertionFailure.");
+        } catch (const moonlight::core::AssertionFailure& e) { }
+    })
+    .test("Benchmarks report allocations per call", []() {
+        auto suite = BenchmarkSuite("internal benchmark suite")
+        .samples(3)
+        .warmup(std::chrono::milliseconds(0))
+        .sample_time(std::chrono::milliseconds(1))
+        .bench("allocate", []() {
+            do_not_optimize(std::make_unique<int64_t>(1));
+        });
+        auto output = std::ostringstream();
+        ASSERT_EQUAL(suite.run(output), 0);
+        ASSERT_TRUE(output.str().find("1.0 allocs (8.0 B)/call") != std::string::npos);
+    })
+    .test("Benchmark statistics", []() {
+        Benchmark bench("noop", []() { });
+        bench.items(10).bytes(100);
+        auto result = BenchmarkResult::summarize(bench, 1, {40, 10, 30, 20});
+        ASSERT_EQUAL(result.samples, (size_t)4);
+        ASSERT_EQUAL(result.min_ns, 10.0);
+        ASSERT_EQUAL(result.max_ns, 40.0);
+        ASSERT_EQUAL(result.mean_ns, 25.0);
+        ASSERT_EQUAL(result.median_ns, 20.0);
+        ASSERT_EQUAL(result.p90_ns, 40.0);
+        ASSERT_EP_EQUAL(result.stddev_ns, 12.9099, 0.0001);
+        ASSERT_EQUAL(result.items_per_second, 4e8);
+        ASSERT_EQUAL(result.bytes_per_second, 4e9);
+    })
+    .test("Failed benchmarks are counted", []() {
+        ostream cnull(0);
+        int calls = 0;
+        ASSERT_EQUAL(BenchmarkSuite("internal benchmark suite")
+                     .samples(3)
+                     .warmup(std::chrono::milliseconds(0))
+                     .sample_time(std::chrono::milliseconds(1))
+                     .bench("counted", [&]() {
+                         do_not_optimize(++calls);
+                     })
+                     .bench("doomed", []() {
+                         throw runtime_error("oh noes!");
+                     })
+                     .run(cnull), 1);
+        ASSERT_TRUE(calls > 3);
+    })
     .run();
 }
@@ -5,12 +5,40 @@
  * Date: Tuesday May 28, 2024
  */
 
+#include <random>
 #include "moonlight/unicode.h"
 #include "moonlight/test.h"
 
 using namespace moonlight::test;
 namespace unicode = moonlight::unicode;
 
+// A stream buffer which hands out one byte at a time and buffers nothing
+// ahead, like a terminal which has only received the first `limit` bytes.
+// Reading past them sets `overread` instead of blocking.
+class TrickleBuf : public std::streambuf {
+ public:
+    TrickleBuf(const std::string& data, size_t limit) : _data(data), _limit(limit) { }
+
+    bool overread = false;
+
+ protected:
+    int_type underflow() override {
+        if (_pos >= _limit) {
+            overread = true;
+            return traits_type::eof();
+        }
+        _c = _data[_pos++];
+        setg(&_c, &_c, &_c + 1);
+        return traits_type::to_int_type(_c);
+    }
+
+ private:
+    std::string _data;
+    size_t _limit;
+    size_t _pos = 0;
+    char _c = 0;
+};
+
 int main() {
     return TestSuite("moonlight utf8 tests")
     .die_on_signal(SIGSEGV)
@@ -32,5 +60,120 @@ int main() {
         std::string result = utf8::utf32to8(result32);
         ASSERT_EQUAL(sample_text, result);
     })
+    .test("whitespace is preserved", []() {
+        std::istringstream infile("a b\n\tc");
+        unicode::BufferedInput input(infile);
+        ASSERT_EQUAL(utf8::utf32to8(input.scan_dump()), std::string("a b\n\tc"));
+        ASSERT(input.getline() == U"a b\n");
+        ASSERT_EQUAL(input.line(), 2);
+    })
+    .test("sequences split across chunk boundaries", []() {
+        std::string text;
+        while (text.size() < MOONLIGHT_UNICODE_CHUNK_SIZE * 3) {
+            text += "x間濾😺mew\n";
+        }
+        std::istringstream infile(text);
+        unicode::BufferedInput input(infile);
+        unicode::string result;
+        for (auto c = input.getc(); c != (unicode::u32_t)EOF; c = input.getc()) {
+            result.push_back(c);
+        }
+        ASSERT(input.is_exhausted());
+        ASSERT(result == unicode::decode(text));
+        ASSERT_EQUAL(unicode::encode(result), text);
+    })
+    .test("reads no further than the characters asked for", []() {
+        std::string text = "h\u00e9llo\n\u9593\n";
+        TrickleBuf buf(text, text.find('\n') + 1);
+        std::istream infile(&buf);
+        unicode::BufferedInput input(infile);
+        ASSERT(input.getline() == U"h\u00e9llo\n");
+        ASSERT_FALSE(buf.overread);
+
+        TrickleBuf buf2(text, 2);
+        std::istream infile2(&buf2);
+        unicode::BufferedInput input2(infile2);
+        ASSERT(input2.getc() == U'h');
+        ASSERT_FALSE(buf2.overread);
+    })
+    .test("invalid input is raised when it is reached", []() {
+        std::istringstream infile("abc\xff");
+        unicode::BufferedInput input(infile);
+        ASSERT(input.getc() == U'a');
+        ASSERT(input.peek(2) == U'c');
+        try {
+            input.peek(3);
+            FAIL("Expected UnicodeError.");
+        } catch (const unicode::UnicodeError& e) {
+            ASSERT_EQUAL(e.loc().offset, 1u);
+        }
+
+        std::istringstream truncated("ab\xe9\x96");
+        unicode::BufferedInput input2(truncated);
+        input2.advance(2);
+        try {
+            input2.getc();
+            FAIL("Expected UnicodeError.");
+        } catch (const unicode::UnicodeError& e) { }
+    })
+    .test("is_valid_utf8", []() {
+        ASSERT(unicode::is_valid_utf8(""));
+        ASSERT(unicode::is_valid_utf8("間濾mew😺"));
+        ASSERT(unicode::is_valid_utf8(std::string(100, 'a') + "é"));
+
+        const std::vector<std::string> invalid = {
+            "\x80", "\xc0\xaf", "\xc3", "\xe0\x80\xaf", "\xed\xa0\x80",
+            "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xe9\x96", "\xff", "\xc3\xa9\xa9"
+        };
+        for (const auto& bad : invalid) {
+            for (size_t pad : {0, 1, 13, 14, 15, 16, 29, 30, 31, 32, 64}) {
+                ASSERT_FALSE(unicode::is_valid_utf8(std::string(pad, 'a') + bad));
+                ASSERT_FALSE(unicode::is_valid_utf8(std::string(pad, 'a') + bad + std::string(40, 'b')));
+            }
+        }
+    })
+    .test("is_valid_utf8 agrees with the scalar decoder", []() {
+        std::mt19937 rng(1234);
+        const std::string sample = "x間濾😺mew é ü ÿ ascii text and more ascii 𝄞";
+        for (int x = 0; x < 20000; x++) {
+            std::string s;
+            size_t len = rng() % 100;
+            while (s.size() < len) {
+                s += sample;
+            }
+            s.resize(len);
+            for (int y = rng() % 3; y > 0 && ! s.empty(); y--) {
+                s[rng() % s.size()] = static_cast<char>(rng());
+            }
+            std::vector<unicode::u32_t> out(s.size());
+            auto result = unicode::utf8_to_utf32(s, out);
+            bool expected = result.status == unicode::TranscodeStatus::COMPLETE;
+            ASSERT_EQUAL(unicode::is_valid_utf8(s), expected);
+        }
+    })
+    .test("transcoding into bounded spans", []() {
+        std::string text = std::string(40, 'a') + "間濾" + std::string(40, 'b');
+        std::vector<unicode::u32_t> out(41);
+        auto result = unicode::utf8_to_utf32(text, out);
+        ASSERT_EQUAL(result.read, 43ul);
+        ASSERT_EQUAL(result.written, 41ul);
+        ASSERT(out[40] == U'間');
+
+        result = unicode::utf8_to_utf32(std::string_view(text).substr(0, 42), out);
+        ASSERT(result.status == unicode::TranscodeStatus::INCOMPLETE);
+        ASSERT_EQUAL(result.read, 40ul);
+
+        unicode::string wide = unicode::decode(text);
+        std::vector<char> bytes(42);
+        result = unicode::utf32_to_utf8(wide, bytes);
+        ASSERT_EQUAL(result.read, 40ul);
+        ASSERT_EQUAL(result.written, 40ul);
+
+        unicode::string bad = U"ok";
+        bad.push_back(0xD800);
+        result = unicode::utf32_to_utf8(bad, bytes);
+        ASSERT(result.status == unicode::TranscodeStatus::INVALID);
+        ASSERT_EQUAL(result.read, 2ul);
+    })
     .run();
 }
@@ -0,0 +1,127 @@
+/*
+ * uuid.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "moonlight/uuid.h"
+#include "moonlight/test.h"
+
+using namespace std;
+using namespace moonlight;
+using namespace moonlight::test;
+
+string text(const uuid::UUID& id) {
+    char buffer[36];
+    uuid::format(id, buffer);
+    return string(buffer, sizeof(buffer));
+}
+
+int main() {
+    return TestSuite("moonlight uuid.h tests")
+    .test("format and parse the text form", []() {
+        const string s = "0190a3c1-7e2b-7c4d-8e9f-a1b2c3d4e5f6";
+        auto id = uuid::parse(s);
+        ASSERT_EQUAL(text(id), s);
+        ASSERT_EQUAL(text(id), uuids::to_string(id));
+        ASSERT(uuid::parse("0190A3C1-7E2B-7C4D-8E9F-A1B2C3D4E5F6") == id);
+        ASSERT_EQUAL(uuid::version(id), 7);
+
+        uuid::Generator v4;
+        for (int x = 0; x < 100; x++) {
+            auto random_id = v4();
+            ASSERT_EQUAL(text(random_id), uuids::to_string(random_id));
+            ASSERT(uuid::parse(text(random_id)) == random_id);
+        }
+    })
+    .test("malformed text is rejected", []() {
+        for (auto s : {
+            "",
+            "0190a3c1-7e2b-7c4d-8e9f-a1b2c3d4e5f",
+            "0190a3c1-7e2b-7c4d-8e9f-a1b2c3d4e5f6a",
+            "0190a3c1x7e2b-7c4d-8e9f-a1b2c3d4e5f6",
+            "0190a3c17e2b-7c4d-8e9f-a1b2c3d4e5f6-",
+            "0190a3c1-7e2b-7c4d-8e9f-a1b2c3d4e5fg",
+            "{190a3c1-7e2b-7c4d-8e9f-a1b2c3d4e5f6"
+        }) {
+            ASSERT(! uuid::try_parse(s).ok());
+        }
+
+        try {
+            uuid::parse("not a uuid");
+            FAIL("Expected core::ValueError.");
+        } catch (const core::ValueError& e) { }
+    })
+    .test("V7Generator layout", []() {
+        uuid::V7Generator gen;
+        const uint64_t ms = 0x0190a3c17e2bull;
+        auto id = gen.generate(ms);
+        auto bytes = reinterpret_cast<const uint8_t*>(id.as_bytes().data());
+
+        ASSERT_EQUAL(uuid::version(id), 7);
+        ASSERT_EQUAL(bytes[8] & 0xc0, 0x80);
+        ASSERT_EQUAL(uuid::timestamp_ms(id), ms);
+        ASSERT(text(id).starts_with("0190a3c1-7e2b-7"));
+
+        auto now = gen();
+        auto wall = chrono::duration_cast<chrono::milliseconds>(
+            chrono::system_clock::now().time_since_epoch()).count();
+        ASSERT((int64_t)uuid::timestamp_ms(now) <= wall);
+        ASSERT((int64_t)uuid::timestamp_ms(now) > wall - 1000);
+    })
+    .test("V7Generator is monotonic within a thread", []() {
+        uuid::V7Generator gen;
+        const uint64_t ms = 1700000000000;
+        vector<uuid::UUID> ids;
+
+        // Generator state is per-thread, so start from a fresh thread
+        // unaffected by the other tests' use of the wall clock.
+        thread([&]() {
+            for (int x = 0; x < 1000; x++) {
+                ids.push_back(gen.generate(ms));
+            }
+            // The clock steps backwards.
+            for (int x = 0; x < 100; x++) {
+                ids.push_back(gen.generate(ms - 5000));
+            }
+            ids.push_back(gen.generate(ms + 1));
+        }).join();
+
+        for (size_t x = 1; x < ids.size(); x++) {
+            ASSERT(ids[x - 1] < ids[x]);
+            ASSERT(text(ids[x - 1]) < text(ids[x]));
+        }
+        ASSERT_EQUAL(uuid::timestamp_ms(ids[1099]), ms);
+        ASSERT_EQUAL(uuid::timestamp_ms(ids.back()), ms + 1);
+    })
+    .test("V7Generator is unique across threads", []() {
+        uuid::V7Generator gen;
+        vector<vector<uuid::UUID>> batches(4);
+        vector<thread> threads;
+        for (auto& batch : batches) {
+            threads.emplace_back([&]() {
+                for (int x = 0; x < 5000; x++) {
+                    batch.push_back(gen());
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        set<uuid::UUID> seen;
+        for (const auto& batch : batches) {
+            for (const auto& id : batch) {
+                ASSERT(seen.insert(id).second);
+            }
+        }
+    })
+    .run();
+}
@@ -0,0 +1,167 @@
+/*
+ * yaml.cpp
+ *
+ * Author: Lain Musgrove (lain.proliant@gmail.com)
+ * Date: Sunday October 18, 2026
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+#define RYML_SINGLE_HDR_DEFINE_NOW
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "moonlight/yaml.h"
+#include "moonlight/json/mapping.h"
+#include "moonlight/test.h"
+
+using namespace moonlight;
+using namespace moonlight::test;
+
+struct Job {
+    std::string name;
+    std::vector<std::string> args;
+    int retries = 0;
+
+    json::Mapper<Job> __json__() {
+        return json::Mapper(this)
+        .field("name", name)
+        .field("args", args)
+        .field("retries", retries);
+    }
+};
+
+int main() {
+    return TestSuite("moonlight yaml tests")
+    .test("scalars follow the core schema", []() {
+        auto obj = yaml::read<json::Object>(
+            "empty:\n"
+            "tilde: ~\n"
+            "yes: true\n"
+            "no: False\n"
+            "int: -42\n"
+            "hex: 0x1f\n"
+            "octal: 0o17\n"
+            "float: 6.02e+23\n"
+            "inf: -.inf\n"
+            "nan: .nan\n"
+            "word: hello world\n"
+            "quoted: \"123\"\n"
+            "single: 'true'\n"
+            "tagged: !!str 3.5\n"
+            "version: 1.2.3\n"
+            "block: |\n"
+            "  42\n");
+
+        ASSERT_TRUE(obj.get<json::Value::Pointer>("empty")->is<json::Null>());
+        ASSERT_TRUE(obj.get<json::Value::Pointer>("tilde")->is<json::Null>());
+        ASSERT_EQUAL(obj.get<bool>("yes"), true);
+        ASSERT_EQUAL(obj.get<bool>("no"), false);
+        ASSERT_EQUAL(obj.get<int>("int"), -42);
+        ASSERT_EQUAL(obj.get<int>("hex"), 31);
+        ASSERT_EQUAL(obj.get<int>("octal"), 15);
+        ASSERT_EQUAL(obj.get<double>("float"), 6.02e23);
+        ASSERT_EQUAL(obj.get<double>("inf"), -std::numeric_limits<double>::infinity());
+        ASSERT_TRUE(std::isnan(obj.get<double>("nan")));
+        ASSERT_EQUAL(obj.get<std::string>("word"), std::string("hello world"));
+        ASSERT_EQUAL(obj.get<std::string>("quoted"), std::string("123"));
+        ASSERT_EQUAL(obj.get<std::string>("single"), std::string("true"));
+        ASSERT_EQUAL(obj.get<std::string>("tagged"), std::string("3.5"));
+        ASSERT_EQUAL(obj.get<std::string>("version"), std::string("1.2.3"));
+        ASSERT_EQUAL(obj.get<std::string>("block"), std::string("42\n"));
+    })
+    .test("collections, anchors and merge keys", []() {
+        auto obj = yaml::read<json::Object>(
+            "defaults: &defaults\n"
+            "  retries: 3\n"
+            "  queue: batch\n"
+            "jobs:\n"
+            "  - <<: *defaults\n"
+            "    name: build\n"
+            "    retries: 5\n"
+            "  - {name: test, tags: [fast, unit]}\n");
+
+        auto jobs = obj.get<json::Array>("jobs");
+        auto build = jobs.get<json::Object>(0);
+        auto test = jobs.get<json::Object>(1);
+        ASSERT_EQUAL(build.get<std::string>("name"), std::string("build"));
+        ASSERT_EQUAL(build.get<int>("retries"), 5);
+        ASSERT_EQUAL(build.get<std::string>("queue"), std::string("batch"));
+        ASSERT_EQUAL(test.get<std::vector<std::string>>("tags"), {"fast", "unit"});
+        ASSERT_EQUAL(yaml::read<json::Value::Pointer>("- 1\n- [2, 3]\n")->get<json::Array>().size(), 2u);
+    })
+    .test("mapping into classes", []() {
+        auto job = yaml::read<Job>(
+            "name: nightly\n"
+            "args: [--all, -j8]\n"
+            "retries: 2\n");
+        ASSERT_EQUAL(job.name, std::string("nightly"));
+        ASSERT_EQUAL(job.args, {"--all", "-j8"});
+        ASSERT_EQUAL(job.retries, 2);
+
+        std::string buffer = "name: in-place\nargs: []\nretries: 0\n";
+        ASSERT_EQUAL(yaml::parse_in_place(buffer)->get<Job>().name, std::string("in-place"));
+    })
+    .test("streaming multiple documents", []() {
+        std::istringstream infile(
+            "# leading comment\n"
+            "%YAML 1.2\n"
+            "---\n"
+            "name: one\n"
+            "args: [a]\n"
+            "---\n"
+            "# a comment inside the second document\n"
+            "name: two\n"
+            "args: |\n"
+            "  b\n"
+            "...\n"
+            "--- {name: three, args: []}\n"
+            "---\n");
+
+        std::vector<json::Value::Pointer> docs;
+        for (auto doc : yaml::documents(infile, "jobs.yaml")) {
+            docs.push_back(doc);
+        }
+
+        ASSERT_EQUAL(docs.size(), (size_t)4);
+        ASSERT_EQUAL(docs[0]->get<Job>().name, std::string("one"));
+        ASSERT_EQUAL(docs[1]->get<json::Object>().get<std::string>("args"), std::string("b\n"));
+        ASSERT_EQUAL(docs[2]->get<Job>().name, std::string("three"));
+        ASSERT_TRUE(docs[3]->is<json::Null>());
+    })
+    .test("errors", []() {
+        try {
+            yaml::read<json::Value::Pointer>("a: 1\n---\nb: 2\n");
+            FAIL("Expected ParseError.");
+
+        } catch (const yaml::ParseError& e) { }
+
+        auto result = yaml::try_read<json::Value::Pointer>("a: [1, 2\n");
+        ASSERT_FALSE((bool)result);
+        ASSERT_EQUAL(result.error().code, core::ErrorCode::SYNTAX_ERROR);
+        ASSERT_EQUAL(result.error().loc.line, 2u);
+        ASSERT_EQUAL(result.error().loc.col, 1u);
+
+        std::istringstream infile("a: 1\n---\nb: 2\n---\nc: [1, 2\n");
+        auto docs = yaml::documents(infile, "bad.yaml");
+        auto iter = docs.begin();
+        ASSERT_EQUAL((*iter)->get<json::Object>().get<int>("a"), 1);
+        iter++;
+        ASSERT_EQUAL((*iter)->get<json::Object>().get<int>("b"), 2);
+        try {
+            iter++;
+            FAIL("Expected ParseError.");
+
+        } catch (const yaml::ParseError& e) {
+            ASSERT_EQUAL(std::string(e.loc().name), std::string("bad.yaml"));
+            // The flow sequence is unterminated at the end of the input,
+            // the start of line 6 of the file.
+            ASSERT_EQUAL(e.loc().line, 6u);
+            ASSERT_EQUAL(e.loc().col, 1u);
+        }
+    })
+    .run();
+}
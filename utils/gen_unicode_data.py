@@ -0,0 +1,305 @@
+#!/usr/bin/env python
+# --------------------------------------------------------------------
+# gen_unicode_data.py
+#
+# Author: Lain Musgrove (lain.proliant@gmail.com)
+# Date: Sunday October 18, 2026
+#
+# Distributed under terms of the MIT license.
+#
+# Generates `include/moonlight/unicode_data.h`, the two-level lookup
+# tables for display width and grapheme cluster break properties used
+# by `unicode.h`.
+#
+# Usage: gen_unicode_data.py UCD_DIR
+#        gen_unicode_data.py --from-unicodedata
+#
+# UCD_DIR must contain `EastAsianWidth.txt`, `DerivedGeneralCategory.txt`,
+# `auxiliary/GraphemeBreakProperty.txt`, and `emoji/emoji-data.txt` from
+# the Unicode Character Database, as fetched by `./build.py ucd`.  This is
+# how the checked-in tables are generated.
+#
+# With `--from-unicodedata`, the properties are instead approximated from
+# Python's `unicodedata` module and the UAX #29 definitions below, for use
+# when the UCD files can't be fetched.  Its Unicode version is whatever
+# Python was built with, and its grapheme properties are not exact.
+# --------------------------------------------------------------------
+import re
+import sys
+import unicodedata
+from pathlib import Path
+
+MAX_CODEPOINT = 0x110000
+BLOCK_SIZE = 256
+
+GCB = [
+    "Other",
+    "CR",
+    "LF",
+    "Control",
+    "Extend",
+    "ZWJ",
+    "Regional_Indicator",
+    "Prepend",
+    "SpacingMark",
+    "L",
+    "V",
+    "T",
+    "LV",
+    "LVT",
+]
+
+EXT_PICT_BIT = 1 << 4
+WIDTH_SHIFT = 5
+
+# Used only with `--from-unicodedata`, which lacks these properties.
+OTHER_GRAPHEME_EXTEND = [
+    (0x09BE, 0x09BE), (0x09D7, 0x09D7), (0x0B3E, 0x0B3E), (0x0B57, 0x0B57),
+    (0x0BBE, 0x0BBE), (0x0BD7, 0x0BD7), (0x0CC2, 0x0CC2), (0x0CD5, 0x0CD6),
+    (0x0D3E, 0x0D3E), (0x0D57, 0x0D57), (0x0DCF, 0x0DCF), (0x0DDF, 0x0DDF),
+    (0x1B35, 0x1B35), (0x200C, 0x200C), (0x302E, 0x302F), (0xFF9E, 0xFF9F),
+    (0x1133E, 0x1133E), (0x11357, 0x11357), (0x114B0, 0x114B0),
+    (0x114BD, 0x114BD), (0x115AF, 0x115AF), (0x11930, 0x11930),
+    (0x1D165, 0x1D165), (0x1D16E, 0x1D172), (0xE0020, 0xE007F),
+    (0x1F3FB, 0x1F3FF),
+]
+
+PREPEND = [
+    (0x0600, 0x0605), (0x06DD, 0x06DD), (0x070F, 0x070F), (0x0890, 0x0891),
+    (0x08E2, 0x08E2), (0x0D4E, 0x0D4E), (0x110BD, 0x110BD),
+    (0x110CD, 0x110CD), (0x111C2, 0x111C3), (0x1193F, 0x1193F),
+    (0x11941, 0x11941), (0x11A3A, 0x11A3A), (0x11A84, 0x11A89),
+    (0x11D46, 0x11D46),
+]
+
+NOT_SPACING_MARK = [
+    (0x102B, 0x102C), (0x1038, 0x1038), (0x1062, 0x1064), (0x1067, 0x106D),
+    (0x1083, 0x1083), (0x1087, 0x108C), (0x108F, 0x108F), (0x109A, 0x109C),
+    (0x1A61, 0x1A61), (0x1A63, 0x1A64), (0xAA7B, 0xAA7B), (0xAA7D, 0xAA7D),
+    (0x11720, 0x11721),
+]
+
+EXTENDED_PICTOGRAPHIC = [
+    (0x00A9, 0x00A9), (0x00AE, 0x00AE), (0x203C, 0x203C), (0x2049, 0x2049),
+    (0x2122, 0x2122), (0x2139, 0x2139), (0x2194, 0x2199), (0x21A9, 0x21AA),
+    (0x231A, 0x231B), (0x2328, 0x2328), (0x2388, 0x2388), (0x23CF, 0x23CF),
+    (0x23E9, 0x23F3), (0x23F8, 0x23FA), (0x24C2, 0x24C2), (0x25AA, 0x25AB),
+    (0x25B6, 0x25B6), (0x25C0, 0x25C0), (0x25FB, 0x25FE), (0x2600, 0x2605),
+    (0x2607, 0x2612), (0x2614, 0x2685), (0x2690, 0x2705), (0x2708, 0x2712),
+    (0x2714, 0x2714), (0x2716, 0x2716), (0x271D, 0x271D), (0x2721, 0x2721),
+    (0x2728, 0x2728), (0x2733, 0x2734), (0x2744, 0x2744), (0x2747, 0x2747),
+    (0x274C, 0x274C), (0x274E, 0x274E), (0x2753, 0x2755), (0x2757, 0x2757),
+    (0x2763, 0x2767), (0x2795, 0x2797), (0x27A1, 0x27A1), (0x27B0, 0x27B0),
+    (0x27BF, 0x27BF), (0x2934, 0x2935), (0x2B05, 0x2B07), (0x2B1B, 0x2B1C),
+    (0x2B50, 0x2B50), (0x2B55, 0x2B55), (0x3030, 0x3030), (0x303D, 0x303D),
+    (0x3297, 0x3297), (0x3299, 0x3299), (0x1F000, 0x1F0FF),
+    (0x1F10D, 0x1F10F), (0x1F12F, 0x1F12F), (0x1F16C, 0x1F171),
+    (0x1F17E, 0x1F17F), (0x1F18E, 0x1F18E), (0x1F191, 0x1F19A),
+    (0x1F1AD, 0x1F1E5), (0x1F201, 0x1F20F), (0x1F21A, 0x1F21A),
+    (0x1F22F, 0x1F22F), (0x1F232, 0x1F23A), (0x1F23C, 0x1F23F),
+    (0x1F249, 0x1F3FA), (0x1F400, 0x1F53D), (0x1F546, 0x1F64F),
+    (0x1F680, 0x1F6FF), (0x1F774, 0x1F77F), (0x1F7D5, 0x1F7FF),
+    (0x1F80C, 0x1F80F), (0x1F848, 0x1F84F), (0x1F85A, 0x1F85F),
+    (0x1F888, 0x1F88F), (0x1F8AE, 0x1F8FF), (0x1F90C, 0x1F93A),
+    (0x1F93C, 0x1F945), (0x1F947, 0x1FAFF), (0x1FC00, 0x1FFFD),
+]
+
+
+# --------------------------------------------------------------------
+def in_ranges(cp, ranges):
+    return any(lo <= cp <= hi for lo, hi in ranges)
+
+
+# --------------------------------------------------------------------
+def parse_ucd(path):
+    """Yield (first, last, value) for each entry in a UCD data file."""
+    pattern = re.compile(r"^([0-9A-F]+)(?:\.\.([0-9A-F]+))?\s*;\s*([A-Za-z_]+)")
+    for line in path.read_text().splitlines():
+        match = pattern.match(line)
+        if match:
+            first = int(match.group(1), 16)
+            last = int(match.group(2) or match.group(1), 16)
+            yield first, last, match.group(3)
+
+
+# --------------------------------------------------------------------
+def ucd_version(ucd_dir):
+    """The Unicode version named in the first line of `EastAsianWidth.txt`."""
+    with (ucd_dir / "EastAsianWidth.txt").open() as infile:
+        match = re.match(r"^# EastAsianWidth-([0-9.]+)\.txt", infile.readline())
+    return match.group(1) if match else "of unknown version"
+
+
+# --------------------------------------------------------------------
+def load_ucd(ucd_dir):
+    eaw = ["N"] * MAX_CODEPOINT
+    category = ["Cn"] * MAX_CODEPOINT
+    gcb = [0] * MAX_CODEPOINT
+    ext_pict = [False] * MAX_CODEPOINT
+
+    for first, last, value in parse_ucd(ucd_dir / "EastAsianWidth.txt"):
+        for cp in range(first, last + 1):
+            eaw[cp] = value
+    for first, last, value in parse_ucd(ucd_dir / "DerivedGeneralCategory.txt"):
+        for cp in range(first, last + 1):
+            category[cp] = value
+    for first, last, value in parse_ucd(ucd_dir / "auxiliary" / "GraphemeBreakProperty.txt"):
+        for cp in range(first, last + 1):
+            gcb[cp] = GCB.index(value)
+    for first, last, value in parse_ucd(ucd_dir / "emoji" / "emoji-data.txt"):
+        if value == "Extended_Pictographic":
+            for cp in range(first, last + 1):
+                ext_pict[cp] = True
+
+    return eaw, category, gcb, ext_pict
+
+
+# --------------------------------------------------------------------
+def derive_gcb(cp, category):
+    if cp == 0x0D:
+        return GCB.index("CR")
+    if cp == 0x0A:
+        return GCB.index("LF")
+    if cp == 0x200D:
+        return GCB.index("ZWJ")
+    if 0x1F1E6 <= cp <= 0x1F1FF:
+        return GCB.index("Regional_Indicator")
+    if in_ranges(cp, PREPEND):
+        return GCB.index("Prepend")
+    if category in ("Mn", "Me") or in_ranges(cp, OTHER_GRAPHEME_EXTEND):
+        return GCB.index("Extend")
+    if category in ("Zl", "Zp", "Cc", "Cs") or (category == "Cf" and cp not in (0x200C, 0x200D)):
+        return GCB.index("Control")
+    if 0x1100 <= cp <= 0x115F or 0xA960 <= cp <= 0xA97C:
+        return GCB.index("L")
+    if 0x1160 <= cp <= 0x11A7 or 0xD7B0 <= cp <= 0xD7C6:
+        return GCB.index("V")
+    if 0x11A8 <= cp <= 0x11FF or 0xD7CB <= cp <= 0xD7FB:
+        return GCB.index("T")
+    if 0xAC00 <= cp <= 0xD7A3:
+        return GCB.index("LV" if (cp - 0xAC00) % 28 == 0 else "LVT")
+    if cp in (0x0E33, 0x0EB3) or (category == "Mc" and not in_ranges(cp, NOT_SPACING_MARK)):
+        return GCB.index("SpacingMark")
+    return GCB.index("Other")
+
+
+# --------------------------------------------------------------------
+def derive_unicodedata():
+    eaw = []
+    category = []
+    gcb = []
+    ext_pict = []
+    for cp in range(MAX_CODEPOINT):
+        c = chr(cp)
+        eaw.append(unicodedata.east_asian_width(c))
+        category.append(unicodedata.category(c))
+        gcb.append(derive_gcb(cp, category[-1]))
+        ext_pict.append(in_ranges(cp, EXTENDED_PICTOGRAPHIC))
+    return eaw, category, gcb, ext_pict
+
+
+# --------------------------------------------------------------------
+def display_width(cp, eaw, category, gcb):
+    if cp == 0 or category in ("Cc", "Cs"):
+        return 0
+    if cp == 0x00AD:
+        return 1
+    if category in ("Mn", "Me", "Cf", "Zl", "Zp") or GCB[gcb] in ("Extend", "ZWJ", "V", "T"):
+        return 0
+    if eaw in ("W", "F"):
+        return 2
+    return 1
+
+
+# --------------------------------------------------------------------
+def build_tables(eaw, category, gcb, ext_pict):
+    props = []
+    for cp in range(MAX_CODEPOINT):
+        value = gcb[cp]
+        if ext_pict[cp]:
+            value |= EXT_PICT_BIT
+        value |= display_width(cp, eaw[cp], category[cp], gcb[cp]) << WIDTH_SHIFT
+        props.append(value)
+
+    blocks = {}
+    stage1 = []
+    stage2 = []
+    for offset in range(0, MAX_CODEPOINT, BLOCK_SIZE):
+        block = tuple(props[offset:offset + BLOCK_SIZE])
+        if block not in blocks:
+            blocks[block] = len(blocks)
+            stage2.extend(block)
+        stage1.append(blocks[block])
+    return stage1, stage2
+
+
+# --------------------------------------------------------------------
+def emit_array(out, ctype, name, values):
+    out.write(f"inline constexpr {ctype} {name}[{len(values)}] = {{\n")
+    for offset in range(0, len(values), 16):
+        row = ", ".join(f"0x{v:02x}" for v in values[offset:offset + 16])
+        out.write(f"    {row},\n")
+    out.write("};\n\n")
+
+
+# --------------------------------------------------------------------
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("Usage: gen_unicode_data.py UCD_DIR | --from-unicodedata")
+
+    if sys.argv[1] == "--from-unicodedata":
+        source = f"Python unicodedata {unicodedata.unidata_version} (approximate)"
+        tables = derive_unicodedata()
+    else:
+        ucd_dir = Path(sys.argv[1])
+        source = f"the Unicode Character Database {ucd_version(ucd_dir)}"
+        tables = load_ucd(ucd_dir)
+
+    stage1, stage2 = build_tables(*tables)
+    stage1_type = "uint8_t" if max(stage1) < 256 else "uint16_t"
+
+    out = sys.stdout
+    out.write(f"""/*
+ * ## unicode_data.h: Generated Unicode property tables. -------------
+ *
+ * DO NOT EDIT.  Generated by `utils/gen_unicode_data.py` from
+ * {source}.
+ *
+ * Distributed under terms of the MIT license.
+ *
+ * Each code point maps to a property byte via a two-level table: `STAGE1`
+ * maps the high bits of a code point to a block of {BLOCK_SIZE} entries in
+ * `STAGE2`, and identical blocks are shared.  In each property byte, bits 0-3
+ * are the grapheme cluster break class, bit 4 is the Extended_Pictographic
+ * property, and bits 5-6 are the display width in terminal columns.
+ */
+
+#ifndef __MOONLIGHT_UNICODE_DATA_H
+#define __MOONLIGHT_UNICODE_DATA_H
+
+#include <cstdint>
+
+namespace moonlight {{
+namespace unicode {{
+namespace _data {{
+
+inline constexpr unsigned int BLOCK_SIZE = {BLOCK_SIZE};
+inline constexpr unsigned int MAX_CODEPOINT = 0x{MAX_CODEPOINT:x};
+inline constexpr uint8_t GCB_MASK = 0x0f;
+inline constexpr uint8_t EXT_PICT_BIT = 0x{EXT_PICT_BIT:02x};
+inline constexpr unsigned int WIDTH_SHIFT = {WIDTH_SHIFT};
+
+""")
+    emit_array(out, stage1_type, "STAGE1", stage1)
+    emit_array(out, "uint8_t", "STAGE2", stage2)
+    out.write("""}  // namespace _data
+}  // namespace unicode
+}  // namespace moonlight
+
+#endif /* !__MOONLIGHT_UNICODE_DATA_H */
+""")
+
+
+# --------------------------------------------------------------------
+if __name__ == "__main__":
+    main()
@@ -15,11 +15,12 @@
 const std::string CHARACTER_SPACE = moonlight::nanoid::NUMBERS + moonlight::nanoid::LOWERCASE;
 
 int main() {
+    const moonlight::nanoid::Generator ids(8, CHARACTER_SPACE);
     auto infile = moonlight::file::BufferedInput(std::cin);
     while (! infile.is_exhausted()) {
         auto line = infile.getline();
         if (line.size() > 0) {
-            std::cout << moonlight::nanoid::generate(8, CHARACTER_SPACE) << " " << line;
+            std::cout << ids.generate() << " " << line;
         }
     }
     return 0;